@@ -0,0 +1,65 @@
+#include "z80batch.hpp"
+
+struct Machine {
+    unsigned char memory[0x10000];
+};
+
+static unsigned char readByte(void* arg, unsigned short addr) { return ((Machine*)arg)->memory[addr]; }
+static void writeByte(void* arg, unsigned short addr, unsigned char value) { ((Machine*)arg)->memory[addr] = value; }
+static unsigned char inPort(void* arg, unsigned short port) { return 0x00; }
+static void outPort(void* arg, unsigned short port, unsigned char value) {}
+
+// sum of 1 to n (mod 65536)
+static int expected(int n)
+{
+    return (n * (n + 1) / 2) & 0xFFFF;
+}
+
+int main()
+{
+    const int jobCount = 256;
+    int status[jobCount];
+    for (int i = 0; i < jobCount; i++) status[i] = -1;
+    {
+        Z80Batch batch(4, sizeof(Machine) + sizeof(Z80) + 256);
+        for (int i = 0; i < jobCount; i++) {
+            batch.submit([i](Z80Batch::Worker& worker) -> int {
+                Machine* m = worker.create<Machine>();
+                Z80* z80 = worker.create<Z80>(readByte, writeByte, inPort, outPort, m);
+                if (!m || !z80) return -2;
+                const unsigned char rom[] = {
+                    0x21, 0x00, 0x00, // LD HL, $0000
+                    0x01, 0x00, 0x00, // LD BC, n
+                    0x09,             // ADD HL, BC
+                    0x0B,             // DEC BC
+                    0x78,             // LD A, B
+                    0xB1,             // OR C
+                    0x20, 0xFA,       // JR NZ, -6
+                    0x76,             // HALT
+                };
+                memset(m->memory, 0, sizeof(m->memory));
+                memcpy(m->memory, rom, sizeof(rom));
+                m->memory[4] = (unsigned char)(i * 37 + 1);
+                m->memory[5] = (unsigned char)((i * 37 + 1) >> 8);
+                while (0x000D != z80->reg.PC) z80->execute(1000); // until HALT
+                return z80->reg.pair.H * 256 + z80->reg.pair.L;
+            });
+        }
+        Z80Batch::Result result;
+        int received = 0;
+        while (batch.waitResult(&result)) {
+            status[result.id] = result.status;
+            received++;
+        }
+        printf("threads: %d, jobs: %d, received: %d\n", batch.getThreadCount(), jobCount, received);
+    }
+    int ok = 0;
+    for (int i = 0; i < jobCount; i++) {
+        if (status[i] == expected(i * 37 + 1)) ok++;
+        if (i < 4) printf("job #%d: sum(1..%d) = %d\n", i, i * 37 + 1, status[i]);
+    }
+    printf("ok: %d\n", ok);
+    bool matched = ok == jobCount;
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
@@ -0,0 +1,107 @@
+#include "z80bisect.hpp"
+
+struct Machine {
+    Z80* cpu;
+    unsigned char memory[0x10000];
+    unsigned int seed;
+    int inCount;
+    int faultAt; // returns a wrong value at the specified IN (-1: never)
+    unsigned long long resetPosition;
+    unsigned long long faultPosition;
+};
+
+// reset the device state with the CPU and the memory
+class MachineTarget : public Z80BisectCpu
+{
+  private:
+    Machine* machine;
+
+  public:
+    MachineTarget(Machine* machine_) : Z80BisectCpu(machine_->cpu, machine_->memory, sizeof(machine_->memory))
+    {
+        this->machine = machine_;
+    }
+
+    void reset() override
+    {
+        Z80BisectCpu::reset();
+        machine->seed = 1;
+        machine->inCount = 0;
+        machine->resetPosition = cpu->getInstructionCount();
+    }
+
+    // NOTE: the device state is not saved, so the bisector replays from reset
+    bool saveCheckpoint() override { return false; }
+};
+
+static unsigned char readByte(void* arg, unsigned short addr) { return ((Machine*)arg)->memory[addr]; }
+static void writeByte(void* arg, unsigned short addr, unsigned char value) { ((Machine*)arg)->memory[addr] = value; }
+static void outPort(void* arg, unsigned short port, unsigned char value) {}
+static unsigned char inPort(void* arg, unsigned short port)
+{
+    Machine* m = (Machine*)arg;
+    m->seed = m->seed * 1103515245U + 12345U;
+    unsigned char result = (unsigned char)(m->seed >> 16);
+    if (m->inCount++ == m->faultAt) {
+        m->faultPosition = m->cpu->getInstructionCount() - m->resetPosition + 1;
+        result ^= 0x01;
+    }
+    return result;
+}
+
+static void setupMachine(Machine* m, int faultAt)
+{
+    const unsigned char rom[] = {
+        0x21, 0x00, 0x80, // LD HL, $8000
+        0xDB, 0x10,       // IN A, ($10)
+        0x86,             // ADD A, (HL)
+        0x77,             // LD (HL), A
+        0x23,             // INC HL
+        0xCB, 0xBC,       // RES 7, H
+        0xCB, 0xFC,       // SET 7, H
+        0x18, 0xF5,       // JR -11
+    };
+    memset(m->memory, 0, sizeof(m->memory));
+    memcpy(m->memory, rom, sizeof(rom));
+    m->cpu = new Z80(readByte, writeByte, inPort, outPort, m);
+    m->seed = 1;
+    m->inCount = 0;
+    m->faultAt = faultAt;
+    m->resetPosition = 0;
+    m->faultPosition = 0;
+}
+
+int main()
+{
+    static Machine ma;
+    static Machine mb;
+    setupMachine(&ma, -1);
+    setupMachine(&mb, 12345);
+    MachineTarget ta(&ma);
+    MachineTarget tb(&mb);
+    Z80Bisector bisector(&ta, &tb, 4);
+    Z80Bisector::Result result;
+    bisector.run(1000000, &result);
+    bisector.print(stdout, &result);
+    bool matched = result.diverged && result.instruction == mb.faultPosition;
+    printf("expected at instruction #%llu\n", mb.faultPosition);
+
+    // same runs (the break points stop the CPUs before the instruction)
+    mb.faultAt = -1;
+    static int breaks = 0;
+    for (Machine* m : {&ma, &mb}) {
+        m->cpu->addBreakPoint(0x0005, [](void* arg) {
+            breaks++;
+            ((Machine*)arg)->cpu->requestBreakBefore();
+        });
+    }
+    Z80Bisector same(&ta, &tb);
+    same.run(100000, &result);
+    same.print(stdout, &result);
+    printf("breaks: %s\n", 0 < breaks ? "ok" : "ng");
+    matched = matched && !result.diverged && 0 < breaks;
+    delete ma.cpu;
+    delete mb.cpu;
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
@@ -0,0 +1,39 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+int main()
+{
+    // NOP x 16 (4Hz + 3Hz of the fetch wait per instruction)
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.wtc.fetch = 3;
+    long callbackClocks = 0;
+    z80.setConsumeClockCallback([&callbackClocks](void* arg, int clocks) {
+        callbackClocks += clocks;
+    });
+    int hits = 0;
+    z80.addBreakPoint(0x0005, [&](void* arg) {
+        if (0 == hits++) z80.requestBreakBefore();
+    });
+    int executed = z80.execute(70);
+    printf("1st: PC=$%04X, executed=%dHz, total=%lluHz, callback=%ldHz\n", z80.reg.PC, executed, z80.getTotalClocks(), callbackClocks);
+    if (0x0005 != z80.reg.PC || 35 != executed || 35 != z80.getTotalClocks() || 35 != callbackClocks) {
+        puts("unmatched: the fetch wait was consumed before the break");
+        return -1;
+    }
+    executed += z80.execute(35);
+    printf("2nd: PC=$%04X, executed=%dHz, total=%lluHz, callback=%ldHz\n", z80.reg.PC, executed, z80.getTotalClocks(), callbackClocks);
+    if (0x000A != z80.reg.PC || 70 != executed || 70 != z80.getTotalClocks() || 70 != callbackClocks) {
+        puts("unmatched: the fetch wait was consumed twice");
+        return -1;
+    }
+    puts("matched");
+    return 0;
+}
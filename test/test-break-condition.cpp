@@ -0,0 +1,75 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+int main()
+{
+    const unsigned char program[] = {
+        0x21, 0xF0, 0xBF, // LD HL, $BFF0
+        0x23,             // INC HL
+        0x7C,             // LD A, H
+        0xFE, 0xC1,       // CP $C1
+        0x20, 0xFA,       // JR NZ, $0003
+        0x76,             // HALT
+    };
+    memcpy(memory, program, sizeof(program));
+    memory[0xC020] = 0xAA;
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+
+    const char* invalids[] = {"", "A ==", "XYZ == 1", "A == $10000", "(A == 1", "A = 1", "[HL == 1", "A == 1 &&", "A == 1 B"};
+    for (auto condition : invalids) {
+        if (z80.addBreakPoint(0x0003, condition, [](void* arg) { puts("unexpected"); })) {
+            printf("unmatched: accepted \"%s\"\n", condition);
+            return -1;
+        }
+    }
+    int calls[6] = {0, 0, 0, 0, 0, 0};
+    z80.addBreakPoint(0x0003, "HL > $C000 && L == $10", [&](void* arg) {
+        printf("#0 HL=$%02X%02X\n", z80.reg.pair.H, z80.reg.pair.L);
+        calls[0]++;
+    });
+    z80.addBreakPoint(0x0003, "h == 0xC0 && [HL] == 170", [&](void* arg) {
+        printf("#1 HL=$%02X%02X\n", z80.reg.pair.H, z80.reg.pair.L);
+        calls[1]++;
+    });
+    z80.addBreakPoint(0x0003, "(L == $00 || L == $80) && H == $C0", [&](void* arg) {
+        printf("#2 HL=$%02X%02X\n", z80.reg.pair.H, z80.reg.pair.L);
+        calls[2]++;
+    });
+    z80.addBreakPoint(0x0003, "HL - 1 == $BFF0 || [HL + $20] == $AA", [&](void* arg) {
+        printf("#3 HL=$%02X%02X\n", z80.reg.pair.H, z80.reg.pair.L);
+        calls[3]++;
+    });
+    z80.addBreakPoint(0x0003, "H == $C0", [&](void* arg) {
+        printf("#4 HL=$%02X%02X\n", z80.reg.pair.H, z80.reg.pair.L);
+        calls[4]++;
+    }, 250);
+    z80.addBreakPoint(0x0009, [&](void* arg) {
+        printf("#5 HL=$%02X%02X, ZF=%d\n", z80.reg.pair.H, z80.reg.pair.L, z80.reg.pair.F & 0x40 ? 1 : 0);
+        calls[5]++;
+    });
+    z80.addBreakPoint(0x0009, "ZF && A == $C1", [&](void* arg) {
+        puts("#6 ZF && A == $C1");
+    });
+    z80.execute(100000);
+    printf("hits at $0003: %llu\n", z80.getBreakPointHitCount(0x0003));
+    printf("hits at $0009: %llu\n", z80.getBreakPointHitCount(0x0009));
+    z80.resetBreakPointHitCount(0x0003);
+    printf("hits at $0003 after reset: %llu\n", z80.getBreakPointHitCount(0x0003));
+    const int expect[6] = {1, 1, 2, 2, 6, 1};
+    for (int i = 0; i < 6; i++) {
+        if (calls[i] != expect[i]) {
+            printf("unmatched: #%d called %d times (expected: %d)\n", i, calls[i], expect[i]);
+            return -1;
+        }
+    }
+    puts("matched");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "z80.hpp"
+
+static unsigned char rom[256] = {
+    0xDD, 0x21, 0x00, 0x10, // LD IX, $1000
+    0xDD, 0xCB, 0x05, 0x06, // RLC (IX+5)
+    0xFD, 0x36, 0x02, 0xAA, // LD (IY+2), $AA
+    0xED, 0x4B, 0x34, 0x12, // LD BC, ($1234)
+    0xCB, 0x07,             // RLC A
+    0x3E, 0x01,             // LD A, $01
+    0x3E, 0x02,             // LD A, $02
+    0x76,                   // HALT
+};
+
+static int readCount;
+
+static void printOpcode(const char* name, const unsigned char* opcode, int opcodeLength)
+{
+    printf("%s:", name);
+    for (int i = 0; i < opcodeLength; i++) printf(" %02X", opcode[i]);
+    printf(" (len=%d)\n", opcodeLength);
+}
+
+int main()
+{
+    Z80 z80([](void* arg, unsigned short addr) {
+        readCount++;
+        return rom[addr & 0xFF];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.addBreakOperand(0xDD, 0x21, [](void* arg, unsigned char* opcode, int opcodeLength) { printOpcode("DD", opcode, opcodeLength); });
+    z80.addBreakOperand(0xDD, 0xCB, 0x06, [](void* arg, unsigned char* opcode, int opcodeLength) { printOpcode("DDCB", opcode, opcodeLength); });
+    z80.addBreakOperand(0xFD, 0x36, [](void* arg, unsigned char* opcode, int opcodeLength) { printOpcode("FD", opcode, opcodeLength); });
+    z80.addBreakOperand(0xED, 0x4B, [](void* arg, unsigned char* opcode, int opcodeLength) { printOpcode("ED", opcode, opcodeLength); });
+    z80.addBreakOperand(0xCB, 0x07, [](void* arg, unsigned char* opcode, int opcodeLength) { printOpcode("CB", opcode, opcodeLength); });
+    z80.addBreakOperand(0x12, 0x34, [](void* arg, unsigned char* opcode, int opcodeLength) { printOpcode("unsupported prefix", opcode, opcodeLength); });
+    // remove itself and add the other one in the callback
+    z80.addBreakOperand(0x3E, [](void* arg, unsigned char* opcode, int opcodeLength) {
+        printOpcode("LD A, n (first)", opcode, opcodeLength);
+        ((Z80*)arg)->removeBreakOperand(0x3E);
+        ((Z80*)arg)->addBreakOperand(0x3E, [](void* arg2, unsigned char* opcode2, int opcodeLength2) { printOpcode("LD A, n (second)", opcode2, opcodeLength2); });
+    });
+
+    puts("===== read via the callback =====");
+    z80.execute(120);
+    printf("reads: %d\n", readCount);
+
+    puts("===== read via the code pages =====");
+    z80.mapCodePages(0x0000, 0x100, rom);
+    z80.reg.PC = 0x0000;
+    z80.reg.IFF = 0;
+    readCount = 0;
+    z80.execute(120);
+    printf("reads: %d\n", readCount);
+
+    puts("===== remove all break operands =====");
+    z80.removeAllBreakOperands();
+    z80.reg.PC = 0x0000;
+    z80.reg.IFF = 0;
+    z80.execute(120);
+    puts("done");
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+static const char* busTypeName(Z80::BusType type)
+{
+    switch (type) {
+        case Z80::BusType::Fetch: return "FETCH";
+        case Z80::BusType::Read: return "READ ";
+        case Z80::BusType::Write: return "WRITE";
+        case Z80::BusType::In: return "IN   ";
+        case Z80::BusType::Out: return "OUT  ";
+        case Z80::BusType::Acknowledge: return "ACK  ";
+    }
+    return "?";
+}
+
+static void printBusEvents(Z80::BusEvent* events, int count)
+{
+    for (int i = 0; i < count; i++) {
+        printf("%4llu: %s [%04X] $%04X = $%02X\n", events[i].clock, busTypeName(events[i].type), events[i].pc, events[i].addr, events[i].value);
+    }
+}
+
+int main()
+{
+    const unsigned char rom[] = {
+        0x31, 0x00, 0x00, // LD SP, $0000
+        0x3E, 0x12,       // LD A, $12
+        0xED, 0x47,       // LD I, A
+        0xED, 0x5E,       // IM 2
+        0xFB,             // EI
+        0x32, 0x00, 0x80, // LD ($8000), A
+        0xDB, 0xFE,       // IN A, ($FE)
+        0xD3, 0xFE,       // OUT ($FE), A
+        0x76,             // HALT
+    };
+    memcpy(memory, rom, sizeof(rom));
+    memory[0x1234] = 0x00;
+    memory[0x1235] = 0x90;
+    memory[0x9000] = 0xED; // RETI
+    memory[0x9001] = 0x4D;
+    Z80 z80([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) { return 0x5A; },
+            [](void* arg, unsigned short port, unsigned char value) {}, &z80);
+    z80.enableBusLog(16);
+    z80.execute(60);
+    Z80::BusEvent events[64];
+    printf("===== snapshot (count=%d, lost=%llu) =====\n", z80.getBusLogCount(), z80.getBusLogLost());
+    printBusEvents(events, z80.snapshotBusLog(events, 64));
+    z80.clearBusLog();
+    z80.generateIRQ(0x34);
+    z80.execute(20);
+    printf("===== drain 4 (count=%d, lost=%llu) =====\n", z80.getBusLogCount(), z80.getBusLogLost());
+    printBusEvents(events, z80.drainBusLog(events, 4));
+    printf("===== drain all (count=%d) =====\n", z80.getBusLogCount());
+    printBusEvents(events, z80.drainBusLog(events, 64));
+    printf("===== disable (count=%d) =====\n", z80.getBusLogCount());
+    z80.disableBusLog();
+    z80.execute(20);
+    printf("count=%d\n", z80.getBusLogCount());
+    return 0;
+}
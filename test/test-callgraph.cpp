@@ -0,0 +1,76 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+int main()
+{
+    const unsigned char program[] = {
+        0x31, 0x00, 0x00, // $0000: LD SP, $0000
+        0x06, 0x03,       // $0003: LD B, 3
+        0xCD, 0x20, 0x00, // $0005: CALL $0020 (calls $0030)
+        0xCD, 0x30, 0x00, // $0008: CALL $0030
+        0xCD, 0x40, 0x00, // $000B: CALL $0040 (returns with POP HL and JP (HL))
+        0xCD, 0x50, 0x00, // $000E: CALL $0050 (recursive)
+        0xCD, 0x60, 0x00, // $0011: CALL $0060 (jumps with PUSH HL and RET)
+        0x76,             // $0014: HALT
+    };
+    const unsigned char a[] = {0xCD, 0x30, 0x00, 0xC9};       // $0020: CALL $0030, RET
+    const unsigned char b[] = {0x00, 0x00, 0xC9};             // $0030: NOP, NOP, RET
+    const unsigned char c[] = {0xE1, 0x00, 0xE9};             // $0040: POP HL, NOP, JP (HL)
+    const unsigned char d[] = {0x05, 0xC8, 0xCD, 0x50, 0x00, 0xC9}; // $0050: DEC B, RET Z, CALL $0050, RET
+    const unsigned char e[] = {0x21, 0x68, 0x00, 0xE5, 0xC9}; // $0060: LD HL, $0068, PUSH HL, RET
+    memcpy(&memory[0x0000], program, sizeof(program));
+    memcpy(&memory[0x0020], a, sizeof(a));
+    memcpy(&memory[0x0030], b, sizeof(b));
+    memcpy(&memory[0x0040], c, sizeof(c));
+    memcpy(&memory[0x0050], d, sizeof(d));
+    memcpy(&memory[0x0060], e, sizeof(e));
+    memory[0x0068] = 0xC9; // RET
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.addBreakPoint(0x0014, [](void* arg) { ((Z80*)arg)->requestBreak(); });
+    z80.addBreakPoint(0x0031, [](void* arg) { printf("depth at $0031: %d\n", ((Z80*)arg)->getCallGraphDepth()); });
+
+    z80.enableCallGraph();
+    z80.execute(10000);
+    printf("depth at the end: %d\n", z80.getCallGraphDepth());
+
+    Z80::CallGraphEntry entries[8];
+    int n = z80.getCallGraphTop(entries, 8);
+    puts("callees (by inclusive):");
+    for (int i = 0; i < n; i++) {
+        printf("  $%04X: calls=%llu, inclusive=%llu, exclusive=%llu\n", entries[i].addr, entries[i].calls, entries[i].inclusive, entries[i].exclusive);
+    }
+    n = z80.getCallGraphTop(entries, 2, false);
+    puts("callees (by exclusive, top 2):");
+    for (int i = 0; i < n; i++) {
+        printf("  $%04X: calls=%llu, inclusive=%llu, exclusive=%llu\n", entries[i].addr, entries[i].calls, entries[i].inclusive, entries[i].exclusive);
+    }
+
+    puts("folded stacks:");
+    FILE* fp = tmpfile();
+    int lines = z80.exportCallGraph(fp);
+    rewind(fp);
+    unsigned long long total = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        printf("  %s", line);
+        total += strtoull(strrchr(line, ' ') + 1, nullptr, 10);
+    }
+    fclose(fp);
+    printf("lines=%d, total=%llu, total clocks=%llu\n", lines, total, z80.getTotalClocks());
+    if (total != z80.getTotalClocks()) {
+        puts("unmatched");
+        return -1;
+    }
+    z80.disableCallGraph();
+    printf("after disable: enabled=%s, top=%d\n", z80.isCallGraphEnabled() ? "true" : "false", z80.getCallGraphTop(entries, 8));
+    puts("matched");
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "z80.hpp"
+
+struct Machine {
+    unsigned char memory[0x10000];
+    int breakCount;
+};
+
+static unsigned char readByte(void* arg, unsigned short addr) { return ((Machine*)arg)->memory[addr]; }
+static void writeByte(void* arg, unsigned short addr, unsigned char value) { ((Machine*)arg)->memory[addr] = value; }
+static unsigned char inPort(void* arg, unsigned short port) { return 0x00; }
+static void outPort(void* arg, unsigned short port, unsigned char value) {}
+
+int main()
+{
+    const unsigned char rom[] = {
+        0x3C,             // INC A
+        0x47,             // LD B, A
+        0x48,             // LD C, B
+        0x32, 0x00, 0x80, // LD ($8000), A
+        0xC3, 0x00, 0x00, // JP $0000
+    };
+    Machine m1;
+    memset(&m1, 0, sizeof(m1));
+    memcpy(m1.memory, rom, sizeof(rom));
+    Z80 z80(readByte, writeByte, inPort, outPort, &m1);
+    z80.addBreakPoint(0x0003, [](void* arg) { ((Machine*)arg)->breakCount++; });
+    z80.execute(1000);
+    printf("original: A=%02X B=%02X C=%02X ($8000)=%02X break=%d\n", z80.reg.pair.A, z80.reg.pair.B, z80.reg.pair.C, m1.memory[0x8000], m1.breakCount);
+
+    // fork the CPU and its memory
+    Machine m2 = m1;
+    Z80* cpu2 = z80.clone();
+    cpu2->setCallbackArg(&m2);
+    Machine m3 = m1;
+    Z80 cpu3(z80, false);
+    cpu3.setCallbackArg(&m3);
+    m2.breakCount = 0;
+    m3.breakCount = 0;
+    z80.execute(1000);
+    cpu2->execute(1000);
+    cpu3.execute(1000);
+    printf("original: A=%02X B=%02X C=%02X ($8000)=%02X break=%d\n", z80.reg.pair.A, z80.reg.pair.B, z80.reg.pair.C, m1.memory[0x8000], m1.breakCount);
+    printf("clone:    A=%02X B=%02X C=%02X ($8000)=%02X break=%d\n", cpu2->reg.pair.A, cpu2->reg.pair.B, cpu2->reg.pair.C, m2.memory[0x8000], m2.breakCount);
+    printf("nohooks:  A=%02X B=%02X C=%02X ($8000)=%02X break=%d\n", cpu3.reg.pair.A, cpu3.reg.pair.B, cpu3.reg.pair.C, m3.memory[0x8000], m3.breakCount);
+    bool matched = z80.reg.pair.A == cpu2->reg.pair.A && z80.reg.PC == cpu2->reg.PC && m1.memory[0x8000] == m2.memory[0x8000];
+    delete cpu2;
+
+    // move and assign
+    Machine m4 = m1;
+    Z80 cpu4(std::move(cpu3));
+    cpu4.setCallbackArg(&m4);
+    Z80 cpu5;
+    cpu5 = z80;
+    cpu5.setCallbackArg(&m4);
+    cpu4.execute(100);
+    printf("moved:    A=%02X B=%02X C=%02X\n", cpu4.reg.pair.A, cpu4.reg.pair.B, cpu4.reg.pair.C);
+    printf("assigned: A=%02X B=%02X C=%02X\n", cpu5.reg.pair.A, cpu5.reg.pair.B, cpu5.reg.pair.C);
+    z80.removeAllBreakPoints();
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
@@ -0,0 +1,77 @@
+#include "z80.hpp"
+#include <atomic>
+#include <thread>
+
+static unsigned char memory[0x10000];
+static Z80* cpu;
+static unsigned long long outClocks[16];
+static unsigned char outValues[16];
+static int outCount;
+static std::atomic<bool> posted(false);
+
+int main()
+{
+    const unsigned char rom[] = {
+        0xED, 0x56,       // IM 1
+        0xFB,             // EI
+        0x00,             // NOP
+        0x18, 0xFD,       // JR -3
+    };
+    const unsigned char isr[] = {
+        0x2A, 0x00, 0x80, // LD HL, ($8000)
+        0x23,             // INC HL
+        0x22, 0x00, 0x80, // LD ($8000), HL
+        0xFB,             // EI
+        0xED, 0x4D,       // RETI
+    };
+    memcpy(memory, rom, sizeof(rom));
+    memcpy(&memory[0x38], isr, sizeof(isr));
+    Z80 z80([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) { return 0x00; },
+            [](void* arg, unsigned short port, unsigned char value) {
+                if (outCount < 16) {
+                    outClocks[outCount] = cpu->getTotalClocks();
+                    outValues[outCount++] = value;
+                }
+            },
+            &z80);
+    cpu = &z80;
+    z80.enableCommandQueue(64);
+    // NOTE: wait for the host thread if the queue is empty (emulate the host that posts the commands in time)
+    z80.setConsumeClockCallback([](void* arg, int clocks) {
+        while (0 == cpu->getCommandCount() && !posted) std::this_thread::yield();
+    });
+
+    // post the timed commands from the other thread
+    std::thread host([&z80]() {
+        for (int i = 1; i <= 100; i++) {
+            while (!z80.postCommand(Z80::CommandType::IRQ, (unsigned long long)i * 10000, 0, 0xFF)) std::this_thread::yield();
+            if (0 == i % 10) {
+                while (!z80.postCommand(Z80::CommandType::Out, (unsigned long long)i * 10000 + 5000, 0x10, (unsigned char)i)) std::this_thread::yield();
+            }
+        }
+        while (!z80.postCommand(Z80::CommandType::Write, 1500000, 0x9000, 0x55)) std::this_thread::yield();
+        while (!z80.postCommand(Z80::CommandType::Break, 2000000)) std::this_thread::yield();
+        posted = true;
+    });
+    z80.execute(); // execute until the break command
+    host.join();
+
+    bool matched = true;
+    unsigned long long clocks = z80.getTotalClocks();
+    bool breakOk = 2000000 <= clocks && clocks < 2000000 + 32;
+    printf("break: %s\n", breakOk ? "ok" : "ng");
+    int irq = memory[0x8000] + memory[0x8001] * 256;
+    printf("IRQ: %d times\n", irq);
+    printf("write: $%02X\n", memory[0x9000]);
+    matched = breakOk && 100 == irq && 0x55 == memory[0x9000] && 10 == outCount;
+    for (int i = 0; i < outCount; i++) {
+        unsigned long long stamp = (unsigned long long)outValues[i] * 10000 + 5000;
+        bool ok = stamp <= outClocks[i] && outClocks[i] < stamp + 32;
+        printf("out #%d: value=%d %s\n", i, outValues[i], ok ? "ok" : "ng");
+        matched = matched && ok;
+    }
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
@@ -0,0 +1,50 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+static unsigned char delayTable[64];
+
+int main()
+{
+    const unsigned char rom[] = {
+        0x3A, 0x00, 0x40, // LD A, ($4000)
+        0x32, 0x00, 0x80, // LD ($8000), A
+        0xD3, 0xFE,       // OUT ($FE), A
+        0xC3, 0x00, 0x00, // JP $0000
+    };
+    memcpy(memory, rom, sizeof(rom));
+    Z80 z80([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) { return 0xFF; },
+            [](void* arg, unsigned short port, unsigned char value) {}, &z80);
+    // ZX Spectrum like delay pattern: 6, 5, 4, 3, 2, 1, 0, 0 (from frame cycle 16 to 47)
+    for (int i = 16; i < 48; i++) {
+        const unsigned char pattern[8] = {6, 5, 4, 3, 2, 1, 0, 0};
+        delayTable[i] = pattern[i & 7];
+    }
+    z80.setupContention(delayTable, sizeof(delayTable));
+    z80.setContendedMemory(0x4000, 0x4000, true);
+    z80.setContendedPorts(0x0000, 0x10000, false);
+    for (int i = 0; i < 12; i++) {
+        unsigned short pc = z80.reg.PC;
+        int frameClock = z80.getContentionFrameClock();
+        int clocks = z80.execute(1);
+        printf("[%04X] frame cycle %2d: %2dHz\n", pc, frameClock, clocks);
+    }
+    puts("===== contended ports =====");
+    z80.setContendedPorts(0x0000, 0x10000, true);
+    z80.setContentionFrameClock(0);
+    for (int i = 0; i < 4; i++) {
+        unsigned short pc = z80.reg.PC;
+        int frameClock = z80.getContentionFrameClock();
+        int clocks = z80.execute(1);
+        printf("[%04X] frame cycle %2d: %2dHz\n", pc, frameClock, clocks);
+    }
+    puts("===== reset contention =====");
+    z80.resetContention();
+    for (int i = 0; i < 4; i++) {
+        unsigned short pc = z80.reg.PC;
+        int clocks = z80.execute(1);
+        printf("[%04X] %2dHz\n", pc, clocks);
+    }
+    return 0;
+}
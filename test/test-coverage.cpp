@@ -0,0 +1,75 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+int main()
+{
+    const unsigned char program[] = {
+        0x06, 0x03,       // LD B, 3
+        0xCD, 0x10, 0x00, // CALL $0010
+        0x10, 0xFB,       // DJNZ $0002
+        0x76,             // HALT
+    };
+    const unsigned char sub[] = {
+        0xB7,             // OR A
+        0xC8,             // RET Z
+        0xCA, 0x20, 0x00, // JP Z, $0020
+        0xC9,             // RET
+    };
+    memcpy(&memory[0x0000], program, sizeof(program));
+    memcpy(&memory[0x0010], sub, sizeof(sub));
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.addBreakPoint(0x0007, [](void* arg) { ((Z80*)arg)->requestBreak(); });
+
+    z80.enableCoverage();
+    z80.reg.pair.A = 0;
+    z80.execute(10000);
+    printf("A=0: executed=%d, taken=%d, not-taken=%d\n", z80.getCoveredCount(), z80.getCoveredCount(Z80::CoverageMap::BranchTaken), z80.getCoveredCount(Z80::CoverageMap::BranchNotTaken));
+    if (z80.getCoveredCount() != 6 || z80.isCovered(0x0012) || !z80.isCovered(0x0011, Z80::CoverageMap::BranchTaken) || z80.isCovered(0x0011, Z80::CoverageMap::BranchNotTaken)) {
+        puts("unmatched");
+        return -1;
+    }
+
+    // run the other path with the copied CPU and merge it
+    Z80 other(z80);
+    other.clearCoverage();
+    other.reg.PC = 0;
+    other.reg.IFF = 0;
+    other.reg.pair.A = 1;
+    other.execute(10000);
+    z80.mergeCoverage(other);
+    printf("merged: executed=%d, taken=%d, not-taken=%d\n", z80.getCoveredCount(), z80.getCoveredCount(Z80::CoverageMap::BranchTaken), z80.getCoveredCount(Z80::CoverageMap::BranchNotTaken));
+    if (z80.getCoveredCount() != 8 || !z80.isCovered(0x0011, Z80::CoverageMap::BranchNotTaken) || !z80.isCovered(0x0012, Z80::CoverageMap::BranchNotTaken) || z80.isCovered(0x0012, Z80::CoverageMap::BranchTaken)) {
+        puts("unmatched");
+        return -1;
+    }
+
+    z80.exportCoverage(stdout, [](void* arg, unsigned short addr) -> const char* {
+        return addr < 0x0010 ? "main" : "sub";
+    });
+
+    // merge the raw bitmap
+    Z80 empty(z80);
+    empty.clearCoverage();
+    empty.mergeCoverage(Z80::CoverageMap::Executed, z80.getCoverageMap(Z80::CoverageMap::Executed));
+    printf("raw merge: executed=%d, taken=%d\n", empty.getCoveredCount(), empty.getCoveredCount(Z80::CoverageMap::BranchTaken));
+    if (empty.getCoveredCount() != 8 || empty.getCoveredCount(Z80::CoverageMap::BranchTaken) != 0) {
+        puts("unmatched");
+        return -1;
+    }
+
+    z80.disableCoverage();
+    if (z80.isCoverageEnabled() || z80.getCoverageMap(Z80::CoverageMap::Executed)) {
+        puts("unmatched");
+        return -1;
+    }
+    puts("matched");
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+static Z80::DebugEvent events[16];
+static int eventCount;
+
+int main()
+{
+    const unsigned char program[] = {
+        0x3E, 0x12,             // LD A, $12
+        0x06, 0x00,             // LD B, $00
+        0xDD, 0x21, 0x00, 0x80, // LD IX, $8000
+        0xDD, 0x36, 0xFE, 0x34, // LD (IX-$02), $34
+        0xDD, 0xCB, 0x05, 0xC6, // SET 0, (IX+$05)
+        0xCB, 0x27,             // SLA A
+        0x20, 0xFE,             // JR NZ, $0012
+    };
+    memcpy(memory, program, sizeof(program));
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.addBreakPoint(0x0012, [](void* arg) { ((Z80*)arg)->requestBreak(); });
+    z80.setDebugEvent([](void* arg, const Z80::DebugEvent* event) {
+        if (eventCount < 16) events[eventCount++] = *event;
+    });
+    z80.execute(10000);
+
+    char text[64];
+    char mnemonic[32];
+    for (int i = 0; i < eventCount; i++) {
+        const Z80::DebugEvent& e = events[i];
+        Z80::formatDebugEvent(e, text, sizeof(text));
+        z80.getOpcodeMnemonic(e.prefix, e.opcode, mnemonic, sizeof(mnemonic));
+        printf("%-24s id=%04X:%02X (%s), length=%d, operands=%X, n=$%04X, d=%d, clocks=%d, A=$%02X->$%02X, PC=$%04X->$%04X\n",
+               text, e.prefix, e.opcode, mnemonic, e.length, e.operands, e.immediate, e.displacement, e.clocks,
+               e.before.pair.A, e.after.pair.A, e.before.PC, e.after.PC);
+    }
+    if (7 != eventCount ||
+        Z80::operandN != events[0].operands || 0x12 != events[0].immediate || 0x12 != events[0].after.pair.A ||
+        Z80::operandN != events[1].operands || 0x00 != events[1].immediate ||
+        Z80::operandNN != events[2].operands || 0xDD != events[2].prefix || 0x8000 != events[2].immediate || 4 != events[2].length ||
+        (Z80::operandD | Z80::operandN) != events[3].operands || -2 != events[3].displacement || 0x34 != events[3].immediate ||
+        Z80::operandD != events[4].operands || 0xDDCB != events[4].prefix || 0xC6 != events[4].opcode || 5 != events[4].displacement || 4 != events[4].length ||
+        0 != events[5].operands || 0x24 != events[5].after.pair.A ||
+        Z80::operandE != events[6].operands || -2 != events[6].displacement || 0x0012 != events[6].after.PC || 12 != events[6].clocks) {
+        puts("unmatched");
+        return -1;
+    }
+    z80.resetDebugEvent();
+    eventCount = 0;
+    z80.execute(100);
+    if (0 != eventCount) {
+        puts("unmatched");
+        return -1;
+    }
+    puts("matched");
+    return 0;
+}
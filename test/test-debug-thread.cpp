@@ -0,0 +1,61 @@
+#include "z80.hpp"
+#include <string>
+#include <thread>
+
+struct Machine {
+    unsigned char memory[0x10000];
+    std::string trace;
+};
+
+static unsigned char readByte(void* arg, unsigned short addr) { return ((Machine*)arg)->memory[addr]; }
+static void writeByte(void* arg, unsigned short addr, unsigned char value) { ((Machine*)arg)->memory[addr] = value; }
+static unsigned char inPort(void* arg, unsigned short port) { return 0x00; }
+static void outPort(void* arg, unsigned short port, unsigned char value) {}
+
+static void run(Machine* m, unsigned char seed)
+{
+    const unsigned char rom[] = {
+        0x3E, seed,       // LD A, seed
+        0x01, 0x34, 0x12, // LD BC, $1234
+        0x11, 0x78, 0x56, // LD DE, $5678
+        0x21, 0x00, 0x80, // LD HL, $8000
+        0x80,             // ADD A, B
+        0x91,             // SUB A, C
+        0x09,             // ADD HL, BC
+        0x19,             // ADD HL, DE
+        0x77,             // LD (HL), A
+        0x10, 0xF7,       // DJNZ -9
+        0x18, 0xEC,       // JR -20
+    };
+    memset(m->memory, 0, sizeof(m->memory));
+    memcpy(m->memory, rom, sizeof(rom));
+    m->trace.clear();
+    Z80 z80(readByte, writeByte, inPort, outPort, m);
+    z80.setDebugMessage([](void* arg, const char* msg) {
+        ((Machine*)arg)->trace += msg;
+        ((Machine*)arg)->trace += "\n";
+    });
+    z80.execute(200000);
+}
+
+int main()
+{
+    // reference traces (single thread)
+    static Machine expect[4];
+    for (int i = 0; i < 4; i++) run(&expect[i], (unsigned char)(i * 0x35));
+
+    // trace the CPUs concurrently
+    static Machine actual[4];
+    std::thread threads[4];
+    for (int i = 0; i < 4; i++) threads[i] = std::thread(run, &actual[i], (unsigned char)(i * 0x35));
+    for (int i = 0; i < 4; i++) threads[i].join();
+
+    bool matched = true;
+    for (int i = 0; i < 4; i++) {
+        bool same = expect[i].trace == actual[i].trace;
+        printf("CPU#%d: %d bytes trace, %s\n", i, (int)actual[i].trace.size(), same ? "same" : "different");
+        matched = matched && same;
+    }
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
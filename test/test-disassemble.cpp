@@ -0,0 +1,113 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+static int reads;
+
+static int listing(Z80& z80, unsigned short addr, int lines)
+{
+    char buf[64];
+    for (int i = 0; i < lines; i++) {
+        int length = z80.disassemble(addr, buf, sizeof(buf));
+        printf("  $%04X (%d): %s\n", addr, length, buf);
+        addr += (unsigned short)length;
+    }
+    return addr;
+}
+
+int main()
+{
+    const unsigned char program[] = {
+        0x21, 0x00, 0x01,       // $0000: LD HL, $0100
+        0x36, 0x3C,             // $0003: LD (HL), $3C (INC A)
+        0xDD, 0x7E, 0xFB,       // $0005: LD A, (IX-$05)
+        0xFD, 0xCB, 0x10, 0x46, // $0008: BIT 0, (IY+$10)
+        0xED, 0xB0,             // $000C: LDIR
+        0xCB, 0x11,             // $000E: RL C
+        0x18, 0xFE,             // $0010: JR $0010
+        0xED, 0x00,             // $0012: unknown
+        0x76,                   // $0014: HALT
+    };
+    memcpy(memory, program, sizeof(program));
+    memory[0x0100] = 0x00; // NOP
+    Z80 z80([](void* arg, unsigned short addr) {
+        reads++;
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+
+    puts("listing:");
+    if (0x0015 != listing(z80, 0x0000, 9)) {
+        puts("unmatched");
+        return -1;
+    }
+
+    char buf[64];
+    z80.enableDisassembleCache();
+    z80.disassemble(0x0100, buf, sizeof(buf));
+    printf("$0100 before: %s\n", buf);
+
+    // the write of the CPU invalidates the cache
+    z80.execute(17);
+    z80.disassemble(0x0100, buf, sizeof(buf));
+    printf("$0100 after LD (HL), $3C: %s\n", buf);
+    if (0 != strcmp(buf, "INC A")) {
+        puts("unmatched");
+        return -1;
+    }
+
+    // the write out of the CPU needs invalidateDisassembleCache
+    memory[0x0100] = 0x3D;
+    z80.disassemble(0x0100, buf, sizeof(buf));
+    printf("$0100 cached: %s\n", buf);
+    if (0 != strcmp(buf, "INC A")) {
+        puts("unmatched");
+        return -1;
+    }
+    z80.invalidateDisassembleCache(0x0100);
+    z80.disassemble(0x0100, buf, sizeof(buf));
+    printf("$0100 invalidated: %s\n", buf);
+    if (0 != strcmp(buf, "DEC A")) {
+        puts("unmatched");
+        return -1;
+    }
+
+    // the write of an operand invalidates the instruction that contains it
+    memory[0x0200] = 0x01; // LD BC, $5678
+    memory[0x0201] = 0x78;
+    memory[0x0202] = 0x56;
+    z80.disassemble(0x0200, buf, sizeof(buf));
+    printf("$0200 before: %s\n", buf);
+    z80.reg.PC = 0x0300;
+    memory[0x0300] = 0x32; // LD ($0202), A
+    memory[0x0301] = 0x02;
+    memory[0x0302] = 0x02;
+    z80.reg.pair.A = 0x12;
+    z80.execute(13);
+    z80.disassemble(0x0200, buf, sizeof(buf));
+    printf("$0200 after: %s\n", buf);
+    if (0 != strcmp(buf, "LD BC, $1278")) {
+        puts("unmatched");
+        return -1;
+    }
+    z80.disableDisassembleCache();
+
+    // the peek callback reads the code without the side effects of the read callback
+    int peeks = 0;
+    z80.setPeekCallback([&peeks](void* arg, unsigned short addr) {
+        peeks++;
+        return memory[addr];
+    });
+    reads = 0;
+    z80.disassemble(0x0000, buf, sizeof(buf));
+    printf("peek: %s (peeks=%d, reads=%d)\n", buf, peeks, reads);
+    if (0 != strcmp(buf, "LD HL, $0100") || 0 == peeks || 0 != reads) {
+        puts("unmatched");
+        return -1;
+    }
+    puts("matched");
+    return 0;
+}
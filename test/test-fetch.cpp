@@ -0,0 +1,50 @@
+#include "z80.hpp"
+
+// opcode bytes are encrypted with XOR $55 (operands and data are not encrypted)
+static unsigned char rom[256] = {
+    0x01 ^ 0x55, 0x34, 0x12, // LD BC, $1234
+    0x3E ^ 0x55, 0x01,       // LD A, $01
+    0xED ^ 0x55, 0x79 ^ 0x55, // OUT (C), A
+    0x3A ^ 0x55, 0x80, 0x00, // LD A, ($0080)
+    0x76 ^ 0x55,             // HALT
+};
+
+unsigned char readMemory(void* arg, unsigned short addr)
+{
+    printf("read: $%04X\n", addr);
+    return rom[addr & 0xFF];
+}
+
+void writeMemory(void* arg, unsigned short addr, unsigned char value) {}
+unsigned char inPort(void* arg, unsigned short port) { return 0x00; }
+void outPort(void* arg, unsigned short port, unsigned char value) { printf("out: port $%04X <- $%02X\n", port, value); }
+
+int main()
+{
+    rom[0x80] = 0xA5;
+    Z80 z80(readMemory, writeMemory, inPort, outPort, &z80);
+    z80.setDebugMessage([](void* arg, const char* msg) { puts(msg); });
+    z80.setFetchCallback([](void* arg, unsigned short addr) {
+        printf("fetch (M1): $%04X\n", addr);
+        return (unsigned char)(rom[addr & 0xFF] ^ 0x55);
+    });
+    puts("===== with M1 callback =====");
+    printf("actualExecuteClocks = %dHz\n", z80.execute(46));
+
+    puts("===== with code pages (plain opcode) =====");
+    for (int i = 0; i < 11; i++) {
+        if (i != 1 && i != 2 && i != 4 && i != 8 && i != 9) rom[i] ^= 0x55;
+    }
+    z80.resetFetchCallback();
+    z80.mapCodePages(0x0000, 0x100, rom);
+    z80.reg.PC = 0x0000;
+    z80.reg.IFF = 0;
+    printf("actualExecuteClocks = %dHz\n", z80.execute(46));
+
+    puts("===== unmap code pages =====");
+    z80.unmapCodePages(0x0000, 0x100);
+    z80.reg.PC = 0x0000;
+    z80.reg.IFF = 0;
+    printf("actualExecuteClocks = %dHz\n", z80.execute(10));
+    return 0;
+}
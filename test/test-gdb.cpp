@@ -0,0 +1,128 @@
+#include "z80gdb.hpp"
+#include <atomic>
+#include <thread>
+
+static unsigned char memory[0x10000];
+
+static std::string command(int fd, const char* data)
+{
+    char packet[256];
+    unsigned char sum = 0;
+    for (const char* ptr = data; *ptr; ptr++) sum = (unsigned char)(sum + (unsigned char)*ptr);
+    snprintf(packet, sizeof(packet), "$%s#%02x", data, sum);
+    send(fd, packet, strlen(packet), 0);
+    std::string reply;
+    char c;
+    bool body = false;
+    while (1 == recv(fd, &c, 1, 0)) {
+        if ('$' == c) {
+            body = true;
+        } else if ('#' == c && body) {
+            recv(fd, packet, 2, 0); // checksum
+            send(fd, "+", 1, 0);
+            break;
+        } else if (body) {
+            reply += c;
+        }
+    }
+    printf("%-20s -> %s\n", data, reply.c_str());
+    return reply;
+}
+
+int main()
+{
+    const unsigned char program[] = {
+        0x3C,       // $0000: INC A
+        0x00,       // $0001: NOP
+        0x04,       // $0002: INC B
+        0x18, 0xFB, // $0003: JR $0000
+    };
+    memcpy(memory, program, sizeof(program));
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, nullptr);
+    z80.reg.pair.A = 0;
+    z80.reg.pair.B = 0;
+    std::atomic<int> hostHits(0);
+    z80.addBreakPoint(0x0002, [&hostHits](void* arg) { hostHits++; }); // the break point of the host at the same address
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        puts("socketpair failed");
+        return -1;
+    }
+    Z80GdbStub* stub = new Z80GdbStub(&z80);
+    stub->attach(fds[0]);
+    std::thread server([stub]() { stub->serve(); });
+    int fd = fds[1];
+
+    bool result = true;
+    result &= command(fd, "qSupported:swbreak+") == "PacketSize=1000";
+    result &= command(fd, "?") == "S05";
+    result &= command(fd, "g").size() == 13 * 4;
+    result &= command(fd, "M8000,2:abcd") == "OK";
+    result &= command(fd, "m8000,2") == "abcd";
+    result &= memory[0x8000] == 0xAB && memory[0x8001] == 0xCD;
+
+    // stop before the break point
+    result &= command(fd, "Z0,2,1") == "OK";
+    result &= command(fd, "c") == "S05";
+    result &= command(fd, "p5") == "0200"; // PC = $0002
+    result &= command(fd, "p1") == "0000"; // BC = $0000 (INC B is not executed)
+    result &= command(fd, "p0").substr(2) == "01"; // A = 1
+    result &= 1 == hostHits;
+
+    // continue from the break point
+    result &= command(fd, "c") == "S05";
+    result &= command(fd, "p5") == "0200";
+    result &= command(fd, "p1") == "0001"; // BC = $0100
+    result &= 2 == hostHits; // not called again when leaving the break point
+    result &= 2 * 2 == z80.getBreakPointHitCount(0x0002);
+    result &= command(fd, "s") == "S05";
+    result &= command(fd, "p5") == "0300";
+
+    // remove only the break point of the debugger
+    result &= command(fd, "z0,2,1") == "OK";
+    result &= command(fd, "Z0,3,1") == "OK";
+    result &= command(fd, "c") == "S05";
+    result &= command(fd, "p5") == "0300";
+    result &= 0 < z80.getBreakPointHitCount(0x0003);
+    result &= command(fd, "z0,3,1") == "OK";
+    result &= 0 == z80.getBreakPointHitCount(0x0003);
+
+    // write the registers
+    result &= command(fd, "P1=3412") == "OK";
+    result &= z80.reg.pair.B == 0x12 && z80.reg.pair.C == 0x34;
+
+    // interrupt the infinite loop
+    std::thread interrupter([fd]() {
+        usleep(10000);
+        char c = 0x03;
+        send(fd, &c, 1, 0);
+    });
+    result &= command(fd, "c") == "S02";
+    interrupter.join();
+    result &= command(fd, "D") == "OK";
+    server.join();
+    close(fd);
+    if (!result || stub->isConnected()) {
+        puts("unmatched");
+        return -1;
+    }
+
+    // the break point of the host remains after the destructor
+    delete stub;
+    int hits = hostHits;
+    z80.execute(100);
+    if (hits == hostHits) {
+        puts("unmatched: the break point of the host was removed");
+        return -1;
+    }
+    puts("matched");
+    return 0;
+}
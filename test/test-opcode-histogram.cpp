@@ -0,0 +1,66 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+int main()
+{
+    const unsigned char program[] = {
+        0xDD, 0x21, 0x00, 0x80, // LD IX, $8000
+        0x06, 0x10,             // LD B, 16
+        0xDD, 0x7E, 0x00,       // LD A, (IX+0)
+        0xCB, 0x3F,             // SRL A
+        0xDD, 0xCB, 0x01, 0x06, // RLC (IX+1)
+        0xED, 0x44,             // NEG
+        0xDD, 0x23,             // INC IX
+        0x10, 0xF1,             // DJNZ $0006
+        0x76,                   // HALT
+    };
+    memcpy(memory, program, sizeof(program));
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.addBreakPoint(0x0015, [](void* arg) { ((Z80*)arg)->requestBreak(); });
+
+    z80.enableOpcodeHistogram();
+    z80.execute(10000);
+
+    Z80::OpcodeEntry entries[16];
+    int n = z80.getOpcodeHistogramTop(entries, 16);
+    puts("by count:");
+    for (int i = 0; i < n; i++) {
+        printf("  %-4X %02X %-16s count=%llu, clocks=%llu\n", entries[i].prefix, entries[i].opcode, entries[i].mnemonic, entries[i].count, entries[i].clocks);
+    }
+    n = z80.getOpcodeHistogramTop(entries, 3, true);
+    puts("by clocks (top 3):");
+    for (int i = 0; i < n; i++) {
+        printf("  %-4X %02X %-16s count=%llu, clocks=%llu\n", entries[i].prefix, entries[i].opcode, entries[i].mnemonic, entries[i].count, entries[i].clocks);
+    }
+
+    unsigned long long clocks = 0;
+    const int prefixes[7] = {0x00, 0xCB, 0xED, 0xDD, 0xFD, 0xDDCB, 0xFDCB};
+    for (auto prefix : prefixes) {
+        for (int op = 0; op < 256; op++) clocks += z80.getOpcodeClocks(prefix, (unsigned char)op);
+    }
+    printf("clocks=%llu, total clocks=%llu\n", clocks, z80.getTotalClocks());
+    if (clocks != z80.getTotalClocks() || z80.getOpcodeCount(0xDD, 0xCB) != z80.getOpcodeCount(0xDDCB, 0x06)) {
+        puts("unmatched");
+        return -1;
+    }
+
+    puts("mnemonics:");
+    const int samples[][2] = {{0x00, 0x36}, {0x00, 0xE3}, {0xCB, 0x7E}, {0xED, 0x70}, {0xED, 0xB0}, {0xDD, 0x66}, {0xFD, 0x6C}, {0xFD, 0xE9}, {0xFDCB, 0xC6}, {0xFDCB, 0x8F}};
+    for (auto& sample : samples) {
+        char buf[24];
+        z80.getOpcodeMnemonic(sample[0], (unsigned char)sample[1], buf, sizeof(buf));
+        printf("  %-4X %02X %s\n", sample[0], sample[1], buf);
+    }
+    z80.disableOpcodeHistogram();
+    printf("after disable: enabled=%s, top=%d\n", z80.isOpcodeHistogramEnabled() ? "true" : "false", z80.getOpcodeHistogramTop(entries, 16));
+    puts("matched");
+    return 0;
+}
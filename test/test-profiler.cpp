@@ -0,0 +1,65 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+static void printTop(Z80& z80, bool byClocks)
+{
+    Z80::ProfileEntry entries[4];
+    int n = z80.getProfilerTop(entries, 4, byClocks);
+    printf("top %d (by %s):\n", n, byClocks ? "clocks" : "count");
+    for (int i = 0; i < n; i++) {
+        printf("  $%04X: count=%llu, clocks=%llu\n", entries[i].addr, entries[i].count, entries[i].clocks);
+    }
+}
+
+int main()
+{
+    const unsigned char program[] = {
+        0x06, 0x0A,       // LD B, 10
+        0xCD, 0x10, 0x00, // CALL $0010
+        0x10, 0xFB,       // DJNZ $0002
+        0x76,             // HALT
+    };
+    const unsigned char sub[] = {
+        0x3E, 0x05, // LD A, 5
+        0x3D,       // DEC A
+        0x20, 0xFD, // JR NZ, $0012
+        0xC9,       // RET
+    };
+    memcpy(&memory[0x0000], program, sizeof(program));
+    memcpy(&memory[0x0010], sub, sizeof(sub));
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.addBreakPoint(0x0007, [](void* arg) { ((Z80*)arg)->requestBreak(); });
+
+    z80.enableProfiler();
+    z80.execute(10000);
+    printTop(z80, true);
+    printTop(z80, false);
+
+    unsigned long long clocks = 0;
+    unsigned long long count = 0;
+    for (int i = 0; i < 0x10000; i++) {
+        clocks += z80.getProfilerClocks()[i];
+        count += z80.getProfilerCounts()[i];
+    }
+    printf("total: count=%llu (instructions: %llu), clocks=%llu (total clocks: %llu)\n", count, z80.getInstructionCount(), clocks, z80.getTotalClocks());
+    if (count != z80.getInstructionCount() || clocks != z80.getTotalClocks()) {
+        puts("unmatched");
+        return -1;
+    }
+
+    Z80 copy(z80);
+    z80.clearProfiler();
+    printf("after clear: $0012 count=%llu, copied $0012 count=%llu\n", z80.getProfilerCounts()[0x0012], copy.getProfilerCounts()[0x0012]);
+    z80.disableProfiler();
+    printf("after disable: enabled=%s, top=%d\n", z80.isProfilerEnabled() ? "true" : "false", z80.getProfilerTop(nullptr, 4));
+    puts("matched");
+    return 0;
+}
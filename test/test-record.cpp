@@ -0,0 +1,106 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+static unsigned int seed = 1;
+
+static unsigned int hashMemory()
+{
+    unsigned int hash = 2166136261U;
+    for (size_t i = 0; i < sizeof(memory); i++) hash = (hash ^ memory[i]) * 16777619U;
+    return hash;
+}
+
+static void setupMemory()
+{
+    const unsigned char rom[] = {
+        0xED, 0x56,       // IM 1
+        0x21, 0x00, 0x80, // LD HL, $8000
+        0xFB,             // EI
+        0xDB, 0x10,       // IN A, ($10)
+        0x86,             // ADD A, (HL)
+        0x77,             // LD (HL), A
+        0x23,             // INC HL
+        0xCB, 0xBC,       // RES 7, H
+        0xCB, 0xFC,       // SET 7, H
+        0x18, 0xF5,       // JR -11
+    };
+    const unsigned char isr[] = {
+        0xF5,             // PUSH AF
+        0xDB, 0x20,       // IN A, ($20)
+        0x32, 0x00, 0x70, // LD ($7000), A
+        0xF1,             // POP AF
+        0xFB,             // EI
+        0xED, 0x4D,       // RETI
+    };
+    const unsigned char nmi[] = {
+        0xF5,             // PUSH AF
+        0x3A, 0x01, 0x70, // LD A, ($7001)
+        0x3C,             // INC A
+        0x32, 0x01, 0x70, // LD ($7001), A
+        0xF1,             // POP AF
+        0xED, 0x45,       // RETN
+    };
+    memset(memory, 0, sizeof(memory));
+    memcpy(memory, rom, sizeof(rom));
+    memcpy(&memory[0x38], isr, sizeof(isr));
+    memcpy(&memory[0x66], nmi, sizeof(nmi));
+}
+
+int main()
+{
+    // record: the input values and the interrupts are generated by the (random) host devices
+    setupMemory();
+    Z80 z80([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) {
+                seed = seed * 1103515245U + 12345U;
+                return (unsigned char)(seed >> 16);
+            },
+            [](void* arg, unsigned short port, unsigned char value) {}, &z80);
+    z80.setConsumeClockCallback([](void* arg, int clocks) {
+        seed = seed * 1103515245U + 12345U;
+        if (0 == (seed >> 16) % 397) ((Z80*)arg)->generateIRQ(0xFF);
+        if (0 == (seed >> 16) % 1999) ((Z80*)arg)->generateNMI(0x0066);
+    });
+    z80.execute(1000);
+    static unsigned char initialMemory[0x10000];
+    memcpy(initialMemory, memory, sizeof(memory));
+    unsigned long long recordStart = z80.getInstructionCount();
+    z80.startRecording();
+    for (int i = 0; i < 100; i++) {
+        z80.execute(1000);
+        if (i % 10 == 5) z80.generateIRQ(0xFF); // between the executions
+    }
+    z80.stopRecording();
+    printf("recorded: PC=$%04X, A=$%02X, HL=$%02X%02X, %llu clocks\n", z80.reg.PC, z80.reg.pair.A, z80.reg.pair.H, z80.reg.pair.L, z80.getTotalClocks());
+    unsigned int hash = hashMemory();
+    unsigned long long instructions = z80.getInstructionCount() - recordStart;
+    printf("recorded: %d bytes, %llu instructions, NMI %d times\n", (int)z80.getRecordSize(), instructions, memory[0x7001] - initialMemory[0x7001]);
+
+    // replay: no host devices are attached
+    unsigned char* stream = (unsigned char*)malloc(z80.getRecordSize());
+    memcpy(stream, z80.getRecordData(), z80.getRecordSize());
+    size_t streamSize = z80.getRecordSize();
+    setupMemory();
+    Z80 cpu([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) { return 0x00; },
+            [](void* arg, unsigned short port, unsigned char value) {}, &cpu);
+    cpu.execute(1000); // NOTE: run with the other inputs before the replay (overwritten by the replay)
+    unsigned long long start = cpu.getInstructionCount();
+    if (!cpu.startReplay(stream, streamSize)) {
+        puts("startReplay failed");
+        return -1;
+    }
+    // NOTE: the memory should be restored by the host
+    memcpy(memory, initialMemory, sizeof(memory));
+    while (cpu.isReplaying()) {
+        cpu.execute(1000);
+    }
+    printf("replayed: PC=$%04X, A=$%02X, HL=$%02X%02X, %llu clocks\n", cpu.reg.PC, cpu.reg.pair.A, cpu.reg.pair.H, cpu.reg.pair.L, cpu.getTotalClocks());
+    printf("replayed: %llu instructions, desync=%s\n", cpu.getInstructionCount() - start, cpu.isReplayDesynced() ? "true" : "false");
+    free(stream);
+    bool matched = hash == hashMemory() && 0 == memcmp(&z80.reg, &cpu.reg, sizeof(z80.reg)) && z80.getTotalClocks() == cpu.getTotalClocks();
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
@@ -0,0 +1,69 @@
+#include "z80rewind.hpp"
+
+static unsigned char memory[0x10000];
+
+static unsigned int hashFrame(Z80* z80)
+{
+    unsigned char state[256];
+    size_t size = z80->saveState(state, sizeof(state));
+    unsigned int hash = 2166136261U;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ state[i]) * 16777619U;
+    for (size_t i = 0; i < sizeof(memory); i++) hash = (hash ^ memory[i]) * 16777619U;
+    return hash;
+}
+
+int main()
+{
+    const unsigned char rom[] = {
+        0x21, 0x00, 0x80, // LD HL, $8000
+        0x34,             // INC (HL)
+        0x7E,             // LD A, (HL)
+        0x23,             // INC HL
+        0x77,             // LD (HL), A
+        0xC3, 0x03, 0x00, // JP $0003
+    };
+    memcpy(memory, rom, sizeof(rom));
+    Z80 z80([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) { return 0x00; },
+            [](void* arg, unsigned short port, unsigned char value) {}, &z80);
+    Z80Rewind rewind(&z80, memory, sizeof(memory), 1024 * 1024, 30, 600);
+    unsigned int hashes[300];
+    for (int i = 0; i < 300; i++) {
+        z80.execute(1000);
+        rewind.capture();
+        hashes[i] = hashFrame(&z80);
+    }
+    printf("captured: %d frames, used %d bytes (arena %d bytes, total %d bytes)\n", rewind.getFrameCount(), (int)rewind.getUsedSize(), (int)rewind.getArenaSize(), (int)rewind.getMemoryUsage());
+    const int steps[] = {0, 1, 29, 30, 31, 100};
+    for (int i = 0; i < 6; i++) {
+        int latest = rewind.getFrameCount() - 1;
+        bool result = rewind.rewind(steps[i]);
+        printf("rewind(%d): %s, frames=%d, hash %s\n", steps[i], result ? "OK" : "NG", rewind.getFrameCount(), hashFrame(&z80) == hashes[latest - steps[i]] ? "matched" : "unmatched");
+    }
+    printf("rewind(1000): %s\n", rewind.rewind(1000) ? "OK" : "NG");
+
+    puts("===== continue after the rewind =====");
+    int base = rewind.getFrameCount();
+    for (int i = base; i < base + 10; i++) {
+        z80.execute(1000);
+        rewind.capture();
+        hashes[i] = hashFrame(&z80);
+    }
+    int latest = rewind.getFrameCount() - 1;
+    bool result = rewind.rewind(5);
+    printf("rewind(5): %s, hash %s\n", result ? "OK" : "NG", hashFrame(&z80) == hashes[latest - 5] ? "matched" : "unmatched");
+
+    puts("===== small arena =====");
+    Z80Rewind small(&z80, memory, sizeof(memory), 64 * 1024, 10, 600);
+    for (int i = 0; i < 300; i++) {
+        z80.execute(1000);
+        small.capture();
+        hashes[i] = hashFrame(&z80);
+    }
+    printf("captured: %d frames, used %d bytes (arena %d bytes)\n", small.getFrameCount(), (int)small.getUsedSize(), (int)small.getArenaSize());
+    int oldest = small.getFrameCount() - 1;
+    result = small.rewind(oldest);
+    printf("rewind(%d): %s, hash %s\n", oldest, result ? "OK" : "NG", hashFrame(&z80) == hashes[299 - oldest] ? "matched" : "unmatched");
+    return 0;
+}
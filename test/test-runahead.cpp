@@ -0,0 +1,125 @@
+#include "z80runahead.hpp"
+
+struct Machine {
+    Z80* cpu;
+    unsigned char memory[0x10000];
+    unsigned char input;
+    unsigned char vdp; // the device driven by OUT
+    int timer;         // the device driven by consumeClock (IRQ per 1000Hz)
+    int outCount;
+};
+
+static Machine primary;
+static Machine speculative;
+
+static unsigned char readByte(void* arg, unsigned short addr) { return ((Machine*)arg)->memory[addr]; }
+static void writeByte(void* arg, unsigned short addr, unsigned char value) { ((Machine*)arg)->memory[addr] = value; }
+static unsigned char inPort(void* arg, unsigned short port) { return ((Machine*)arg)->input; }
+
+static void outPort(void* arg, unsigned short port, unsigned char value)
+{
+    Machine* m = (Machine*)arg;
+    m->vdp = (unsigned char)(m->vdp * 31 + value);
+    m->outCount++;
+}
+
+static void consumeClock(void* arg, int clocks)
+{
+    Machine* m = (Machine*)arg;
+    m->timer += clocks;
+    if (1000 <= m->timer) {
+        m->timer -= 1000;
+        m->cpu->generateIRQ(0xFF);
+    }
+}
+
+static unsigned int hashMachine(Machine* m)
+{
+    unsigned char state[256];
+    size_t size = m->cpu->saveState(state, sizeof(state));
+    unsigned int hash = 2166136261U;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ state[i]) * 16777619U;
+    for (size_t i = 0; i < sizeof(m->memory); i++) hash = (hash ^ m->memory[i]) * 16777619U;
+    hash = (hash ^ m->vdp) * 16777619U;
+    hash = (hash ^ (unsigned int)m->timer) * 16777619U;
+    return hash;
+}
+
+static unsigned char inputAt(int frame) { return (unsigned char)(frame / 20); }
+
+int main()
+{
+    const unsigned char rom[] = {
+        0xED, 0x56,       // $0000: IM 1
+        0xFB,             // $0002: EI
+        0xDB, 0x00,       // $0003: IN A, ($00)
+        0x2A, 0x00, 0x80, // $0005: LD HL, ($8000)
+        0x5F,             // $0008: LD E, A
+        0x16, 0x00,       // $0009: LD D, 0
+        0x19,             // $000B: ADD HL, DE
+        0x22, 0x00, 0x80, // $000C: LD ($8000), HL
+        0x3A, 0x02, 0x80, // $000F: LD A, ($8002)
+        0x85,             // $0012: ADD A, L
+        0xD3, 0x01,       // $0013: OUT ($01), A
+        0x18, 0xEC,       // $0015: JR $0003
+    };
+    const unsigned char irq[] = {
+        0xF5,             // $0038: PUSH AF
+        0x3A, 0x02, 0x80, // $0039: LD A, ($8002)
+        0x3C,             // $003C: INC A
+        0x32, 0x02, 0x80, // $003D: LD ($8002), A
+        0xF1,             // $0040: POP AF
+        0xFB,             // $0041: EI
+        0xED, 0x4D,       // $0042: RETI
+    };
+    memcpy(primary.memory, rom, sizeof(rom));
+    memcpy(&primary.memory[0x38], irq, sizeof(irq));
+    Z80 cpu(readByte, writeByte, inPort, outPort, &primary);
+    cpu.reg.SP = 0xF000;
+    cpu.setConsumeClockCallback(consumeClock);
+    Z80 ahead(cpu, false);
+    ahead.setCallbackArg(&speculative);
+    ahead.setConsumeClockCallback(consumeClock);
+    primary.cpu = &cpu;
+    speculative.cpu = &ahead;
+    const int frames = 3;
+    Z80RunAhead runAhead(&cpu, primary.memory, &ahead, speculative.memory, sizeof(primary.memory), frames, []() {
+        speculative.input = primary.input;
+        speculative.vdp = primary.vdp;
+        speculative.timer = primary.timer;
+    });
+
+    // displayed[n]: hash of the speculative machine presented at the frame n (= the primary machine at the frame n + frames)
+    static unsigned int displayed[200];
+    int verified = 0;
+    int mismatched = 0;
+    for (int frame = 0; frame < 200; frame++) {
+        unsigned char input = inputAt(frame);
+        bool inputChanged = 0 == frame || input != inputAt(frame - 1);
+        primary.input = input;
+        speculative.input = input;
+        runAhead.run([](Z80* z80) { z80->execute(10000); }, inputChanged);
+        displayed[frame] = hashMachine(&speculative);
+        // the prediction is correct if the input was not changed in the speculative frames
+        int predicted = frame - frames;
+        if (0 <= predicted && inputAt(predicted) == input) {
+            verified++;
+            if (displayed[predicted] != hashMachine(&primary)) mismatched++;
+        }
+    }
+    printf("displayed: %llu frames, emulated: %llu frames, rollbacks: %llu\n", runAhead.getDisplayedFrames(), runAhead.getEmulatedFrames(), runAhead.getRollbacks());
+    printf("out: primary=%d, speculative=%d\n", primary.outCount, speculative.outCount);
+    printf("irq: primary=%d, speculative=%d\n", primary.memory[0x8002], speculative.memory[0x8002]);
+    printf("verified: %d frames, mismatched: %d frames\n", verified, mismatched);
+    bool matched = 0 < verified && 0 == mismatched && 0 < speculative.outCount && 0 < primary.outCount && 0 < primary.memory[0x8002];
+
+    // the out and consumeClock callbacks are suppressed only if requested
+    int outCount = speculative.outCount;
+    int timer = speculative.timer;
+    ahead.setSpeculative(true, Z80::speculativeOut | Z80::speculativeClock);
+    ahead.execute(10000);
+    printf("suppressed: out=%d, timer=%d\n", speculative.outCount - outCount, speculative.timer - timer);
+    matched &= outCount == speculative.outCount && timer == speculative.timer;
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
@@ -0,0 +1,58 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+
+static void printRegisters(Z80* z80)
+{
+    printf("PC=$%04X SP=$%04X AF=$%02X%02X BC=$%02X%02X HL=$%02X%02X R=$%02X IFF=$%02X clocks=%llu\n",
+           z80->reg.PC, z80->reg.SP, z80->reg.pair.A, z80->reg.pair.F, z80->reg.pair.B, z80->reg.pair.C,
+           z80->reg.pair.H, z80->reg.pair.L, z80->reg.R, z80->reg.IFF, z80->getTotalClocks());
+}
+
+int main()
+{
+    const unsigned char rom[] = {
+        0x21, 0x00, 0x80, // LD HL, $8000
+        0x06, 0x10,       // LD B, $10
+        0x78,             // LD A, B
+        0x77,             // LD (HL), A
+        0x23,             // INC HL
+        0x10, 0xFB,       // DJNZ $0005
+        0x76,             // HALT
+    };
+    memcpy(memory, rom, sizeof(rom));
+    Z80 z80([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) { return 0x00; },
+            [](void* arg, unsigned short port, unsigned char value) {}, &z80);
+    z80.wtc.fetch = 1;
+    z80.execute(100);
+    unsigned char state[256];
+    size_t size = z80.saveState(state, sizeof(state));
+    printf("saveState: %d bytes (state size = %d)\n", (int)size, (int)z80.getStateSize());
+    printf("header:");
+    for (int i = 0; i < 8; i++) printf(" %02X", state[i]);
+    printf("\n");
+    printRegisters(&z80);
+    z80.execute(100);
+    puts("===== continue =====");
+    printRegisters(&z80);
+
+    puts("===== load to the other instance =====");
+    Z80 other([](void* arg, unsigned short addr) { return memory[addr]; },
+              [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+              [](void* arg, unsigned short port) { return 0x00; },
+              [](void* arg, unsigned short port, unsigned char value) {}, &other);
+    printf("loadState: %s\n", other.loadState(state, size) ? "OK" : "NG");
+    printRegisters(&other);
+    other.execute(100);
+    puts("===== continue =====");
+    printRegisters(&other);
+
+    puts("===== invalid state =====");
+    printf("saveState (small buffer): %d bytes\n", (int)z80.saveState(state, 16));
+    printf("loadState (short): %s\n", z80.loadState(state, size - 1) ? "OK" : "NG");
+    state[0] ^= 0xFF;
+    printf("loadState (broken magic): %s\n", z80.loadState(state, size) ? "OK" : "NG");
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "z80.hpp"
+#include <atomic>
+#include <thread>
+
+static unsigned char memory[0x10000];
+
+int main()
+{
+    const unsigned char rom[] = {
+        0xED, 0x56,       // IM 1
+        0xFB,             // EI
+        0x00,             // NOP
+        0x18, 0xFD,       // JR -3
+    };
+    const unsigned char isr[] = {
+        0x2A, 0x00, 0x80, // LD HL, ($8000)
+        0x23,             // INC HL
+        0x22, 0x00, 0x80, // LD ($8000), HL
+        0xFB,             // EI
+        0xED, 0x4D,       // RETI
+    };
+    const unsigned char nmi[] = {
+        0x2A, 0x02, 0x80, // LD HL, ($8002)
+        0x23,             // INC HL
+        0x22, 0x02, 0x80, // LD ($8002), HL
+        0xED, 0x45,       // RETN
+    };
+    memcpy(memory, rom, sizeof(rom));
+    memcpy(&memory[0x38], isr, sizeof(isr));
+    memcpy(&memory[0x66], nmi, sizeof(nmi));
+    Z80 z80([](void* arg, unsigned short addr) { return memory[addr]; },
+            [](void* arg, unsigned short addr, unsigned char value) { memory[addr] = value; },
+            [](void* arg, unsigned short port) { return 0x00; },
+            [](void* arg, unsigned short port, unsigned char value) {}, &z80);
+
+    // generateIRQ, cancelIRQ and generateNMI are applied at once on the CPU thread
+    z80.generateIRQ(0x12);
+    bool sync = (z80.reg.interrupt & 0b01000000) && 0x12 == z80.reg.interruptVector;
+    z80.cancelIRQ();
+    sync &= 0 == (z80.reg.interrupt & 0b01000000);
+    z80.generateNMI(0x0066);
+    sync &= (z80.reg.interrupt & 0b10000000) && 0x0066 == z80.reg.interruptAddrN;
+    z80.reg.interrupt &= 0b01111111;
+    printf("sync: %s\n", sync ? "ok" : "ng");
+
+    // the interrupts and the break are posted from the other thread
+    static std::atomic<bool> started(false);
+    std::thread host([&z80]() {
+        while (!started) std::this_thread::yield();
+        for (int i = 0; i < 1000; i++) {
+            z80.postIRQ(0xFF);
+            if (0 == i % 10) z80.postNMI(0x0066);
+            std::this_thread::yield();
+        }
+        z80.requestBreak();
+    });
+    z80.setConsumeClockCallback([](void* arg, int clocks) { started = true; });
+    z80.execute(); // execute until requestBreak
+    host.join();
+    int irq = memory[0x8000] + memory[0x8001] * 256;
+    int nmiCount = memory[0x8002] + memory[0x8003] * 256;
+    printf("break: ok\n");
+    printf("IRQ: %s\n", 0 < irq && irq <= 1000 ? "ok" : "ng");
+    printf("NMI: %s\n", 0 < nmiCount && nmiCount <= 100 ? "ok" : "ng");
+    bool matched = sync && 0 < irq && irq <= 1000 && 0 < nmiCount && nmiCount <= 100;
+    printf("%s\n", matched ? "matched" : "unmatched");
+    return matched ? 0 : -1;
+}
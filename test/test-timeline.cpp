@@ -0,0 +1,80 @@
+#include "z80timeline.hpp"
+#include <string>
+
+static unsigned char memory[0x10000];
+
+static int count(const std::string& text, const char* word)
+{
+    int n = 0;
+    for (size_t pos = text.find(word); std::string::npos != pos; pos = text.find(word, pos + 1)) n++;
+    return n;
+}
+
+int main()
+{
+    const unsigned char program[] = {
+        0xED, 0x56, // $0000: IM 1
+        0xFB,       // $0002: EI
+        0x76,       // $0003: HALT
+        0x18, 0xFD, // $0004: JR $0003
+    };
+    const unsigned char irq[] = {
+        0xD3, 0x01, // $0038: OUT ($01), A
+        0xFB,       // $003A: EI
+        0xED, 0x4D, // $003B: RETI
+    };
+    const unsigned char nmi[] = {
+        0xED, 0x45, // $0066: RETN
+    };
+    memcpy(&memory[0x0000], program, sizeof(program));
+    memcpy(&memory[0x0038], irq, sizeof(irq));
+    memcpy(&memory[0x0066], nmi, sizeof(nmi));
+    Z80 z80([](void* arg, unsigned short addr) {
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+        ((Z80*)arg)->beginTimelineSpan("vdp \"write\"");
+        ((Z80*)arg)->endTimelineSpan("vdp \"write\"");
+    }, &z80);
+    z80.addBreakPoint(0x0066, [](void* arg) {});
+
+    FILE* fp = tmpfile();
+    z80.enableTimeline(256);
+    {
+        Z80TimelineWriter writer(&z80, fp, 4000000.0);
+        for (int frame = 0; frame < 3; frame++) {
+            z80.markTimeline("frame");
+            z80.execute(100);
+            z80.generateIRQ(0xFF);
+        }
+        z80.generateNMI(0x0066);
+        z80.execute(100);
+    }
+    printf("lost: %llu\n", z80.getTimelineLost());
+
+    std::string json;
+    rewind(fp);
+    char buf[256];
+    while (fgets(buf, sizeof(buf), fp)) json += buf;
+    fclose(fp);
+    fputs(json.c_str(), stdout);
+
+    int executeBegin = count(json, "\"name\":\"execute\",\"ph\":\"B\"");
+    int executeEnd = count(json, "\"name\":\"execute\",\"ph\":\"E\"");
+    int haltBegin = count(json, "\"name\":\"HALT\",\"ph\":\"B\"");
+    int haltEnd = count(json, "\"name\":\"HALT\",\"ph\":\"E\"");
+    printf("execute: %d/%d, HALT: %d/%d, IM1: %d, NMI: %d, break point: %d, vdp: %d, frame: %d\n",
+           executeBegin, executeEnd, haltBegin, haltEnd, count(json, "\"IM1\""), count(json, "\"NMI\""),
+           count(json, "\"break point\""), count(json, "vdp \\\"write\\\""), count(json, "\"frame\""));
+    if (4 != executeBegin || 4 != executeEnd || 4 != haltBegin || 3 != haltEnd || 3 != count(json, "\"IM1\"") ||
+        1 != count(json, "\"NMI\"") || 1 != count(json, "\"break point\"") || 6 != count(json, "vdp \\\"write\\\"") ||
+        3 != count(json, "\"frame\"") || 0 != z80.getTimelineLost()) {
+        puts("unmatched");
+        return -1;
+    }
+    puts("matched");
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "z80.hpp"
+
+static unsigned char memory[0x10000];
+static int reads;
+
+int main()
+{
+    const unsigned char program[] = {
+        0x06, 0x02,             // LD B, 2
+        0x3E, 0x12,             // LD A, $12
+        0xDD, 0x21, 0x00, 0x80, // LD IX, $8000
+        0xDD, 0x36, 0xFE, 0x34, // LD (IX-$02), $34
+        0xDD, 0xCB, 0x05, 0xC6, // SET 0, (IX+$05)
+        0xED, 0x43, 0x00, 0x90, // LD ($9000), BC
+        0xCB, 0x27,             // SLA A
+        0x10, 0xEA,             // DJNZ $0002
+        0x76,                   // HALT
+    };
+    memcpy(memory, program, sizeof(program));
+    Z80 z80([](void* arg, unsigned short addr) {
+        reads++;
+        return memory[addr];
+    }, [](void* arg, unsigned short addr, unsigned char value) {
+        memory[addr] = value;
+    }, [](void* arg, unsigned short port) {
+        return (unsigned char)0x00;
+    }, [](void* arg, unsigned short port, unsigned char value) {
+    }, &z80);
+    z80.addBreakPoint(0x0018, [](void* arg) { ((Z80*)arg)->requestBreak(); });
+
+    // ring buffer
+    z80.enableTrace(8);
+    z80.execute(10000);
+    printf("count=%d, lost=%llu, instructions=%llu\n", z80.getTraceCount(), z80.getTraceLost(), z80.getInstructionCount());
+    Z80::TraceRecord records[8];
+    int n = z80.drainTrace(records, 8);
+    char buf[256];
+    for (int i = 0; i < n; i++) {
+        Z80::formatTraceRecord(records[i], buf, sizeof(buf));
+        puts(buf);
+    }
+    if (8 != n || 8 != z80.getTraceLost() || 0 != z80.getTraceCount() || 0x0018 != records[7].pc || 0x76 != records[7].opcode[0]) {
+        puts("unmatched");
+        return -1;
+    }
+
+    // stream to the file and format it offline
+    FILE* fp = tmpfile();
+    z80.reg.PC = 0;
+    z80.reg.IFF = 0;
+    z80.enableTrace(4, fp);
+    unsigned long long start = z80.getInstructionCount();
+    z80.execute(10000);
+    z80.disableTrace();
+    unsigned long long executed = z80.getInstructionCount() - start;
+    rewind(fp);
+    int total = 0;
+    while (0 < (n = (int)fread(records, sizeof(Z80::TraceRecord), 8, fp))) {
+        for (int i = 0; i < n; i++) {
+            Z80::formatTraceRecord(records[i], buf, sizeof(buf));
+            if (total < 4) puts(buf);
+            total++;
+        }
+    }
+    fclose(fp);
+    printf("streamed=%d, executed=%llu\n", total, executed);
+    if ((unsigned long long)total != executed) {
+        puts("unmatched");
+        return -1;
+    }
+
+    // the opcode bytes are captured from the fetches (the trace does not read the memory)
+    int counts[2];
+    for (int i = 0; i < 2; i++) {
+        z80.reg.PC = 0;
+        z80.reg.IFF = 0;
+        if (i) z80.enableTrace(64);
+        reads = 0;
+        z80.execute(10000);
+        counts[i] = reads;
+    }
+    z80.disableTrace();
+    printf("reads: %d (trace off), %d (trace on)\n", counts[0], counts[1]);
+    if (counts[0] != counts[1]) {
+        puts("unmatched");
+        return -1;
+    }
+    puts("matched");
+    return 0;
+}
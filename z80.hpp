@@ -26,14 +26,14 @@
  */
 #ifndef INCLUDE_Z80_HPP
 #define INCLUDE_Z80_HPP
+#include <ctype.h>
 #include <limits.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#if !defined(Z80_DISABLE_BREAKPOINT) || !defined(Z80_DISABLE_NESTCHECK)
-#include <map>
+#if !defined(Z80_DISABLE_BREAKPOINT) || !defined(Z80_DISABLE_NESTCHECK) || !defined(Z80_DISABLE_RECORD)
 #include <vector>
 #endif
 
@@ -45,6 +45,19 @@
 #include <stdexcept>
 #endif
 
+#ifndef Z80_NO_ATOMIC
+#include <atomic>
+#endif
+
+// the paths of the optional features are not inlined into the opcode handlers and the execute loops
+#if defined(__GNUC__)
+#define Z80_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define Z80_NOINLINE __declspec(noinline)
+#else
+#define Z80_NOINLINE
+#endif
+
 class Z80
 {
   public: // Interface data types
@@ -86,6 +99,114 @@ class Z80
         unsigned char reserved8[2];
     } reg;
 
+    enum class BusType : unsigned char {
+        Fetch = 0,       // opcode fetch (M1)
+        Read = 1,        // memory read
+        Write = 2,       // memory write
+        In = 3,          // I/O read
+        Out = 4,         // I/O write
+        Acknowledge = 5, // interrupt acknowledge (IRQ)
+    };
+
+    struct BusEvent {
+        unsigned long long clock; // total clocks at the bus cycle
+        unsigned short addr;      // memory address or port number
+        unsigned short pc;        // address of the instruction
+        BusType type;
+        unsigned char value;
+    };
+
+    enum class TimelineType : unsigned char {
+        ExecuteBegin = 0, // start of execute
+        ExecuteEnd = 1,   // end of execute
+        NMI = 2,          // NMI accepted (addr: interrupted PC)
+        IRQ = 3,          // IRQ accepted (addr: interrupted PC, value: interrupt mode)
+        HaltBegin = 4,    // HALT executed
+        HaltEnd = 5,      // HALT released by the interrupt
+        BreakPoint = 6,   // break point hit
+        SpanBegin = 7,    // user-defined span (beginTimelineSpan)
+        SpanEnd = 8,      // user-defined span (endTimelineSpan)
+        Instant = 9,      // user-defined instant event (markTimeline)
+    };
+
+    struct TimelineEvent {
+        unsigned long long clock; // total clocks at the event
+        const char* name;         // name of the user-defined event (nullptr: built-in event)
+        unsigned short addr;      // PC at the event
+        TimelineType type;
+        unsigned char value;
+    };
+
+    struct TraceRecord {
+        unsigned long long clock;  // total clocks at the start of the instruction
+        unsigned short pc;         // address of the instruction
+        unsigned short af;         // registers before the instruction
+        unsigned short bc;
+        unsigned short de;
+        unsigned short hl;
+        unsigned short ix;
+        unsigned short iy;
+        unsigned short sp;
+        unsigned char opcode[4];   // the fetched bytes of the instruction (the rest is 0)
+    };
+
+    // kinds of the operands of the instruction (DebugEvent::operands)
+    static const unsigned char operandN = 0b0001;  // immediate is n
+    static const unsigned char operandNN = 0b0010; // immediate is nn
+    static const unsigned char operandD = 0b0100;  // displacement is d of (IX+d) or (IY+d)
+    static const unsigned char operandE = 0b1000;  // displacement is e of the relative jump
+
+    struct DebugEvent {
+        unsigned long long clock;  // total clocks at the start of the instruction
+        int clocks;                // clocks (T-states) consumed by the instruction
+        unsigned short pc;         // address of the instruction
+        int prefix;                // mnemonic ID: 0x00 (no prefix), 0xCB, 0xED, 0xDD, 0xFD, 0xDDCB or 0xFDCB
+        unsigned char opcode;      // mnemonic ID: opcode in the table of the prefix (see getOpcodeMnemonic)
+        unsigned char length;      // length of the instruction
+        unsigned char bytes[4];    // instruction bytes (the fetched bytes, the rest is 0)
+        unsigned char operands;    // kinds of the operands: operandN, operandNN, operandD and/or operandE (0: none)
+        unsigned short immediate;  // value of n or nn (valid if operands has operandN or operandNN)
+        signed char displacement;  // value of d or e (valid if operands has operandD or operandE)
+        Register before;           // registers before the instruction
+        Register after;            // registers after the instruction
+    };
+
+    struct ProfileEntry {
+        unsigned short addr;       // start address of the instruction
+        unsigned long long count;  // number of the executions
+        unsigned long long clocks; // total clocks (T-states) consumed by the instruction
+    };
+
+    struct OpcodeEntry {
+        int prefix;                // 0x00 (no prefix), 0xCB, 0xED, 0xDD, 0xFD, 0xDDCB or 0xFDCB
+        unsigned char opcode;      // opcode in the table of the prefix
+        unsigned long long count;  // number of the executions
+        unsigned long long clocks; // total clocks (T-states) of the instructions
+        char mnemonic[24];
+    };
+
+    enum class CoverageMap : unsigned char {
+        Executed = 0,       // start addresses of the executed instructions
+        BranchTaken = 1,    // addresses of the conditional branches that were taken
+        BranchNotTaken = 2, // addresses of the conditional branches that were not taken
+    };
+
+    struct CallGraphEntry {
+        unsigned short addr;          // callee address
+        unsigned long long calls;     // number of the calls
+        unsigned long long inclusive; // clocks (T-states) including the callees
+        unsigned long long exclusive; // clocks (T-states) excluding the callees
+    };
+
+    enum class CommandType : unsigned char {
+        IRQ = 0,   // generateIRQ(value)
+        NMI = 1,   // generateNMI(addr)
+        CancelIRQ, // cancelIRQ()
+        Break,     // requestBreak() (pause the execute)
+        Out,       // call the out callback (port: addr)
+        Write,     // call the write callback
+    };
+
     inline unsigned char flagS() { return 0b10000000; }
     inline unsigned char flagZ() { return 0b01000000; }
     inline unsigned char flagY() { return 0b00100000; }
@@ -96,6 +217,70 @@ class Z80
     inline unsigned char flagC() { return 0b00000001; }
 
     inline unsigned char readByte(unsigned short addr, int clock = 4)
+    {
+        return readMemory(addr, clock, BusType::Read);
+    }
+
+    inline unsigned char readMemory(unsigned short addr, int clock, BusType busType)
+    {
+        if (busHooked) return readMemoryWithHooks(addr, clock, busType);
+        return readMemoryDirect(addr, clock);
+    }
+
+    inline void writeByte(unsigned short addr, unsigned char value, int clock = 4)
+    {
+        if (busHooked) {
+            writeMemoryWithHooks(addr, value, clock);
+            return;
+        }
+        consumeClock(wtc.write);
+        CB.write(CB.arg, addr, value);
+        consumeClock(clock);
+    }
+
+    inline unsigned char readCode(unsigned short addr, int clock, BusType busType = BusType::Read)
+    {
+        if (codeHooked) return readCodeWithHooks(addr, clock, busType);
+        return readMemoryDirect(addr, clock);
+    }
+
+    inline unsigned char readOpcode(unsigned short addr, int clock)
+    {
+        return readCode(addr, clock, BusType::Fetch);
+    }
+
+  private: // Internal functions & variables
+    bool busHooked = false;  // the memory accesses have the hooks (see updateBusHooked)
+    bool codeHooked = false; // the code fetches have the hooks (see updateBusHooked)
+
+    // set the flags if any feature hooks the bus accesses (the accesses without the hooks take the direct path)
+    //   busHooked: contention, bus log or disassemble cache
+    //   codeHooked: busHooked, fetch callback, code pages or the capture of the fetched bytes (trace or debug event)
+    void updateBusHooked()
+    {
+        busHooked = false;
+#ifndef Z80_DISABLE_CONTENTION
+        if (contention.table) busHooked = true;
+#endif
+#ifndef Z80_DISABLE_BUSLOG
+        if (busLog.events) busHooked = true;
+#endif
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        if (decodeCache.entries) busHooked = true;
+#endif
+        codeHooked = busHooked || CB.fetchEnabled;
+        for (int i = 0; CB.hooks && i < 256; i++) {
+            if (CB.hooks->codePages[i]) codeHooked = true;
+        }
+#ifndef Z80_DISABLE_TRACE
+        if (trace.records) codeHooked = true;
+#endif
+#ifndef Z80_DISABLE_DEBUG
+        if (CB.debugEventEnabled) codeHooked = true;
+#endif
+    }
+
+    inline unsigned char readMemoryDirect(unsigned short addr, int clock)
     {
 #ifndef Z80_DISABLE_BREAKPOINT
         if (clock && wtc.read) consumeClock(wtc.read);
@@ -109,14 +294,73 @@ class Z80
         return byte;
     }
 
-    inline void writeByte(unsigned short addr, unsigned char value, int clock = 4)
+    Z80_NOINLINE unsigned char readMemoryWithHooks(unsigned short addr, int clock, BusType busType)
+    {
+#ifndef Z80_DISABLE_BREAKPOINT
+        if (clock && wtc.read) consumeClock(wtc.read);
+#ifndef Z80_DISABLE_CONTENTION
+        if (clock) contendMemory(addr);
+#endif
+        unsigned char byte = CB.read(CB.arg, addr);
+#ifndef Z80_DISABLE_BUSLOG
+        if (clock) logBus(busType, addr, byte);
+#endif
+        if (clock) consumeClock(clock);
+#else
+        consumeClock(wtc.read);
+#ifndef Z80_DISABLE_CONTENTION
+        contendMemory(addr);
+#endif
+        unsigned char byte = CB.read(CB.arg, addr);
+#ifndef Z80_DISABLE_BUSLOG
+        logBus(busType, addr, byte);
+#endif
+        consumeClock(clock);
+#endif
+        return byte;
+    }
+
+    Z80_NOINLINE void writeMemoryWithHooks(unsigned short addr, unsigned char value, int clock)
     {
         consumeClock(wtc.write);
+#ifndef Z80_DISABLE_CONTENTION
+        contendMemory(addr);
+#endif
         CB.write(CB.arg, addr, value);
+#ifndef Z80_DISABLE_BUSLOG
+        logBus(BusType::Write, addr, value);
+#endif
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        if (decodeCache.entries) invalidateDecodeCache(addr);
+#endif
         consumeClock(clock);
     }
 
-  private: // Internal functions & variables
+    // the fetch callback is called for M1, and the code pages mapped by mapCodePages are read directly
+    Z80_NOINLINE unsigned char readCodeWithHooks(unsigned short addr, int clock, BusType busType)
+    {
+        unsigned char* page = CB.hooks ? CB.hooks->codePages[addr >> 8] : nullptr;
+        bool fetchCallback = BusType::Fetch == busType && CB.fetchEnabled;
+        unsigned char byte;
+        if (!page && !fetchCallback) {
+            byte = readMemoryWithHooks(addr, clock, busType);
+        } else {
+            if (wtc.read) consumeClock(wtc.read);
+#ifndef Z80_DISABLE_CONTENTION
+            contendMemory(addr);
+#endif
+            byte = fetchCallback ? CB.fetch(CB.arg, addr) : page[addr & 0xFF];
+#ifndef Z80_DISABLE_BUSLOG
+            logBus(busType, addr, byte);
+#endif
+            consumeClock(clock);
+        }
+#if !defined(Z80_DISABLE_TRACE) || !defined(Z80_DISABLE_DEBUG)
+        if (fetched.count < 4) fetched.bytes[fetched.count++] = byte; // the code is read only by fetchM1 and fetch
+#endif
+        return byte;
+    }
+
     // bit table
     const unsigned char bits[8] = {0b00000001, 0b00000010, 0b00000100, 0b00001000, 0b00010000, 0b00100000, 0b01000000, 0b10000000};
     // flag setter
@@ -187,6 +431,10 @@ class Z80
     {
       public:
         unsigned short addr;
+        int id;                               // returned by addBreakPoint to remove it
+        std::vector<unsigned char> condition; // compiled condition (empty: always true)
+        unsigned long long hitCount;          // number of times the condition was true
+        unsigned long long ignoreCount;       // number of hits to skip the callback
 #ifdef Z80_NO_FUNCTIONAL
         void (*callback)(void*);
         BreakPoint(unsigned short addr_, void (*callback_)(void*))
@@ -196,10 +444,30 @@ class Z80
 #endif
         {
             this->addr = addr_;
+            this->id = 0;
             this->callback = callback_;
+            this->hitCount = 0;
+            this->ignoreCount = 0;
         }
     };
 
+    // instructions of the compiled break point condition (stack machine)
+    enum class ConditionCode : unsigned char {
+        Register = 0,  // push the register (operand: index of getConditionRegisterName)
+        Immediate = 1, // push the 16-bit immediate (operand: low, high)
+        Memory = 2,    // pop the address and push the byte at the address
+        Add = 3,       // pop 2 values and push the 16-bit sum
+        Sub = 4,       // pop 2 values and push the 16-bit difference
+        Equal = 5,     // pop 2 values and push the comparison result (0 or 1)
+        NotEqual = 6,
+        Less = 7,
+        LessEqual = 8,
+        Greater = 9,
+        GreaterEqual = 10,
+        And = 11, // pop 2 values and push the logical result (0 or 1)
+        Or = 12,
+    };
+
     class BreakOperand
     {
       public:
@@ -241,8 +509,97 @@ class Z80
         }
     };
 
+    struct CallGraphNode {
+        unsigned short addr; // callee address
+        int parent;          // index of the caller node (-1: root)
+        int firstChild;      // index of the first callee node (-1: none)
+        int nextSibling;     // index of the next callee node of the parent (-1: none)
+        unsigned long long calls;
+        unsigned long long inclusive; // clocks of the finished calls including the callees
+        unsigned long long exclusive; // clocks of the finished calls excluding the callees
+    };
+
+    struct CallGraphFrame {
+        int node;
+        unsigned short sp;           // SP after pushing the return address
+        unsigned long long start;    // total clocks at the call
+        unsigned long long children; // inclusive clocks of the finished callees
+    };
+
+    struct CallGraph {
+        bool enabled = false;
+        std::vector<CallGraphNode> nodes;   // call tree (nodes[0]: root)
+        std::vector<CallGraphFrame> frames; // shadow call stack (frames[0]: root)
+    } callGraph;
+
+    inline void pushCallFrame()
+    {
+        // the frames at or below the new return address were abandoned (e.g. POP-ed return address and JP (HL))
+        while (1 < callGraph.frames.size() && callGraph.frames.back().sp <= reg.SP) popCallFrame();
+        int parent = callGraph.frames.back().node;
+        int node = callGraph.nodes[(size_t)parent].firstChild;
+        while (-1 != node && callGraph.nodes[(size_t)node].addr != reg.PC) node = callGraph.nodes[(size_t)node].nextSibling;
+        if (-1 == node) {
+            CallGraphNode child;
+            child.addr = reg.PC;
+            child.parent = parent;
+            child.firstChild = -1;
+            child.nextSibling = callGraph.nodes[(size_t)parent].firstChild;
+            child.calls = 0;
+            child.inclusive = 0;
+            child.exclusive = 0;
+            node = (int)callGraph.nodes.size();
+            callGraph.nodes.push_back(child);
+            callGraph.nodes[(size_t)parent].firstChild = node;
+        }
+        callGraph.nodes[(size_t)node].calls++;
+        CallGraphFrame frame;
+        frame.node = node;
+        frame.sp = reg.SP;
+        frame.start = getTotalClocks();
+        frame.children = 0;
+        callGraph.frames.push_back(frame);
+    }
+
+    inline void popCallFrame()
+    {
+        CallGraphFrame frame = callGraph.frames.back();
+        callGraph.frames.pop_back();
+        unsigned long long inclusive = getTotalClocks() - frame.start;
+        callGraph.nodes[(size_t)frame.node].inclusive += inclusive;
+        callGraph.nodes[(size_t)frame.node].exclusive += inclusive - frame.children;
+        callGraph.frames.back().children += inclusive;
+    }
+
+    inline void returnCallFrame()
+    {
+        while (1 < callGraph.frames.size() && callGraph.frames.back().sp < reg.SP) popCallFrame();
+        // ignore RET that does not return to a tracked caller (e.g. PUSH HL and RET as the jump)
+        if (1 < callGraph.frames.size() && callGraph.frames.back().sp == reg.SP) popCallFrame();
+    }
+
+    // inclusive and exclusive clocks per node including the unfinished calls
+    void getCallGraphClocks(std::vector<unsigned long long>& inclusive, std::vector<unsigned long long>& exclusive)
+    {
+        inclusive.clear();
+        exclusive.clear();
+        for (auto& node : callGraph.nodes) {
+            inclusive.push_back(node.inclusive);
+            exclusive.push_back(node.exclusive);
+        }
+        unsigned long long child = 0;
+        for (size_t i = callGraph.frames.size(); 0 < i; i--) {
+            auto& frame = callGraph.frames[i - 1];
+            unsigned long long running = getTotalClocks() - frame.start;
+            inclusive[(size_t)frame.node] += running;
+            exclusive[(size_t)frame.node] += running - frame.children - child;
+            child = running;
+        }
+    }
+
     inline void invokeReturnHandlers()
     {
+        if (callGraph.enabled) returnCallFrame();
         for (auto handler : this->CB.returnHandlers) {
             handler->callback(this->CB.arg);
         }
@@ -250,12 +607,23 @@ class Z80
 
     inline void invokeCallHandlers()
     {
+        if (callGraph.enabled) pushCallFrame();
         for (auto handler : this->CB.callHandlers) {
             handler->callback(this->CB.arg);
         }
     }
 #endif
 
+    // the tables of the code pages, the break points and the break operands (allocated on the first use)
+    struct HookTables {
+        unsigned char* codePages[256] = {}; // direct pointers to 256 bytes code pages (nullptr: read via the read callback)
+#ifndef Z80_DISABLE_BREAKPOINT
+        unsigned int breakPointBitmap[0x10000 / 32] = {}; // 1 bit per address (set: the address has break points)
+        std::vector<BreakPoint*>* breakPointPages[256] = {}; // 256 break point lists per page (nullptr: no break points in the page)
+        std::vector<BreakOperand*>* breakOperands[7][256] = {}; // per-prefix tables of the break operand lists (nullptr: no break operands)
+#endif
+    };
+
     struct Callback {
 #ifdef Z80_NO_FUNCTIONAL
         unsigned char (*read)(void*, unsigned short);
@@ -263,13 +631,20 @@ class Z80
         unsigned char (*in)(void*, unsigned short);
         void (*out)(void*, unsigned short, unsigned char);
         void (*consumeClock)(void*, int);
+        unsigned char (*fetch)(void*, unsigned short);
+        unsigned char (*peek)(void*, unsigned short);
 #else
         std::function<unsigned char(void*, unsigned short)> read;
         std::function<void(void*, unsigned short, unsigned char)> write;
         std::function<unsigned char(void*, unsigned short)> in;
         std::function<void(void*, unsigned short, unsigned char)> out;
         std::function<void(void*, int)> consumeClock;
+        std::function<unsigned char(void*, unsigned short)> fetch;
+        std::function<unsigned char(void*, unsigned short)> peek;
 #endif
+        bool fetchEnabled = false;
+        bool peekEnabled;
+        HookTables* hooks = nullptr; // nullptr: no code pages, no break points and no break operands
 
 #ifndef Z80_UNSUPPORT_16BIT_PORT
         bool returnPortAs16Bits;
@@ -282,11 +657,16 @@ class Z80
         std::function<void(void*, const char*)> debugMessage;
 #endif
         bool debugMessageEnabled;
+#ifdef Z80_NO_FUNCTIONAL
+        void (*debugEvent)(void*, const DebugEvent*);
+#else
+        std::function<void(void*, const DebugEvent*)> debugEvent;
+#endif
+        bool debugEventEnabled = false;
 #endif
 
 #ifndef Z80_DISABLE_BREAKPOINT
-        std::map<int, std::vector<BreakPoint*>*> breakPoints;
-        std::map<int, std::vector<BreakOperand*>*> breakOperands;
+        int breakPointId = 0; // the last id of the break points
 #endif
 #ifndef Z80_DISABLE_NESTCHECK
         std::vector<SimpleHandler*> returnHandlers;
@@ -296,5401 +676,6459 @@ class Z80
         void* arg;
     } CB;
 
-    bool requestBreakFlag;
-
-#ifndef Z80_DISABLE_BREAKPOINT
-    inline void checkBreakPoint()
+    HookTables* getHooks()
     {
-        auto it = CB.breakPoints.find(reg.PC);
-        if (it == CB.breakPoints.end()) return;
-        for (auto bp : *CB.breakPoints[reg.PC]) {
-            bp->callback(CB.arg);
-        }
+        if (!CB.hooks) CB.hooks = new HookTables();
+        return CB.hooks;
     }
 
-    inline void readFullOpcode(BreakOperand* operand, unsigned char* opcode, int* opcodeLength)
+    // map the same code pages as the source tables (the tables are allocated only if any page is mapped)
+    void copyCodePages(const HookTables* srcHooks)
     {
-        *opcodeLength = 0;
-        switch (operand->prefixNumber) {
-            case 0x00:
-                opcode[0] = operand->operandNumber;
-                *opcodeLength = opLength1[opcode[0]];
-                for (int i = 1; i < *opcodeLength; i++) {
-                    opcode[i] = readByte(reg.PC + i - 1, 0); // read without consume clocks
-                }
-                break;
-            case 0xCB:
-                opcode[0] = 0xCB;
-                opcode[1] = operand->operandNumber;
-                *opcodeLength = 2;
-                break;
-            case 0xED:
-                opcode[0] = 0xED;
-                opcode[1] = operand->operandNumber;
-                *opcodeLength = opLengthED[opcode[1]];
-                for (int i = 2; i < *opcodeLength; i++) {
-                    opcode[i] = readByte(reg.PC + i - 2, 0); // read without consume clocks
-                }
-                break;
-            case 0xDD:
-                opcode[0] = 0xDD;
-                opcode[1] = operand->operandNumber;
-                *opcodeLength = opLengthIXY[opcode[1]];
-                for (int i = 2; i < *opcodeLength; i++) {
-                    opcode[i] = readByte(reg.PC + i - 2, 0); // read without consume clocks
-                }
-                break;
-            case 0xFD:
-                opcode[0] = 0xFD;
-                opcode[1] = operand->operandNumber;
-                *opcodeLength = opLengthIXY[opcode[1]];
-                for (int i = 2; i < *opcodeLength; i++) {
-                    opcode[i] = readByte(reg.PC + i - 2, 0); // read without consume clocks
-                }
-                break;
-            case 0xDDCB:
-                opcode[0] = 0xDD;
-                opcode[1] = 0xCB;
-                opcode[2] = operand->operandNumber;
-                opcode[3] = readByte(reg.PC, 0);
-                *opcodeLength = 4;
-                break;
-            case 0xFDCB:
-                opcode[0] = 0xFD;
-                opcode[1] = 0xCB;
-                opcode[2] = operand->operandNumber;
-                opcode[3] = readByte(reg.PC, 0);
-                *opcodeLength = 4;
-                break;
+        for (int i = 0; srcHooks && i < 256; i++) {
+            if (srcHooks->codePages[i]) getHooks()->codePages[i] = srcHooks->codePages[i];
         }
     }
 
-    inline void checkBreakOperand(int operandNumber)
+    // signals from the host (may be the other threads) folded at the instruction boundary
+    struct Signals {
+#ifdef Z80_NO_ATOMIC
+        unsigned int pending;
+        unsigned char vector;
+        unsigned short addrN;
+#else
+        std::atomic<unsigned int> pending;
+        std::atomic<unsigned char> vector;
+        std::atomic<unsigned short> addrN;
+#endif
+    } signals;
+
+    static const unsigned int signalBreak = 0b0001;
+    static const unsigned int signalIRQ = 0b0010;
+    static const unsigned int signalNMI = 0b0100;
+    static const unsigned int signalCancelIRQ = 0b1000;
+
+    inline unsigned int getSignals()
     {
-        if (CB.breakOperands.empty()) return;
-        auto it = CB.breakOperands.find(operandNumber);
-        if (it == CB.breakOperands.end()) return;
-        unsigned char opcode[16];
-        int opcodeLength = 16;
-        bool first = true;
-        for (auto bo : *CB.breakOperands[operandNumber]) {
-            if (first) {
-                readFullOpcode(bo, opcode, &opcodeLength);
-                first = false;
-            }
-            bo->callback(CB.arg, opcode, opcodeLength);
-        }
+#ifdef Z80_NO_ATOMIC
+        return signals.pending;
+#else
+        return signals.pending.load(std::memory_order_relaxed);
+#endif
     }
 
-    inline void checkBreakOperandCB(unsigned char operandNumber) { checkBreakOperand(0xCB00 | operandNumber); }
-    inline void checkBreakOperandED(unsigned char operandNumber) { checkBreakOperand(0xED00 | operandNumber); }
-    inline void checkBreakOperandIX(unsigned char operandNumber) { checkBreakOperand(0xDD00 | operandNumber); }
-    inline void checkBreakOperandIY(unsigned char operandNumber) { checkBreakOperand(0xFD00 | operandNumber); }
-    inline void checkBreakOperandIX4(unsigned char operandNumber) { checkBreakOperand(0xDDCB00 | operandNumber); }
-    inline void checkBreakOperandIY4(unsigned char operandNumber) { checkBreakOperand(0xFDCB00 | operandNumber); }
+    inline void postSignals(unsigned int mask)
+    {
+#ifdef Z80_NO_ATOMIC
+        signals.pending |= mask;
+#else
+        signals.pending.fetch_or(mask, std::memory_order_release);
 #endif
+    }
 
-#ifndef Z80_DISABLE_DEBUG
-    inline void log(const char* format, ...)
+    // returns the signals before clear
+    inline unsigned int clearSignals(unsigned int mask)
     {
-        char buf[1024];
-        va_list args;
-        va_start(args, format);
-        vsnprintf(buf, sizeof(buf), format, args);
-        va_end(args);
-        CB.debugMessage(CB.arg, buf);
-    }
+#ifdef Z80_NO_ATOMIC
+        unsigned int result = signals.pending;
+        signals.pending &= ~mask;
+        return result;
+#else
+        return signals.pending.fetch_and(~mask, std::memory_order_acquire);
 #endif
+    }
 
-    inline unsigned short getAF()
+    void copySignals(const Z80& src)
     {
-        return make16BitsFromLE(reg.pair.F, reg.pair.A);
+#ifdef Z80_NO_ATOMIC
+        signals = src.signals;
+#else
+        signals.pending.store(src.signals.pending.load());
+        signals.vector.store(src.signals.vector.load());
+        signals.addrN.store(src.signals.addrN.load());
+#endif
     }
-    inline unsigned short getAF2() { return make16BitsFromLE(reg.back.F, reg.back.A); }
-    inline unsigned short getBC() { return make16BitsFromLE(reg.pair.C, reg.pair.B); }
-    inline unsigned short getBC2() { return make16BitsFromLE(reg.back.C, reg.back.B); }
-    inline unsigned short getDE() { return make16BitsFromLE(reg.pair.E, reg.pair.D); }
-    inline unsigned short getDE2() { return make16BitsFromLE(reg.back.E, reg.back.D); }
-    inline unsigned short getHL() { return make16BitsFromLE(reg.pair.L, reg.pair.H); }
-    inline unsigned short getHL2() { return make16BitsFromLE(reg.back.L, reg.back.H); }
 
-    inline void setAF(unsigned short value) { splitTo8BitsPair(value, &reg.pair.A, &reg.pair.F); }
-    inline void setAF2(unsigned short value) { splitTo8BitsPair(value, &reg.back.A, &reg.back.F); }
-    inline void setBC(unsigned short value) { splitTo8BitsPair(value, &reg.pair.B, &reg.pair.C); }
-    inline void setBC2(unsigned short value) { splitTo8BitsPair(value, &reg.back.B, &reg.back.C); }
-    inline void setDE(unsigned short value) { splitTo8BitsPair(value, &reg.pair.D, &reg.pair.E); }
-    inline void setDE2(unsigned short value) { splitTo8BitsPair(value, &reg.back.D, &reg.back.E); }
-    inline void setHL(unsigned short value) { splitTo8BitsPair(value, &reg.pair.H, &reg.pair.L); }
-    inline void setHL2(unsigned short value) { splitTo8BitsPair(value, &reg.back.H, &reg.back.L); }
+    inline bool isBreakRequested() { return getSignals() & signalBreak; }
 
-    inline unsigned short getRP(unsigned char rp)
+#ifndef Z80_DISABLE_COMMANDQUEUE
+    struct Command {
+        unsigned long long clock; // total clocks to be executed at
+        unsigned short addr;
+        CommandType type;
+        unsigned char value;
+    };
+
+    // bounded single-producer/single-consumer ring buffer (the consumer is the CPU thread)
+    struct CommandQueue {
+        Command* buffer = nullptr; // nullptr: disabled
+        unsigned int capacity = 0; // power of 2
+#ifdef Z80_NO_ATOMIC
+        unsigned int head = 0; // next index to be consumed
+        unsigned int tail = 0; // next index to be produced
+#else
+        std::atomic<unsigned int> head{0}; // next index to be consumed
+        std::atomic<unsigned int> tail{0}; // next index to be produced
+#endif
+    } commandQueue;
+
+    inline void runCommand(const Command* command)
     {
-        switch (rp & 0b11) {
-            case 0b00: return getBC();
-            case 0b01: return getDE();
-            case 0b10: return getHL();
-            default: return reg.SP;
+        switch (command->type) {
+            case CommandType::IRQ: generateIRQ(command->value); break;
+            case CommandType::NMI: generateNMI(command->addr); break;
+            case CommandType::CancelIRQ: cancelIRQ(); break;
+            case CommandType::Break: requestBreak(); break;
+            case CommandType::Out: CB.out(CB.arg, command->addr, command->value); break;
+            case CommandType::Write:
+                CB.write(CB.arg, command->addr, command->value);
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+                if (decodeCache.entries) invalidateDecodeCache(command->addr);
+#endif
+                break;
         }
     }
 
-    inline unsigned short getRPIX(unsigned char rp)
+    // run the commands that reached the stamped clock
+    Z80_NOINLINE void drainCommands()
     {
-        switch (rp & 0b11) {
-            case 0b00: return getBC();
-            case 0b01: return getDE();
-            case 0b10: return reg.IX;
-            default: return reg.SP;
+#ifdef Z80_NO_ATOMIC
+        while (commandQueue.head != commandQueue.tail) {
+            Command* command = &commandQueue.buffer[commandQueue.head & (commandQueue.capacity - 1)];
+            if (getTotalClocks() < command->clock) return;
+            runCommand(command);
+            commandQueue.head++;
+        }
+#else
+        unsigned int head = commandQueue.head.load(std::memory_order_relaxed);
+        while (head != commandQueue.tail.load(std::memory_order_acquire)) {
+            Command* command = &commandQueue.buffer[head & (commandQueue.capacity - 1)];
+            if (getTotalClocks() < command->clock) return;
+            runCommand(command);
+            commandQueue.head.store(++head, std::memory_order_release);
         }
+#endif
     }
+#endif
 
-    inline unsigned short getRPIY(unsigned char rp)
-    {
-        switch (rp & 0b11) {
-            case 0b00: return getBC();
-            case 0b01: return getDE();
-            case 0b10: return reg.IY;
-            default: return reg.SP;
+    unsigned long long totalClocks; // clocks until the last instruction boundary (see getTotalClocks)
+    unsigned long long instructionCount;
+    bool speculative;   // suppress the debugging outputs (debug message, debug event, trace and timeline)
+    bool suppressOut;   // suppress the out callback in the speculative mode (opt-in)
+    bool suppressClock; // suppress the consumeClock callback in the speculative mode (opt-in)
+    unsigned short instructionPC; // address of the executing instruction
+
+#ifndef Z80_DISABLE_BUSLOG
+    struct BusLog {
+        BusEvent* events = nullptr; // ring buffer (nullptr: disabled)
+        int capacity = 0;
+        int head = 0;
+        int count = 0;
+        unsigned long long lost = 0;
+    } busLog;
+
+    inline void logBus(BusType type, unsigned short addr, unsigned char value)
+    {
+        if (!busLog.events) return;
+        BusEvent* e = &busLog.events[busLog.head];
+        e->clock = getTotalClocks();
+        e->addr = addr;
+        e->pc = instructionPC;
+        e->type = type;
+        e->value = value;
+        if (++busLog.head == busLog.capacity) busLog.head = 0;
+        if (busLog.count < busLog.capacity) {
+            busLog.count++;
+        } else {
+            busLog.lost++;
         }
     }
+#endif
 
-    inline void setRP(unsigned char rp, unsigned short value)
+#ifndef Z80_DISABLE_PROFILER
+    struct Profiler {
+        unsigned long long* counts = nullptr; // number of the executions per instruction address (nullptr: disabled)
+        unsigned long long* clocks = nullptr; // total clocks per instruction address
+    } profiler;
+
+    inline void profileInstruction(unsigned long long startClock)
     {
-        switch (rp & 0b11) {
-            case 0b00: setBC(value); break;
-            case 0b01: setDE(value); break;
-            case 0b10: setHL(value); break;
-            default: reg.SP = value;
-        }
+        profiler.counts[instructionPC]++;
+        profiler.clocks[instructionPC] += getTotalClocks() - startClock;
     }
+#endif
 
-    inline unsigned char getIXH() { return (reg.IX & 0xFF00) >> 8; }
-    inline unsigned char getIXL() { return reg.IX & 0x00FF; }
-    inline unsigned char getIYH() { return (reg.IY & 0xFF00) >> 8; }
-    inline unsigned char getIYL() { return reg.IY & 0x00FF; }
-    inline unsigned char getPCH() { return (reg.PC & 0xFF00) >> 8; }
-    inline unsigned char getPCL() { return reg.PC & 0x00FF; }
-    inline void setPCH(unsigned char v) { reg.PC = (reg.PC & 0x00FF) + v * 256; }
-    inline void setPCL(unsigned char v) { reg.PC = (reg.PC & 0xFF00) + v; }
-    inline void setSPH(unsigned char v) { reg.SP = (reg.SP & 0x00FF) + v * 256; }
-    inline void setSPL(unsigned char v) { reg.SP = (reg.SP & 0xFF00) + v; }
-    inline void setIXH(unsigned char v) { reg.IX = (reg.IX & 0x00FF) + v * 256; }
-    inline void setIXL(unsigned char v) { reg.IX = (reg.IX & 0xFF00) + v; }
-    inline void setIYH(unsigned char v) { reg.IY = (reg.IY & 0x00FF) + v * 256; }
-    inline void setIYL(unsigned char v) { reg.IY = (reg.IY & 0xFF00) + v; }
+#ifndef Z80_DISABLE_COVERAGE
+    struct Coverage {
+        unsigned int* maps = nullptr; // 3 bitmaps of 65536 bits (nullptr: disabled)
+    } coverage;
 
-    inline bool isEvenNumberBits(unsigned char value)
+    // the outcome of the conditional branch (JR cc, JP cc, CALL cc, RET cc and DJNZ) evaluated before the instruction
+    //   returns 1: taken, 0: not taken, -1: not a conditional branch
+    inline int checkBranch(unsigned char operandNumber)
     {
-        int on = 0;
-        int off = 0;
-        value & 0b10000000 ? on++ : off++;
-        value & 0b01000000 ? on++ : off++;
-        value & 0b00100000 ? on++ : off++;
-        value & 0b00010000 ? on++ : off++;
-        value & 0b00001000 ? on++ : off++;
-        value & 0b00000100 ? on++ : off++;
-        value & 0b00000010 ? on++ : off++;
-        value & 0b00000001 ? on++ : off++;
-        return (on & 1) == 0;
+        static const Condition conditions[8] = {Condition::NZ, Condition::Z, Condition::NC, Condition::C, Condition::NPV, Condition::PV, Condition::NS, Condition::S};
+        if (0x10 == operandNumber) return 1 != reg.pair.B ? 1 : 0; // DJNZ (B is decremented before the test)
+        if (0x20 == (operandNumber & 0xE7)) return checkConditionFlag(conditions[(operandNumber >> 3) & 3]) ? 1 : 0;
+        switch (operandNumber & 0xC7) {
+            case 0xC0: // RET cc
+            case 0xC2: // JP cc, nn
+            case 0xC4: // CALL cc, nn
+                return checkConditionFlag(conditions[(operandNumber >> 3) & 7]) ? 1 : 0;
+        }
+        return -1;
     }
 
-    inline void consumeClock(int hz)
+    inline void coverInstruction(int branch)
     {
-        reg.consumeClockCounter += hz;
-#ifndef Z80_CALLBACK_PER_INSTRUCTION
-#ifdef Z80_CALLBACK_WITHOUT_CHECK
-        CB.consumeClock(CB.arg, hz);
-#else
-        if (CB.consumeClockEnabled && hz) CB.consumeClock(CB.arg, hz);
-#endif
-#endif
+        coverage.maps[instructionPC >> 5] |= 1U << (instructionPC & 31);
+        if (branch < 0) return;
+        coverage.maps[(branch ? 0x800 : 0x1000) + (instructionPC >> 5)] |= 1U << (instructionPC & 31);
     }
+#endif
 
-    inline unsigned short getPort16WithB(unsigned char c) { return make16BitsFromLE(c, reg.pair.B); }
-    inline unsigned short getPort16WithA(unsigned char c) { return make16BitsFromLE(c, reg.pair.A); }
+    bool instrumented = false; // any instrument per instruction is enabled (see updateInstrumented)
 
-    inline unsigned char inPortWithB(unsigned char port, int clock = 4)
+    // set instrumented if the profiler, the opcode histogram, the trace, the debug event or the coverage is enabled
+    void updateInstrumented()
     {
-#ifdef Z80_UNSUPPORT_16BIT_PORT
-        unsigned char byte = CB.in(CB.arg, port);
-#else
-        unsigned char byte = CB.in(CB.arg, CB.returnPortAs16Bits ? getPort16WithB(port) : port);
+        instrumented = false;
+#ifndef Z80_DISABLE_PROFILER
+        if (profiler.counts) instrumented = true;
+#endif
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        if (opcodeHistogram.counters) instrumented = true;
+#endif
+#ifndef Z80_DISABLE_TRACE
+        if (trace.records) instrumented = true;
+#endif
+#ifndef Z80_DISABLE_DEBUG
+        if (CB.debugEventEnabled) instrumented = true;
+#endif
+#ifndef Z80_DISABLE_COVERAGE
+        if (coverage.maps) instrumented = true;
 #endif
-        consumeClock(clock);
-        return byte;
     }
 
-    inline unsigned char inPortWithA(unsigned char port, int clock = 4)
+    // execute an instruction (or a NOP while halt) with the instruments
+    //   waitBeforeFetch: consume the wait clocks of the fetch before the instruction (execute(int)) or with M1 (execute())
+    //   returns false if the break point stopped the execution before the instruction
+    Z80_NOINLINE bool executeInstrumented(bool waitBeforeFetch)
     {
-#ifdef Z80_UNSUPPORT_16BIT_PORT
-        unsigned char byte = CB.in(CB.arg, port);
-#else
-        unsigned char byte = CB.in(CB.arg, CB.returnPortAs16Bits ? getPort16WithA(port) : port);
+#if !defined(Z80_DISABLE_PROFILER) || !defined(Z80_DISABLE_OPCODE_HISTOGRAM)
+        unsigned long long startClock = getTotalClocks();
 #endif
-        consumeClock(clock);
-        return byte;
+        if (reg.IFF & IFF_HALT()) {
+            reg.execEI = 0;
+            readOpcode(reg.PC, 4); // NOTE: read and discard (to be consumed 4Hz)
+        } else {
+#ifndef Z80_DISABLE_BREAKPOINT
+            if (checkBreakPoint()) return false;
+#endif
+            if (waitBeforeFetch && wtc.fetch) consumeClock(wtc.fetch);
+#ifndef Z80_DISABLE_TRACE
+            if (trace.records) traceInstruction();
+#endif
+#ifndef Z80_DISABLE_DEBUG
+            if (isDebugEvent()) beginDebugEvent();
+#endif
+            reg.execEI = 0;
+            int operandNumber = fetchM1(waitBeforeFetch ? 2 : 2 + wtc.fetch);
+            updateRefreshRegister();
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+            countOpcode(0, (unsigned char)operandNumber);
+#endif
+#ifndef Z80_DISABLE_BREAKPOINT
+            checkBreakOperand(operandNumber);
+#endif
+#ifndef Z80_DISABLE_COVERAGE
+            int branch = coverage.maps ? checkBranch((unsigned char)operandNumber) : -1;
+#endif
+            opSet1[operandNumber](this);
+#ifndef Z80_DISABLE_DEBUG
+            if (isDebugEvent()) endDebugEvent();
+#endif
+#ifndef Z80_DISABLE_TRACE
+            if (trace.records) endTraceInstruction();
+#endif
+#ifndef Z80_DISABLE_COVERAGE
+            if (coverage.maps) coverInstruction(branch);
+#endif
+        }
+#ifndef Z80_DISABLE_PROFILER
+        if (profiler.counts) profileInstruction(startClock);
+#endif
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        if (opcodeHistogram.current) {
+            opcodeHistogram.current->clocks += getTotalClocks() - startClock;
+            opcodeHistogram.current = nullptr;
+        }
+#endif
+        return true;
     }
 
-    inline void outPortWithB(unsigned char port, unsigned char value, int clock = 4)
+#ifndef Z80_DISABLE_CONTENTION
+    struct Contention {
+        const unsigned char* table = nullptr; // delay clocks per each frame cycle (nullptr: disabled)
+        int frameClocks;
+        unsigned long long frameStart;
+        bool memoryPages[256];
+        bool portPages[256];
+    } contention;
+
+    inline int getContentionDelay()
     {
-#ifdef Z80_UNSUPPORT_16BIT_PORT
-        CB.out(CB.arg, port, value);
-#else
-        CB.out(CB.arg, CB.returnPortAs16Bits ? getPort16WithB(port) : port, value);
-#endif
-        consumeClock(clock);
+        return contention.table[(getTotalClocks() - contention.frameStart) % (unsigned int)contention.frameClocks];
     }
 
-    inline void outPortWithA(unsigned char port, unsigned char value, int clock = 4)
+    inline void contendMemory(unsigned short addr)
     {
-#ifdef Z80_UNSUPPORT_16BIT_PORT
-        CB.out(CB.arg, port, value);
-#else
-        CB.out(CB.arg, CB.returnPortAs16Bits ? getPort16WithA(port) : port, value);
-#endif
-        consumeClock(clock);
+        if (contention.table && contention.memoryPages[addr >> 8]) consumeClock(getContentionDelay());
     }
 
-    static inline void NOP(Z80* ctx)
+    inline void contendPort(unsigned short port)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] NOP", ctx->reg.PC - 1);
+        if (contention.table && contention.portPages[port >> 8]) consumeClock(getContentionDelay());
+    }
 #endif
+
+    // read the code without the bus cycle (no clocks, no contention and no bus log)
+    //   the pages that are not mapped by mapCodePages are read with the peek callback (or the read callback if not set)
+    inline unsigned char peekCode(unsigned short addr)
+    {
+        unsigned char* page = CB.hooks ? CB.hooks->codePages[addr >> 8] : nullptr;
+        if (page) return page[addr & 0xFF];
+        return CB.peekEnabled ? CB.peek(CB.arg, addr) : CB.read(CB.arg, addr);
     }
 
-    static inline void HALT(Z80* ctx)
+#if !defined(Z80_DISABLE_TRACE) || !defined(Z80_DISABLE_DEBUG)
+    // the opcode bytes of the traced instruction captured by readCodeWithHooks while the trace or the debug event is enabled (no extra reads)
+    struct FetchedBytes {
+        unsigned char bytes[4];
+        int count = 4; // 4: not capturing (set 0 at the beginning of the traced instruction)
+    } fetched;
+
+    inline void copyFetchedBytes(unsigned char* bytes)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] HALT", ctx->reg.PC - 1);
+        for (int i = 0; i < 4; i++) bytes[i] = i < fetched.count ? fetched.bytes[i] : 0;
+    }
 #endif
-        ctx->reg.IFF |= ctx->IFF_HALT();
+
+    // index of the opcode table: 0 (no prefix), CB, ED, DD, FD, DDCB, FDCB (-1: not supported)
+    inline int getPrefixTable(int prefixNumber)
+    {
+        switch (prefixNumber) {
+            case 0x00: return 0;
+            case 0xCB: return 1;
+            case 0xED: return 2;
+            case 0xDD: return 3;
+            case 0xFD: return 4;
+            case 0xDDCB: return 5;
+            case 0xFDCB: return 6;
+            default: return -1;
+        }
     }
 
-    static inline void DI(Z80* ctx)
+    // mnemonic of the opcode (the operands are lower case: n = 8-bit, nn = 16-bit, d = displacement, e = relative address)
+    static void formatMnemonic(int table, unsigned char op, char* buf, size_t size)
+    {
+        static const char* r[8] = {"B", "C", "D", "E", "H", "L", "(HL)", "A"};
+        static const char* rp[4] = {"BC", "DE", "HL", "SP"};
+        static const char* rp2[4] = {"BC", "DE", "HL", "AF"};
+        static const char* cc[8] = {"NZ", "Z", "NC", "C", "PO", "PE", "P", "M"};
+        static const char* alu[8] = {"ADD A, ", "ADC A, ", "SUB ", "SBC A, ", "AND ", "XOR ", "OR ", "CP "};
+        static const char* rot[8] = {"RLC", "RRC", "RL", "RR", "SLA", "SRA", "SLL", "SRL"};
+        static const char* bli[4][4] = {{"LDI", "CPI", "INI", "OUTI"}, {"LDD", "CPD", "IND", "OUTD"}, {"LDIR", "CPIR", "INIR", "OTIR"}, {"LDDR", "CPDR", "INDR", "OTDR"}};
+        static const char* im[8] = {"0", "0", "1", "2", "0", "0", "1", "2"};
+        int x = op >> 6;
+        int y = (op >> 3) & 7;
+        int z = op & 7;
+        int p = y >> 1;
+        int q = y & 1;
+        const char* index = 3 == table || 5 == table ? "IX" : "IY";
+        if (5 == table || 6 == table) {
+            // DD CB d op / FD CB d op
+            static const char* ops[4] = {"", "BIT", "RES", "SET"};
+            char bit[4] = {' ', (char)('0' + y), ',', '\0'};
+            char target[16];
+            snprintf(target, sizeof(target), "%s%s (%s+d)", x ? ops[x] : rot[y], x ? bit : "", index);
+            if (1 == x || 6 == z) {
+                snprintf(buf, size, "%s", target);
+            } else {
+                snprintf(buf, size, "%s, %s", target, r[z]);
+            }
+            return;
+        }
+        if (1 == table) {
+            if (0 == x) {
+                snprintf(buf, size, "%s %s", rot[y], r[z]);
+            } else {
+                snprintf(buf, size, "%s %d, %s", 1 == x ? "BIT" : 2 == x ? "RES" : "SET", y, r[z]);
+            }
+            return;
+        }
+        if (2 == table) {
+            if (1 == x) {
+                switch (z) {
+                    case 0: snprintf(buf, size, "IN %s%s(C)", 6 == y ? "" : r[y], 6 == y ? "" : ", "); return;
+                    case 1: snprintf(buf, size, "OUT (C), %s", 6 == y ? "0" : r[y]); return;
+                    case 2: snprintf(buf, size, "%s HL, %s", q ? "ADC" : "SBC", rp[p]); return;
+                    case 3:
+                        if (q) {
+                            snprintf(buf, size, "LD %s, (nn)", rp[p]);
+                        } else {
+                            snprintf(buf, size, "LD (nn), %s", rp[p]);
+                        }
+                        return;
+                    case 4: snprintf(buf, size, "NEG"); return;
+                    case 5: snprintf(buf, size, 1 == y ? "RETI" : "RETN"); return;
+                    case 6: snprintf(buf, size, "IM %s", im[y]); return;
+                    default: {
+                        static const char* misc[8] = {"LD I, A", "LD R, A", "LD A, I", "LD A, R", "RRD", "RLD", "NOP", "NOP"};
+                        snprintf(buf, size, "%s", misc[y]);
+                        return;
+                    }
+                }
+            }
+            if (2 == x && z <= 3 && 4 <= y) {
+                snprintf(buf, size, "%s", bli[y - 4][z]);
+            } else {
+                snprintf(buf, size, "NOP"); // undefined (works as NOP)
+            }
+            return;
+        }
+        // no prefix or DD/FD prefix (HL, H, L and (HL) are replaced with the index register)
+        const char* hl = "HL";
+        const char* regs[8] = {r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]};
+        const char* pairs[4] = {rp[0], rp[1], rp[2], rp[3]};
+        const char* pairs2[4] = {rp2[0], rp2[1], rp2[2], rp2[3]};
+        char memIndex[8];
+        char high[4];
+        char low[4];
+        if (3 == table || 4 == table) {
+            snprintf(memIndex, sizeof(memIndex), "(%s+d)", index);
+            snprintf(high, sizeof(high), "%sH", index);
+            snprintf(low, sizeof(low), "%sL", index);
+            hl = index;
+            pairs[2] = index;
+            pairs2[2] = index;
+            regs[6] = memIndex;
+            // H and L are not replaced in the instructions with (IX+d)
+            bool withMemory = (1 == x && (6 == y || 6 == z)) || (2 == x && 6 == z);
+            if (!withMemory) {
+                regs[4] = high;
+                regs[5] = low;
+            }
+        }
+        switch (x) {
+            case 0:
+                switch (z) {
+                    case 0:
+                        if (0 == y) {
+                            snprintf(buf, size, "NOP");
+                        } else if (1 == y) {
+                            snprintf(buf, size, "EX AF, AF'");
+                        } else if (2 == y) {
+                            snprintf(buf, size, "DJNZ e");
+                        } else if (3 == y) {
+                            snprintf(buf, size, "JR e");
+                        } else {
+                            snprintf(buf, size, "JR %s, e", cc[y - 4]);
+                        }
+                        return;
+                    case 1:
+                        if (q) {
+                            snprintf(buf, size, "ADD %s, %s", hl, pairs[p]);
+                        } else {
+                            snprintf(buf, size, "LD %s, nn", pairs[p]);
+                        }
+                        return;
+                    case 2: {
+                        static const char* loads[8] = {"LD (BC), A", "LD A, (BC)", "LD (DE), A", "LD A, (DE)", "LD (nn), %s", "LD %s, (nn)", "LD (nn), A", "LD A, (nn)"};
+                        snprintf(buf, size, loads[y], hl);
+                        return;
+                    }
+                    case 3: snprintf(buf, size, "%s %s", q ? "DEC" : "INC", pairs[p]); return;
+                    case 4: snprintf(buf, size, "INC %s", regs[y]); return;
+                    case 5: snprintf(buf, size, "DEC %s", regs[y]); return;
+                    case 6: snprintf(buf, size, "LD %s, n", regs[y]); return;
+                    default: {
+                        static const char* misc[8] = {"RLCA", "RRCA", "RLA", "RRA", "DAA", "CPL", "SCF", "CCF"};
+                        snprintf(buf, size, "%s", misc[y]);
+                        return;
+                    }
+                }
+            case 1:
+                if (6 == y && 6 == z) {
+                    snprintf(buf, size, "HALT");
+                } else {
+                    snprintf(buf, size, "LD %s, %s", regs[y], regs[z]);
+                }
+                return;
+            case 2: snprintf(buf, size, "%s%s", alu[y], regs[z]); return;
+            default:
+                switch (z) {
+                    case 0: snprintf(buf, size, "RET %s", cc[y]); return;
+                    case 1:
+                        if (!q) {
+                            snprintf(buf, size, "POP %s", pairs2[p]);
+                        } else if (0 == p) {
+                            snprintf(buf, size, "RET");
+                        } else if (1 == p) {
+                            snprintf(buf, size, "EXX");
+                        } else if (2 == p) {
+                            snprintf(buf, size, "JP (%s)", hl);
+                        } else {
+                            snprintf(buf, size, "LD SP, %s", hl);
+                        }
+                        return;
+                    case 2: snprintf(buf, size, "JP %s, nn", cc[y]); return;
+                    case 3: {
+                        static const char* misc[8] = {"JP nn", "PREFIX CB", "OUT (n), A", "IN A, (n)", "EX (SP), %s", "EX DE, HL", "DI", "EI"};
+                        if (1 == y && (3 == table || 4 == table)) {
+                            snprintf(buf, size, "PREFIX %sCB", 3 == table ? "DD" : "FD");
+                        } else {
+                            snprintf(buf, size, misc[y], hl);
+                        }
+                        return;
+                    }
+                    case 4: snprintf(buf, size, "CALL %s, nn", cc[y]); return;
+                    case 5: {
+                        static const char* misc[4] = {"CALL nn", "PREFIX DD", "PREFIX ED", "PREFIX FD"};
+                        if (!q) {
+                            snprintf(buf, size, "PUSH %s", pairs2[p]);
+                        } else {
+                            snprintf(buf, size, "%s", misc[p]);
+                        }
+                        return;
+                    }
+                    case 6: snprintf(buf, size, "%sn", alu[y]); return;
+                    default: snprintf(buf, size, "RST $%02X", y * 8); return;
+                }
+        }
+    }
+
+    // table and opcode of the instruction bytes (returns the position of the first operand)
+    static inline int decodeOpcode(const unsigned char* bytes, int* table, unsigned char* op)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] DI", ctx->reg.PC - 1);
-#endif
-        ctx->reg.IFF &= ~(ctx->IFF1() | ctx->IFF2());
+        switch (bytes[0]) {
+            case 0xCB: *table = 1; break;
+            case 0xED: *table = 2; break;
+            case 0xDD: *table = 0xCB == bytes[1] ? 5 : 3; break;
+            case 0xFD: *table = 0xCB == bytes[1] ? 6 : 4; break;
+            default: *table = 0; *op = bytes[0]; return 1;
+        }
+        *op = 5 <= *table ? bytes[3] : bytes[1];
+        return 2;
+    }
+
+    // operand kinds per table and opcode (operandN, operandNN, operandD and operandE), taken from the mnemonics once
+    static const unsigned char* getOperandKinds()
+    {
+        static struct OperandKinds {
+            unsigned char kinds[7 * 256];
+            OperandKinds()
+            {
+                for (int i = 0; i < 7 * 256; i++) {
+                    char mnemonic[24];
+                    formatMnemonic(i >> 8, (unsigned char)i, mnemonic, sizeof(mnemonic));
+                    kinds[i] = 0;
+                    for (const char* ptr = mnemonic; *ptr; ptr++) {
+                        if ('n' == ptr[0] && 'n' == ptr[1]) {
+                            kinds[i] |= operandNN;
+                            ptr++;
+                        } else if ('n' == *ptr) {
+                            kinds[i] |= operandN;
+                        } else if ('d' == *ptr) {
+                            kinds[i] |= operandD;
+                        } else if ('e' == *ptr) {
+                            kinds[i] |= operandE;
+                        }
+                    }
+                }
+            }
+        } operandKinds;
+        return operandKinds.kinds;
+    }
+
+    // decode an instruction from the bytes (up to 4) into the text, and returns the length
+    static int decodeInstruction(unsigned short pc, const unsigned char* bytes, char* buf, size_t size)
+    {
+        int table;
+        unsigned char op;
+        int cursor = decodeOpcode(bytes, &table, &op);
+        char mnemonic[24];
+        formatMnemonic(table, op, mnemonic, sizeof(mnemonic));
+        size_t n = 0;
+        for (const char* ptr = mnemonic; *ptr && n + 1 < size; ptr++) {
+            char operand[8];
+            if ('n' == ptr[0] && 'n' == ptr[1]) {
+                snprintf(operand, sizeof(operand), "$%02X%02X", bytes[cursor + 1], bytes[cursor]);
+                cursor += 2;
+                ptr++;
+            } else if ('n' == *ptr) {
+                snprintf(operand, sizeof(operand), "$%02X", bytes[cursor++]);
+            } else if ('d' == *ptr) {
+                signed char d = (signed char)bytes[cursor++];
+                if (0 < n && '+' == buf[n - 1]) n--;
+                snprintf(operand, sizeof(operand), "%c$%02X", d < 0 ? '-' : '+', d < 0 ? -d : d);
+            } else if ('e' == *ptr) {
+                signed char e = (signed char)bytes[cursor++];
+                snprintf(operand, sizeof(operand), "$%04X", (pc + cursor + e) & 0xFFFF);
+            } else {
+                buf[n++] = *ptr;
+                continue;
+            }
+            for (const char* o = operand; *o && n + 1 < size; o++) buf[n++] = *o;
+        }
+        if (size) buf[n] = '\0';
+        return 5 <= table ? 4 : cursor;
     }
 
-    static inline void EI(Z80* ctx)
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+    struct DecodedInstruction {
+        char text[30];
+        unsigned char length; // 0: not decoded
+        unsigned char reserved;
+    };
+
+    struct DecodeCache {
+        DecodedInstruction* entries = nullptr; // per start address (nullptr: disabled)
+    } decodeCache;
+
+    // the instructions that start at the 3 bytes before the address may contain it
+    inline void invalidateDecodeCache(unsigned short addr)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] EI", ctx->reg.PC - 1);
-#endif
-        ctx->reg.IFF |= ctx->IFF1() | ctx->IFF2();
-        ctx->reg.execEI = 1;
+        for (int i = 0; i < 4; i++) decodeCache.entries[(addr - i) & 0xFFFF].length = 0;
     }
+#endif
 
-    static inline void IM0(Z80* ctx) { ctx->IM(0); }
-    static inline void IM1(Z80* ctx) { ctx->IM(1); }
-    static inline void IM2(Z80* ctx) { ctx->IM(2); }
-    inline void IM(unsigned char interrptMode)
+#ifndef Z80_DISABLE_TIMELINE
+    // bounded single-producer/single-consumer ring buffer (the producer is the CPU thread)
+    struct Timeline {
+        TimelineEvent* events = nullptr; // nullptr: disabled
+        unsigned int capacity = 0;       // power of 2
+#ifdef Z80_NO_ATOMIC
+        unsigned int head = 0;       // next index to be consumed
+        unsigned int tail = 0;       // next index to be produced
+        unsigned long long lost = 0; // read by getTimelineLost on the writer thread
+#else
+        std::atomic<unsigned int> head{0};       // next index to be consumed
+        std::atomic<unsigned int> tail{0};       // next index to be produced
+        std::atomic<unsigned long long> lost{0}; // read by getTimelineLost on the writer thread
+#endif
+    } timeline;
+
+    inline void logTimeline(TimelineType type, unsigned short addr, unsigned char value = 0, const char* name = nullptr)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] IM %d", reg.PC - 2, interrptMode);
+        if (!timeline.events || speculative) return;
+#ifdef Z80_NO_ATOMIC
+        unsigned int tail = timeline.tail;
+        if (tail - timeline.head == timeline.capacity) {
+#else
+        unsigned int tail = timeline.tail.load(std::memory_order_relaxed);
+        if (tail - timeline.head.load(std::memory_order_acquire) == timeline.capacity) {
 #endif
-        reg.interrupt &= 0b11111100;
-        reg.interrupt |= interrptMode & 0b11;
+#ifdef Z80_NO_ATOMIC
+            timeline.lost++;
+#else
+            timeline.lost.fetch_add(1, std::memory_order_relaxed);
+#endif
+            return;
+        }
+        TimelineEvent* e = &timeline.events[tail & (timeline.capacity - 1)];
+        e->clock = getTotalClocks();
+        e->name = name;
+        e->addr = addr;
+        e->type = type;
+        e->value = value;
+#ifdef Z80_NO_ATOMIC
+        timeline.tail = tail + 1;
+#else
+        timeline.tail.store(tail + 1, std::memory_order_release);
+#endif
+    }
+#endif
+
+#ifndef Z80_DISABLE_TRACE
+    struct Trace {
+        TraceRecord* records = nullptr; // buffer (nullptr: disabled)
+        FILE* fp = nullptr;             // stream (nullptr: ring buffer)
+        int capacity = 0;
+        int head = 0;
+        int count = 0;
+        unsigned long long lost = 0;
+        bool pending = false; // the record at the head is being traced
+    } trace;
+
+    // fill the record at the head before the instruction (the opcode bytes are filled by endTraceInstruction)
+    inline void traceInstruction()
+    {
+        if (speculative) return;
+        TraceRecord* r = &trace.records[trace.head];
+        r->clock = getTotalClocks();
+        r->pc = reg.PC;
+        r->af = (unsigned short)((reg.pair.A << 8) | reg.pair.F);
+        r->bc = (unsigned short)((reg.pair.B << 8) | reg.pair.C);
+        r->de = (unsigned short)((reg.pair.D << 8) | reg.pair.E);
+        r->hl = (unsigned short)((reg.pair.H << 8) | reg.pair.L);
+        r->ix = reg.IX;
+        r->iy = reg.IY;
+        r->sp = reg.SP;
+        trace.pending = true;
+        fetched.count = 0;
+    }
+
+    inline void endTraceInstruction()
+    {
+        if (!trace.pending) return;
+        trace.pending = false;
+        copyFetchedBytes(trace.records[trace.head].opcode);
+        if (++trace.head == trace.capacity) trace.head = 0;
+        if (trace.count < trace.capacity) {
+            trace.count++;
+        } else {
+            trace.lost++;
+        }
+        if (trace.fp && trace.count == trace.capacity) flushTrace();
     }
+#endif
 
-    static inline void LD_A_I_(Z80* ctx) { ctx->LD_A_I(); }
-    inline void LD_A_I()
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+    struct OpcodeCounter {
+        unsigned long long count;
+        unsigned long long clocks;
+    };
+
+    struct OpcodeHistogram {
+        OpcodeCounter* counters = nullptr; // 7 tables x 256 opcodes (nullptr: disabled)
+        OpcodeCounter* current = nullptr;  // counter of the innermost table of the executing instruction
+    } opcodeHistogram;
+
+    inline void countOpcode(int table, unsigned char operandNumber)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD A<$%02X>, I<$%02X>", reg.PC - 2, reg.pair.A, reg.I);
+        if (!opcodeHistogram.counters) return;
+        opcodeHistogram.current = &opcodeHistogram.counters[(table << 8) | operandNumber];
+        opcodeHistogram.current->count++;
+    }
 #endif
-        reg.pair.A = reg.I;
-        setFlagPV(reg.IFF & IFF2());
-        consumeClock(1);
+
+#ifndef Z80_DISABLE_BREAKPOINT
+    bool breakBefore = false; // requested by requestBreakBefore in the break point callback
+    bool breakSkip = false;   // requested by skipBreakPointOnce (cleared when the execute returns)
+
+    // returns true if the execution should be stopped before the instruction
+    inline bool checkBreakPoint()
+    {
+        if (!CB.hooks || !(CB.hooks->breakPointBitmap[reg.PC >> 5] & (1U << (reg.PC & 31)))) return false;
+        return callBreakPoints();
     }
 
-    static inline void LD_I_A_(Z80* ctx) { ctx->LD_I_A(); }
-    inline void LD_I_A()
+    Z80_NOINLINE bool callBreakPoints()
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD I<$%02X>, A<$%02X>", reg.PC - 2, reg.I, reg.pair.A);
+        if (breakSkip) {
+            breakSkip = false;
+            return false;
+        }
+        unsigned short addr = reg.PC;
+        for (size_t i = 0;; i++) {
+            auto page = CB.hooks ? CB.hooks->breakPointPages[addr >> 8] : nullptr; // re-read: the callback may add or remove the break points
+            if (!page || page[addr & 0xFF].size() <= i) break;
+            BreakPoint* bp = page[addr & 0xFF][i];
+            if (!bp->condition.empty() && !evaluateCondition(bp->condition)) continue;
+            if (++bp->hitCount <= bp->ignoreCount) continue;
+#ifndef Z80_DISABLE_TIMELINE
+            logTimeline(TimelineType::BreakPoint, addr);
 #endif
-        reg.I = reg.pair.A;
-        consumeClock(1);
+            bp->callback(CB.arg);
+        }
+        if (!breakBefore) return false;
+        breakBefore = false;
+        return true;
     }
 
-    static inline void LD_A_R_(Z80* ctx) { ctx->LD_A_R(); }
-    inline void LD_A_R()
+    int insertBreakPoint(BreakPoint* bp)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD A<$%02X>, R<$%02X>", reg.PC - 2, reg.pair.A, reg.R);
-#endif
-        reg.pair.A = reg.R;
-        setFlagPV(reg.IFF & IFF1());
-        consumeClock(1);
+        HookTables* hooks = getHooks();
+        auto& page = hooks->breakPointPages[bp->addr >> 8];
+        if (!page) {
+            page = new std::vector<BreakPoint*>[256];
+        }
+        bp->id = ++CB.breakPointId;
+        page[bp->addr & 0xFF].push_back(bp);
+        hooks->breakPointBitmap[bp->addr >> 5] |= 1U << (bp->addr & 31);
+        return bp->id;
+    }
+
+    static const int conditionStackSize = 16;
+    static const int conditionRegisterCount = 28;
+
+    inline const char* getConditionRegisterName(int index)
+    {
+        static const char* names[conditionRegisterCount] = {
+            "A", "F", "B", "C", "D", "E", "H", "L", "I", "R",
+            "AF", "BC", "DE", "HL", "IX", "IY", "SP", "PC",
+            "AF'", "BC'", "DE'", "HL'",
+            "SF", "ZF", "HF", "PF", "NF", "CF"};
+        return names[index];
+    }
+
+    inline int getConditionRegister(int index)
+    {
+        switch (index) {
+            case 0: return reg.pair.A;
+            case 1: return reg.pair.F;
+            case 2: return reg.pair.B;
+            case 3: return reg.pair.C;
+            case 4: return reg.pair.D;
+            case 5: return reg.pair.E;
+            case 6: return reg.pair.H;
+            case 7: return reg.pair.L;
+            case 8: return reg.I;
+            case 9: return reg.R;
+            case 10: return (reg.pair.A << 8) | reg.pair.F;
+            case 11: return (reg.pair.B << 8) | reg.pair.C;
+            case 12: return (reg.pair.D << 8) | reg.pair.E;
+            case 13: return (reg.pair.H << 8) | reg.pair.L;
+            case 14: return reg.IX;
+            case 15: return reg.IY;
+            case 16: return reg.SP;
+            case 17: return reg.PC;
+            case 18: return (reg.back.A << 8) | reg.back.F;
+            case 19: return (reg.back.B << 8) | reg.back.C;
+            case 20: return (reg.back.D << 8) | reg.back.E;
+            case 21: return (reg.back.H << 8) | reg.back.L;
+            case 22: return reg.pair.F & flagS() ? 1 : 0;
+            case 23: return reg.pair.F & flagZ() ? 1 : 0;
+            case 24: return reg.pair.F & flagH() ? 1 : 0;
+            case 25: return reg.pair.F & flagPV() ? 1 : 0;
+            case 26: return reg.pair.F & flagN() ? 1 : 0;
+            case 27: return reg.pair.F & flagC() ? 1 : 0;
+            default: return 0;
+        }
     }
 
-    static inline void LD_R_A_(Z80* ctx) { ctx->LD_R_A(); }
-    inline void LD_R_A()
+    inline bool evaluateCondition(const std::vector<unsigned char>& code)
+    {
+        int stack[conditionStackSize];
+        int sp = 0;
+        size_t size = code.size();
+        for (size_t i = 0; i < size; i++) {
+            switch ((ConditionCode)code[i]) {
+                case ConditionCode::Register: stack[sp++] = getConditionRegister(code[++i]); continue;
+                case ConditionCode::Immediate:
+                    stack[sp++] = code[i + 1] | (code[i + 2] << 8);
+                    i += 2;
+                    continue;
+                case ConditionCode::Memory: stack[sp - 1] = peekCode((unsigned short)stack[sp - 1]); continue;
+                default: break;
+            }
+            int right = stack[--sp];
+            int left = stack[sp - 1];
+            int result = 0;
+            switch ((ConditionCode)code[i]) {
+                case ConditionCode::Add: result = (left + right) & 0xFFFF; break;
+                case ConditionCode::Sub: result = (left - right) & 0xFFFF; break;
+                case ConditionCode::Equal: result = left == right; break;
+                case ConditionCode::NotEqual: result = left != right; break;
+                case ConditionCode::Less: result = left < right; break;
+                case ConditionCode::LessEqual: result = left <= right; break;
+                case ConditionCode::Greater: result = left > right; break;
+                case ConditionCode::GreaterEqual: result = left >= right; break;
+                case ConditionCode::And: result = left && right; break;
+                case ConditionCode::Or: result = left || right; break;
+                default: break;
+            }
+            stack[sp - 1] = result;
+        }
+        return sp && stack[0];
+    }
+
+    // compiler of the break point condition (recursive descent)
+    //   or      := and ("||" and)*
+    //   and     := compare ("&&" compare)*
+    //   compare := "(" or ")" | value [("==" | "!=" | "<" | "<=" | ">" | ">=") value]
+    //   value   := primary (("+" | "-") primary)*
+    //   primary := register | flag | number ($hex, 0xhex or decimal) | "[" value "]" (byte at the address)
+    struct ConditionCompiler {
+        const char* ptr;
+        std::vector<unsigned char>* code;
+        int depth;
+        int maxDepth;
+    };
+
+    inline void skipConditionSpace(ConditionCompiler& cc)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD R<$%02X>, A<$%02X>", reg.PC - 2, reg.R, reg.pair.A);
-#endif
-        reg.R = reg.pair.A;
-        consumeClock(1);
+        while (*cc.ptr == ' ' || *cc.ptr == '\t') cc.ptr++;
     }
 
-    static inline void OP_CB(Z80* ctx)
+    inline bool matchCondition(ConditionCompiler& cc, const char* token)
     {
-        unsigned char operandNumber = ctx->fetch(4 + ctx->wtc.fetchM);
-#ifndef Z80_DISABLE_BREAKPOINT
-        ctx->checkBreakOperandCB(operandNumber);
-#endif
-        ctx->opSetCB[operandNumber](ctx);
+        skipConditionSpace(cc);
+        size_t length = strlen(token);
+        if (strncmp(cc.ptr, token, length)) return false;
+        cc.ptr += length;
+        return true;
     }
 
-    static inline void OP_ED(Z80* ctx)
+    inline void emitCondition(ConditionCompiler& cc, ConditionCode op, int push)
     {
-        unsigned char operandNumber = ctx->fetch(4 + ctx->wtc.fetchM);
-#ifndef Z80_NO_EXCEPTION
-        if (!ctx->opSetED[operandNumber]) {
-            char buf[80];
-            snprintf(buf, sizeof(buf), "detect an unknown operand (ED,%02X)", operandNumber);
-            throw std::runtime_error(buf);
+        cc.code->push_back((unsigned char)op);
+        cc.depth += push;
+        if (cc.maxDepth < cc.depth) cc.maxDepth = cc.depth;
+    }
+
+    bool compileConditionPrimary(ConditionCompiler& cc)
+    {
+        skipConditionSpace(cc);
+        if (matchCondition(cc, "[")) {
+            if (!compileConditionValue(cc) || !matchCondition(cc, "]")) return false;
+            emitCondition(cc, ConditionCode::Memory, 0);
+            return true;
+        }
+        int value = 0;
+        int digits = 0;
+        if (*cc.ptr == '$' || (cc.ptr[0] == '0' && (cc.ptr[1] == 'x' || cc.ptr[1] == 'X'))) {
+            cc.ptr += *cc.ptr == '$' ? 1 : 2;
+            for (; isxdigit((unsigned char)*cc.ptr); cc.ptr++, digits++) {
+                value = (value << 4) | (isdigit((unsigned char)*cc.ptr) ? *cc.ptr - '0' : (toupper((unsigned char)*cc.ptr) - 'A' + 10));
+                if (0xFFFF < value) return false;
+            }
+        } else if (isdigit((unsigned char)*cc.ptr)) {
+            for (; isdigit((unsigned char)*cc.ptr); cc.ptr++, digits++) {
+                value = value * 10 + (*cc.ptr - '0');
+                if (0xFFFF < value) return false;
+            }
+        } else {
+            char name[8];
+            int length = 0;
+            while (isalnum((unsigned char)cc.ptr[length]) || cc.ptr[length] == '\'') {
+                if (length == 7) return false;
+                name[length] = (char)toupper((unsigned char)cc.ptr[length]);
+                length++;
+            }
+            name[length] = '\0';
+            for (int i = 0; i < conditionRegisterCount; i++) {
+                if (0 == strcmp(name, getConditionRegisterName(i))) {
+                    cc.ptr += length;
+                    emitCondition(cc, ConditionCode::Register, 1);
+                    cc.code->push_back((unsigned char)i);
+                    return true;
+                }
+            }
+            return false;
+        }
+        if (!digits) return false;
+        emitCondition(cc, ConditionCode::Immediate, 1);
+        cc.code->push_back((unsigned char)(value & 0xFF));
+        cc.code->push_back((unsigned char)(value >> 8));
+        return true;
+    }
+
+    bool compileConditionValue(ConditionCompiler& cc)
+    {
+        if (!compileConditionPrimary(cc)) return false;
+        while (true) {
+            ConditionCode op;
+            if (matchCondition(cc, "+")) {
+                op = ConditionCode::Add;
+            } else if (matchCondition(cc, "-")) {
+                op = ConditionCode::Sub;
+            } else {
+                return true;
+            }
+            if (!compileConditionPrimary(cc)) return false;
+            emitCondition(cc, op, -1);
         }
-#endif
-#ifndef Z80_DISABLE_BREAKPOINT
-        ctx->checkBreakOperandED(operandNumber);
-#endif
-        ctx->opSetED[operandNumber](ctx);
     }
 
-    static inline void OP_IX(Z80* ctx)
+    bool compileConditionCompare(ConditionCompiler& cc)
     {
-        unsigned char operandNumber = ctx->fetch(4 + ctx->wtc.fetchM);
-#ifndef Z80_NO_EXCEPTION
-        if (!ctx->opSetIX[operandNumber]) {
-            char buf[80];
-            snprintf(buf, sizeof(buf), "detect an unknown operand (DD,%02X)", operandNumber);
-            throw std::runtime_error(buf);
+        if (matchCondition(cc, "(")) {
+            return compileConditionOr(cc) && matchCondition(cc, ")");
         }
-#endif
-#ifndef Z80_DISABLE_BREAKPOINT
-        ctx->checkBreakOperandIX(operandNumber);
-#endif
-        ctx->opSetIX[operandNumber](ctx);
+        if (!compileConditionValue(cc)) return false;
+        ConditionCode op;
+        if (matchCondition(cc, "==")) {
+            op = ConditionCode::Equal;
+        } else if (matchCondition(cc, "!=")) {
+            op = ConditionCode::NotEqual;
+        } else if (matchCondition(cc, "<=")) {
+            op = ConditionCode::LessEqual;
+        } else if (matchCondition(cc, ">=")) {
+            op = ConditionCode::GreaterEqual;
+        } else if (matchCondition(cc, "<")) {
+            op = ConditionCode::Less;
+        } else if (matchCondition(cc, ">")) {
+            op = ConditionCode::Greater;
+        } else {
+            return true; // true if the value is not zero
+        }
+        if (!compileConditionValue(cc)) return false;
+        emitCondition(cc, op, -1);
+        return true;
     }
 
-    static inline void OP_IY(Z80* ctx)
+    bool compileConditionAnd(ConditionCompiler& cc)
     {
-        unsigned char operandNumber = ctx->fetch(4 + ctx->wtc.fetchM);
-#ifndef Z80_NO_EXCEPTION
-        if (!ctx->opSetIY[operandNumber]) {
-            char buf[80];
-            snprintf(buf, sizeof(buf), "detect an unknown operand (FD,%02X)", operandNumber);
-            throw std::runtime_error(buf);
+        if (!compileConditionCompare(cc)) return false;
+        while (matchCondition(cc, "&&")) {
+            if (!compileConditionCompare(cc)) return false;
+            emitCondition(cc, ConditionCode::And, -1);
         }
-#endif
-#ifndef Z80_DISABLE_BREAKPOINT
-        ctx->checkBreakOperandIY(operandNumber);
-#endif
-        ctx->opSetIY[operandNumber](ctx);
+        return true;
     }
 
-    static inline void OP_IX4(Z80* ctx)
+    bool compileConditionOr(ConditionCompiler& cc)
     {
-        signed char op3 = (signed char)ctx->fetch(4);
-        unsigned char op4 = ctx->fetch(4);
-#ifndef Z80_DISABLE_BREAKPOINT
-        ctx->checkBreakOperandIX4(op4);
-#endif
-        ctx->opSetIX4[op4](ctx, op3);
+        if (!compileConditionAnd(cc)) return false;
+        while (matchCondition(cc, "||")) {
+            if (!compileConditionAnd(cc)) return false;
+            emitCondition(cc, ConditionCode::Or, -1);
+        }
+        return true;
     }
 
-    static inline void OP_IY4(Z80* ctx)
+    bool compileCondition(const char* condition, std::vector<unsigned char>& code)
     {
-        signed char op3 = (signed char)ctx->fetch(4);
-        unsigned char op4 = ctx->fetch(4);
-#ifndef Z80_DISABLE_BREAKPOINT
-        ctx->checkBreakOperandIY4(op4);
-#endif
-        ctx->opSetIY4[op4](ctx, op3);
+        ConditionCompiler cc;
+        cc.ptr = condition;
+        cc.code = &code;
+        cc.depth = 0;
+        cc.maxDepth = 0;
+        code.clear();
+        if (!compileConditionOr(cc)) return false;
+        skipConditionSpace(cc);
+        return '\0' == *cc.ptr && cc.maxDepth <= conditionStackSize;
     }
 
-    // Load location (HL) with value n
-    static inline void LD_HL_N(Z80* ctx)
+    inline void callBreakOperands(int table, unsigned char operandNumber, unsigned char* opcode, int opcodeLength)
     {
-        unsigned char n = ctx->fetch(3);
-        unsigned short hl = ctx->getHL();
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD (HL<$%04X>), $%02X", ctx->reg.PC - 2, hl, n);
-#endif
-        ctx->writeByte(hl, n, 3);
+        for (size_t i = 0;; i++) {
+            auto breakOperands = CB.hooks ? CB.hooks->breakOperands[table][operandNumber] : nullptr; // re-read: the callback may add or remove the break operands
+            if (!breakOperands || breakOperands->size() <= i) break;
+            (*breakOperands)[i]->callback(CB.arg, opcode, opcodeLength);
+        }
     }
 
-    // Load Acc. wth location (BC)
-    static inline void LD_A_BC(Z80* ctx)
+    // the prefixes and the operand number are taken from the fetch, and the remaining operands are peeked from PC
+    inline void checkBreakOperand(unsigned char operandNumber)
     {
-        unsigned short addr = ctx->getBC();
-        unsigned char n = ctx->readByte(addr, 3);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD A, (BC<$%02X%02X>) = $%02X", ctx->reg.PC - 1, ctx->reg.pair.B, ctx->reg.pair.C, n);
-#endif
-        ctx->reg.pair.A = n;
+        if (!CB.hooks || !CB.hooks->breakOperands[0][operandNumber]) return;
+        unsigned char opcode[8];
+        opcode[0] = operandNumber;
+        int opcodeLength = opLength1[operandNumber];
+        for (int i = 1; i < opcodeLength; i++) opcode[i] = peekCode((unsigned short)(reg.PC + i - 1));
+        callBreakOperands(0, operandNumber, opcode, opcodeLength);
     }
 
-    // Load Acc. wth location (DE)
-    static inline void LD_A_DE(Z80* ctx)
+    inline void checkBreakOperandCB(unsigned char operandNumber)
     {
-        unsigned short addr = ctx->getDE();
-        unsigned char n = ctx->readByte(addr, 3);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD A, (DE<$%02X%02X>) = $%02X", ctx->reg.PC - 1, ctx->reg.pair.D, ctx->reg.pair.E, n);
-#endif
-        ctx->reg.pair.A = n;
+        if (!CB.hooks || !CB.hooks->breakOperands[1][operandNumber]) return;
+        unsigned char opcode[8] = {0xCB, operandNumber};
+        callBreakOperands(1, operandNumber, opcode, 2);
     }
 
-    // Load Acc. wth location (nn)
-    static inline void LD_A_NN(Z80* ctx)
+    inline void checkBreakOperandPrefixed(int table, unsigned char prefix, unsigned char operandNumber, const int* opLength)
     {
-        unsigned char l = ctx->fetch(3);
-        unsigned char h = ctx->fetch(3);
-        unsigned short addr = ctx->make16BitsFromLE(l, h);
-        unsigned char n = ctx->readByte(addr, 3);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD A, ($%04X) = $%02X", ctx->reg.PC - 3, addr, n);
-#endif
-        ctx->reg.pair.A = n;
+        if (!CB.hooks || !CB.hooks->breakOperands[table][operandNumber]) return;
+        unsigned char opcode[8];
+        opcode[0] = prefix;
+        opcode[1] = operandNumber;
+        int opcodeLength = opLength[operandNumber];
+        for (int i = 2; i < opcodeLength; i++) opcode[i] = peekCode((unsigned short)(reg.PC + i - 2));
+        callBreakOperands(table, operandNumber, opcode, opcodeLength);
     }
 
-    // Load location (BC) wtih Acc.
-    static inline void LD_BC_A(Z80* ctx)
+    inline void checkBreakOperandED(unsigned char operandNumber) { checkBreakOperandPrefixed(2, 0xED, operandNumber, opLengthED); }
+    inline void checkBreakOperandIX(unsigned char operandNumber) { checkBreakOperandPrefixed(3, 0xDD, operandNumber, opLengthIXY); }
+    inline void checkBreakOperandIY(unsigned char operandNumber) { checkBreakOperandPrefixed(4, 0xFD, operandNumber, opLengthIXY); }
+
+    // DD CB d op / FD CB d op: all bytes have been fetched already
+    inline void checkBreakOperandXY4(int table, unsigned char prefix, signed char displacement, unsigned char operandNumber)
     {
-        unsigned short addr = ctx->getBC();
-        unsigned char n = ctx->reg.pair.A;
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD (BC<$%02X%02X>), A<$%02X>", ctx->reg.PC - 1, ctx->reg.pair.B, ctx->reg.pair.C, n);
-#endif
-        ctx->writeByte(addr, n, 3);
+        if (!CB.hooks || !CB.hooks->breakOperands[table][operandNumber]) return;
+        unsigned char opcode[8] = {prefix, 0xCB, (unsigned char)displacement, operandNumber};
+        callBreakOperands(table, operandNumber, opcode, 4);
     }
 
-    // Load location (DE) wtih Acc.
-    static inline void LD_DE_A(Z80* ctx)
-    {
-        unsigned short addr = ctx->getDE();
-        unsigned char n = ctx->reg.pair.A;
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD (DE<$%02X%02X>), A<$%02X>", ctx->reg.PC - 1, ctx->reg.pair.D, ctx->reg.pair.E, n);
+    inline void checkBreakOperandIX4(signed char displacement, unsigned char operandNumber) { checkBreakOperandXY4(5, 0xDD, displacement, operandNumber); }
+    inline void checkBreakOperandIY4(signed char displacement, unsigned char operandNumber) { checkBreakOperandXY4(6, 0xFD, displacement, operandNumber); }
 #endif
-        ctx->writeByte(addr, n, 3);
-    }
 
-    // Load location (nn) with Acc.
-    static inline void LD_NN_A(Z80* ctx)
-    {
-        unsigned char l = ctx->fetch(3);
-        unsigned char h = ctx->fetch(3);
-        unsigned short addr = ctx->make16BitsFromLE(l, h);
-        unsigned char n = ctx->reg.pair.A;
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD ($%04X), A<$%02X>", ctx->reg.PC - 3, addr, n);
-#endif
-        ctx->writeByte(addr, n, 3);
-    }
+    DebugEvent currentDebugEvent; // event of the executing instruction
+    bool debugEventPending = false;
 
-    // Load HL with location (nn).
-    static inline void LD_HL_ADDR(Z80* ctx)
+    inline bool isDebugEvent() { return CB.debugEventEnabled && !speculative; }
+
+    inline void beginDebugEvent()
     {
-        unsigned char l = ctx->fetch(3);
-        unsigned char h = ctx->fetch(3);
-        unsigned short addr = ctx->make16BitsFromLE(l, h);
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short hl = ctx->getHL();
-#endif
-        ctx->reg.pair.L = ctx->readByte(addr, 3);
-        ctx->reg.pair.H = ctx->readByte(addr + 1, 3);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD HL<$%04X>, ($%04X) = $%04X", ctx->reg.PC - 3, hl, addr, ctx->getHL());
-#endif
+        currentDebugEvent.clock = getTotalClocks();
+        currentDebugEvent.pc = reg.PC;
+        currentDebugEvent.before = reg;
+        debugEventPending = true;
+        fetched.count = 0;
     }
 
-    // Load location (nn) with HL.
-    static inline void LD_ADDR_HL(Z80* ctx)
+    inline void endDebugEvent()
     {
-        unsigned char l = ctx->fetch(3);
-        unsigned char h = ctx->fetch(3);
-        unsigned short addr = ctx->make16BitsFromLE(l, h);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD ($%04X), %s", ctx->reg.PC - 3, addr, ctx->registerPairDump(0b10));
-#endif
-        ctx->writeByte(addr, ctx->reg.pair.L, 3);
-        ctx->writeByte(addr + 1, ctx->reg.pair.H, 3);
+        if (!debugEventPending) return;
+        debugEventPending = false;
+        DebugEvent* e = &currentDebugEvent;
+        copyFetchedBytes(e->bytes);
+        int table;
+        int cursor = decodeOpcode(e->bytes, &table, &e->opcode);
+        static const int prefixes[7] = {0x00, 0xCB, 0xED, 0xDD, 0xFD, 0xDDCB, 0xFDCB};
+        e->prefix = prefixes[table];
+        e->operands = getOperandKinds()[(table << 8) | e->opcode];
+        e->displacement = 0;
+        e->immediate = 0;
+        if (e->operands & (operandD | operandE)) e->displacement = (signed char)e->bytes[cursor++];
+        if (e->operands & operandNN) {
+            e->immediate = make16BitsFromLE(e->bytes[cursor], e->bytes[cursor + 1]);
+            cursor += 2;
+        } else if (e->operands & operandN) {
+            e->immediate = e->bytes[cursor++];
+        }
+        e->length = (unsigned char)(5 <= table ? 4 : cursor);
+        e->after = reg;
+        e->clocks = (int)(getTotalClocks() - e->clock);
+        CB.debugEvent(CB.arg, e);
     }
 
-    // Load SP with HL.
-    static inline void LD_SP_HL(Z80* ctx)
+    inline void log(const char* format, ...)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] LD %s, HL<$%04X>", ctx->reg.PC - 1, ctx->registerPairDump(0b11), ctx->getHL());
-#endif
-        ctx->reg.SP = ctx->getHL();
-        ctx->consumeClock(2);
+        char buf[1024];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        CB.debugMessage(CB.arg, buf);
     }
+#endif
 
-    // Exchange H and L with D and E
-    static inline void EX_DE_HL(Z80* ctx)
+    inline unsigned short getAF()
     {
-        unsigned short de = ctx->getDE();
-        unsigned short hl = ctx->getHL();
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] EX %s, %s", ctx->reg.PC - 1, ctx->registerPairDump(0b01), ctx->registerPairDump(0b10));
-#endif
-        ctx->setDE(hl);
-        ctx->setHL(de);
+        return make16BitsFromLE(reg.pair.F, reg.pair.A);
     }
+    inline unsigned short getAF2() { return make16BitsFromLE(reg.back.F, reg.back.A); }
+    inline unsigned short getBC() { return make16BitsFromLE(reg.pair.C, reg.pair.B); }
+    inline unsigned short getBC2() { return make16BitsFromLE(reg.back.C, reg.back.B); }
+    inline unsigned short getDE() { return make16BitsFromLE(reg.pair.E, reg.pair.D); }
+    inline unsigned short getDE2() { return make16BitsFromLE(reg.back.E, reg.back.D); }
+    inline unsigned short getHL() { return make16BitsFromLE(reg.pair.L, reg.pair.H); }
+    inline unsigned short getHL2() { return make16BitsFromLE(reg.back.L, reg.back.H); }
 
-    // Exchange A and F with A' and F'
-    static inline void EX_AF_AF2(Z80* ctx)
+    inline void setAF(unsigned short value) { splitTo8BitsPair(value, &reg.pair.A, &reg.pair.F); }
+    inline void setAF2(unsigned short value) { splitTo8BitsPair(value, &reg.back.A, &reg.back.F); }
+    inline void setBC(unsigned short value) { splitTo8BitsPair(value, &reg.pair.B, &reg.pair.C); }
+    inline void setBC2(unsigned short value) { splitTo8BitsPair(value, &reg.back.B, &reg.back.C); }
+    inline void setDE(unsigned short value) { splitTo8BitsPair(value, &reg.pair.D, &reg.pair.E); }
+    inline void setDE2(unsigned short value) { splitTo8BitsPair(value, &reg.back.D, &reg.back.E); }
+    inline void setHL(unsigned short value) { splitTo8BitsPair(value, &reg.pair.H, &reg.pair.L); }
+    inline void setHL2(unsigned short value) { splitTo8BitsPair(value, &reg.back.H, &reg.back.L); }
+
+    inline unsigned short getRP(unsigned char rp)
     {
-        unsigned short af = ctx->getAF();
-        unsigned short af2 = ctx->getAF2();
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] EX AF<$%02X%02X>, AF'<$%02X%02X>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->reg.pair.F, ctx->reg.back.A, ctx->reg.back.F);
-#endif
-        ctx->setAF(af2);
-        ctx->setAF2(af);
+        switch (rp & 0b11) {
+            case 0b00: return getBC();
+            case 0b01: return getDE();
+            case 0b10: return getHL();
+            default: return reg.SP;
+        }
     }
 
-    static inline void EX_SP_HL(Z80* ctx)
+    inline unsigned short getRPIX(unsigned char rp)
     {
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short sp = ctx->reg.SP;
-#endif
-        unsigned char l = ctx->pop(4);
-        unsigned char h = ctx->pop(4);
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short hl = ctx->getHL();
-        if (ctx->isDebug()) ctx->log("[%04X] EX (SP<$%04X>) = $%02X%02X, HL<$%04X>", ctx->reg.PC - 1, sp, h, l, hl);
-#endif
-        ctx->push(ctx->reg.pair.H, 4);
-        ctx->reg.pair.H = h;
-        ctx->push(ctx->reg.pair.L, 3);
-        ctx->reg.pair.L = l;
+        switch (rp & 0b11) {
+            case 0b00: return getBC();
+            case 0b01: return getDE();
+            case 0b10: return reg.IX;
+            default: return reg.SP;
+        }
     }
 
-    static inline void EXX(Z80* ctx)
+    inline unsigned short getRPIY(unsigned char rp)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] EXX", ctx->reg.PC - 1);
-#endif
-        unsigned short bc = ctx->getBC();
-        unsigned short bc2 = ctx->getBC2();
-        unsigned short de = ctx->getDE();
-        unsigned short de2 = ctx->getDE2();
-        unsigned short hl = ctx->getHL();
-        unsigned short hl2 = ctx->getHL2();
-        ctx->setBC(bc2);
-        ctx->setBC2(bc);
-        ctx->setDE(de2);
-        ctx->setDE2(de);
-        ctx->setHL(hl2);
-        ctx->setHL2(hl);
+        switch (rp & 0b11) {
+            case 0b00: return getBC();
+            case 0b01: return getDE();
+            case 0b10: return reg.IY;
+            default: return reg.SP;
+        }
     }
 
-    inline void push(unsigned char value, int clocks)
+    inline void setRP(unsigned char rp, unsigned short value)
     {
-        reg.SP--;
-        writeByte(reg.SP, value, clocks);
+        switch (rp & 0b11) {
+            case 0b00: setBC(value); break;
+            case 0b01: setDE(value); break;
+            case 0b10: setHL(value); break;
+            default: reg.SP = value;
+        }
     }
 
-    inline unsigned char pop(int clocks)
+    inline unsigned char getIXH() { return (reg.IX & 0xFF00) >> 8; }
+    inline unsigned char getIXL() { return reg.IX & 0x00FF; }
+    inline unsigned char getIYH() { return (reg.IY & 0xFF00) >> 8; }
+    inline unsigned char getIYL() { return reg.IY & 0x00FF; }
+    inline unsigned char getPCH() { return (reg.PC & 0xFF00) >> 8; }
+    inline unsigned char getPCL() { return reg.PC & 0x00FF; }
+    inline void setPCH(unsigned char v) { reg.PC = (reg.PC & 0x00FF) + v * 256; }
+    inline void setPCL(unsigned char v) { reg.PC = (reg.PC & 0xFF00) + v; }
+    inline void setSPH(unsigned char v) { reg.SP = (reg.SP & 0x00FF) + v * 256; }
+    inline void setSPL(unsigned char v) { reg.SP = (reg.SP & 0xFF00) + v; }
+    inline void setIXH(unsigned char v) { reg.IX = (reg.IX & 0x00FF) + v * 256; }
+    inline void setIXL(unsigned char v) { reg.IX = (reg.IX & 0xFF00) + v; }
+    inline void setIYH(unsigned char v) { reg.IY = (reg.IY & 0x00FF) + v * 256; }
+    inline void setIYL(unsigned char v) { reg.IY = (reg.IY & 0xFF00) + v; }
+
+    inline bool isEvenNumberBits(unsigned char value)
     {
-        unsigned char value = readByte(reg.SP, clocks);
-        reg.SP++;
-        return value;
+        int on = 0;
+        int off = 0;
+        value & 0b10000000 ? on++ : off++;
+        value & 0b01000000 ? on++ : off++;
+        value & 0b00100000 ? on++ : off++;
+        value & 0b00010000 ? on++ : off++;
+        value & 0b00001000 ? on++ : off++;
+        value & 0b00000100 ? on++ : off++;
+        value & 0b00000010 ? on++ : off++;
+        value & 0b00000001 ? on++ : off++;
+        return (on & 1) == 0;
     }
 
-    static inline void PUSH_AF(Z80* ctx)
+    inline void consumeClock(int hz)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] PUSH AF<$%02X%02X> <SP:$%04X>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->reg.pair.F, ctx->reg.SP);
+        reg.consumeClockCounter += hz;
+#ifndef Z80_CALLBACK_PER_INSTRUCTION
+#ifdef Z80_CALLBACK_WITHOUT_CHECK
+        CB.consumeClock(CB.arg, hz);
+#else
+        if (CB.consumeClockEnabled && hz && !suppressClock) CB.consumeClock(CB.arg, hz);
+#endif
 #endif
-        ctx->push(ctx->reg.pair.A, 4);
-        ctx->push(ctx->reg.pair.F, 3);
     }
 
-    static inline void POP_AF(Z80* ctx)
+    inline unsigned char readPort(unsigned short port)
     {
-        ctx->reg.pair.F = ctx->pop(3);
-        ctx->reg.pair.A = ctx->pop(3);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] POP AF <SP:$%04X> = $%04X", ctx->reg.PC - 1, ctx->reg.SP - 2, ctx->getAF());
+#ifndef Z80_DISABLE_RECORD
+        if (RecorderMode::Off != recorder.mode) return readPortWithRecorder(port);
 #endif
+        return CB.in(CB.arg, port);
     }
 
-    unsigned char* registerPointerTable[8] = {&reg.pair.B, &reg.pair.C, &reg.pair.D, &reg.pair.E, &reg.pair.H, &reg.pair.L, &reg.pair.F, &reg.pair.A};
-    inline unsigned char* getRegisterPointer(unsigned char r) { return registerPointerTable[r]; }
-    inline unsigned char getRegister(unsigned char r) { return *registerPointerTable[r]; }
+    inline unsigned short getPort16WithB(unsigned char c) { return make16BitsFromLE(c, reg.pair.B); }
+    inline unsigned short getPort16WithA(unsigned char c) { return make16BitsFromLE(c, reg.pair.A); }
 
-#ifndef Z80_DISABLE_DEBUG
-    inline char* registerDump(unsigned char r)
+    inline unsigned char inPortWithB(unsigned char port, int clock = 4)
     {
-        static char A[16];
-        static char B[16];
-        static char C[16];
-        static char D[16];
-        static char E[16];
-        static char H[16];
-        static char L[16];
-        static char F[16];
-        static char unknown[2];
-        switch (r & 0b111) {
-            case 0b111: snprintf(A, sizeof(A), "A<$%02X>", reg.pair.A); return A;
-            case 0b000: snprintf(B, sizeof(B), "B<$%02X>", reg.pair.B); return B;
-            case 0b001: snprintf(C, sizeof(C), "C<$%02X>", reg.pair.C); return C;
-            case 0b010: snprintf(D, sizeof(D), "D<$%02X>", reg.pair.D); return D;
-            case 0b011: snprintf(E, sizeof(E), "E<$%02X>", reg.pair.E); return E;
-            case 0b100: snprintf(H, sizeof(H), "H<$%02X>", reg.pair.H); return H;
-            case 0b101: snprintf(L, sizeof(L), "L<$%02X>", reg.pair.L); return L;
-            case 0b110: snprintf(F, sizeof(F), "F<$%02X>", reg.pair.F); return F;
-        }
-        unknown[0] = '?';
-        unknown[1] = '\0';
-        return unknown;
+#ifndef Z80_DISABLE_CONTENTION
+        contendPort(getPort16WithB(port));
+#endif
+#ifdef Z80_UNSUPPORT_16BIT_PORT
+        unsigned char byte = readPort(port);
+#else
+        unsigned char byte = readPort(CB.returnPortAs16Bits ? getPort16WithB(port) : port);
+#endif
+#ifndef Z80_DISABLE_BUSLOG
+        logBus(BusType::In, getPort16WithB(port), byte);
+#endif
+        consumeClock(clock);
+        return byte;
     }
 
-    inline char* conditionDump(Condition c)
+    inline unsigned char inPortWithA(unsigned char port, int clock = 4)
     {
-        static char CN[4];
-        switch (c) {
-            case Condition::NZ: strcpy(CN, "NZ"); break;
-            case Condition::Z: strcpy(CN, "Z"); break;
-            case Condition::NC: strcpy(CN, "NC"); break;
-            case Condition::C: strcpy(CN, "C"); break;
-            case Condition::NPV: strcpy(CN, "PO"); break;
-            case Condition::PV: strcpy(CN, "PE"); break;
-            case Condition::NS: strcpy(CN, "P"); break;
-            case Condition::S: strcpy(CN, "M"); break;
-        }
-        return CN;
-    }
-
-    inline char* relativeDump(unsigned short pc, signed char e)
-    {
-        static char buf[80];
-        if (e < 0) {
-            int ee = -e;
-            ee -= 2;
-            snprintf(buf, sizeof(buf), "$%04X - %d = $%04X", pc, ee, pc + e + 2);
-        } else {
-            snprintf(buf, sizeof(buf), "$%04X + %d = $%04X", pc, e + 2, pc + e + 2);
-        }
-        return buf;
-    }
-
-    inline char* registerDump2(unsigned char r)
-    {
-        static char A[16];
-        static char B[16];
-        static char C[16];
-        static char D[16];
-        static char E[16];
-        static char H[16];
-        static char L[16];
-        static char unknown[2] = "?";
-        switch (r) {
-            case 0b111: snprintf(A, sizeof(A), "A'<$%02X>", reg.back.A); return A;
-            case 0b000: snprintf(B, sizeof(B), "B'<$%02X>", reg.back.B); return B;
-            case 0b001: snprintf(C, sizeof(C), "C'<$%02X>", reg.back.C); return C;
-            case 0b010: snprintf(D, sizeof(D), "D'<$%02X>", reg.back.D); return D;
-            case 0b011: snprintf(E, sizeof(E), "E'<$%02X>", reg.back.E); return E;
-            case 0b100: snprintf(H, sizeof(H), "H'<$%02X>", reg.back.H); return H;
-            case 0b101: snprintf(L, sizeof(L), "L'<$%02X>", reg.back.L); return L;
-            default: return unknown;
-        }
-    }
-
-    inline char* registerPairDump(unsigned char ptn)
-    {
-        static char BC[16];
-        static char DE[16];
-        static char HL[16];
-        static char SP[16];
-        static char unknown[2] = "?";
-        switch (ptn & 0b11) {
-            case 0b00: snprintf(BC, sizeof(BC), "BC<$%02X%02X>", reg.pair.B, reg.pair.C); return BC;
-            case 0b01: snprintf(DE, sizeof(DE), "DE<$%02X%02X>", reg.pair.D, reg.pair.E); return DE;
-            case 0b10: snprintf(HL, sizeof(HL), "HL<$%02X%02X>", reg.pair.H, reg.pair.L); return HL;
-            case 0b11: snprintf(SP, sizeof(SP), "SP<$%04X>", reg.SP); return SP;
-            default: return unknown;
-        }
+#ifndef Z80_DISABLE_CONTENTION
+        contendPort(getPort16WithA(port));
+#endif
+#ifdef Z80_UNSUPPORT_16BIT_PORT
+        unsigned char byte = readPort(port);
+#else
+        unsigned char byte = readPort(CB.returnPortAs16Bits ? getPort16WithA(port) : port);
+#endif
+#ifndef Z80_DISABLE_BUSLOG
+        logBus(BusType::In, getPort16WithA(port), byte);
+#endif
+        consumeClock(clock);
+        return byte;
     }
 
-    inline char* registerPairDumpIX(unsigned char ptn)
+    inline void outPortWithB(unsigned char port, unsigned char value, int clock = 4)
     {
-        static char BC[16];
-        static char DE[16];
-        static char IX[16];
-        static char SP[16];
-        static char unknown[2] = "?";
-        switch (ptn & 0b11) {
-            case 0b00: snprintf(BC, sizeof(BC), "BC<$%02X%02X>", reg.pair.B, reg.pair.C); return BC;
-            case 0b01: snprintf(DE, sizeof(DE), "DE<$%02X%02X>", reg.pair.D, reg.pair.E); return DE;
-            case 0b10: snprintf(IX, sizeof(IX), "IX<$%04X>", reg.IX); return IX;
-            case 0b11: snprintf(SP, sizeof(SP), "SP<$%04X>", reg.SP); return SP;
-            default: return unknown;
-        }
+#ifndef Z80_DISABLE_CONTENTION
+        contendPort(getPort16WithB(port));
+#endif
+#ifdef Z80_UNSUPPORT_16BIT_PORT
+        if (!suppressOut) CB.out(CB.arg, port, value);
+#else
+        if (!suppressOut) CB.out(CB.arg, CB.returnPortAs16Bits ? getPort16WithB(port) : port, value);
+#endif
+#ifndef Z80_DISABLE_BUSLOG
+        logBus(BusType::Out, getPort16WithB(port), value);
+#endif
+        consumeClock(clock);
     }
 
-    inline char* registerPairDumpIY(unsigned char ptn)
+    inline void outPortWithA(unsigned char port, unsigned char value, int clock = 4)
     {
-        static char BC[16];
-        static char DE[16];
-        static char IY[16];
-        static char SP[16];
-        static char unknown[2] = "?";
-        switch (ptn & 0b11) {
-            case 0b00: snprintf(BC, sizeof(BC), "BC<$%02X%02X>", reg.pair.B, reg.pair.C); return BC;
-            case 0b01: snprintf(DE, sizeof(DE), "DE<$%02X%02X>", reg.pair.D, reg.pair.E); return DE;
-            case 0b10: snprintf(IY, sizeof(IY), "IY<$%04X>", reg.IY); return IY;
-            case 0b11: snprintf(SP, sizeof(SP), "SP<$%04X>", reg.SP); return SP;
-            default: return unknown;
-        }
-    }
+#ifndef Z80_DISABLE_CONTENTION
+        contendPort(getPort16WithA(port));
 #endif
-
-    // Load Reg. r1 with Reg. r2
-    static inline void LD_B_B(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b000); }
-    static inline void LD_B_C(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b001); }
-    static inline void LD_B_D(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b010); }
-    static inline void LD_B_E(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b011); }
-    static inline void LD_B_B_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b000, 2); }
-    static inline void LD_B_C_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b001, 2); }
-    static inline void LD_B_D_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b010, 2); }
-    static inline void LD_B_E_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b011, 2); }
-    static inline void LD_B_H(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b100); }
-    static inline void LD_B_L(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b101); }
-    static inline void LD_B_A(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b111); }
-    static inline void LD_C_B(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b000); }
-    static inline void LD_C_C(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b001); }
-    static inline void LD_C_D(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b010); }
-    static inline void LD_C_E(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b011); }
-    static inline void LD_B_A_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b111, 2); }
-    static inline void LD_C_B_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b000, 2); }
-    static inline void LD_C_C_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b001, 2); }
-    static inline void LD_C_D_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b010, 2); }
-    static inline void LD_C_E_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b011, 2); }
-    static inline void LD_C_H(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b100); }
-    static inline void LD_C_L(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b101); }
-    static inline void LD_C_A(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b111); }
-    static inline void LD_D_B(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b000); }
-    static inline void LD_D_C(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b001); }
-    static inline void LD_D_D(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b010); }
-    static inline void LD_D_E(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b011); }
-    static inline void LD_C_A_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b111, 2); }
-    static inline void LD_D_B_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b000, 2); }
-    static inline void LD_D_C_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b001, 2); }
-    static inline void LD_D_D_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b010, 2); }
-    static inline void LD_D_E_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b011, 2); }
-    static inline void LD_D_H(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b100); }
-    static inline void LD_D_L(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b101); }
-    static inline void LD_D_A(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b111); }
-    static inline void LD_E_B(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b000); }
-    static inline void LD_E_C(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b001); }
-    static inline void LD_E_D(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b010); }
-    static inline void LD_E_E(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b011); }
-    static inline void LD_D_A_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b111, 2); }
-    static inline void LD_E_B_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b000, 2); }
-    static inline void LD_E_C_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b001, 2); }
-    static inline void LD_E_D_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b010, 2); }
-    static inline void LD_E_E_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b011, 2); }
-    static inline void LD_E_H(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b100); }
-    static inline void LD_E_L(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b101); }
-    static inline void LD_E_A(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b111); }
-    static inline void LD_E_A_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b111, 2); }
-    static inline void LD_H_B(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b000); }
-    static inline void LD_H_C(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b001); }
-    static inline void LD_H_D(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b010); }
-    static inline void LD_H_E(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b011); }
-    static inline void LD_H_H(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b100); }
-    static inline void LD_H_L(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b101); }
-    static inline void LD_H_A(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b111); }
-    static inline void LD_L_B(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b000); }
-    static inline void LD_L_C(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b001); }
-    static inline void LD_L_D(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b010); }
-    static inline void LD_L_E(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b011); }
-    static inline void LD_L_H(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b100); }
-    static inline void LD_L_L(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b101); }
-    static inline void LD_L_A(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b111); }
-    static inline void LD_A_B(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b000); }
-    static inline void LD_A_C(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b001); }
-    static inline void LD_A_D(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b010); }
-    static inline void LD_A_E(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b011); }
-    static inline void LD_A_B_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b000, 2); }
-    static inline void LD_A_C_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b001, 2); }
-    static inline void LD_A_D_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b010, 2); }
-    static inline void LD_A_E_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b011, 2); }
-    static inline void LD_A_H(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b100); }
-    static inline void LD_A_L(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b101); }
-    static inline void LD_A_A(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b111); }
-    static inline void LD_A_A_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b111, 2); }
-    inline void LD_R1_R2(unsigned char r1, unsigned char r2, int counter = 1)
-    {
-        unsigned char* r1p = getRegisterPointer(r1);
-        unsigned char* r2p = getRegisterPointer(r2);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, %s", reg.PC - counter, registerDump(r1), registerDump(r2));
+#ifdef Z80_UNSUPPORT_16BIT_PORT
+        if (!suppressOut) CB.out(CB.arg, port, value);
+#else
+        if (!suppressOut) CB.out(CB.arg, CB.returnPortAs16Bits ? getPort16WithA(port) : port, value);
 #endif
-        if (r1p && r2p) *r1p = *r2p;
+#ifndef Z80_DISABLE_BUSLOG
+        logBus(BusType::Out, getPort16WithA(port), value);
+#endif
+        consumeClock(clock);
     }
 
-    // Load Reg. r with value n
-    static inline void LD_A_N(Z80* ctx) { ctx->LD_R_N(0b111); }
-    static inline void LD_B_N(Z80* ctx) { ctx->LD_R_N(0b000); }
-    static inline void LD_C_N(Z80* ctx) { ctx->LD_R_N(0b001); }
-    static inline void LD_D_N(Z80* ctx) { ctx->LD_R_N(0b010); }
-    static inline void LD_E_N(Z80* ctx) { ctx->LD_R_N(0b011); }
-    static inline void LD_H_N(Z80* ctx) { ctx->LD_R_N(0b100); }
-    static inline void LD_L_N(Z80* ctx) { ctx->LD_R_N(0b101); }
-    static inline void LD_A_N_3(Z80* ctx) { ctx->LD_R_N(0b111, 3); }
-    static inline void LD_B_N_3(Z80* ctx) { ctx->LD_R_N(0b000, 3); }
-    static inline void LD_C_N_3(Z80* ctx) { ctx->LD_R_N(0b001, 3); }
-    static inline void LD_D_N_3(Z80* ctx) { ctx->LD_R_N(0b010, 3); }
-    static inline void LD_E_N_3(Z80* ctx) { ctx->LD_R_N(0b011, 3); }
-    inline void LD_R_N(unsigned char r, int pc = 2)
+    static inline void NOP(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, $%02X", reg.PC - pc, registerDump(r), n);
+        if (ctx->isDebug()) ctx->log("[%04X] NOP", ctx->reg.PC - 1);
 #endif
-        if (rp) *rp = n;
     }
 
-    // Load Reg. IX(high) with value n
-    static inline void LD_IXH_N_(Z80* ctx) { ctx->LD_IXH_N(); }
-    inline void LD_IXH_N()
+    static inline void HALT(Z80* ctx)
     {
-        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXH, $%02X", reg.PC - 3, n);
+        if (ctx->isDebug()) ctx->log("[%04X] HALT", ctx->reg.PC - 1);
 #endif
-        setIXH(n);
+#ifndef Z80_DISABLE_TIMELINE
+        ctx->logTimeline(TimelineType::HaltBegin, (unsigned short)(ctx->reg.PC - 1));
+#endif
+        ctx->reg.IFF |= ctx->IFF_HALT();
     }
 
-    // Load Reg. IX(high) with value Reg.
-    static inline void LD_IXH_A(Z80* ctx) { ctx->LD_IXH_R(0b111); }
-    static inline void LD_IXH_B(Z80* ctx) { ctx->LD_IXH_R(0b000); }
-    static inline void LD_IXH_C(Z80* ctx) { ctx->LD_IXH_R(0b001); }
-    static inline void LD_IXH_D(Z80* ctx) { ctx->LD_IXH_R(0b010); }
-    static inline void LD_IXH_E(Z80* ctx) { ctx->LD_IXH_R(0b011); }
-    inline void LD_IXH_R(unsigned char r)
+    static inline void DI(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXH, %s", reg.PC - 2, registerDump(r));
+        if (ctx->isDebug()) ctx->log("[%04X] DI", ctx->reg.PC - 1);
 #endif
-        setIXH(*rp);
+        ctx->reg.IFF &= ~(ctx->IFF1() | ctx->IFF2());
     }
 
-    // Load Reg. IX(high) with value IX(high)
-    static inline void LD_IXH_IXH_(Z80* ctx) { ctx->LD_IXH_IXH(); }
-    inline void LD_IXH_IXH()
+    static inline void EI(Z80* ctx)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXH, IXH<$%02X>", reg.PC - 2, getIXH());
+        if (ctx->isDebug()) ctx->log("[%04X] EI", ctx->reg.PC - 1);
 #endif
+        ctx->reg.IFF |= ctx->IFF1() | ctx->IFF2();
+        ctx->reg.execEI = 1;
     }
 
-    // Load Reg. IX(high) with value IX(low)
-    static inline void LD_IXH_IXL_(Z80* ctx) { ctx->LD_IXH_IXL(); }
-    inline void LD_IXH_IXL()
+    static inline void IM0(Z80* ctx) { ctx->IM(0); }
+    static inline void IM1(Z80* ctx) { ctx->IM(1); }
+    static inline void IM2(Z80* ctx) { ctx->IM(2); }
+    inline void IM(unsigned char interrptMode)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXH, IXL<$%02X>", reg.PC - 2, getIXL());
+        if (isDebug()) log("[%04X] IM %d", reg.PC - 2, interrptMode);
 #endif
-        setIXH(getIXL());
+        reg.interrupt &= 0b11111100;
+        reg.interrupt |= interrptMode & 0b11;
     }
 
-    // Load Reg. IX(low) with value n
-    static inline void LD_IXL_N_(Z80* ctx) { ctx->LD_IXL_N(); }
-    inline void LD_IXL_N()
+    static inline void LD_A_I_(Z80* ctx) { ctx->LD_A_I(); }
+    inline void LD_A_I()
     {
-        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXL, $%02X", reg.PC - 3, n);
+        if (isDebug()) log("[%04X] LD A<$%02X>, I<$%02X>", reg.PC - 2, reg.pair.A, reg.I);
 #endif
-        setIXL(n);
+        reg.pair.A = reg.I;
+        setFlagPV(reg.IFF & IFF2());
+        consumeClock(1);
     }
 
-    // Load Reg. IX(low) with value Reg.
-    static inline void LD_IXL_A(Z80* ctx) { ctx->LD_IXL_R(0b111); }
-    static inline void LD_IXL_B(Z80* ctx) { ctx->LD_IXL_R(0b000); }
-    static inline void LD_IXL_C(Z80* ctx) { ctx->LD_IXL_R(0b001); }
-    static inline void LD_IXL_D(Z80* ctx) { ctx->LD_IXL_R(0b010); }
-    static inline void LD_IXL_E(Z80* ctx) { ctx->LD_IXL_R(0b011); }
-    inline void LD_IXL_R(unsigned char r)
+    static inline void LD_I_A_(Z80* ctx) { ctx->LD_I_A(); }
+    inline void LD_I_A()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXL, %s", reg.PC - 2, registerDump(r));
+        if (isDebug()) log("[%04X] LD I<$%02X>, A<$%02X>", reg.PC - 2, reg.I, reg.pair.A);
 #endif
-        setIXL(*rp);
+        reg.I = reg.pair.A;
+        consumeClock(1);
     }
 
-    // Load Reg. IX(low) with value IX(high)
-    static inline void LD_IXL_IXH_(Z80* ctx) { ctx->LD_IXL_IXH(); }
-    inline void LD_IXL_IXH()
+    static inline void LD_A_R_(Z80* ctx) { ctx->LD_A_R(); }
+    inline void LD_A_R()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXL, IXH<$%02X>", reg.PC - 2, getIXH());
+        if (isDebug()) log("[%04X] LD A<$%02X>, R<$%02X>", reg.PC - 2, reg.pair.A, reg.R);
 #endif
-        setIXL(getIXH());
+        reg.pair.A = reg.R;
+        setFlagPV(reg.IFF & IFF1());
+        consumeClock(1);
     }
 
-    // Load Reg. IX(low) with value IX(low)
-    static inline void LD_IXL_IXL_(Z80* ctx) { ctx->LD_IXL_IXL(); }
-    inline void LD_IXL_IXL()
+    static inline void LD_R_A_(Z80* ctx) { ctx->LD_R_A(); }
+    inline void LD_R_A()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IXL, IXL<$%02X>", reg.PC - 2, getIXL());
+        if (isDebug()) log("[%04X] LD R<$%02X>, A<$%02X>", reg.PC - 2, reg.R, reg.pair.A);
 #endif
+        reg.R = reg.pair.A;
+        consumeClock(1);
     }
 
-    // Load Reg. IY(high) with value n
-    static inline void LD_IYH_N_(Z80* ctx) { ctx->LD_IYH_N(); }
-    inline void LD_IYH_N()
+    static inline void OP_CB(Z80* ctx)
     {
-        unsigned char n = fetch(3);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYH, $%02X", reg.PC - 3, n);
+        unsigned char operandNumber = ctx->fetchM1(4 + ctx->wtc.fetchM);
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        ctx->countOpcode(1, operandNumber);
 #endif
-        setIYH(n);
+#ifndef Z80_DISABLE_BREAKPOINT
+        ctx->checkBreakOperandCB(operandNumber);
+#endif
+        ctx->opSetCB[operandNumber](ctx);
     }
 
-    // Load Reg. IY(high) with value Reg.
-    static inline void LD_IYH_A(Z80* ctx) { ctx->LD_IYH_R(0b111); }
-    static inline void LD_IYH_B(Z80* ctx) { ctx->LD_IYH_R(0b000); }
-    static inline void LD_IYH_C(Z80* ctx) { ctx->LD_IYH_R(0b001); }
-    static inline void LD_IYH_D(Z80* ctx) { ctx->LD_IYH_R(0b010); }
-    static inline void LD_IYH_E(Z80* ctx) { ctx->LD_IYH_R(0b011); }
-    inline void LD_IYH_R(unsigned char r)
+    static inline void OP_ED(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYH, %s", reg.PC - 2, registerDump(r));
+        unsigned char operandNumber = ctx->fetchM1(4 + ctx->wtc.fetchM);
+#ifndef Z80_NO_EXCEPTION
+        if (!ctx->opSetED[operandNumber]) {
+            char buf[80];
+            snprintf(buf, sizeof(buf), "detect an unknown operand (ED,%02X)", operandNumber);
+            throw std::runtime_error(buf);
+        }
 #endif
-        setIYH(*rp);
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        ctx->countOpcode(2, operandNumber);
+#endif
+#ifndef Z80_DISABLE_BREAKPOINT
+        ctx->checkBreakOperandED(operandNumber);
+#endif
+        ctx->opSetED[operandNumber](ctx);
     }
 
-    // Load Reg. IY(high) with value IY(high)
-    static inline void LD_IYH_IYH_(Z80* ctx) { ctx->LD_IYH_IYH(); }
-    inline void LD_IYH_IYH()
+    static inline void OP_IX(Z80* ctx)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYH, IYH<$%02X>", reg.PC - 2, getIYH());
+        unsigned char operandNumber = ctx->fetchM1(4 + ctx->wtc.fetchM);
+#ifndef Z80_NO_EXCEPTION
+        if (!ctx->opSetIX[operandNumber]) {
+            char buf[80];
+            snprintf(buf, sizeof(buf), "detect an unknown operand (DD,%02X)", operandNumber);
+            throw std::runtime_error(buf);
+        }
+#endif
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        ctx->countOpcode(3, operandNumber);
+#endif
+#ifndef Z80_DISABLE_BREAKPOINT
+        ctx->checkBreakOperandIX(operandNumber);
 #endif
+        ctx->opSetIX[operandNumber](ctx);
     }
 
-    // Load Reg. IY(high) with value IY(low)
-    static inline void LD_IYH_IYL_(Z80* ctx) { ctx->LD_IYH_IYL(); }
-    inline void LD_IYH_IYL()
+    static inline void OP_IY(Z80* ctx)
     {
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYH, IYL<$%02X>", reg.PC - 2, getIYL());
+        unsigned char operandNumber = ctx->fetchM1(4 + ctx->wtc.fetchM);
+#ifndef Z80_NO_EXCEPTION
+        if (!ctx->opSetIY[operandNumber]) {
+            char buf[80];
+            snprintf(buf, sizeof(buf), "detect an unknown operand (FD,%02X)", operandNumber);
+            throw std::runtime_error(buf);
+        }
 #endif
-        setIYH(getIYL());
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        ctx->countOpcode(4, operandNumber);
+#endif
+#ifndef Z80_DISABLE_BREAKPOINT
+        ctx->checkBreakOperandIY(operandNumber);
+#endif
+        ctx->opSetIY[operandNumber](ctx);
     }
 
-    // Load Reg. IY(low) with value n
-    static inline void LD_IYL_N_(Z80* ctx) { ctx->LD_IYL_N(); }
-    inline void LD_IYL_N()
+    static inline void OP_IX4(Z80* ctx)
     {
-        unsigned char n = fetch(3);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYL, $%02X", reg.PC - 3, n);
+        signed char op3 = (signed char)ctx->fetch(4);
+        unsigned char op4 = ctx->fetch(4);
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        ctx->countOpcode(5, op4);
 #endif
-        setIYL(n);
+#ifndef Z80_DISABLE_BREAKPOINT
+        ctx->checkBreakOperandIX4(op3, op4);
+#endif
+        ctx->opSetIX4[op4](ctx, op3);
     }
 
-    // Load Reg. IY(low) with value Reg.
-    static inline void LD_IYL_A(Z80* ctx) { ctx->LD_IYL_R(0b111); }
-    static inline void LD_IYL_B(Z80* ctx) { ctx->LD_IYL_R(0b000); }
-    static inline void LD_IYL_C(Z80* ctx) { ctx->LD_IYL_R(0b001); }
-    static inline void LD_IYL_D(Z80* ctx) { ctx->LD_IYL_R(0b010); }
-    static inline void LD_IYL_E(Z80* ctx) { ctx->LD_IYL_R(0b011); }
-    inline void LD_IYL_R(unsigned char r)
+    static inline void OP_IY4(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYL, %s", reg.PC - 2, registerDump(r));
+        signed char op3 = (signed char)ctx->fetch(4);
+        unsigned char op4 = ctx->fetch(4);
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        ctx->countOpcode(6, op4);
 #endif
-        setIYL(*rp);
+#ifndef Z80_DISABLE_BREAKPOINT
+        ctx->checkBreakOperandIY4(op3, op4);
+#endif
+        ctx->opSetIY4[op4](ctx, op3);
     }
 
-    // Load Reg. IY(low) with value IY(high)
-    static inline void LD_IYL_IYH_(Z80* ctx) { ctx->LD_IYL_IYH(); }
-    inline void LD_IYL_IYH()
+    // Load location (HL) with value n
+    static inline void LD_HL_N(Z80* ctx)
     {
+        unsigned char n = ctx->fetch(3);
+        unsigned short hl = ctx->getHL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYL, IYH<$%02X>", reg.PC - 2, getIYH());
+        if (ctx->isDebug()) ctx->log("[%04X] LD (HL<$%04X>), $%02X", ctx->reg.PC - 2, hl, n);
 #endif
-        setIYL(getIYH());
+        ctx->writeByte(hl, n, 3);
     }
 
-    // Load Reg. IY(low) with value IY(low)
-    static inline void LD_IYL_IYL_(Z80* ctx) { ctx->LD_IYL_IYL(); }
-    inline void LD_IYL_IYL()
+    // Load Acc. wth location (BC)
+    static inline void LD_A_BC(Z80* ctx)
     {
+        unsigned short addr = ctx->getBC();
+        unsigned char n = ctx->readByte(addr, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IYL, IYL<$%02X>", reg.PC - 2, getIYL());
+        if (ctx->isDebug()) ctx->log("[%04X] LD A, (BC<$%02X%02X>) = $%02X", ctx->reg.PC - 1, ctx->reg.pair.B, ctx->reg.pair.C, n);
 #endif
+        ctx->reg.pair.A = n;
     }
 
-    // Load Reg. r with location (HL)
-    static inline void LD_B_HL(Z80* ctx) { ctx->LD_R_HL(0b000); }
-    static inline void LD_C_HL(Z80* ctx) { ctx->LD_R_HL(0b001); }
-    static inline void LD_D_HL(Z80* ctx) { ctx->LD_R_HL(0b010); }
-    static inline void LD_E_HL(Z80* ctx) { ctx->LD_R_HL(0b011); }
-    static inline void LD_H_HL(Z80* ctx) { ctx->LD_R_HL(0b100); }
-    static inline void LD_L_HL(Z80* ctx) { ctx->LD_R_HL(0b101); }
-    static inline void LD_A_HL(Z80* ctx) { ctx->LD_R_HL(0b111); }
-    inline void LD_R_HL(unsigned char r)
+    // Load Acc. wth location (DE)
+    static inline void LD_A_DE(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-        unsigned char n = readByte(getHL(), 3);
+        unsigned short addr = ctx->getDE();
+        unsigned char n = ctx->readByte(addr, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, (%s) = $%02X", reg.PC - 1, registerDump(r), registerPairDump(0b10), n);
+        if (ctx->isDebug()) ctx->log("[%04X] LD A, (DE<$%02X%02X>) = $%02X", ctx->reg.PC - 1, ctx->reg.pair.D, ctx->reg.pair.E, n);
 #endif
-        if (rp) *rp = n;
+        ctx->reg.pair.A = n;
     }
 
-    // Load Reg. r with location (IX+d)
-    static inline void LD_A_IX(Z80* ctx) { ctx->LD_R_IX(0b111); }
-    static inline void LD_B_IX(Z80* ctx) { ctx->LD_R_IX(0b000); }
-    static inline void LD_C_IX(Z80* ctx) { ctx->LD_R_IX(0b001); }
-    static inline void LD_D_IX(Z80* ctx) { ctx->LD_R_IX(0b010); }
-    static inline void LD_E_IX(Z80* ctx) { ctx->LD_R_IX(0b011); }
-    static inline void LD_H_IX(Z80* ctx) { ctx->LD_R_IX(0b100); }
-    static inline void LD_L_IX(Z80* ctx) { ctx->LD_R_IX(0b101); }
-    inline void LD_R_IX(unsigned char r)
+    // Load Acc. wth location (nn)
+    static inline void LD_A_NN(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-        signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((reg.IX + d) & 0xFFFF);
+        unsigned char l = ctx->fetch(3);
+        unsigned char h = ctx->fetch(3);
+        unsigned short addr = ctx->make16BitsFromLE(l, h);
+        unsigned char n = ctx->readByte(addr, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, (IX<$%04X>+$%02X) = $%02X", reg.PC - 3, registerDump(r), reg.IX, d, n);
+        if (ctx->isDebug()) ctx->log("[%04X] LD A, ($%04X) = $%02X", ctx->reg.PC - 3, addr, n);
 #endif
-        if (rp) *rp = n;
-        consumeClock(3);
+        ctx->reg.pair.A = n;
     }
 
-    // Load Reg. r with IXH
-    static inline void LD_A_IXH(Z80* ctx) { ctx->LD_R_IXH(0b111); }
-    static inline void LD_B_IXH(Z80* ctx) { ctx->LD_R_IXH(0b000); }
-    static inline void LD_C_IXH(Z80* ctx) { ctx->LD_R_IXH(0b001); }
-    static inline void LD_D_IXH(Z80* ctx) { ctx->LD_R_IXH(0b010); }
-    static inline void LD_E_IXH(Z80* ctx) { ctx->LD_R_IXH(0b011); }
-    inline void LD_R_IXH(unsigned char r)
+    // Load location (BC) wtih Acc.
+    static inline void LD_BC_A(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
+        unsigned short addr = ctx->getBC();
+        unsigned char n = ctx->reg.pair.A;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, IXH<$%02X>", reg.PC - 2, registerDump(r), getIXH());
+        if (ctx->isDebug()) ctx->log("[%04X] LD (BC<$%02X%02X>), A<$%02X>", ctx->reg.PC - 1, ctx->reg.pair.B, ctx->reg.pair.C, n);
 #endif
-        if (rp) *rp = getIXH();
+        ctx->writeByte(addr, n, 3);
     }
 
-    // Load Reg. r with IXL
-    static inline void LD_A_IXL(Z80* ctx) { ctx->LD_R_IXL(0b111); }
-    static inline void LD_B_IXL(Z80* ctx) { ctx->LD_R_IXL(0b000); }
-    static inline void LD_C_IXL(Z80* ctx) { ctx->LD_R_IXL(0b001); }
-    static inline void LD_D_IXL(Z80* ctx) { ctx->LD_R_IXL(0b010); }
-    static inline void LD_E_IXL(Z80* ctx) { ctx->LD_R_IXL(0b011); }
-    inline void LD_R_IXL(unsigned char r)
+    // Load location (DE) wtih Acc.
+    static inline void LD_DE_A(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
+        unsigned short addr = ctx->getDE();
+        unsigned char n = ctx->reg.pair.A;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, IXL<$%02X>", reg.PC - 2, registerDump(r), getIXL());
+        if (ctx->isDebug()) ctx->log("[%04X] LD (DE<$%02X%02X>), A<$%02X>", ctx->reg.PC - 1, ctx->reg.pair.D, ctx->reg.pair.E, n);
 #endif
-        if (rp) *rp = getIXL();
+        ctx->writeByte(addr, n, 3);
     }
 
-    // Load Reg. r with location (IY+d)
-    static inline void LD_A_IY(Z80* ctx) { ctx->LD_R_IY(0b111); }
-    static inline void LD_B_IY(Z80* ctx) { ctx->LD_R_IY(0b000); }
-    static inline void LD_C_IY(Z80* ctx) { ctx->LD_R_IY(0b001); }
-    static inline void LD_D_IY(Z80* ctx) { ctx->LD_R_IY(0b010); }
-    static inline void LD_E_IY(Z80* ctx) { ctx->LD_R_IY(0b011); }
-    static inline void LD_H_IY(Z80* ctx) { ctx->LD_R_IY(0b100); }
-    static inline void LD_L_IY(Z80* ctx) { ctx->LD_R_IY(0b101); }
-    inline void LD_R_IY(unsigned char r)
+    // Load location (nn) with Acc.
+    static inline void LD_NN_A(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-        signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((reg.IY + d) & 0xFFFF);
+        unsigned char l = ctx->fetch(3);
+        unsigned char h = ctx->fetch(3);
+        unsigned short addr = ctx->make16BitsFromLE(l, h);
+        unsigned char n = ctx->reg.pair.A;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, (IY<$%04X>+$%02X) = $%02X", reg.PC - 3, registerDump(r), reg.IY, d, n);
+        if (ctx->isDebug()) ctx->log("[%04X] LD ($%04X), A<$%02X>", ctx->reg.PC - 3, addr, n);
 #endif
-        if (rp) *rp = n;
-        consumeClock(3);
+        ctx->writeByte(addr, n, 3);
     }
 
-    // Load Reg. r with IYH
-    static inline void LD_A_IYH(Z80* ctx) { ctx->LD_R_IYH(0b111); }
-    static inline void LD_B_IYH(Z80* ctx) { ctx->LD_R_IYH(0b000); }
-    static inline void LD_C_IYH(Z80* ctx) { ctx->LD_R_IYH(0b001); }
-    static inline void LD_D_IYH(Z80* ctx) { ctx->LD_R_IYH(0b010); }
-    static inline void LD_E_IYH(Z80* ctx) { ctx->LD_R_IYH(0b011); }
-    inline void LD_R_IYH(unsigned char r)
+    // Load HL with location (nn).
+    static inline void LD_HL_ADDR(Z80* ctx)
     {
-        unsigned char iyh = getIYH();
-        unsigned char* rp = getRegisterPointer(r);
+        unsigned char l = ctx->fetch(3);
+        unsigned char h = ctx->fetch(3);
+        unsigned short addr = ctx->make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, IYH<$%02X>", reg.PC - 2, registerDump(r), iyh);
+        unsigned short hl = ctx->getHL();
+#endif
+        ctx->reg.pair.L = ctx->readByte(addr, 3);
+        ctx->reg.pair.H = ctx->readByte(addr + 1, 3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] LD HL<$%04X>, ($%04X) = $%04X", ctx->reg.PC - 3, hl, addr, ctx->getHL());
 #endif
-        if (rp) *rp = iyh;
     }
 
-    // Load Reg. r with IYL
-    static inline void LD_A_IYL(Z80* ctx) { ctx->LD_R_IYL(0b111); }
-    static inline void LD_B_IYL(Z80* ctx) { ctx->LD_R_IYL(0b000); }
-    static inline void LD_C_IYL(Z80* ctx) { ctx->LD_R_IYL(0b001); }
-    static inline void LD_D_IYL(Z80* ctx) { ctx->LD_R_IYL(0b010); }
-    static inline void LD_E_IYL(Z80* ctx) { ctx->LD_R_IYL(0b011); }
-    inline void LD_R_IYL(unsigned char r)
+    // Load location (nn) with HL.
+    static inline void LD_ADDR_HL(Z80* ctx)
     {
-        unsigned char iyl = getIYL();
-        unsigned char* rp = getRegisterPointer(r);
+        unsigned char l = ctx->fetch(3);
+        unsigned char h = ctx->fetch(3);
+        unsigned short addr = ctx->make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, IYL<$%02X>", reg.PC - 2, registerDump(r), iyl);
+        if (ctx->isDebug()) ctx->log("[%04X] LD ($%04X), %s", ctx->reg.PC - 3, addr, ctx->registerPairDump(0b10));
 #endif
-        if (rp) *rp = iyl;
+        ctx->writeByte(addr, ctx->reg.pair.L, 3);
+        ctx->writeByte(addr + 1, ctx->reg.pair.H, 3);
     }
 
-    // Load location (HL) with Reg. r
-    static inline void LD_HL_B(Z80* ctx) { ctx->LD_HL_R(0b000); }
-    static inline void LD_HL_C(Z80* ctx) { ctx->LD_HL_R(0b001); }
-    static inline void LD_HL_D(Z80* ctx) { ctx->LD_HL_R(0b010); }
-    static inline void LD_HL_E(Z80* ctx) { ctx->LD_HL_R(0b011); }
-    static inline void LD_HL_H(Z80* ctx) { ctx->LD_HL_R(0b100); }
-    static inline void LD_HL_L(Z80* ctx) { ctx->LD_HL_R(0b101); }
-    static inline void LD_HL_A(Z80* ctx) { ctx->LD_HL_R(0b111); }
-    inline void LD_HL_R(unsigned char r)
+    // Load SP with HL.
+    static inline void LD_SP_HL(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-        unsigned short addr = getHL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD (%s), %s", reg.PC - 1, registerPairDump(0b10), registerDump(r));
+        if (ctx->isDebug()) ctx->log("[%04X] LD %s, HL<$%04X>", ctx->reg.PC - 1, ctx->registerPairDump(0b11), ctx->getHL());
 #endif
-        writeByte(addr, *rp, 3);
+        ctx->reg.SP = ctx->getHL();
+        ctx->consumeClock(2);
     }
 
-    // 	Load location (IX+d) with Reg. r
-    static inline void LD_IX_A(Z80* ctx) { ctx->LD_IX_R(0b111); }
-    static inline void LD_IX_B(Z80* ctx) { ctx->LD_IX_R(0b000); }
-    static inline void LD_IX_C(Z80* ctx) { ctx->LD_IX_R(0b001); }
-    static inline void LD_IX_D(Z80* ctx) { ctx->LD_IX_R(0b010); }
-    static inline void LD_IX_E(Z80* ctx) { ctx->LD_IX_R(0b011); }
-    static inline void LD_IX_H(Z80* ctx) { ctx->LD_IX_R(0b100); }
-    static inline void LD_IX_L(Z80* ctx) { ctx->LD_IX_R(0b101); }
-    inline void LD_IX_R(unsigned char r)
+    // Exchange H and L with D and E
+    static inline void EX_DE_HL(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned short de = ctx->getDE();
+        unsigned short hl = ctx->getHL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD (IX<$%04X>+$%02X), %s", reg.PC - 3, reg.IX, d, registerDump(r));
+        if (ctx->isDebug()) ctx->log("[%04X] EX %s, %s", ctx->reg.PC - 1, ctx->registerPairDump(0b01), ctx->registerPairDump(0b10));
 #endif
-        if (rp) writeByte(addr, *rp);
-        consumeClock(3);
+        ctx->setDE(hl);
+        ctx->setHL(de);
     }
 
-    // 	Load location (IY+d) with Reg. r
-    static inline void LD_IY_A(Z80* ctx) { ctx->LD_IY_R(0b111); }
-    static inline void LD_IY_B(Z80* ctx) { ctx->LD_IY_R(0b000); }
-    static inline void LD_IY_C(Z80* ctx) { ctx->LD_IY_R(0b001); }
-    static inline void LD_IY_D(Z80* ctx) { ctx->LD_IY_R(0b010); }
-    static inline void LD_IY_E(Z80* ctx) { ctx->LD_IY_R(0b011); }
-    static inline void LD_IY_H(Z80* ctx) { ctx->LD_IY_R(0b100); }
-    static inline void LD_IY_L(Z80* ctx) { ctx->LD_IY_R(0b101); }
-    inline void LD_IY_R(unsigned char r)
+    // Exchange A and F with A' and F'
+    static inline void EX_AF_AF2(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned short af = ctx->getAF();
+        unsigned short af2 = ctx->getAF2();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD (IY<$%04X>+$%02X), %s", reg.PC - 3, reg.IY, d, registerDump(r));
+        if (ctx->isDebug()) ctx->log("[%04X] EX AF<$%02X%02X>, AF'<$%02X%02X>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->reg.pair.F, ctx->reg.back.A, ctx->reg.back.F);
 #endif
-        if (rp) writeByte(addr, *rp);
-        consumeClock(3);
+        ctx->setAF(af2);
+        ctx->setAF2(af);
     }
 
-    // Load location (IX+d) with value n
-    static inline void LD_IX_N_(Z80* ctx) { ctx->LD_IX_N(); }
-    inline void LD_IX_N()
+    static inline void EX_SP_HL(Z80* ctx)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned char n = fetch(4);
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        writeByte(addr, n, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD (IX<$%04X>+$%02X), $%02X", reg.PC - 4, reg.IX, d, n);
+        unsigned short sp = ctx->reg.SP;
+#endif
+        unsigned char l = ctx->pop(4);
+        unsigned char h = ctx->pop(4);
+#ifndef Z80_DISABLE_DEBUG
+        unsigned short hl = ctx->getHL();
+        if (ctx->isDebug()) ctx->log("[%04X] EX (SP<$%04X>) = $%02X%02X, HL<$%04X>", ctx->reg.PC - 1, sp, h, l, hl);
 #endif
+        ctx->push(ctx->reg.pair.H, 4);
+        ctx->reg.pair.H = h;
+        ctx->push(ctx->reg.pair.L, 3);
+        ctx->reg.pair.L = l;
     }
 
-    // Load location (IY+d) with value n
-    static inline void LD_IY_N_(Z80* ctx) { ctx->LD_IY_N(); }
-    inline void LD_IY_N()
+    static inline void EXX(Z80* ctx)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned char n = fetch(4);
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        writeByte(addr, n, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD (IY<$%04X>+$%02X), $%02X", reg.PC - 4, reg.IY, d, n);
+        if (ctx->isDebug()) ctx->log("[%04X] EXX", ctx->reg.PC - 1);
 #endif
+        unsigned short bc = ctx->getBC();
+        unsigned short bc2 = ctx->getBC2();
+        unsigned short de = ctx->getDE();
+        unsigned short de2 = ctx->getDE2();
+        unsigned short hl = ctx->getHL();
+        unsigned short hl2 = ctx->getHL2();
+        ctx->setBC(bc2);
+        ctx->setBC2(bc);
+        ctx->setDE(de2);
+        ctx->setDE2(de);
+        ctx->setHL(hl2);
+        ctx->setHL2(hl);
     }
 
-    // Load Reg. pair rp with value nn.
-    static inline void LD_BC_NN(Z80* ctx) { ctx->LD_RP_NN(0b00); }
-    static inline void LD_DE_NN(Z80* ctx) { ctx->LD_RP_NN(0b01); }
-    static inline void LD_HL_NN(Z80* ctx) { ctx->LD_RP_NN(0b10); }
-    static inline void LD_SP_NN(Z80* ctx) { ctx->LD_RP_NN(0b11); }
-    inline void LD_RP_NN(unsigned char rp)
+    inline void push(unsigned char value, int clocks)
+    {
+        reg.SP--;
+        writeByte(reg.SP, value, clocks);
+    }
+
+    inline unsigned char pop(int clocks)
+    {
+        unsigned char value = readByte(reg.SP, clocks);
+        reg.SP++;
+        return value;
+    }
+
+    static inline void PUSH_AF(Z80* ctx)
     {
-        unsigned char* rH;
-        unsigned char* rL;
-        switch (rp) {
-            case 0b00:
-                rH = &reg.pair.B;
-                rL = &reg.pair.C;
-                break;
-            case 0b01:
-                rH = &reg.pair.D;
-                rL = &reg.pair.E;
-                break;
-            case 0b10:
-                rH = &reg.pair.H;
-                rL = &reg.pair.L;
-                break;
-            case 0b11: {
-                // SP is not managed in pair structure, so calculate directly
 #ifndef Z80_DISABLE_DEBUG
-                unsigned short sp = reg.SP;
+        if (ctx->isDebug()) ctx->log("[%04X] PUSH AF<$%02X%02X> <SP:$%04X>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->reg.pair.F, ctx->reg.SP);
 #endif
-                setSPL(fetch(3));
-                setSPH(fetch(3));
+        ctx->push(ctx->reg.pair.A, 4);
+        ctx->push(ctx->reg.pair.F, 3);
+    }
+
+    static inline void POP_AF(Z80* ctx)
+    {
+        ctx->reg.pair.F = ctx->pop(3);
+        ctx->reg.pair.A = ctx->pop(3);
 #ifndef Z80_DISABLE_DEBUG
-                if (isDebug()) log("[%04X] LD SP<$%04X>, $%04X", reg.PC - 3, sp, reg.SP);
+        if (ctx->isDebug()) ctx->log("[%04X] POP AF <SP:$%04X> = $%04X", ctx->reg.PC - 1, ctx->reg.SP - 2, ctx->getAF());
 #endif
-                return;
-            }
-            default:
+    }
+
+    unsigned char* registerPointerTable[8] = {&reg.pair.B, &reg.pair.C, &reg.pair.D, &reg.pair.E, &reg.pair.H, &reg.pair.L, &reg.pair.F, &reg.pair.A};
+    inline unsigned char* getRegisterPointer(unsigned char r) { return registerPointerTable[r]; }
+    inline unsigned char getRegister(unsigned char r) { return *registerPointerTable[r]; }
+
 #ifndef Z80_DISABLE_DEBUG
-                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
-#endif
-#ifndef Z80_NO_EXCEPTION
-                throw std::runtime_error("invalid register pair has specified");
-#endif
-                return;
+    // per-instance buffers of the debug formatters (reentrant with the other instances)
+    struct DumpBuffer {
+        char reg[8][16];
+        char back[8][16];
+        char pair[4][16];
+        char pairIX[4][16];
+        char pairIY[4][16];
+        char relative[80];
+    } dumpBuffer;
+
+    inline const char* registerDump(unsigned char r)
+    {
+        char* buf = dumpBuffer.reg[r & 0b111];
+        switch (r & 0b111) {
+            case 0b111: snprintf(buf, 16, "A<$%02X>", reg.pair.A); break;
+            case 0b000: snprintf(buf, 16, "B<$%02X>", reg.pair.B); break;
+            case 0b001: snprintf(buf, 16, "C<$%02X>", reg.pair.C); break;
+            case 0b010: snprintf(buf, 16, "D<$%02X>", reg.pair.D); break;
+            case 0b011: snprintf(buf, 16, "E<$%02X>", reg.pair.E); break;
+            case 0b100: snprintf(buf, 16, "H<$%02X>", reg.pair.H); break;
+            case 0b101: snprintf(buf, 16, "L<$%02X>", reg.pair.L); break;
+            case 0b110: snprintf(buf, 16, "F<$%02X>", reg.pair.F); break;
         }
-#ifndef Z80_DISABLE_DEBUG
-        const char* dump = isDebug() ? registerPairDump(rp) : "";
-#endif
-        unsigned char nL = fetch(3);
-        *rL = nL;
-        unsigned char nH = fetch(3);
-        *rH = nH;
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, $%02X%02X", reg.PC - 3, dump, nH, nL);
-#endif
+        return buf;
     }
 
-    static inline void LD_IX_NN_(Z80* ctx) { ctx->LD_IX_NN(); }
-    inline void LD_IX_NN()
+    inline const char* conditionDump(Condition c)
     {
-        setIXL(fetch(3));
-        setIXH(fetch(3));
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IX, $%04X", reg.PC - 4, reg.IX);
-#endif
+        switch (c) {
+            case Condition::NZ: return "NZ";
+            case Condition::Z: return "Z";
+            case Condition::NC: return "NC";
+            case Condition::C: return "C";
+            case Condition::NPV: return "PO";
+            case Condition::PV: return "PE";
+            case Condition::NS: return "P";
+            case Condition::S: return "M";
+        }
+        return "?";
     }
 
-    static inline void LD_IY_NN_(Z80* ctx) { ctx->LD_IY_NN(); }
-    inline void LD_IY_NN()
+    inline const char* relativeDump(unsigned short pc, signed char e)
     {
-        setIYL(fetch(3));
-        setIYH(fetch(3));
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IY, $%04X", reg.PC - 4, reg.IY);
-#endif
+        char* buf = dumpBuffer.relative;
+        if (e < 0) {
+            int ee = -e;
+            ee -= 2;
+            snprintf(buf, sizeof(dumpBuffer.relative), "$%04X - %d = $%04X", pc, ee, pc + e + 2);
+        } else {
+            snprintf(buf, sizeof(dumpBuffer.relative), "$%04X + %d = $%04X", pc, e + 2, pc + e + 2);
+        }
+        return buf;
     }
 
-    // Load Reg. pair rp with location (nn)
-    static inline void LD_RP_ADDR_BC(Z80* ctx) { ctx->LD_RP_ADDR(0b00); }
-    static inline void LD_RP_ADDR_DE(Z80* ctx) { ctx->LD_RP_ADDR(0b01); }
-    static inline void LD_RP_ADDR_HL(Z80* ctx) { ctx->LD_RP_ADDR(0b10); }
-    static inline void LD_RP_ADDR_SP(Z80* ctx) { ctx->LD_RP_ADDR(0b11); }
-    inline void LD_RP_ADDR(unsigned char rp)
+    inline const char* registerDump2(unsigned char r)
     {
-        unsigned char l = fetch(3);
-        unsigned char h = fetch(3);
-        unsigned short addr = make16BitsFromLE(l, h);
-        unsigned char* rL;
-        unsigned char* rH;
-        switch (rp) {
-            case 0:
-                rH = &reg.pair.B;
-                rL = &reg.pair.C;
-                break;
-            case 1:
-                rH = &reg.pair.D;
-                rL = &reg.pair.E;
-                break;
-            case 2:
-                rH = &reg.pair.H;
-                rL = &reg.pair.L;
-                break;
-            case 3: {
-#ifndef Z80_DISABLE_DEBUG
-                const char* dump = isDebug() ? registerPairDump(rp) : "";
-#endif
-                setSPL(readByte(addr, 3));
-                setSPH(readByte(addr + 1, 3));
-                reg.WZ = addr + 1;
-#ifndef Z80_DISABLE_DEBUG
-                if (isDebug()) log("[%04X] LD %s, ($%04X) = $%04X", reg.PC - 4, dump, addr, reg.SP);
-#endif
-                return;
-            }
-            default:
-#ifndef Z80_DISABLE_DEBUG
-                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
-#endif
-#ifndef Z80_NO_EXCEPTION
-                throw std::runtime_error("invalid register pair has specified");
-#endif
-                return;
+        char* buf = dumpBuffer.back[r & 0b111];
+        switch (r) {
+            case 0b111: snprintf(buf, 16, "A'<$%02X>", reg.back.A); return buf;
+            case 0b000: snprintf(buf, 16, "B'<$%02X>", reg.back.B); return buf;
+            case 0b001: snprintf(buf, 16, "C'<$%02X>", reg.back.C); return buf;
+            case 0b010: snprintf(buf, 16, "D'<$%02X>", reg.back.D); return buf;
+            case 0b011: snprintf(buf, 16, "E'<$%02X>", reg.back.E); return buf;
+            case 0b100: snprintf(buf, 16, "H'<$%02X>", reg.back.H); return buf;
+            case 0b101: snprintf(buf, 16, "L'<$%02X>", reg.back.L); return buf;
+            default: return "?";
         }
-#ifndef Z80_DISABLE_DEBUG
-        const char* dump = isDebug() ? registerPairDump(rp) : "";
-#endif
-        *rL = readByte(addr, 3);
-        *rH = readByte(addr + 1, 3);
-        reg.WZ = addr + 1;
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, ($%04X) = $%04X", reg.PC - 4, dump, addr, make16BitsFromLE(*rL, *rH));
-#endif
     }
 
-    // Load location (nn) with Reg. pair rp.
-    static inline void LD_ADDR_RP_BC(Z80* ctx) { ctx->LD_ADDR_RP(0b00); }
-    static inline void LD_ADDR_RP_DE(Z80* ctx) { ctx->LD_ADDR_RP(0b01); }
-    static inline void LD_ADDR_RP_HL(Z80* ctx) { ctx->LD_ADDR_RP(0b10); }
-    static inline void LD_ADDR_RP_SP(Z80* ctx) { ctx->LD_ADDR_RP(0b11); }
-    inline void LD_ADDR_RP(unsigned char rp)
+    inline const char* registerPairDump(unsigned char ptn)
     {
-        unsigned char l = fetch(3);
-        unsigned char h = fetch(3);
-        unsigned short addr = make16BitsFromLE(l, h);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD ($%04X), %s", reg.PC - 4, addr, registerPairDump(rp));
-#endif
-        switch (rp) {
-            case 0b00:
-                h = reg.pair.B;
-                l = reg.pair.C;
-                break;
-            case 0b01:
-                h = reg.pair.D;
-                l = reg.pair.E;
-                break;
-            case 0b10:
-                h = reg.pair.H;
-                l = reg.pair.L;
-                break;
-            case 0b11:
-                splitTo8BitsPair(reg.SP, &h, &l);
-                break;
-            default:
-#ifndef Z80_DISABLE_DEBUG
-                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
+        char* buf = dumpBuffer.pair[ptn & 0b11];
+        switch (ptn & 0b11) {
+            case 0b00: snprintf(buf, 16, "BC<$%02X%02X>", reg.pair.B, reg.pair.C); break;
+            case 0b01: snprintf(buf, 16, "DE<$%02X%02X>", reg.pair.D, reg.pair.E); break;
+            case 0b10: snprintf(buf, 16, "HL<$%02X%02X>", reg.pair.H, reg.pair.L); break;
+            case 0b11: snprintf(buf, 16, "SP<$%04X>", reg.SP); break;
+        }
+        return buf;
+    }
+
+    inline const char* registerPairDumpIX(unsigned char ptn)
+    {
+        char* buf = dumpBuffer.pairIX[ptn & 0b11];
+        switch (ptn & 0b11) {
+            case 0b00: snprintf(buf, 16, "BC<$%02X%02X>", reg.pair.B, reg.pair.C); break;
+            case 0b01: snprintf(buf, 16, "DE<$%02X%02X>", reg.pair.D, reg.pair.E); break;
+            case 0b10: snprintf(buf, 16, "IX<$%04X>", reg.IX); break;
+            case 0b11: snprintf(buf, 16, "SP<$%04X>", reg.SP); break;
+        }
+        return buf;
+    }
+
+    inline const char* registerPairDumpIY(unsigned char ptn)
+    {
+        char* buf = dumpBuffer.pairIY[ptn & 0b11];
+        switch (ptn & 0b11) {
+            case 0b00: snprintf(buf, 16, "BC<$%02X%02X>", reg.pair.B, reg.pair.C); break;
+            case 0b01: snprintf(buf, 16, "DE<$%02X%02X>", reg.pair.D, reg.pair.E); break;
+            case 0b10: snprintf(buf, 16, "IY<$%04X>", reg.IY); break;
+            case 0b11: snprintf(buf, 16, "SP<$%04X>", reg.SP); break;
+        }
+        return buf;
+    }
 #endif
-#ifndef Z80_NO_EXCEPTION
-                throw std::runtime_error("invalid register pair has specified");
+
+    // Load Reg. r1 with Reg. r2
+    static inline void LD_B_B(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b000); }
+    static inline void LD_B_C(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b001); }
+    static inline void LD_B_D(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b010); }
+    static inline void LD_B_E(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b011); }
+    static inline void LD_B_B_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b000, 2); }
+    static inline void LD_B_C_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b001, 2); }
+    static inline void LD_B_D_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b010, 2); }
+    static inline void LD_B_E_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b011, 2); }
+    static inline void LD_B_H(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b100); }
+    static inline void LD_B_L(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b101); }
+    static inline void LD_B_A(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b111); }
+    static inline void LD_C_B(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b000); }
+    static inline void LD_C_C(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b001); }
+    static inline void LD_C_D(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b010); }
+    static inline void LD_C_E(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b011); }
+    static inline void LD_B_A_2(Z80* ctx) { ctx->LD_R1_R2(0b000, 0b111, 2); }
+    static inline void LD_C_B_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b000, 2); }
+    static inline void LD_C_C_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b001, 2); }
+    static inline void LD_C_D_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b010, 2); }
+    static inline void LD_C_E_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b011, 2); }
+    static inline void LD_C_H(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b100); }
+    static inline void LD_C_L(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b101); }
+    static inline void LD_C_A(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b111); }
+    static inline void LD_D_B(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b000); }
+    static inline void LD_D_C(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b001); }
+    static inline void LD_D_D(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b010); }
+    static inline void LD_D_E(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b011); }
+    static inline void LD_C_A_2(Z80* ctx) { ctx->LD_R1_R2(0b001, 0b111, 2); }
+    static inline void LD_D_B_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b000, 2); }
+    static inline void LD_D_C_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b001, 2); }
+    static inline void LD_D_D_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b010, 2); }
+    static inline void LD_D_E_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b011, 2); }
+    static inline void LD_D_H(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b100); }
+    static inline void LD_D_L(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b101); }
+    static inline void LD_D_A(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b111); }
+    static inline void LD_E_B(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b000); }
+    static inline void LD_E_C(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b001); }
+    static inline void LD_E_D(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b010); }
+    static inline void LD_E_E(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b011); }
+    static inline void LD_D_A_2(Z80* ctx) { ctx->LD_R1_R2(0b010, 0b111, 2); }
+    static inline void LD_E_B_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b000, 2); }
+    static inline void LD_E_C_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b001, 2); }
+    static inline void LD_E_D_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b010, 2); }
+    static inline void LD_E_E_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b011, 2); }
+    static inline void LD_E_H(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b100); }
+    static inline void LD_E_L(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b101); }
+    static inline void LD_E_A(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b111); }
+    static inline void LD_E_A_2(Z80* ctx) { ctx->LD_R1_R2(0b011, 0b111, 2); }
+    static inline void LD_H_B(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b000); }
+    static inline void LD_H_C(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b001); }
+    static inline void LD_H_D(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b010); }
+    static inline void LD_H_E(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b011); }
+    static inline void LD_H_H(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b100); }
+    static inline void LD_H_L(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b101); }
+    static inline void LD_H_A(Z80* ctx) { ctx->LD_R1_R2(0b100, 0b111); }
+    static inline void LD_L_B(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b000); }
+    static inline void LD_L_C(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b001); }
+    static inline void LD_L_D(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b010); }
+    static inline void LD_L_E(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b011); }
+    static inline void LD_L_H(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b100); }
+    static inline void LD_L_L(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b101); }
+    static inline void LD_L_A(Z80* ctx) { ctx->LD_R1_R2(0b101, 0b111); }
+    static inline void LD_A_B(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b000); }
+    static inline void LD_A_C(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b001); }
+    static inline void LD_A_D(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b010); }
+    static inline void LD_A_E(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b011); }
+    static inline void LD_A_B_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b000, 2); }
+    static inline void LD_A_C_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b001, 2); }
+    static inline void LD_A_D_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b010, 2); }
+    static inline void LD_A_E_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b011, 2); }
+    static inline void LD_A_H(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b100); }
+    static inline void LD_A_L(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b101); }
+    static inline void LD_A_A(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b111); }
+    static inline void LD_A_A_2(Z80* ctx) { ctx->LD_R1_R2(0b111, 0b111, 2); }
+    inline void LD_R1_R2(unsigned char r1, unsigned char r2, int counter = 1)
+    {
+        unsigned char* r1p = getRegisterPointer(r1);
+        unsigned char* r2p = getRegisterPointer(r2);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] LD %s, %s", reg.PC - counter, registerDump(r1), registerDump(r2));
 #endif
-                return;
-        }
-        writeByte(addr, l, 3);
-        writeByte(addr + 1, h, 3);
-        reg.WZ = addr + 1;
+        if (r1p && r2p) *r1p = *r2p;
     }
 
-    // Load IX with location (nn)
-    static inline void LD_IX_ADDR_(Z80* ctx) { ctx->LD_IX_ADDR(); }
-    inline void LD_IX_ADDR()
+    // Load Reg. r with value n
+    static inline void LD_A_N(Z80* ctx) { ctx->LD_R_N(0b111); }
+    static inline void LD_B_N(Z80* ctx) { ctx->LD_R_N(0b000); }
+    static inline void LD_C_N(Z80* ctx) { ctx->LD_R_N(0b001); }
+    static inline void LD_D_N(Z80* ctx) { ctx->LD_R_N(0b010); }
+    static inline void LD_E_N(Z80* ctx) { ctx->LD_R_N(0b011); }
+    static inline void LD_H_N(Z80* ctx) { ctx->LD_R_N(0b100); }
+    static inline void LD_L_N(Z80* ctx) { ctx->LD_R_N(0b101); }
+    static inline void LD_A_N_3(Z80* ctx) { ctx->LD_R_N(0b111, 3); }
+    static inline void LD_B_N_3(Z80* ctx) { ctx->LD_R_N(0b000, 3); }
+    static inline void LD_C_N_3(Z80* ctx) { ctx->LD_R_N(0b001, 3); }
+    static inline void LD_D_N_3(Z80* ctx) { ctx->LD_R_N(0b010, 3); }
+    static inline void LD_E_N_3(Z80* ctx) { ctx->LD_R_N(0b011, 3); }
+    inline void LD_R_N(unsigned char r, int pc = 2)
     {
-        unsigned char l = fetch(3);
-        unsigned char h = fetch(3);
-        unsigned short addr = make16BitsFromLE(l, h);
+        unsigned char* rp = getRegisterPointer(r);
+        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        unsigned short ix = reg.IX;
+        if (isDebug()) log("[%04X] LD %s, $%02X", reg.PC - pc, registerDump(r), n);
 #endif
-        setIXL(readByte(addr, 3));
-        setIXH(readByte(addr + 1, 3));
+        if (rp) *rp = n;
+    }
+
+    // Load Reg. IX(high) with value n
+    static inline void LD_IXH_N_(Z80* ctx) { ctx->LD_IXH_N(); }
+    inline void LD_IXH_N()
+    {
+        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IX<$%04X>, ($%04X) = $%04X", reg.PC - 4, ix, addr, reg.IX);
+        if (isDebug()) log("[%04X] LD IXH, $%02X", reg.PC - 3, n);
 #endif
+        setIXH(n);
     }
 
-    // Load IY with location (nn)
-    static inline void LD_IY_ADDR_(Z80* ctx) { ctx->LD_IY_ADDR(); }
-    inline void LD_IY_ADDR()
+    // Load Reg. IX(high) with value Reg.
+    static inline void LD_IXH_A(Z80* ctx) { ctx->LD_IXH_R(0b111); }
+    static inline void LD_IXH_B(Z80* ctx) { ctx->LD_IXH_R(0b000); }
+    static inline void LD_IXH_C(Z80* ctx) { ctx->LD_IXH_R(0b001); }
+    static inline void LD_IXH_D(Z80* ctx) { ctx->LD_IXH_R(0b010); }
+    static inline void LD_IXH_E(Z80* ctx) { ctx->LD_IXH_R(0b011); }
+    inline void LD_IXH_R(unsigned char r)
     {
-        unsigned char l = fetch(3);
-        unsigned char h = fetch(3);
-        unsigned short addr = make16BitsFromLE(l, h);
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        unsigned short iy = reg.IY;
+        if (isDebug()) log("[%04X] LD IXH, %s", reg.PC - 2, registerDump(r));
 #endif
-        setIYL(readByte(addr, 3));
-        setIYH(readByte(addr + 1, 3));
+        setIXH(*rp);
+    }
+
+    // Load Reg. IX(high) with value IX(high)
+    static inline void LD_IXH_IXH_(Z80* ctx) { ctx->LD_IXH_IXH(); }
+    inline void LD_IXH_IXH()
+    {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD IY<$%04X>, ($%04X) = $%04X", reg.PC - 4, iy, addr, reg.IY);
+        if (isDebug()) log("[%04X] LD IXH, IXH<$%02X>", reg.PC - 2, getIXH());
 #endif
     }
 
-    static inline void LD_ADDR_IX_(Z80* ctx) { ctx->LD_ADDR_IX(); }
-    inline void LD_ADDR_IX()
+    // Load Reg. IX(high) with value IX(low)
+    static inline void LD_IXH_IXL_(Z80* ctx) { ctx->LD_IXH_IXL(); }
+    inline void LD_IXH_IXL()
     {
-        unsigned char l = fetch(3);
-        unsigned char h = fetch(3);
-        unsigned short addr = make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD ($%04X), IX<$%04X>", reg.PC - 4, addr, reg.IX);
+        if (isDebug()) log("[%04X] LD IXH, IXL<$%02X>", reg.PC - 2, getIXL());
 #endif
-        writeByte(addr, getIXL(), 3);
-        writeByte(addr + 1, getIXH(), 3);
+        setIXH(getIXL());
     }
 
-    static inline void LD_ADDR_IY_(Z80* ctx) { ctx->LD_ADDR_IY(); }
-    inline void LD_ADDR_IY()
+    // Load Reg. IX(low) with value n
+    static inline void LD_IXL_N_(Z80* ctx) { ctx->LD_IXL_N(); }
+    inline void LD_IXL_N()
     {
-        unsigned char l = fetch(3);
-        unsigned char h = fetch(3);
-        unsigned short addr = make16BitsFromLE(l, h);
+        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD ($%04X), IY<$%04X>", reg.PC - 4, addr, reg.IY);
+        if (isDebug()) log("[%04X] LD IXL, $%02X", reg.PC - 3, n);
 #endif
-        writeByte(addr, getIYL(), 3);
-        writeByte(addr + 1, getIYH(), 3);
+        setIXL(n);
     }
 
-    // Load SP with IX.
-    static inline void LD_SP_IX_(Z80* ctx) { ctx->LD_SP_IX(); }
-    inline void LD_SP_IX()
+    // Load Reg. IX(low) with value Reg.
+    static inline void LD_IXL_A(Z80* ctx) { ctx->LD_IXL_R(0b111); }
+    static inline void LD_IXL_B(Z80* ctx) { ctx->LD_IXL_R(0b000); }
+    static inline void LD_IXL_C(Z80* ctx) { ctx->LD_IXL_R(0b001); }
+    static inline void LD_IXL_D(Z80* ctx) { ctx->LD_IXL_R(0b010); }
+    static inline void LD_IXL_E(Z80* ctx) { ctx->LD_IXL_R(0b011); }
+    inline void LD_IXL_R(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, IX<$%04X>", reg.PC - 2, registerPairDump(0b11), reg.IX);
+        if (isDebug()) log("[%04X] LD IXL, %s", reg.PC - 2, registerDump(r));
 #endif
-        reg.SP = reg.IX;
-        consumeClock(2);
+        setIXL(*rp);
     }
 
-    // Load SP with IY.
-    static inline void LD_SP_IY_(Z80* ctx) { ctx->LD_SP_IY(); }
-    inline void LD_SP_IY()
+    // Load Reg. IX(low) with value IX(high)
+    static inline void LD_IXL_IXH_(Z80* ctx) { ctx->LD_IXL_IXH(); }
+    inline void LD_IXL_IXH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] LD %s, IY<$%04X>", reg.PC - 2, registerPairDump(0b11), reg.IY);
+        if (isDebug()) log("[%04X] LD IXL, IXH<$%02X>", reg.PC - 2, getIXH());
 #endif
-        reg.SP = reg.IY;
-        consumeClock(2);
+        setIXL(getIXH());
     }
 
-    // Load location (DE) with Loacation (HL), increment/decrement DE, HL, decrement BC
-    inline void repeatLD(bool isIncDEHL, bool isRepeat)
+    // Load Reg. IX(low) with value IX(low)
+    static inline void LD_IXL_IXL_(Z80* ctx) { ctx->LD_IXL_IXL(); }
+    inline void LD_IXL_IXL()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) {
-            if (isIncDEHL) {
-                if (isDebug()) log("[%04X] %s ... %s, %s, %s", reg.PC - 2, isRepeat ? "LDIR" : "LDI", registerPairDump(0b00), registerPairDump(0b01), registerPairDump(0b10));
-            } else {
-                if (isDebug()) log("[%04X] %s ... %s, %s, %s", reg.PC - 2, isRepeat ? "LDDR" : "LDD", registerPairDump(0b00), registerPairDump(0b01), registerPairDump(0b10));
-            }
-        }
+        if (isDebug()) log("[%04X] LD IXL, IXL<$%02X>", reg.PC - 2, getIXL());
 #endif
-        unsigned short bc = getBC();
-        unsigned short de = getDE();
-        unsigned short hl = getHL();
-        unsigned char n = readByte(hl);
-        writeByte(de, n);
-        if (isIncDEHL) {
-            de++;
-            hl++;
-        } else {
-            de--;
-            hl--;
-        }
-        bc--;
-        setBC(bc);
-        setDE(de);
-        setHL(hl);
-        resetFlagH();
-        setFlagPV(bc != 0);
-        resetFlagN();
-        unsigned char an = reg.pair.A + n;
-        setFlagY(an & 0b00000010);
-        setFlagX(an & 0b00001000);
-        if (isRepeat && 0 != bc) {
-            reg.PC -= 2;
-            consumeClock(5);
-        }
     }
-    static inline void LDI(Z80* ctx) { ctx->repeatLD(true, false); }
-    static inline void LDIR(Z80* ctx) { ctx->repeatLD(true, true); }
-    static inline void LDD(Z80* ctx) { ctx->repeatLD(false, false); }
-    static inline void LDDR(Z80* ctx) { ctx->repeatLD(false, true); }
 
-    // Exchange stack top with IX
-    static inline void EX_SP_IX_(Z80* ctx) { ctx->EX_SP_IX(); }
-    inline void EX_SP_IX()
+    // Load Reg. IY(high) with value n
+    static inline void LD_IYH_N_(Z80* ctx) { ctx->LD_IYH_N(); }
+    inline void LD_IYH_N()
     {
+        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        unsigned short sp = reg.SP;
-#endif
-        unsigned char l = pop(4);
-        unsigned char h = pop(4);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] EX (SP<$%04X>) = $%02X%02X, IX<$%04X>", reg.PC - 2, sp, h, l, reg.IX);
+        if (isDebug()) log("[%04X] LD IYH, $%02X", reg.PC - 3, n);
 #endif
-        push(getIXH(), 4);
-        setIXH(h);
-        push(getIXL(), 3);
-        setIXL(l);
+        setIYH(n);
     }
 
-    // Exchange stack top with IY
-    static inline void EX_SP_IY_(Z80* ctx) { ctx->EX_SP_IY(); }
-    inline void EX_SP_IY()
+    // Load Reg. IY(high) with value Reg.
+    static inline void LD_IYH_A(Z80* ctx) { ctx->LD_IYH_R(0b111); }
+    static inline void LD_IYH_B(Z80* ctx) { ctx->LD_IYH_R(0b000); }
+    static inline void LD_IYH_C(Z80* ctx) { ctx->LD_IYH_R(0b001); }
+    static inline void LD_IYH_D(Z80* ctx) { ctx->LD_IYH_R(0b010); }
+    static inline void LD_IYH_E(Z80* ctx) { ctx->LD_IYH_R(0b011); }
+    inline void LD_IYH_R(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        unsigned short sp = reg.SP;
-#endif
-        unsigned char l = pop(4);
-        unsigned char h = pop(4);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] EX (SP<$%04X>) = $%02X%02X, IY<$%04X>", reg.PC - 2, sp, h, l, reg.IY);
+        if (isDebug()) log("[%04X] LD IYH, %s", reg.PC - 2, registerDump(r));
 #endif
-        push(getIYH(), 4);
-        setIYH(h);
-        push(getIYL(), 3);
-        setIYL(l);
+        setIYH(*rp);
     }
 
-    // Push Reg. on Stack.
-    static inline void PUSH_BC(Z80* ctx) { ctx->PUSH_RP(0b00); }
-    static inline void PUSH_DE(Z80* ctx) { ctx->PUSH_RP(0b01); }
-    static inline void PUSH_HL(Z80* ctx) { ctx->PUSH_RP(0b10); }
-    inline void PUSH_RP(unsigned char rp)
+    // Load Reg. IY(high) with value IY(high)
+    static inline void LD_IYH_IYH_(Z80* ctx) { ctx->LD_IYH_IYH(); }
+    inline void LD_IYH_IYH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] PUSH %s <SP:$%04X>", reg.PC - 1, registerPairDump(rp), reg.SP);
-#endif
-        switch (rp) {
-            case 0b00:
-                push(reg.pair.B, 4);
-                push(reg.pair.C, 3);
-                break;
-            case 0b01:
-                push(reg.pair.D, 4);
-                push(reg.pair.E, 3);
-                break;
-            case 0b10:
-                push(reg.pair.H, 4);
-                push(reg.pair.L, 3);
-                break;
-            default:
-#ifndef Z80_DISABLE_DEBUG
-                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
-#endif
-#ifdef Z80_NO_EXCEPTION
-                ;
-#else
-                throw std::runtime_error("invalid register pair has specified");
+        if (isDebug()) log("[%04X] LD IYH, IYH<$%02X>", reg.PC - 2, getIYH());
 #endif
-        }
     }
 
-    // Push Reg. on Stack.
-    static inline void POP_BC(Z80* ctx) { ctx->POP_RP(0b00); }
-    static inline void POP_DE(Z80* ctx) { ctx->POP_RP(0b01); }
-    static inline void POP_HL(Z80* ctx) { ctx->POP_RP(0b10); }
-    inline void POP_RP(unsigned char rp)
+    // Load Reg. IY(high) with value IY(low)
+    static inline void LD_IYH_IYL_(Z80* ctx) { ctx->LD_IYH_IYL(); }
+    inline void LD_IYH_IYL()
     {
 #ifndef Z80_DISABLE_DEBUG
-        unsigned short sp = reg.SP;
-        const char* dump = isDebug() ? registerPairDump(rp) : "";
-        unsigned short after;
-#endif
-        switch (rp) {
-            case 0b00:
-                reg.pair.C = pop(3);
-                reg.pair.B = pop(3);
-#ifndef Z80_DISABLE_DEBUG
-                after = getBC();
-#endif
-                break;
-            case 0b01:
-                reg.pair.E = pop(3);
-                reg.pair.D = pop(3);
-#ifndef Z80_DISABLE_DEBUG
-                after = getDE();
-#endif
-                break;
-            case 0b10:
-                reg.pair.L = pop(3);
-                reg.pair.H = pop(3);
-#ifndef Z80_DISABLE_DEBUG
-                after = getHL();
-#endif
-                break;
-            default:
-#ifndef Z80_DISABLE_DEBUG
-                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
-#endif
-#ifndef Z80_NO_EXCEPTION
-                throw std::runtime_error("invalid register pair has specified");
+        if (isDebug()) log("[%04X] LD IYH, IYL<$%02X>", reg.PC - 2, getIYL());
 #endif
-                return;
-        }
+        setIYH(getIYL());
+    }
+
+    // Load Reg. IY(low) with value n
+    static inline void LD_IYL_N_(Z80* ctx) { ctx->LD_IYL_N(); }
+    inline void LD_IYL_N()
+    {
+        unsigned char n = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] POP %s <SP:$%04X> = $%04X", reg.PC - 1, dump, sp, after);
+        if (isDebug()) log("[%04X] LD IYL, $%02X", reg.PC - 3, n);
 #endif
+        setIYL(n);
     }
 
-    // Push Reg. IX on Stack.
-    static inline void PUSH_IX_(Z80* ctx) { ctx->PUSH_IX(); }
-    inline void PUSH_IX()
+    // Load Reg. IY(low) with value Reg.
+    static inline void LD_IYL_A(Z80* ctx) { ctx->LD_IYL_R(0b111); }
+    static inline void LD_IYL_B(Z80* ctx) { ctx->LD_IYL_R(0b000); }
+    static inline void LD_IYL_C(Z80* ctx) { ctx->LD_IYL_R(0b001); }
+    static inline void LD_IYL_D(Z80* ctx) { ctx->LD_IYL_R(0b010); }
+    static inline void LD_IYL_E(Z80* ctx) { ctx->LD_IYL_R(0b011); }
+    inline void LD_IYL_R(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] PUSH IX<$%04X> <SP:$%04X>", reg.PC - 2, reg.IX, reg.SP);
+        if (isDebug()) log("[%04X] LD IYL, %s", reg.PC - 2, registerDump(r));
 #endif
-        push(getIXH(), 4);
-        push(getIXL(), 3);
+        setIYL(*rp);
     }
 
-    // Pop Reg. IX from Stack.
-    static inline void POP_IX_(Z80* ctx) { ctx->POP_IX(); }
-    inline void POP_IX()
+    // Load Reg. IY(low) with value IY(high)
+    static inline void LD_IYL_IYH_(Z80* ctx) { ctx->LD_IYL_IYH(); }
+    inline void LD_IYL_IYH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        unsigned short sp = reg.SP;
+        if (isDebug()) log("[%04X] LD IYL, IYH<$%02X>", reg.PC - 2, getIYH());
 #endif
-        setIXL(pop(3));
-        setIXH(pop(3));
+        setIYL(getIYH());
+    }
+
+    // Load Reg. IY(low) with value IY(low)
+    static inline void LD_IYL_IYL_(Z80* ctx) { ctx->LD_IYL_IYL(); }
+    inline void LD_IYL_IYL()
+    {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] POP IX <SP:$%04X> = $%04X", reg.PC - 2, sp, reg.IX);
+        if (isDebug()) log("[%04X] LD IYL, IYL<$%02X>", reg.PC - 2, getIYL());
 #endif
     }
 
-    // Push Reg. IY on Stack.
-    static inline void PUSH_IY_(Z80* ctx) { ctx->PUSH_IY(); }
-    inline void PUSH_IY()
+    // Load Reg. r with location (HL)
+    static inline void LD_B_HL(Z80* ctx) { ctx->LD_R_HL(0b000); }
+    static inline void LD_C_HL(Z80* ctx) { ctx->LD_R_HL(0b001); }
+    static inline void LD_D_HL(Z80* ctx) { ctx->LD_R_HL(0b010); }
+    static inline void LD_E_HL(Z80* ctx) { ctx->LD_R_HL(0b011); }
+    static inline void LD_H_HL(Z80* ctx) { ctx->LD_R_HL(0b100); }
+    static inline void LD_L_HL(Z80* ctx) { ctx->LD_R_HL(0b101); }
+    static inline void LD_A_HL(Z80* ctx) { ctx->LD_R_HL(0b111); }
+    inline void LD_R_HL(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
+        unsigned char n = readByte(getHL(), 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] PUSH IY<$%04X> <SP:$%04X>", reg.PC - 2, reg.IY, reg.SP);
+        if (isDebug()) log("[%04X] LD %s, (%s) = $%02X", reg.PC - 1, registerDump(r), registerPairDump(0b10), n);
 #endif
-        push(getIYH(), 4);
-        push(getIYL(), 3);
+        if (rp) *rp = n;
     }
 
-    // Pop Reg. IY from Stack.
-    static inline void POP_IY_(Z80* ctx) { ctx->POP_IY(); }
-    inline void POP_IY()
+    // Load Reg. r with location (IX+d)
+    static inline void LD_A_IX(Z80* ctx) { ctx->LD_R_IX(0b111); }
+    static inline void LD_B_IX(Z80* ctx) { ctx->LD_R_IX(0b000); }
+    static inline void LD_C_IX(Z80* ctx) { ctx->LD_R_IX(0b001); }
+    static inline void LD_D_IX(Z80* ctx) { ctx->LD_R_IX(0b010); }
+    static inline void LD_E_IX(Z80* ctx) { ctx->LD_R_IX(0b011); }
+    static inline void LD_H_IX(Z80* ctx) { ctx->LD_R_IX(0b100); }
+    static inline void LD_L_IX(Z80* ctx) { ctx->LD_R_IX(0b101); }
+    inline void LD_R_IX(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((reg.IX + d) & 0xFFFF);
 #ifndef Z80_DISABLE_DEBUG
-        unsigned short sp = reg.SP;
+        if (isDebug()) log("[%04X] LD %s, (IX<$%04X>+$%02X) = $%02X", reg.PC - 3, registerDump(r), reg.IX, d, n);
 #endif
-        setIYL(pop(3));
-        setIYH(pop(3));
+        if (rp) *rp = n;
+        consumeClock(3);
+    }
+
+    // Load Reg. r with IXH
+    static inline void LD_A_IXH(Z80* ctx) { ctx->LD_R_IXH(0b111); }
+    static inline void LD_B_IXH(Z80* ctx) { ctx->LD_R_IXH(0b000); }
+    static inline void LD_C_IXH(Z80* ctx) { ctx->LD_R_IXH(0b001); }
+    static inline void LD_D_IXH(Z80* ctx) { ctx->LD_R_IXH(0b010); }
+    static inline void LD_E_IXH(Z80* ctx) { ctx->LD_R_IXH(0b011); }
+    inline void LD_R_IXH(unsigned char r)
+    {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] POP IY <SP:$%04X> = $%04X", reg.PC - 2, sp, reg.IY);
+        if (isDebug()) log("[%04X] LD %s, IXH<$%02X>", reg.PC - 2, registerDump(r), getIXH());
 #endif
+        if (rp) *rp = getIXH();
     }
 
-    inline void setFlagByRotate(unsigned char n, bool carry, bool isA = false)
-    {
-        setFlagC(carry);
-        resetFlagH();
-        resetFlagN();
-        setFlagXY(n);
-        if (!isA) {
-            setFlagS(n & 0x80);
-            setFlagZ(0 == n);
-            setFlagPV(isEvenNumberBits(n));
-        }
-    }
-
-    inline unsigned char SLL(unsigned char n)
-    {
-        unsigned char c = n & 0x80;
-        n &= 0b01111111;
-        n <<= 1;
-        n |= 1; // differ with SLA
-        setFlagByRotate(n, c);
-        return n;
-    }
-
-    inline unsigned char SLA(unsigned char n)
-    {
-        unsigned char c = (n & 0x80) >> 7;
-        n &= 0b01111111;
-        n <<= 1;
-        setFlagByRotate(n, c);
-        return n;
-    }
-
-    inline unsigned char SRL(unsigned char n)
-    {
-        unsigned char n0 = n & 0x01;
-        n &= 0b11111110;
-        n >>= 1;
-        setFlagByRotate(n, n0);
-        return n;
-    }
-
-    inline unsigned char SRA(unsigned char n)
-    {
-        unsigned char n0 = n & 0x01;
-        unsigned char n7 = n & 0x80;
-        n &= 0b11111110;
-        n >>= 1;
-        n = n7 ? n | 0x80 : n & 0x7F;
-        setFlagByRotate(n, n0);
-        return n;
-    }
-
-    inline unsigned char RLC(unsigned char n, bool isA = false)
-    {
-        unsigned char c = (n & 0x80) >> 7;
-        n &= 0b01111111;
-        n <<= 1;
-        n |= c; // differ with RL
-        setFlagByRotate(n, c, isA);
-        return n;
-    }
-
-    inline unsigned char RL(unsigned char n, bool isA = false)
-    {
-        unsigned char c = (n & 0x80) >> 7;
-        n &= 0b01111111;
-        n <<= 1;
-        n |= isFlagC() ? 1 : 0; // differ with RLC
-        setFlagByRotate(n, c, isA);
-        return n;
-    }
-
-    inline unsigned char RRC(unsigned char n, bool isA = false)
-    {
-        unsigned char c = (n & 1) << 7;
-        n &= 0b11111110;
-        n >>= 1;
-        n |= c; // differ with RR
-        setFlagByRotate(n, c, isA);
-        return n;
-    }
-
-    inline unsigned char RR(unsigned char n, bool isA = false)
-    {
-        unsigned char c = (n & 1) << 7;
-        n &= 0b11111110;
-        n >>= 1;
-        n |= isFlagC() ? 0x80 : 0; // differ with RR
-        setFlagByRotate(n, c, isA);
-        return n;
-    }
-
-    static inline void RLCA(Z80* ctx)
+    // Load Reg. r with IXL
+    static inline void LD_A_IXL(Z80* ctx) { ctx->LD_R_IXL(0b111); }
+    static inline void LD_B_IXL(Z80* ctx) { ctx->LD_R_IXL(0b000); }
+    static inline void LD_C_IXL(Z80* ctx) { ctx->LD_R_IXL(0b001); }
+    static inline void LD_D_IXL(Z80* ctx) { ctx->LD_R_IXL(0b010); }
+    static inline void LD_E_IXL(Z80* ctx) { ctx->LD_R_IXL(0b011); }
+    inline void LD_R_IXL(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] RLCA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD %s, IXL<$%02X>", reg.PC - 2, registerDump(r), getIXL());
 #endif
-        ctx->reg.pair.A = ctx->RLC(ctx->reg.pair.A, true);
+        if (rp) *rp = getIXL();
     }
 
-    static inline void RRCA(Z80* ctx)
+    // Load Reg. r with location (IY+d)
+    static inline void LD_A_IY(Z80* ctx) { ctx->LD_R_IY(0b111); }
+    static inline void LD_B_IY(Z80* ctx) { ctx->LD_R_IY(0b000); }
+    static inline void LD_C_IY(Z80* ctx) { ctx->LD_R_IY(0b001); }
+    static inline void LD_D_IY(Z80* ctx) { ctx->LD_R_IY(0b010); }
+    static inline void LD_E_IY(Z80* ctx) { ctx->LD_R_IY(0b011); }
+    static inline void LD_H_IY(Z80* ctx) { ctx->LD_R_IY(0b100); }
+    static inline void LD_L_IY(Z80* ctx) { ctx->LD_R_IY(0b101); }
+    inline void LD_R_IY(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((reg.IY + d) & 0xFFFF);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] RRCA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD %s, (IY<$%04X>+$%02X) = $%02X", reg.PC - 3, registerDump(r), reg.IY, d, n);
 #endif
-        ctx->reg.pair.A = ctx->RRC(ctx->reg.pair.A, true);
+        if (rp) *rp = n;
+        consumeClock(3);
     }
 
-    static inline void RLA(Z80* ctx)
+    // Load Reg. r with IYH
+    static inline void LD_A_IYH(Z80* ctx) { ctx->LD_R_IYH(0b111); }
+    static inline void LD_B_IYH(Z80* ctx) { ctx->LD_R_IYH(0b000); }
+    static inline void LD_C_IYH(Z80* ctx) { ctx->LD_R_IYH(0b001); }
+    static inline void LD_D_IYH(Z80* ctx) { ctx->LD_R_IYH(0b010); }
+    static inline void LD_E_IYH(Z80* ctx) { ctx->LD_R_IYH(0b011); }
+    inline void LD_R_IYH(unsigned char r)
     {
+        unsigned char iyh = getIYH();
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] RLA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD %s, IYH<$%02X>", reg.PC - 2, registerDump(r), iyh);
 #endif
-        ctx->reg.pair.A = ctx->RL(ctx->reg.pair.A, true);
+        if (rp) *rp = iyh;
     }
 
-    static inline void RRA(Z80* ctx)
+    // Load Reg. r with IYL
+    static inline void LD_A_IYL(Z80* ctx) { ctx->LD_R_IYL(0b111); }
+    static inline void LD_B_IYL(Z80* ctx) { ctx->LD_R_IYL(0b000); }
+    static inline void LD_C_IYL(Z80* ctx) { ctx->LD_R_IYL(0b001); }
+    static inline void LD_D_IYL(Z80* ctx) { ctx->LD_R_IYL(0b010); }
+    static inline void LD_E_IYL(Z80* ctx) { ctx->LD_R_IYL(0b011); }
+    inline void LD_R_IYL(unsigned char r)
     {
+        unsigned char iyl = getIYL();
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] RRA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD %s, IYL<$%02X>", reg.PC - 2, registerDump(r), iyl);
 #endif
-        ctx->reg.pair.A = ctx->RR(ctx->reg.pair.A, true);
+        if (rp) *rp = iyl;
     }
 
-    // Rotate register Left Circular
-    static inline void RLC_B(Z80* ctx) { ctx->RLC_R(0b000); }
-    static inline void RLC_C(Z80* ctx) { ctx->RLC_R(0b001); }
-    static inline void RLC_D(Z80* ctx) { ctx->RLC_R(0b010); }
-    static inline void RLC_E(Z80* ctx) { ctx->RLC_R(0b011); }
-    static inline void RLC_H(Z80* ctx) { ctx->RLC_R(0b100); }
-    static inline void RLC_L(Z80* ctx) { ctx->RLC_R(0b101); }
-    static inline void RLC_A(Z80* ctx) { ctx->RLC_R(0b111); }
-    inline void RLC_R(unsigned char r)
+    // Load location (HL) with Reg. r
+    static inline void LD_HL_B(Z80* ctx) { ctx->LD_HL_R(0b000); }
+    static inline void LD_HL_C(Z80* ctx) { ctx->LD_HL_R(0b001); }
+    static inline void LD_HL_D(Z80* ctx) { ctx->LD_HL_R(0b010); }
+    static inline void LD_HL_E(Z80* ctx) { ctx->LD_HL_R(0b011); }
+    static inline void LD_HL_H(Z80* ctx) { ctx->LD_HL_R(0b100); }
+    static inline void LD_HL_L(Z80* ctx) { ctx->LD_HL_R(0b101); }
+    static inline void LD_HL_A(Z80* ctx) { ctx->LD_HL_R(0b111); }
+    inline void LD_HL_R(unsigned char r)
     {
         unsigned char* rp = getRegisterPointer(r);
+        unsigned short addr = getHL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RLC %s", reg.PC - 2, registerDump(r));
+        if (isDebug()) log("[%04X] LD (%s), %s", reg.PC - 1, registerPairDump(0b10), registerDump(r));
 #endif
-        *rp = RLC(*rp);
+        writeByte(addr, *rp, 3);
     }
 
-    // Rotate Left register
-    static inline void RL_B(Z80* ctx) { ctx->RL_R(0b000); }
-    static inline void RL_C(Z80* ctx) { ctx->RL_R(0b001); }
-    static inline void RL_D(Z80* ctx) { ctx->RL_R(0b010); }
-    static inline void RL_E(Z80* ctx) { ctx->RL_R(0b011); }
-    static inline void RL_H(Z80* ctx) { ctx->RL_R(0b100); }
-    static inline void RL_L(Z80* ctx) { ctx->RL_R(0b101); }
-    static inline void RL_A(Z80* ctx) { ctx->RL_R(0b111); }
-    inline void RL_R(unsigned char r)
+    // 	Load location (IX+d) with Reg. r
+    static inline void LD_IX_A(Z80* ctx) { ctx->LD_IX_R(0b111); }
+    static inline void LD_IX_B(Z80* ctx) { ctx->LD_IX_R(0b000); }
+    static inline void LD_IX_C(Z80* ctx) { ctx->LD_IX_R(0b001); }
+    static inline void LD_IX_D(Z80* ctx) { ctx->LD_IX_R(0b010); }
+    static inline void LD_IX_E(Z80* ctx) { ctx->LD_IX_R(0b011); }
+    static inline void LD_IX_H(Z80* ctx) { ctx->LD_IX_R(0b100); }
+    static inline void LD_IX_L(Z80* ctx) { ctx->LD_IX_R(0b101); }
+    inline void LD_IX_R(unsigned char r)
     {
         unsigned char* rp = getRegisterPointer(r);
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IX + d);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RL %s <C:%s>", reg.PC - 2, registerDump(r), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD (IX<$%04X>+$%02X), %s", reg.PC - 3, reg.IX, d, registerDump(r));
 #endif
-        *rp = RL(*rp);
+        if (rp) writeByte(addr, *rp);
+        consumeClock(3);
     }
 
-    // Shift operand register left Arithmetic
-    static inline void SLA_B(Z80* ctx) { ctx->SLA_R(0b000); }
-    static inline void SLA_C(Z80* ctx) { ctx->SLA_R(0b001); }
-    static inline void SLA_D(Z80* ctx) { ctx->SLA_R(0b010); }
-    static inline void SLA_E(Z80* ctx) { ctx->SLA_R(0b011); }
-    static inline void SLA_H(Z80* ctx) { ctx->SLA_R(0b100); }
-    static inline void SLA_L(Z80* ctx) { ctx->SLA_R(0b101); }
-    static inline void SLA_A(Z80* ctx) { ctx->SLA_R(0b111); }
-    inline void SLA_R(unsigned char r)
+    // 	Load location (IY+d) with Reg. r
+    static inline void LD_IY_A(Z80* ctx) { ctx->LD_IY_R(0b111); }
+    static inline void LD_IY_B(Z80* ctx) { ctx->LD_IY_R(0b000); }
+    static inline void LD_IY_C(Z80* ctx) { ctx->LD_IY_R(0b001); }
+    static inline void LD_IY_D(Z80* ctx) { ctx->LD_IY_R(0b010); }
+    static inline void LD_IY_E(Z80* ctx) { ctx->LD_IY_R(0b011); }
+    static inline void LD_IY_H(Z80* ctx) { ctx->LD_IY_R(0b100); }
+    static inline void LD_IY_L(Z80* ctx) { ctx->LD_IY_R(0b101); }
+    inline void LD_IY_R(unsigned char r)
     {
         unsigned char* rp = getRegisterPointer(r);
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IY + d);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLA %s", reg.PC - 2, registerDump(r));
+        if (isDebug()) log("[%04X] LD (IY<$%04X>+$%02X), %s", reg.PC - 3, reg.IY, d, registerDump(r));
 #endif
-        *rp = SLA(*rp);
+        if (rp) writeByte(addr, *rp);
+        consumeClock(3);
     }
 
-    // Rotate register Right Circular
-    static inline void RRC_B(Z80* ctx) { ctx->RRC_R(0b000); }
-    static inline void RRC_C(Z80* ctx) { ctx->RRC_R(0b001); }
-    static inline void RRC_D(Z80* ctx) { ctx->RRC_R(0b010); }
-    static inline void RRC_E(Z80* ctx) { ctx->RRC_R(0b011); }
-    static inline void RRC_H(Z80* ctx) { ctx->RRC_R(0b100); }
-    static inline void RRC_L(Z80* ctx) { ctx->RRC_R(0b101); }
-    static inline void RRC_A(Z80* ctx) { ctx->RRC_R(0b111); }
-    inline void RRC_R(unsigned char r)
+    // Load location (IX+d) with value n
+    static inline void LD_IX_N_(Z80* ctx) { ctx->LD_IX_N(); }
+    inline void LD_IX_N()
     {
-        unsigned char* rp = getRegisterPointer(r);
+        signed char d = (signed char)fetch(4);
+        unsigned char n = fetch(4);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        writeByte(addr, n, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RRC %s", reg.PC - 2, registerDump(r));
+        if (isDebug()) log("[%04X] LD (IX<$%04X>+$%02X), $%02X", reg.PC - 4, reg.IX, d, n);
 #endif
-        *rp = RRC(*rp);
     }
 
-    // Rotate Right register
-    static inline void RR_B(Z80* ctx) { ctx->RR_R(0b000); }
-    static inline void RR_C(Z80* ctx) { ctx->RR_R(0b001); }
-    static inline void RR_D(Z80* ctx) { ctx->RR_R(0b010); }
-    static inline void RR_E(Z80* ctx) { ctx->RR_R(0b011); }
-    static inline void RR_H(Z80* ctx) { ctx->RR_R(0b100); }
-    static inline void RR_L(Z80* ctx) { ctx->RR_R(0b101); }
-    static inline void RR_A(Z80* ctx) { ctx->RR_R(0b111); }
-    inline void RR_R(unsigned char r)
+    // Load location (IY+d) with value n
+    static inline void LD_IY_N_(Z80* ctx) { ctx->LD_IY_N(); }
+    inline void LD_IY_N()
     {
-        unsigned char* rp = getRegisterPointer(r);
+        signed char d = (signed char)fetch(4);
+        unsigned char n = fetch(4);
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        writeByte(addr, n, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RR %s <C:%s>", reg.PC - 2, registerDump(r), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD (IY<$%04X>+$%02X), $%02X", reg.PC - 4, reg.IY, d, n);
 #endif
-        *rp = RR(*rp);
     }
 
-    // Shift operand register Right Arithmetic
-    static inline void SRA_B(Z80* ctx) { ctx->SRA_R(0b000); }
-    static inline void SRA_C(Z80* ctx) { ctx->SRA_R(0b001); }
-    static inline void SRA_D(Z80* ctx) { ctx->SRA_R(0b010); }
-    static inline void SRA_E(Z80* ctx) { ctx->SRA_R(0b011); }
-    static inline void SRA_H(Z80* ctx) { ctx->SRA_R(0b100); }
-    static inline void SRA_L(Z80* ctx) { ctx->SRA_R(0b101); }
-    static inline void SRA_A(Z80* ctx) { ctx->SRA_R(0b111); }
-    inline void SRA_R(unsigned char r)
+    // Load Reg. pair rp with value nn.
+    static inline void LD_BC_NN(Z80* ctx) { ctx->LD_RP_NN(0b00); }
+    static inline void LD_DE_NN(Z80* ctx) { ctx->LD_RP_NN(0b01); }
+    static inline void LD_HL_NN(Z80* ctx) { ctx->LD_RP_NN(0b10); }
+    static inline void LD_SP_NN(Z80* ctx) { ctx->LD_RP_NN(0b11); }
+    inline void LD_RP_NN(unsigned char rp)
     {
-        unsigned char* rp = getRegisterPointer(r);
+        unsigned char* rH;
+        unsigned char* rL;
+        switch (rp) {
+            case 0b00:
+                rH = &reg.pair.B;
+                rL = &reg.pair.C;
+                break;
+            case 0b01:
+                rH = &reg.pair.D;
+                rL = &reg.pair.E;
+                break;
+            case 0b10:
+                rH = &reg.pair.H;
+                rL = &reg.pair.L;
+                break;
+            case 0b11: {
+                // SP is not managed in pair structure, so calculate directly
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRA %s", reg.PC - 2, registerDump(r));
+                unsigned short sp = reg.SP;
+#endif
+                setSPL(fetch(3));
+                setSPH(fetch(3));
+#ifndef Z80_DISABLE_DEBUG
+                if (isDebug()) log("[%04X] LD SP<$%04X>, $%04X", reg.PC - 3, sp, reg.SP);
+#endif
+                return;
+            }
+            default:
+#ifndef Z80_DISABLE_DEBUG
+                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
+#endif
+#ifndef Z80_NO_EXCEPTION
+                throw std::runtime_error("invalid register pair has specified");
+#endif
+                return;
+        }
+#ifndef Z80_DISABLE_DEBUG
+        const char* dump = isDebug() ? registerPairDump(rp) : "";
+#endif
+        unsigned char nL = fetch(3);
+        *rL = nL;
+        unsigned char nH = fetch(3);
+        *rH = nH;
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] LD %s, $%02X%02X", reg.PC - 3, dump, nH, nL);
 #endif
-        *rp = SRA(*rp);
     }
 
-    // Shift operand register Right Logical
-    static inline void SRL_B(Z80* ctx) { ctx->SRL_R(0b000); }
-    static inline void SRL_C(Z80* ctx) { ctx->SRL_R(0b001); }
-    static inline void SRL_D(Z80* ctx) { ctx->SRL_R(0b010); }
-    static inline void SRL_E(Z80* ctx) { ctx->SRL_R(0b011); }
-    static inline void SRL_H(Z80* ctx) { ctx->SRL_R(0b100); }
-    static inline void SRL_L(Z80* ctx) { ctx->SRL_R(0b101); }
-    static inline void SRL_A(Z80* ctx) { ctx->SRL_R(0b111); }
-    inline void SRL_R(unsigned char r)
+    static inline void LD_IX_NN_(Z80* ctx) { ctx->LD_IX_NN(); }
+    inline void LD_IX_NN()
     {
-        unsigned char* rp = getRegisterPointer(r);
+        setIXL(fetch(3));
+        setIXH(fetch(3));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRL %s", reg.PC - 2, registerDump(r));
+        if (isDebug()) log("[%04X] LD IX, $%04X", reg.PC - 4, reg.IX);
 #endif
-        *rp = SRL(*rp);
     }
 
-    // Shift operand register Left Logical
-    static inline void SLL_B(Z80* ctx) { ctx->SLL_R(0b000); }
-    static inline void SLL_C(Z80* ctx) { ctx->SLL_R(0b001); }
-    static inline void SLL_D(Z80* ctx) { ctx->SLL_R(0b010); }
-    static inline void SLL_E(Z80* ctx) { ctx->SLL_R(0b011); }
-    static inline void SLL_H(Z80* ctx) { ctx->SLL_R(0b100); }
-    static inline void SLL_L(Z80* ctx) { ctx->SLL_R(0b101); }
-    static inline void SLL_A(Z80* ctx) { ctx->SLL_R(0b111); }
-    inline void SLL_R(unsigned char r)
+    static inline void LD_IY_NN_(Z80* ctx) { ctx->LD_IY_NN(); }
+    inline void LD_IY_NN()
     {
-        unsigned char* rp = getRegisterPointer(r);
+        setIYL(fetch(3));
+        setIYH(fetch(3));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLL %s", reg.PC - 2, registerDump(r));
+        if (isDebug()) log("[%04X] LD IY, $%04X", reg.PC - 4, reg.IY);
 #endif
-        *rp = SLL(*rp);
     }
 
-    // Rotate memory (HL) Left Circular
-    static inline void RLC_HL_(Z80* ctx) { ctx->RLC_HL(); }
-    inline void RLC_HL()
+    // Load Reg. pair rp with location (nn)
+    static inline void LD_RP_ADDR_BC(Z80* ctx) { ctx->LD_RP_ADDR(0b00); }
+    static inline void LD_RP_ADDR_DE(Z80* ctx) { ctx->LD_RP_ADDR(0b01); }
+    static inline void LD_RP_ADDR_HL(Z80* ctx) { ctx->LD_RP_ADDR(0b10); }
+    static inline void LD_RP_ADDR_SP(Z80* ctx) { ctx->LD_RP_ADDR(0b11); }
+    inline void LD_RP_ADDR(unsigned char rp)
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
+        unsigned char l = fetch(3);
+        unsigned char h = fetch(3);
+        unsigned short addr = make16BitsFromLE(l, h);
+        unsigned char* rL;
+        unsigned char* rH;
+        switch (rp) {
+            case 0:
+                rH = &reg.pair.B;
+                rL = &reg.pair.C;
+                break;
+            case 1:
+                rH = &reg.pair.D;
+                rL = &reg.pair.E;
+                break;
+            case 2:
+                rH = &reg.pair.H;
+                rL = &reg.pair.L;
+                break;
+            case 3: {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RLC (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
+                const char* dump = isDebug() ? registerPairDump(rp) : "";
+#endif
+                setSPL(readByte(addr, 3));
+                setSPH(readByte(addr + 1, 3));
+                reg.WZ = addr + 1;
+#ifndef Z80_DISABLE_DEBUG
+                if (isDebug()) log("[%04X] LD %s, ($%04X) = $%04X", reg.PC - 4, dump, addr, reg.SP);
+#endif
+                return;
+            }
+            default:
+#ifndef Z80_DISABLE_DEBUG
+                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
+#endif
+#ifndef Z80_NO_EXCEPTION
+                throw std::runtime_error("invalid register pair has specified");
+#endif
+                return;
+        }
+#ifndef Z80_DISABLE_DEBUG
+        const char* dump = isDebug() ? registerPairDump(rp) : "";
+#endif
+        *rL = readByte(addr, 3);
+        *rH = readByte(addr + 1, 3);
+        reg.WZ = addr + 1;
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] LD %s, ($%04X) = $%04X", reg.PC - 4, dump, addr, make16BitsFromLE(*rL, *rH));
 #endif
-        writeByte(addr, RLC(n), 3);
     }
 
-    // Rotate Left memory
-    static inline void RL_HL_(Z80* ctx) { ctx->RL_HL(); }
-    inline void RL_HL()
+    // Load location (nn) with Reg. pair rp.
+    static inline void LD_ADDR_RP_BC(Z80* ctx) { ctx->LD_ADDR_RP(0b00); }
+    static inline void LD_ADDR_RP_DE(Z80* ctx) { ctx->LD_ADDR_RP(0b01); }
+    static inline void LD_ADDR_RP_HL(Z80* ctx) { ctx->LD_ADDR_RP(0b10); }
+    static inline void LD_ADDR_RP_SP(Z80* ctx) { ctx->LD_ADDR_RP(0b11); }
+    inline void LD_ADDR_RP(unsigned char rp)
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
+        unsigned char l = fetch(3);
+        unsigned char h = fetch(3);
+        unsigned short addr = make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RL (HL<$%04X>) = $%02X <C:%s>", reg.PC - 2, addr, n, isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD ($%04X), %s", reg.PC - 4, addr, registerPairDump(rp));
 #endif
-        writeByte(addr, RL(n), 3);
+        switch (rp) {
+            case 0b00:
+                h = reg.pair.B;
+                l = reg.pair.C;
+                break;
+            case 0b01:
+                h = reg.pair.D;
+                l = reg.pair.E;
+                break;
+            case 0b10:
+                h = reg.pair.H;
+                l = reg.pair.L;
+                break;
+            case 0b11:
+                splitTo8BitsPair(reg.SP, &h, &l);
+                break;
+            default:
+#ifndef Z80_DISABLE_DEBUG
+                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
+#endif
+#ifndef Z80_NO_EXCEPTION
+                throw std::runtime_error("invalid register pair has specified");
+#endif
+                return;
+        }
+        writeByte(addr, l, 3);
+        writeByte(addr + 1, h, 3);
+        reg.WZ = addr + 1;
     }
 
-    // Shift operand location (HL) left Arithmetic
-    static inline void SLA_HL_(Z80* ctx) { ctx->SLA_HL(); }
-    inline void SLA_HL()
+    // Load IX with location (nn)
+    static inline void LD_IX_ADDR_(Z80* ctx) { ctx->LD_IX_ADDR(); }
+    inline void LD_IX_ADDR()
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
+        unsigned char l = fetch(3);
+        unsigned char h = fetch(3);
+        unsigned short addr = make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLA (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
+        unsigned short ix = reg.IX;
+#endif
+        setIXL(readByte(addr, 3));
+        setIXH(readByte(addr + 1, 3));
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] LD IX<$%04X>, ($%04X) = $%04X", reg.PC - 4, ix, addr, reg.IX);
 #endif
-        writeByte(addr, SLA(n), 3);
     }
 
-    // Rotate memory (HL) Right Circular
-    static inline void RRC_HL_(Z80* ctx) { ctx->RRC_HL(); }
-    inline void RRC_HL()
+    // Load IY with location (nn)
+    static inline void LD_IY_ADDR_(Z80* ctx) { ctx->LD_IY_ADDR(); }
+    inline void LD_IY_ADDR()
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
+        unsigned char l = fetch(3);
+        unsigned char h = fetch(3);
+        unsigned short addr = make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RRC (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
+        unsigned short iy = reg.IY;
+#endif
+        setIYL(readByte(addr, 3));
+        setIYH(readByte(addr + 1, 3));
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] LD IY<$%04X>, ($%04X) = $%04X", reg.PC - 4, iy, addr, reg.IY);
 #endif
-        writeByte(addr, RRC(n), 3);
     }
 
-    // Rotate Right memory
-    static inline void RR_HL_(Z80* ctx) { ctx->RR_HL(); }
-    inline void RR_HL()
+    static inline void LD_ADDR_IX_(Z80* ctx) { ctx->LD_ADDR_IX(); }
+    inline void LD_ADDR_IX()
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
+        unsigned char l = fetch(3);
+        unsigned char h = fetch(3);
+        unsigned short addr = make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RR (HL<$%04X>) = $%02X <C:%s>", reg.PC - 2, addr, n, isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] LD ($%04X), IX<$%04X>", reg.PC - 4, addr, reg.IX);
 #endif
-        writeByte(addr, RR(n), 3);
+        writeByte(addr, getIXL(), 3);
+        writeByte(addr + 1, getIXH(), 3);
     }
 
-    // Shift operand location (HL) Right Arithmetic
-    static inline void SRA_HL_(Z80* ctx) { ctx->SRA_HL(); }
-    inline void SRA_HL()
+    static inline void LD_ADDR_IY_(Z80* ctx) { ctx->LD_ADDR_IY(); }
+    inline void LD_ADDR_IY()
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRA (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
-#endif
-        writeByte(addr, SRA(n), 3);
-    }
-
-    // Shift operand location (HL) Right Logical
-    static inline void SRL_HL_(Z80* ctx) { ctx->SRL_HL(); }
-    inline void SRL_HL()
-    {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
+        unsigned char l = fetch(3);
+        unsigned char h = fetch(3);
+        unsigned short addr = make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRL (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
+        if (isDebug()) log("[%04X] LD ($%04X), IY<$%04X>", reg.PC - 4, addr, reg.IY);
 #endif
-        writeByte(addr, SRL(n), 3);
+        writeByte(addr, getIYL(), 3);
+        writeByte(addr + 1, getIYH(), 3);
     }
 
-    // Shift operand location (HL) Left Logical
-    static inline void SLL_HL_(Z80* ctx) { ctx->SLL_HL(); }
-    inline void SLL_HL()
+    // Load SP with IX.
+    static inline void LD_SP_IX_(Z80* ctx) { ctx->LD_SP_IX(); }
+    inline void LD_SP_IX()
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLL (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
+        if (isDebug()) log("[%04X] LD %s, IX<$%04X>", reg.PC - 2, registerPairDump(0b11), reg.IX);
 #endif
-        writeByte(addr, SLL(n), 3);
+        reg.SP = reg.IX;
+        consumeClock(2);
     }
 
-    // Rotate memory (IX+d) Left Circular
-    static inline void RLC_IX_(Z80* ctx, signed char d) { ctx->RLC_IX(d); }
-    inline void RLC_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // Load SP with IY.
+    static inline void LD_SP_IY_(Z80* ctx) { ctx->LD_SP_IY(); }
+    inline void LD_SP_IY()
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RLC (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] LD %s, IY<$%04X>", reg.PC - 2, registerPairDump(0b11), reg.IY);
 #endif
-        unsigned char result = RLC(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        reg.SP = reg.IY;
+        consumeClock(2);
     }
 
-    // Rotate memory (IX+d) Left Circular with load to Reg A/B/C/D/E/H/L/F
-    static inline void RLC_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b000); }
-    static inline void RLC_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b001); }
-    static inline void RLC_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b010); }
-    static inline void RLC_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b011); }
-    static inline void RLC_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b100); }
-    static inline void RLC_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b101); }
-    static inline void RLC_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b111); }
-    inline void RLC_IX_with_LD(signed char d, unsigned char r)
+    // Load location (DE) with Loacation (HL), increment/decrement DE, HL, decrement BC
+    inline void repeatLD(bool isIncDEHL, bool isRepeat)
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
         if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
+            if (isIncDEHL) {
+                if (isDebug()) log("[%04X] %s ... %s, %s, %s", reg.PC - 2, isRepeat ? "LDIR" : "LDI", registerPairDump(0b00), registerPairDump(0b01), registerPairDump(0b10));
+            } else {
+                if (isDebug()) log("[%04X] %s ... %s, %s, %s", reg.PC - 2, isRepeat ? "LDDR" : "LDD", registerPairDump(0b00), registerPairDump(0b01), registerPairDump(0b10));
+            }
         }
-        RLC_IX(d, rp, buf);
-#else
-        RLC_IX(d, rp);
 #endif
-    }
-
-    // Rotate memory (IY+d) Left Circular with load to Reg A/B/C/D/E/H/L/F
-    static inline void RLC_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b000); }
-    static inline void RLC_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b001); }
-    static inline void RLC_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b010); }
-    static inline void RLC_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b011); }
-    static inline void RLC_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b100); }
-    static inline void RLC_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b101); }
-    static inline void RLC_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b111); }
-    inline void RLC_IY_with_LD(signed char d, unsigned char r)
-    {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        unsigned short bc = getBC();
+        unsigned short de = getDE();
+        unsigned short hl = getHL();
+        unsigned char n = readByte(hl);
+        writeByte(de, n);
+        if (isIncDEHL) {
+            de++;
+            hl++;
         } else {
-            buf[0] = '\0';
+            de--;
+            hl--;
+        }
+        bc--;
+        setBC(bc);
+        setDE(de);
+        setHL(hl);
+        resetFlagH();
+        setFlagPV(bc != 0);
+        resetFlagN();
+        unsigned char an = reg.pair.A + n;
+        setFlagY(an & 0b00000010);
+        setFlagX(an & 0b00001000);
+        if (isRepeat && 0 != bc) {
+            reg.PC -= 2;
+            consumeClock(5);
         }
-        RLC_IY(d, rp, buf);
-#else
-        RLC_IY(d, rp);
-#endif
     }
+    static inline void LDI(Z80* ctx) { ctx->repeatLD(true, false); }
+    static inline void LDIR(Z80* ctx) { ctx->repeatLD(true, true); }
+    static inline void LDD(Z80* ctx) { ctx->repeatLD(false, false); }
+    static inline void LDDR(Z80* ctx) { ctx->repeatLD(false, true); }
 
-    // Rotate memory (IX+d) Right Circular
-    static inline void RRC_IX_(Z80* ctx, signed char d) { ctx->RRC_IX(d); }
-    inline void RRC_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // Exchange stack top with IX
+    static inline void EX_SP_IX_(Z80* ctx) { ctx->EX_SP_IX(); }
+    inline void EX_SP_IX()
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RRC (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        unsigned short sp = reg.SP;
 #endif
-        unsigned char result = RRC(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
-    }
-
-    // Rotate memory (IX+d) Right Circular with load to Reg A/B/C/D/E/H/L/F
-    static inline void RRC_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b000); }
-    static inline void RRC_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b001); }
-    static inline void RRC_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b010); }
-    static inline void RRC_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b011); }
-    static inline void RRC_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b100); }
-    static inline void RRC_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b101); }
-    static inline void RRC_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b111); }
-    inline void RRC_IX_with_LD(signed char d, unsigned char r)
-    {
-        unsigned char* rp = getRegisterPointer(r);
+        unsigned char l = pop(4);
+        unsigned char h = pop(4);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        RRC_IX(d, rp, buf);
-#else
-        RRC_IX(d, rp);
+        if (isDebug()) log("[%04X] EX (SP<$%04X>) = $%02X%02X, IX<$%04X>", reg.PC - 2, sp, h, l, reg.IX);
 #endif
+        push(getIXH(), 4);
+        setIXH(h);
+        push(getIXL(), 3);
+        setIXL(l);
     }
 
-    // Rotate memory (IY+d) Right Circular with load to Reg A/B/C/D/E/H/L/F
-    static inline void RRC_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b000); }
-    static inline void RRC_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b001); }
-    static inline void RRC_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b010); }
-    static inline void RRC_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b011); }
-    static inline void RRC_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b100); }
-    static inline void RRC_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b101); }
-    static inline void RRC_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b111); }
-    inline void RRC_IY_with_LD(signed char d, unsigned char r)
+    // Exchange stack top with IY
+    static inline void EX_SP_IY_(Z80* ctx) { ctx->EX_SP_IY(); }
+    inline void EX_SP_IY()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        RRC_IY(d, rp, buf);
-#else
-        RRC_IY(d, rp);
+        unsigned short sp = reg.SP;
 #endif
-    }
-
-    // Rotate Left memory
-    static inline void RL_IX_(Z80* ctx, signed char d) { ctx->RL_IX(d); }
-    inline void RL_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
-    {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
+        unsigned char l = pop(4);
+        unsigned char h = pop(4);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RL (IX+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] EX (SP<$%04X>) = $%02X%02X, IY<$%04X>", reg.PC - 2, sp, h, l, reg.IY);
 #endif
-        unsigned char result = RL(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        push(getIYH(), 4);
+        setIYH(h);
+        push(getIYL(), 3);
+        setIYL(l);
     }
 
-    // Rotate Left memory with load Reg.
-    static inline void RL_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b000); }
-    static inline void RL_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b001); }
-    static inline void RL_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b010); }
-    static inline void RL_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b011); }
-    static inline void RL_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b100); }
-    static inline void RL_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b101); }
-    static inline void RL_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b111); }
-    inline void RL_IX_with_LD(signed char d, unsigned char r)
+    // Push Reg. on Stack.
+    static inline void PUSH_BC(Z80* ctx) { ctx->PUSH_RP(0b00); }
+    static inline void PUSH_DE(Z80* ctx) { ctx->PUSH_RP(0b01); }
+    static inline void PUSH_HL(Z80* ctx) { ctx->PUSH_RP(0b10); }
+    inline void PUSH_RP(unsigned char rp)
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        RL_IX(d, rp, buf);
+        if (isDebug()) log("[%04X] PUSH %s <SP:$%04X>", reg.PC - 1, registerPairDump(rp), reg.SP);
+#endif
+        switch (rp) {
+            case 0b00:
+                push(reg.pair.B, 4);
+                push(reg.pair.C, 3);
+                break;
+            case 0b01:
+                push(reg.pair.D, 4);
+                push(reg.pair.E, 3);
+                break;
+            case 0b10:
+                push(reg.pair.H, 4);
+                push(reg.pair.L, 3);
+                break;
+            default:
+#ifndef Z80_DISABLE_DEBUG
+                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
+#endif
+#ifdef Z80_NO_EXCEPTION
+                ;
 #else
-        RL_IX(d, rp);
+                throw std::runtime_error("invalid register pair has specified");
 #endif
+        }
     }
 
-    // Rotate Left memory with load Reg.
-    static inline void RL_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b000); }
-    static inline void RL_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b001); }
-    static inline void RL_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b010); }
-    static inline void RL_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b011); }
-    static inline void RL_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b100); }
-    static inline void RL_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b101); }
-    static inline void RL_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b111); }
-    inline void RL_IY_with_LD(signed char d, unsigned char r)
+    // Push Reg. on Stack.
+    static inline void POP_BC(Z80* ctx) { ctx->POP_RP(0b00); }
+    static inline void POP_DE(Z80* ctx) { ctx->POP_RP(0b01); }
+    static inline void POP_HL(Z80* ctx) { ctx->POP_RP(0b10); }
+    inline void POP_RP(unsigned char rp)
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        RL_IY(d, rp, buf);
-#else
-        RL_IY(d, rp);
+        unsigned short sp = reg.SP;
+        const char* dump = isDebug() ? registerPairDump(rp) : "";
+        unsigned short after;
 #endif
-    }
-
-    // Rotate Right memory
-    static inline void RR_IX_(Z80* ctx, signed char d) { ctx->RR_IX(d); }
-    inline void RR_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
-    {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
+        switch (rp) {
+            case 0b00:
+                reg.pair.C = pop(3);
+                reg.pair.B = pop(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RR (IX+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
+                after = getBC();
 #endif
-        unsigned char result = RR(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
-    }
-
-    // Rotate Right memory with load Reg.
-    static inline void RR_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b000); }
-    static inline void RR_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b001); }
-    static inline void RR_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b010); }
-    static inline void RR_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b011); }
-    static inline void RR_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b100); }
-    static inline void RR_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b101); }
-    static inline void RR_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b111); }
-    inline void RR_IX_with_LD(signed char d, unsigned char r)
-    {
-        unsigned char* rp = getRegisterPointer(r);
+                break;
+            case 0b01:
+                reg.pair.E = pop(3);
+                reg.pair.D = pop(3);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        RR_IX(d, rp, buf);
-#else
-        RR_IX(d, rp);
+                after = getDE();
 #endif
-    }
-
-    // Rotate Right memory with load Reg.
-    static inline void RR_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b000); }
-    static inline void RR_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b001); }
-    static inline void RR_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b010); }
-    static inline void RR_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b011); }
-    static inline void RR_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b100); }
-    static inline void RR_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b101); }
-    static inline void RR_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b111); }
-    inline void RR_IY_with_LD(signed char d, unsigned char r)
-    {
-        unsigned char* rp = getRegisterPointer(r);
+                break;
+            case 0b10:
+                reg.pair.L = pop(3);
+                reg.pair.H = pop(3);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
+                after = getHL();
+#endif
+                break;
+            default:
+#ifndef Z80_DISABLE_DEBUG
+                if (isDebug()) log("invalid register pair has specified: $%02X", rp);
+#endif
+#ifndef Z80_NO_EXCEPTION
+                throw std::runtime_error("invalid register pair has specified");
+#endif
+                return;
         }
-        RR_IY(d, rp, buf);
-#else
-        RR_IY(d, rp);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] POP %s <SP:$%04X> = $%04X", reg.PC - 1, dump, sp, after);
 #endif
     }
 
-    // Shift operand location (IX+d) left Arithmetic
-    static inline void SLA_IX_(Z80* ctx, signed char d) { ctx->SLA_IX(d); }
-    inline void SLA_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // Push Reg. IX on Stack.
+    static inline void PUSH_IX_(Z80* ctx) { ctx->PUSH_IX(); }
+    inline void PUSH_IX()
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLA (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] PUSH IX<$%04X> <SP:$%04X>", reg.PC - 2, reg.IX, reg.SP);
 #endif
-        unsigned char result = SLA(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        push(getIXH(), 4);
+        push(getIXL(), 3);
     }
 
-    // Shift operand location (IX+d) left Arithmetic with load Reg.
-    static inline void SLA_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b000); }
-    static inline void SLA_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b001); }
-    static inline void SLA_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b010); }
-    static inline void SLA_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b011); }
-    static inline void SLA_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b100); }
-    static inline void SLA_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b101); }
-    static inline void SLA_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b111); }
-    inline void SLA_IX_with_LD(signed char d, unsigned char r)
+    // Pop Reg. IX from Stack.
+    static inline void POP_IX_(Z80* ctx) { ctx->POP_IX(); }
+    inline void POP_IX()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SLA_IX(d, rp, buf);
-#else
-        SLA_IX(d, rp);
+        unsigned short sp = reg.SP;
+#endif
+        setIXL(pop(3));
+        setIXH(pop(3));
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] POP IX <SP:$%04X> = $%04X", reg.PC - 2, sp, reg.IX);
 #endif
     }
 
-    // Shift operand location (IY+d) left Arithmetic with load Reg.
-    static inline void SLA_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b000); }
-    static inline void SLA_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b001); }
-    static inline void SLA_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b010); }
-    static inline void SLA_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b011); }
-    static inline void SLA_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b100); }
-    static inline void SLA_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b101); }
-    static inline void SLA_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b111); }
-    inline void SLA_IY_with_LD(signed char d, unsigned char r)
+    // Push Reg. IY on Stack.
+    static inline void PUSH_IY_(Z80* ctx) { ctx->PUSH_IY(); }
+    inline void PUSH_IY()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SLA_IY(d, rp, buf);
-#else
-        SLA_IY(d, rp);
+        if (isDebug()) log("[%04X] PUSH IY<$%04X> <SP:$%04X>", reg.PC - 2, reg.IY, reg.SP);
 #endif
+        push(getIYH(), 4);
+        push(getIYL(), 3);
     }
 
-    // Shift operand location (IX+d) Right Arithmetic
-    static inline void SRA_IX_(Z80* ctx, signed char d) { ctx->SRA_IX(d); }
-    inline void SRA_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // Pop Reg. IY from Stack.
+    static inline void POP_IY_(Z80* ctx) { ctx->POP_IY(); }
+    inline void POP_IY()
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRA (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        unsigned short sp = reg.SP;
+#endif
+        setIYL(pop(3));
+        setIYH(pop(3));
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] POP IY <SP:$%04X> = $%04X", reg.PC - 2, sp, reg.IY);
 #endif
-        unsigned char result = SRA(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
     }
 
-    // Shift operand location (IX+d) right Arithmetic with load Reg.
-    static inline void SRA_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b000); }
-    static inline void SRA_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b001); }
-    static inline void SRA_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b010); }
-    static inline void SRA_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b011); }
-    static inline void SRA_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b100); }
-    static inline void SRA_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b101); }
-    static inline void SRA_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b111); }
-    inline void SRA_IX_with_LD(signed char d, unsigned char r)
+    inline void setFlagByRotate(unsigned char n, bool carry, bool isA = false)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
+        setFlagC(carry);
+        resetFlagH();
+        resetFlagN();
+        setFlagXY(n);
+        if (!isA) {
+            setFlagS(n & 0x80);
+            setFlagZ(0 == n);
+            setFlagPV(isEvenNumberBits(n));
         }
-        SRA_IX(d, rp, buf);
-#else
-        SRA_IX(d, rp);
-#endif
     }
 
-    // Shift operand location (IY+d) right Arithmetic with load Reg.
-    static inline void SRA_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b000); }
-    static inline void SRA_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b001); }
-    static inline void SRA_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b010); }
-    static inline void SRA_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b011); }
-    static inline void SRA_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b100); }
-    static inline void SRA_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b101); }
-    static inline void SRA_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b111); }
-    inline void SRA_IY_with_LD(signed char d, unsigned char r)
+    inline unsigned char SLL(unsigned char n)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SRA_IY(d, rp, buf);
-#else
-        SRA_IY(d, rp);
-#endif
+        unsigned char c = n & 0x80;
+        n &= 0b01111111;
+        n <<= 1;
+        n |= 1; // differ with SLA
+        setFlagByRotate(n, c);
+        return n;
     }
 
-    // Shift operand location (IX+d) Right Logical
-    static inline void SRL_IX_(Z80* ctx, signed char d) { ctx->SRL_IX(d); }
-    inline void SRL_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    inline unsigned char SLA(unsigned char n)
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRL (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
-#endif
-        unsigned char result = SRL(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        unsigned char c = (n & 0x80) >> 7;
+        n &= 0b01111111;
+        n <<= 1;
+        setFlagByRotate(n, c);
+        return n;
     }
 
-    // Shift operand location (IX+d) Right Logical with load Reg.
-    static inline void SRL_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b000); }
-    static inline void SRL_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b001); }
-    static inline void SRL_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b010); }
-    static inline void SRL_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b011); }
-    static inline void SRL_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b100); }
-    static inline void SRL_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b101); }
-    static inline void SRL_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b111); }
-    inline void SRL_IX_with_LD(signed char d, unsigned char r)
+    inline unsigned char SRL(unsigned char n)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SRL_IX(d, rp, buf);
-#else
-        SRL_IX(d, rp);
-#endif
+        unsigned char n0 = n & 0x01;
+        n &= 0b11111110;
+        n >>= 1;
+        setFlagByRotate(n, n0);
+        return n;
     }
 
-    // Shift operand location (IY+d) Right Logical with load Reg.
-    static inline void SRL_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b000); }
-    static inline void SRL_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b001); }
-    static inline void SRL_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b010); }
-    static inline void SRL_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b011); }
-    static inline void SRL_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b100); }
-    static inline void SRL_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b101); }
-    static inline void SRL_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b111); }
-    inline void SRL_IY_with_LD(signed char d, unsigned char r)
+    inline unsigned char SRA(unsigned char n)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SRL_IY(d, rp, buf);
-#else
-        SRL_IY(d, rp);
-#endif
+        unsigned char n0 = n & 0x01;
+        unsigned char n7 = n & 0x80;
+        n &= 0b11111110;
+        n >>= 1;
+        n = n7 ? n | 0x80 : n & 0x7F;
+        setFlagByRotate(n, n0);
+        return n;
     }
 
-    // Shift operand location (IX+d) Left Logical
-    // NOTE: this function is only for SLL_IX_with_LD
-    static inline void SLL_IX_(Z80* ctx, signed char d) { ctx->SLL_IX(d); }
-    inline void SLL_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    inline unsigned char RLC(unsigned char n, bool isA = false)
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLL (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
-#endif
-        unsigned char result = SLL(n);
-        writeByte(addr, result, 3);
-        if (rp) *rp = result;
+        unsigned char c = (n & 0x80) >> 7;
+        n &= 0b01111111;
+        n <<= 1;
+        n |= c; // differ with RL
+        setFlagByRotate(n, c, isA);
+        return n;
     }
 
-    // Shift operand location (IX+d) Left Logical with load Reg.
-    static inline void SLL_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b000); }
-    static inline void SLL_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b001); }
-    static inline void SLL_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b010); }
-    static inline void SLL_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b011); }
-    static inline void SLL_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b100); }
-    static inline void SLL_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b101); }
-    static inline void SLL_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b111); }
-    inline void SLL_IX_with_LD(signed char d, unsigned char r)
+    inline unsigned char RL(unsigned char n, bool isA = false)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SLL_IX(d, rp, buf);
-#else
-        SLL_IX(d, rp);
-#endif
+        unsigned char c = (n & 0x80) >> 7;
+        n &= 0b01111111;
+        n <<= 1;
+        n |= isFlagC() ? 1 : 0; // differ with RLC
+        setFlagByRotate(n, c, isA);
+        return n;
     }
 
-    // Shift operand location (IY+d) Left Logical
-    // NOTE: this function is only for SLL_IY_with_LD
-    static inline void SLL_IY_(Z80* ctx, signed char d) { ctx->SLL_IY(d); }
-    inline void SLL_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    inline unsigned char RRC(unsigned char n, bool isA = false)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLL (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
-#endif
-        unsigned char result = SLL(n);
-        writeByte(addr, result, 3);
-        if (rp) *rp = result;
+        unsigned char c = (n & 1) << 7;
+        n &= 0b11111110;
+        n >>= 1;
+        n |= c; // differ with RR
+        setFlagByRotate(n, c, isA);
+        return n;
     }
 
-    // Shift operand location (IY+d) Left Logical with load Reg.
-    static inline void SLL_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b000); }
-    static inline void SLL_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b001); }
-    static inline void SLL_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b010); }
-    static inline void SLL_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b011); }
-    static inline void SLL_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b100); }
-    static inline void SLL_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b101); }
-    static inline void SLL_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b111); }
-    inline void SLL_IY_with_LD(signed char d, unsigned char r)
+    inline unsigned char RR(unsigned char n, bool isA = false)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SLL_IY(d, rp, buf);
-#else
-        SLL_IY(d, rp);
-#endif
+        unsigned char c = (n & 1) << 7;
+        n &= 0b11111110;
+        n >>= 1;
+        n |= isFlagC() ? 0x80 : 0; // differ with RR
+        setFlagByRotate(n, c, isA);
+        return n;
     }
 
-    // Rotate memory (IY+d) Left Circular
-    static inline void RLC_IY_(Z80* ctx, signed char d) { ctx->RLC_IY(d); }
-    inline void RLC_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    static inline void RLCA(Z80* ctx)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RLC (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        if (ctx->isDebug()) ctx->log("[%04X] RLCA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
 #endif
-        unsigned char result = RLC(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        ctx->reg.pair.A = ctx->RLC(ctx->reg.pair.A, true);
     }
 
-    // Rotate memory (IY+d) Right Circular
-    static inline void RRC_IY_(Z80* ctx, signed char d) { ctx->RRC_IY(d); }
-    inline void RRC_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    static inline void RRCA(Z80* ctx)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RRC (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        if (ctx->isDebug()) ctx->log("[%04X] RRCA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
 #endif
-        unsigned char result = RRC(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        ctx->reg.pair.A = ctx->RRC(ctx->reg.pair.A, true);
     }
 
-    // Rotate Left memory
-    static inline void RL_IY_(Z80* ctx, signed char d) { ctx->RL_IY(d); }
-    inline void RL_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    static inline void RLA(Z80* ctx)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RL (IY+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
+        if (ctx->isDebug()) ctx->log("[%04X] RLA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
 #endif
-        unsigned char result = RL(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        ctx->reg.pair.A = ctx->RL(ctx->reg.pair.A, true);
     }
 
-    // Shift operand location (IY+d) left Arithmetic
-    static inline void SLA_IY_(Z80* ctx, signed char d) { ctx->SLA_IY(d); }
-    inline void SLA_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    static inline void RRA(Z80* ctx)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SLA (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        if (ctx->isDebug()) ctx->log("[%04X] RRA <A:$%02X, C:%s>", ctx->reg.PC - 1, ctx->reg.pair.A, ctx->isFlagC() ? "ON" : "OFF");
 #endif
-        unsigned char result = SLA(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        ctx->reg.pair.A = ctx->RR(ctx->reg.pair.A, true);
     }
 
-    // Rotate Right memory
-    static inline void RR_IY_(Z80* ctx, signed char d) { ctx->RR_IY(d); }
-    inline void RR_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // Rotate register Left Circular
+    static inline void RLC_B(Z80* ctx) { ctx->RLC_R(0b000); }
+    static inline void RLC_C(Z80* ctx) { ctx->RLC_R(0b001); }
+    static inline void RLC_D(Z80* ctx) { ctx->RLC_R(0b010); }
+    static inline void RLC_E(Z80* ctx) { ctx->RLC_R(0b011); }
+    static inline void RLC_H(Z80* ctx) { ctx->RLC_R(0b100); }
+    static inline void RLC_L(Z80* ctx) { ctx->RLC_R(0b101); }
+    static inline void RLC_A(Z80* ctx) { ctx->RLC_R(0b111); }
+    inline void RLC_R(unsigned char r)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RR (IY+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] RLC %s", reg.PC - 2, registerDump(r));
 #endif
-        unsigned char result = RR(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        *rp = RLC(*rp);
     }
 
-    // Shift operand location (IY+d) Right Arithmetic
-    static inline void SRA_IY_(Z80* ctx, signed char d) { ctx->SRA_IY(d); }
-    inline void SRA_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // Rotate Left register
+    static inline void RL_B(Z80* ctx) { ctx->RL_R(0b000); }
+    static inline void RL_C(Z80* ctx) { ctx->RL_R(0b001); }
+    static inline void RL_D(Z80* ctx) { ctx->RL_R(0b010); }
+    static inline void RL_E(Z80* ctx) { ctx->RL_R(0b011); }
+    static inline void RL_H(Z80* ctx) { ctx->RL_R(0b100); }
+    static inline void RL_L(Z80* ctx) { ctx->RL_R(0b101); }
+    static inline void RL_A(Z80* ctx) { ctx->RL_R(0b111); }
+    inline void RL_R(unsigned char r)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRA (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] RL %s <C:%s>", reg.PC - 2, registerDump(r), isFlagC() ? "ON" : "OFF");
 #endif
-        unsigned char result = SRA(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        *rp = RL(*rp);
     }
 
-    // Shift operand location (IY+d) Right Logical
-    static inline void SRL_IY_(Z80* ctx, signed char d) { ctx->SRL_IY(d); }
-    inline void SRL_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
-    {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
+    // Shift operand register left Arithmetic
+    static inline void SLA_B(Z80* ctx) { ctx->SLA_R(0b000); }
+    static inline void SLA_C(Z80* ctx) { ctx->SLA_R(0b001); }
+    static inline void SLA_D(Z80* ctx) { ctx->SLA_R(0b010); }
+    static inline void SLA_E(Z80* ctx) { ctx->SLA_R(0b011); }
+    static inline void SLA_H(Z80* ctx) { ctx->SLA_R(0b100); }
+    static inline void SLA_L(Z80* ctx) { ctx->SLA_R(0b101); }
+    static inline void SLA_A(Z80* ctx) { ctx->SLA_R(0b111); }
+    inline void SLA_R(unsigned char r)
+    {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SRL (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] SLA %s", reg.PC - 2, registerDump(r));
 #endif
-        unsigned char result = SRL(n);
-        if (rp) *rp = result;
-        writeByte(addr, result, 3);
+        *rp = SLA(*rp);
     }
 
-    inline void addition8(int addition, int carry) { arithmetic8(false, addition, carry, true, true); }
-    inline void subtract8(int subtract, int carry, bool setCarry = true, bool setResult = true) { arithmetic8(true, subtract, carry, setCarry, setResult); }
-    inline void arithmetic8(bool negative, int addition, int carry, bool setCarry, bool setResult)
+    // Rotate register Right Circular
+    static inline void RRC_B(Z80* ctx) { ctx->RRC_R(0b000); }
+    static inline void RRC_C(Z80* ctx) { ctx->RRC_R(0b001); }
+    static inline void RRC_D(Z80* ctx) { ctx->RRC_R(0b010); }
+    static inline void RRC_E(Z80* ctx) { ctx->RRC_R(0b011); }
+    static inline void RRC_H(Z80* ctx) { ctx->RRC_R(0b100); }
+    static inline void RRC_L(Z80* ctx) { ctx->RRC_R(0b101); }
+    static inline void RRC_A(Z80* ctx) { ctx->RRC_R(0b111); }
+    inline void RRC_R(unsigned char r)
     {
-        int before = reg.pair.A;
-        int result = before + (negative ? -addition - carry : addition + carry);
-        int carryX = before ^ addition ^ result;
-        unsigned char finalResult = result & 0xFF;
-        setFlagZ(0 == finalResult);
-        setFlagN(negative);
-        setFlagS(0x80 & finalResult);
-        setFlagH(carryX & 0x10);
-        setFlagPV(((carryX << 1) ^ carryX) & 0x100);
-        if (setCarry) setFlagC(carryX & 0x100);
-        if (setResult) {
-            reg.pair.A = finalResult;
-            setFlagXY(reg.pair.A);
-        } else {
-            setFlagXY(addition);
-        }
+        unsigned char* rp = getRegisterPointer(r);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RRC %s", reg.PC - 2, registerDump(r));
+#endif
+        *rp = RRC(*rp);
     }
 
-    inline void setFlagByIncrement(unsigned char before)
+    // Rotate Right register
+    static inline void RR_B(Z80* ctx) { ctx->RR_R(0b000); }
+    static inline void RR_C(Z80* ctx) { ctx->RR_R(0b001); }
+    static inline void RR_D(Z80* ctx) { ctx->RR_R(0b010); }
+    static inline void RR_E(Z80* ctx) { ctx->RR_R(0b011); }
+    static inline void RR_H(Z80* ctx) { ctx->RR_R(0b100); }
+    static inline void RR_L(Z80* ctx) { ctx->RR_R(0b101); }
+    static inline void RR_A(Z80* ctx) { ctx->RR_R(0b111); }
+    inline void RR_R(unsigned char r)
     {
-        unsigned char finalResult = before + 1;
-        resetFlagN();
-        setFlagZ(0 == finalResult);
-        setFlagS(0x80 & finalResult);
-        setFlagH((finalResult & 0x0F) == 0x00);
-        setFlagPV(finalResult == 0x80);
-        setFlagXY(finalResult);
+        unsigned char* rp = getRegisterPointer(r);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RR %s <C:%s>", reg.PC - 2, registerDump(r), isFlagC() ? "ON" : "OFF");
+#endif
+        *rp = RR(*rp);
     }
 
-    inline void setFlagByDecrement(unsigned char before)
+    // Shift operand register Right Arithmetic
+    static inline void SRA_B(Z80* ctx) { ctx->SRA_R(0b000); }
+    static inline void SRA_C(Z80* ctx) { ctx->SRA_R(0b001); }
+    static inline void SRA_D(Z80* ctx) { ctx->SRA_R(0b010); }
+    static inline void SRA_E(Z80* ctx) { ctx->SRA_R(0b011); }
+    static inline void SRA_H(Z80* ctx) { ctx->SRA_R(0b100); }
+    static inline void SRA_L(Z80* ctx) { ctx->SRA_R(0b101); }
+    static inline void SRA_A(Z80* ctx) { ctx->SRA_R(0b111); }
+    inline void SRA_R(unsigned char r)
     {
-        unsigned char finalResult = before - 1;
-        setFlagN();
-        setFlagZ(0 == finalResult);
-        setFlagS(0x80 & finalResult);
-        setFlagH((finalResult & 0x0F) == 0x0F);
-        setFlagPV(finalResult == 0x7F);
-        setFlagXY(finalResult);
+        unsigned char* rp = getRegisterPointer(r);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] SRA %s", reg.PC - 2, registerDump(r));
+#endif
+        *rp = SRA(*rp);
     }
 
-    // Add Reg. r to Acc.
-    static inline void ADD_B(Z80* ctx) { ctx->ADD_R(0b000); }
-    static inline void ADD_C(Z80* ctx) { ctx->ADD_R(0b001); }
-    static inline void ADD_D(Z80* ctx) { ctx->ADD_R(0b010); }
-    static inline void ADD_E(Z80* ctx) { ctx->ADD_R(0b011); }
-    static inline void ADD_H(Z80* ctx) { ctx->ADD_R(0b100); }
-    static inline void ADD_L(Z80* ctx) { ctx->ADD_R(0b101); }
-    static inline void ADD_A(Z80* ctx) { ctx->ADD_R(0b111); }
-    static inline void ADD_B_2(Z80* ctx) { ctx->ADD_R(0b000, 2); }
-    static inline void ADD_C_2(Z80* ctx) { ctx->ADD_R(0b001, 2); }
-    static inline void ADD_D_2(Z80* ctx) { ctx->ADD_R(0b010, 2); }
-    static inline void ADD_E_2(Z80* ctx) { ctx->ADD_R(0b011, 2); }
-    static inline void ADD_A_2(Z80* ctx) { ctx->ADD_R(0b111, 2); }
-    inline void ADD_R(unsigned char r, int pc = 1)
+    // Shift operand register Right Logical
+    static inline void SRL_B(Z80* ctx) { ctx->SRL_R(0b000); }
+    static inline void SRL_C(Z80* ctx) { ctx->SRL_R(0b001); }
+    static inline void SRL_D(Z80* ctx) { ctx->SRL_R(0b010); }
+    static inline void SRL_E(Z80* ctx) { ctx->SRL_R(0b011); }
+    static inline void SRL_H(Z80* ctx) { ctx->SRL_R(0b100); }
+    static inline void SRL_L(Z80* ctx) { ctx->SRL_R(0b101); }
+    static inline void SRL_A(Z80* ctx) { ctx->SRL_R(0b111); }
+    inline void SRL_R(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
+        if (isDebug()) log("[%04X] SRL %s", reg.PC - 2, registerDump(r));
 #endif
-        unsigned char* rp = getRegisterPointer(r);
-        addition8(*rp, 0);
+        *rp = SRL(*rp);
     }
 
-    // Add IXH to Acc.
-    static inline void ADD_IXH_(Z80* ctx) { ctx->ADD_IXH(); }
-    inline void ADD_IXH()
+    // Shift operand register Left Logical
+    static inline void SLL_B(Z80* ctx) { ctx->SLL_R(0b000); }
+    static inline void SLL_C(Z80* ctx) { ctx->SLL_R(0b001); }
+    static inline void SLL_D(Z80* ctx) { ctx->SLL_R(0b010); }
+    static inline void SLL_E(Z80* ctx) { ctx->SLL_R(0b011); }
+    static inline void SLL_H(Z80* ctx) { ctx->SLL_R(0b100); }
+    static inline void SLL_L(Z80* ctx) { ctx->SLL_R(0b101); }
+    static inline void SLL_A(Z80* ctx) { ctx->SLL_R(0b111); }
+    inline void SLL_R(unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
+        if (isDebug()) log("[%04X] SLL %s", reg.PC - 2, registerDump(r));
 #endif
-        addition8(getIXH(), 0);
+        *rp = SLL(*rp);
     }
 
-    // Add IXL to Acc.
-    static inline void ADD_IXL_(Z80* ctx) { ctx->ADD_IXL(); }
-    inline void ADD_IXL()
+    // Rotate memory (HL) Left Circular
+    static inline void RLC_HL_(Z80* ctx) { ctx->RLC_HL(); }
+    inline void RLC_HL()
     {
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
+        if (isDebug()) log("[%04X] RLC (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
 #endif
-        addition8(getIXL(), 0);
+        writeByte(addr, RLC(n), 3);
     }
 
-    // Add IYH to Acc.
-    static inline void ADD_IYH_(Z80* ctx) { ctx->ADD_IYH(); }
-    inline void ADD_IYH()
+    // Rotate Left memory
+    static inline void RL_HL_(Z80* ctx) { ctx->RL_HL(); }
+    inline void RL_HL()
     {
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
+        if (isDebug()) log("[%04X] RL (HL<$%04X>) = $%02X <C:%s>", reg.PC - 2, addr, n, isFlagC() ? "ON" : "OFF");
 #endif
-        addition8(getIYH(), 0);
+        writeByte(addr, RL(n), 3);
     }
 
-    // Add IYL to Acc.
-    static inline void ADD_IYL_(Z80* ctx) { ctx->ADD_IYL(); }
-    inline void ADD_IYL()
+    // Shift operand location (HL) left Arithmetic
+    static inline void SLA_HL_(Z80* ctx) { ctx->SLA_HL(); }
+    inline void SLA_HL()
     {
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+        if (isDebug()) log("[%04X] SLA (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
 #endif
-        addition8(getIYL(), 0);
+        writeByte(addr, SLA(n), 3);
     }
 
-    // Add value n to Acc.
-    static inline void ADD_N(Z80* ctx)
+    // Rotate memory (HL) Right Circular
+    static inline void RRC_HL_(Z80* ctx) { ctx->RRC_HL(); }
+    inline void RRC_HL()
     {
-        unsigned char n = ctx->fetch(3);
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] ADD %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+        if (isDebug()) log("[%04X] RRC (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
 #endif
-        ctx->addition8(n, 0);
+        writeByte(addr, RRC(n), 3);
     }
 
-    // Add location (HL) to Acc.
-    static inline void ADD_HL(Z80* ctx)
+    // Rotate Right memory
+    static inline void RR_HL_(Z80* ctx) { ctx->RR_HL(); }
+    inline void RR_HL()
     {
-        unsigned short addr = ctx->getHL();
-        unsigned char n = ctx->readByte(addr, 3);
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] ADD %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
+        if (isDebug()) log("[%04X] RR (HL<$%04X>) = $%02X <C:%s>", reg.PC - 2, addr, n, isFlagC() ? "ON" : "OFF");
 #endif
-        ctx->addition8(n, 0);
+        writeByte(addr, RR(n), 3);
     }
 
-    // Add location (IX+d) to Acc.
-    static inline void ADD_IX_(Z80* ctx) { ctx->ADD_IX(); }
-    inline void ADD_IX()
+    // Shift operand location (HL) Right Arithmetic
+    static inline void SRA_HL_(Z80* ctx) { ctx->SRA_HL(); }
+    inline void SRA_HL()
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned short addr = getHL();
         unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
+        if (isDebug()) log("[%04X] SRA (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
 #endif
-        addition8(n, 0);
-        consumeClock(3);
+        writeByte(addr, SRA(n), 3);
     }
 
-    // Add location (IY+d) to Acc.
-    static inline void ADD_IY_(Z80* ctx) { ctx->ADD_IY(); }
-    inline void ADD_IY()
+    // Shift operand location (HL) Right Logical
+    static inline void SRL_HL_(Z80* ctx) { ctx->SRL_HL(); }
+    inline void SRL_HL()
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned short addr = getHL();
         unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
+        if (isDebug()) log("[%04X] SRL (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
 #endif
-        addition8(n, 0);
-        consumeClock(3);
+        writeByte(addr, SRL(n), 3);
     }
 
-    // Add Resister with carry
-    static inline void ADC_B(Z80* ctx) { ctx->ADC_R(0b000); }
-    static inline void ADC_C(Z80* ctx) { ctx->ADC_R(0b001); }
-    static inline void ADC_D(Z80* ctx) { ctx->ADC_R(0b010); }
-    static inline void ADC_E(Z80* ctx) { ctx->ADC_R(0b011); }
-    static inline void ADC_H(Z80* ctx) { ctx->ADC_R(0b100); }
-    static inline void ADC_L(Z80* ctx) { ctx->ADC_R(0b101); }
-    static inline void ADC_A(Z80* ctx) { ctx->ADC_R(0b111); }
-    static inline void ADC_B_2(Z80* ctx) { ctx->ADC_R(0b000, 2); }
-    static inline void ADC_C_2(Z80* ctx) { ctx->ADC_R(0b001, 2); }
-    static inline void ADC_D_2(Z80* ctx) { ctx->ADC_R(0b010, 2); }
-    static inline void ADC_E_2(Z80* ctx) { ctx->ADC_R(0b011, 2); }
-    static inline void ADC_A_2(Z80* ctx) { ctx->ADC_R(0b111, 2); }
-    inline void ADC_R(unsigned char r, int pc = 1)
+    // Shift operand location (HL) Left Logical
+    static inline void SLL_HL_(Z80* ctx) { ctx->SLL_HL(); }
+    inline void SLL_HL()
     {
-        unsigned char* rp = getRegisterPointer(r);
-        unsigned char c = isFlagC() ? 1 : 0;
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, %s <C:%s>", reg.PC - pc, registerDump(0b111), registerDump(r), c ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] SLL (HL<$%04X>) = $%02X", reg.PC - 2, addr, n);
 #endif
-        addition8(*rp, c);
+        writeByte(addr, SLL(n), 3);
     }
 
-    // Add IXH to Acc.
-    static inline void ADC_IXH_(Z80* ctx) { ctx->ADC_IXH(); }
-    inline void ADC_IXH()
+    // Rotate memory (IX+d) Left Circular
+    static inline void RLC_IX_(Z80* ctx, signed char d) { ctx->RLC_IX(d); }
+    inline void RLC_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char c = isFlagC() ? 1 : 0;
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, IXH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXH(), c ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] RLC (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        addition8(getIXH(), c);
+        unsigned char result = RLC(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Add IXL to Acc.
-    static inline void ADC_IXL_(Z80* ctx) { ctx->ADC_IXL(); }
-    inline void ADC_IXL()
+    // Rotate memory (IX+d) Left Circular with load to Reg A/B/C/D/E/H/L/F
+    static inline void RLC_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b000); }
+    static inline void RLC_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b001); }
+    static inline void RLC_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b010); }
+    static inline void RLC_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b011); }
+    static inline void RLC_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b100); }
+    static inline void RLC_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b101); }
+    static inline void RLC_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RLC_IX_with_LD(d, 0b111); }
+    inline void RLC_IX_with_LD(signed char d, unsigned char r)
     {
-        unsigned char c = isFlagC() ? 1 : 0;
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, IXL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXL(), c ? "ON" : "OFF");
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RLC_IX(d, rp, buf);
+#else
+        RLC_IX(d, rp);
 #endif
-        addition8(getIXL(), c);
     }
 
-    // Add IYH to Acc.
-    static inline void ADC_IYH_(Z80* ctx) { ctx->ADC_IYH(); }
-    inline void ADC_IYH()
+    // Rotate memory (IY+d) Left Circular with load to Reg A/B/C/D/E/H/L/F
+    static inline void RLC_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b000); }
+    static inline void RLC_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b001); }
+    static inline void RLC_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b010); }
+    static inline void RLC_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b011); }
+    static inline void RLC_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b100); }
+    static inline void RLC_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b101); }
+    static inline void RLC_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RLC_IY_with_LD(d, 0b111); }
+    inline void RLC_IY_with_LD(signed char d, unsigned char r)
     {
-        unsigned char c = isFlagC() ? 1 : 0;
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, IYH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYH(), c ? "ON" : "OFF");
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RLC_IY(d, rp, buf);
+#else
+        RLC_IY(d, rp);
 #endif
-        addition8(getIYH(), c);
     }
 
-    // Add IYL to Acc.
-    static inline void ADC_IYL_(Z80* ctx) { ctx->ADC_IYL(); }
-    inline void ADC_IYL()
+    // Rotate memory (IX+d) Right Circular
+    static inline void RRC_IX_(Z80* ctx, signed char d) { ctx->RRC_IX(d); }
+    inline void RRC_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char c = isFlagC() ? 1 : 0;
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, IYL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYL(), c ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] RRC (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        addition8(getIYL(), c);
+        unsigned char result = RRC(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Add immediate with carry
-    static inline void ADC_N(Z80* ctx)
+    // Rotate memory (IX+d) Right Circular with load to Reg A/B/C/D/E/H/L/F
+    static inline void RRC_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b000); }
+    static inline void RRC_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b001); }
+    static inline void RRC_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b010); }
+    static inline void RRC_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b011); }
+    static inline void RRC_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b100); }
+    static inline void RRC_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b101); }
+    static inline void RRC_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RRC_IX_with_LD(d, 0b111); }
+    inline void RRC_IX_with_LD(signed char d, unsigned char r)
     {
-        unsigned char n = ctx->fetch(3);
-        unsigned char c = ctx->isFlagC() ? 1 : 0;
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] ADC %s, $%02X <C:%s>", ctx->reg.PC - 2, ctx->registerDump(0b111), n, c ? "ON" : "OFF");
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RRC_IX(d, rp, buf);
+#else
+        RRC_IX(d, rp);
 #endif
-        ctx->addition8(n, c);
     }
 
-    // Add memory with carry
-    static inline void ADC_HL(Z80* ctx)
+    // Rotate memory (IY+d) Right Circular with load to Reg A/B/C/D/E/H/L/F
+    static inline void RRC_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b000); }
+    static inline void RRC_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b001); }
+    static inline void RRC_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b010); }
+    static inline void RRC_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b011); }
+    static inline void RRC_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b100); }
+    static inline void RRC_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b101); }
+    static inline void RRC_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RRC_IY_with_LD(d, 0b111); }
+    inline void RRC_IY_with_LD(signed char d, unsigned char r)
     {
-        unsigned short addr = ctx->getHL();
-        unsigned char n = ctx->readByte(addr, 3);
-        unsigned char c = ctx->isFlagC() ? 1 : 0;
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] ADC %s, (%s) = $%02X <C:%s>", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n, c ? "ON" : "OFF");
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RRC_IY(d, rp, buf);
+#else
+        RRC_IY(d, rp);
 #endif
-        ctx->addition8(n, c);
     }
 
-    // Add memory with carry
-    static inline void ADC_IX_(Z80* ctx) { ctx->ADC_IX(); }
-    inline void ADC_IX()
+    // Rotate Left memory
+    static inline void RL_IX_(Z80* ctx, signed char d) { ctx->RL_IX(d); }
+    inline void RL_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        signed char d = (signed char)fetch(4);
         unsigned short addr = (unsigned short)(reg.IX + d);
         unsigned char n = readByte(addr);
-        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, (IX+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), addr, n, c ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] RL (IX+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
 #endif
-        addition8(n, c);
-        consumeClock(3);
+        unsigned char result = RL(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Add memory with carry
-    static inline void ADC_IY_(Z80* ctx) { ctx->ADC_IY(); }
-    inline void ADC_IY()
+    // Rotate Left memory with load Reg.
+    static inline void RL_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b000); }
+    static inline void RL_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b001); }
+    static inline void RL_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b010); }
+    static inline void RL_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b011); }
+    static inline void RL_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b100); }
+    static inline void RL_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b101); }
+    static inline void RL_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RL_IX_with_LD(d, 0b111); }
+    inline void RL_IX_with_LD(signed char d, unsigned char r)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
-        unsigned char c = isFlagC() ? 1 : 0;
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, (IY+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), addr, n, c ? "ON" : "OFF");
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RL_IX(d, rp, buf);
+#else
+        RL_IX(d, rp);
 #endif
-        addition8(n, c);
-        consumeClock(3);
     }
 
-    // Increment Register
-    static inline void INC_B(Z80* ctx) { ctx->INC_R(0b000); }
-    static inline void INC_C(Z80* ctx) { ctx->INC_R(0b001); }
-    static inline void INC_D(Z80* ctx) { ctx->INC_R(0b010); }
-    static inline void INC_E(Z80* ctx) { ctx->INC_R(0b011); }
-    static inline void INC_H(Z80* ctx) { ctx->INC_R(0b100); }
-    static inline void INC_L(Z80* ctx) { ctx->INC_R(0b101); }
-    static inline void INC_A(Z80* ctx) { ctx->INC_R(0b111); }
-    static inline void INC_B_2(Z80* ctx) { ctx->INC_R(0b000, 2); }
-    static inline void INC_C_2(Z80* ctx) { ctx->INC_R(0b001, 2); }
-    static inline void INC_D_2(Z80* ctx) { ctx->INC_R(0b010, 2); }
-    static inline void INC_E_2(Z80* ctx) { ctx->INC_R(0b011, 2); }
-    static inline void INC_A_2(Z80* ctx) { ctx->INC_R(0b111, 2); }
-    inline void INC_R(unsigned char r, int pc = 1)
+    // Rotate Left memory with load Reg.
+    static inline void RL_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b000); }
+    static inline void RL_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b001); }
+    static inline void RL_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b010); }
+    static inline void RL_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b011); }
+    static inline void RL_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b100); }
+    static inline void RL_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b101); }
+    static inline void RL_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RL_IY_with_LD(d, 0b111); }
+    inline void RL_IY_with_LD(signed char d, unsigned char r)
     {
         unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC %s", reg.PC - pc, registerDump(r));
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RL_IY(d, rp, buf);
+#else
+        RL_IY(d, rp);
 #endif
-        setFlagByIncrement(*rp);
-        (*rp)++;
     }
 
-    // Increment location (HL)
-    static inline void INC_HL(Z80* ctx)
+    // Rotate Right memory
+    static inline void RR_IX_(Z80* ctx, signed char d) { ctx->RR_IX(d); }
+    inline void RR_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned short addr = ctx->getHL();
-        unsigned char n = ctx->readByte(addr);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] INC (%s) = $%02X", ctx->reg.PC - 1, ctx->registerPairDump(0b10), n);
+        if (isDebug()) log("[%04X] RR (IX+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
 #endif
-        ctx->setFlagByIncrement(n);
-        ctx->writeByte(addr, n + 1, 3);
+        unsigned char result = RR(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Increment location (IX+d)
-    static inline void INC_IX_(Z80* ctx) { ctx->INC_IX(); }
-    inline void INC_IX()
+    // Rotate Right memory with load Reg.
+    static inline void RR_IX_with_LD_B(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b000); }
+    static inline void RR_IX_with_LD_C(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b001); }
+    static inline void RR_IX_with_LD_D(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b010); }
+    static inline void RR_IX_with_LD_E(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b011); }
+    static inline void RR_IX_with_LD_H(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b100); }
+    static inline void RR_IX_with_LD_L(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b101); }
+    static inline void RR_IX_with_LD_A(Z80* ctx, signed char d) { ctx->RR_IX_with_LD(d, 0b111); }
+    inline void RR_IX_with_LD(signed char d, unsigned char r)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC (IX+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RR_IX(d, rp, buf);
+#else
+        RR_IX(d, rp);
 #endif
-        setFlagByIncrement(n);
-        writeByte(addr, n + 1);
-        consumeClock(3);
     }
 
-    // Increment register high 8 bits of IX
-    static inline void INC_IXH_(Z80* ctx) { ctx->INC_IXH(); }
-    inline void INC_IXH()
+    // Rotate Right memory with load Reg.
+    static inline void RR_IY_with_LD_B(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b000); }
+    static inline void RR_IY_with_LD_C(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b001); }
+    static inline void RR_IY_with_LD_D(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b010); }
+    static inline void RR_IY_with_LD_E(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b011); }
+    static inline void RR_IY_with_LD_H(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b100); }
+    static inline void RR_IY_with_LD_L(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b101); }
+    static inline void RR_IY_with_LD_A(Z80* ctx, signed char d) { ctx->RR_IY_with_LD(d, 0b111); }
+    inline void RR_IY_with_LD(signed char d, unsigned char r)
     {
-        unsigned char ixh = getIXH();
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC IXH<$%02X>", reg.PC - 2, ixh);
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RR_IY(d, rp, buf);
+#else
+        RR_IY(d, rp);
 #endif
-        setFlagByIncrement(ixh++);
-        setIXH(ixh);
     }
 
-    // Increment register low 8 bits of IX
-    static inline void INC_IXL_(Z80* ctx) { ctx->INC_IXL(); }
-    inline void INC_IXL()
+    // Shift operand location (IX+d) left Arithmetic
+    static inline void SLA_IX_(Z80* ctx, signed char d) { ctx->SLA_IX(d); }
+    inline void SLA_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char ixl = getIXL();
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC IXL<$%02X>", reg.PC - 2, ixl);
+        if (isDebug()) log("[%04X] SLA (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        setFlagByIncrement(ixl++);
-        setIXL(ixl);
+        unsigned char result = SLA(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Increment location (IY+d)
-    static inline void INC_IY_(Z80* ctx) { ctx->INC_IY(); }
-    inline void INC_IY()
+    // Shift operand location (IX+d) left Arithmetic with load Reg.
+    static inline void SLA_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b000); }
+    static inline void SLA_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b001); }
+    static inline void SLA_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b010); }
+    static inline void SLA_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b011); }
+    static inline void SLA_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b100); }
+    static inline void SLA_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b101); }
+    static inline void SLA_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SLA_IX_with_LD(d, 0b111); }
+    inline void SLA_IX_with_LD(signed char d, unsigned char r)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC (IY+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SLA_IX(d, rp, buf);
+#else
+        SLA_IX(d, rp);
 #endif
-        setFlagByIncrement(n);
-        writeByte(addr, n + 1);
-        consumeClock(3);
     }
 
-    // Increment register high 8 bits of IY
-    static inline void INC_IYH_(Z80* ctx) { ctx->INC_IYH(); }
-    inline void INC_IYH()
+    // Shift operand location (IY+d) left Arithmetic with load Reg.
+    static inline void SLA_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b000); }
+    static inline void SLA_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b001); }
+    static inline void SLA_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b010); }
+    static inline void SLA_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b011); }
+    static inline void SLA_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b100); }
+    static inline void SLA_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b101); }
+    static inline void SLA_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SLA_IY_with_LD(d, 0b111); }
+    inline void SLA_IY_with_LD(signed char d, unsigned char r)
     {
-        unsigned char iyh = getIYH();
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC IYH<$%02X>", reg.PC - 2, iyh);
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SLA_IY(d, rp, buf);
+#else
+        SLA_IY(d, rp);
 #endif
-        setFlagByIncrement(iyh++);
-        setIYH(iyh);
     }
 
-    // Increment register low 8 bits of IY
-    static inline void INC_IYL_(Z80* ctx) { ctx->INC_IYL(); }
-    inline void INC_IYL()
+    // Shift operand location (IX+d) Right Arithmetic
+    static inline void SRA_IX_(Z80* ctx, signed char d) { ctx->SRA_IX(d); }
+    inline void SRA_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char iyl = getIYL();
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC IYL<$%02X>", reg.PC - 2, iyl);
+        if (isDebug()) log("[%04X] SRA (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        setFlagByIncrement(iyl++);
-        setIYL(iyl);
+        unsigned char result = SRA(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract Register
-    static inline void SUB_B(Z80* ctx) { ctx->SUB_R(0b000); }
-    static inline void SUB_C(Z80* ctx) { ctx->SUB_R(0b001); }
-    static inline void SUB_D(Z80* ctx) { ctx->SUB_R(0b010); }
-    static inline void SUB_E(Z80* ctx) { ctx->SUB_R(0b011); }
-    static inline void SUB_H(Z80* ctx) { ctx->SUB_R(0b100); }
-    static inline void SUB_L(Z80* ctx) { ctx->SUB_R(0b101); }
-    static inline void SUB_A(Z80* ctx) { ctx->SUB_R(0b111); }
-    static inline void SUB_B_2(Z80* ctx) { ctx->SUB_R(0b000, 2); }
-    static inline void SUB_C_2(Z80* ctx) { ctx->SUB_R(0b001, 2); }
-    static inline void SUB_D_2(Z80* ctx) { ctx->SUB_R(0b010, 2); }
-    static inline void SUB_E_2(Z80* ctx) { ctx->SUB_R(0b011, 2); }
-    static inline void SUB_A_2(Z80* ctx) { ctx->SUB_R(0b111, 2); }
-    inline void SUB_R(unsigned char r, int pc = 1)
+    // Shift operand location (IX+d) right Arithmetic with load Reg.
+    static inline void SRA_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b000); }
+    static inline void SRA_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b001); }
+    static inline void SRA_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b010); }
+    static inline void SRA_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b011); }
+    static inline void SRA_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b100); }
+    static inline void SRA_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b101); }
+    static inline void SRA_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SRA_IX_with_LD(d, 0b111); }
+    inline void SRA_IX_with_LD(signed char d, unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SUB %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SRA_IX(d, rp, buf);
+#else
+        SRA_IX(d, rp);
 #endif
-        unsigned char* rp = getRegisterPointer(r);
-        subtract8(*rp, 0);
     }
 
-    // Subtract IXH to Acc.
-    static inline void SUB_IXH_(Z80* ctx) { ctx->SUB_IXH(); }
-    inline void SUB_IXH()
+    // Shift operand location (IY+d) right Arithmetic with load Reg.
+    static inline void SRA_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b000); }
+    static inline void SRA_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b001); }
+    static inline void SRA_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b010); }
+    static inline void SRA_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b011); }
+    static inline void SRA_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b100); }
+    static inline void SRA_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b101); }
+    static inline void SRA_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SRA_IY_with_LD(d, 0b111); }
+    inline void SRA_IY_with_LD(signed char d, unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SUB %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SRA_IY(d, rp, buf);
+#else
+        SRA_IY(d, rp);
 #endif
-        subtract8(getIXH(), 0);
     }
 
-    // Subtract IXL to Acc.
-    static inline void SUB_IXL_(Z80* ctx) { ctx->SUB_IXL(); }
-    inline void SUB_IXL()
+    // Shift operand location (IX+d) Right Logical
+    static inline void SRL_IX_(Z80* ctx, signed char d) { ctx->SRL_IX(d); }
+    inline void SRL_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SUB %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
+        if (isDebug()) log("[%04X] SRL (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        subtract8(getIXL(), 0);
+        unsigned char result = SRL(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract IYH to Acc.
-    static inline void SUB_IYH_(Z80* ctx) { ctx->SUB_IYH(); }
-    inline void SUB_IYH()
+    // Shift operand location (IX+d) Right Logical with load Reg.
+    static inline void SRL_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b000); }
+    static inline void SRL_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b001); }
+    static inline void SRL_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b010); }
+    static inline void SRL_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b011); }
+    static inline void SRL_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b100); }
+    static inline void SRL_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b101); }
+    static inline void SRL_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SRL_IX_with_LD(d, 0b111); }
+    inline void SRL_IX_with_LD(signed char d, unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SUB %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SRL_IX(d, rp, buf);
+#else
+        SRL_IX(d, rp);
 #endif
-        subtract8(getIYH(), 0);
     }
 
-    // Subtract IYL to Acc.
-    static inline void SUB_IYL_(Z80* ctx) { ctx->SUB_IYL(); }
-    inline void SUB_IYL()
+    // Shift operand location (IY+d) Right Logical with load Reg.
+    static inline void SRL_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b000); }
+    static inline void SRL_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b001); }
+    static inline void SRL_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b010); }
+    static inline void SRL_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b011); }
+    static inline void SRL_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b100); }
+    static inline void SRL_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b101); }
+    static inline void SRL_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SRL_IY_with_LD(d, 0b111); }
+    inline void SRL_IY_with_LD(signed char d, unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SUB %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SRL_IY(d, rp, buf);
+#else
+        SRL_IY(d, rp);
 #endif
-        subtract8(getIYL(), 0);
     }
 
-    // Subtract immediate
-    static inline void SUB_N(Z80* ctx)
+    // Shift operand location (IX+d) Left Logical
+    // NOTE: this function is only for SLL_IX_with_LD
+    static inline void SLL_IX_(Z80* ctx, signed char d) { ctx->SLL_IX(d); }
+    inline void SLL_IX(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char n = ctx->fetch(3);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] SUB %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+        if (isDebug()) log("[%04X] SLL (IX+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        ctx->subtract8(n, 0);
+        unsigned char result = SLL(n);
+        writeByte(addr, result, 3);
+        if (rp) *rp = result;
     }
 
-    // Subtract memory
-    static inline void SUB_HL(Z80* ctx)
-    {
-        unsigned short addr = ctx->getHL();
-        unsigned char n = ctx->readByte(addr, 3);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] SUB %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
-#endif
-        ctx->subtract8(n, 0);
-    }
-
-    // Subtract memory
-    static inline void SUB_IX_(Z80* ctx) { ctx->SUB_IX(); }
-    inline void SUB_IX()
+    // Shift operand location (IX+d) Left Logical with load Reg.
+    static inline void SLL_IX_with_LD_B(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b000); }
+    static inline void SLL_IX_with_LD_C(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b001); }
+    static inline void SLL_IX_with_LD_D(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b010); }
+    static inline void SLL_IX_with_LD_E(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b011); }
+    static inline void SLL_IX_with_LD_H(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b100); }
+    static inline void SLL_IX_with_LD_L(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b101); }
+    static inline void SLL_IX_with_LD_A(Z80* ctx, signed char d) { ctx->SLL_IX_with_LD(d, 0b111); }
+    inline void SLL_IX_with_LD(signed char d, unsigned char r)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SUB %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SLL_IX(d, rp, buf);
+#else
+        SLL_IX(d, rp);
 #endif
-        subtract8(n, 0);
-        consumeClock(3);
     }
 
-    // Subtract memory
-    static inline void SUB_IY_(Z80* ctx) { ctx->SUB_IY(); }
-    inline void SUB_IY()
+    // Shift operand location (IY+d) Left Logical
+    // NOTE: this function is only for SLL_IY_with_LD
+    static inline void SLL_IY_(Z80* ctx, signed char d) { ctx->SLL_IY(d); }
+    inline void SLL_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        signed char d = (signed char)fetch(4);
         unsigned short addr = (unsigned short)(reg.IY + d);
         unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SUB %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
+        if (isDebug()) log("[%04X] SLL (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        subtract8(n, 0);
-        consumeClock(3);
+        unsigned char result = SLL(n);
+        writeByte(addr, result, 3);
+        if (rp) *rp = result;
     }
 
-    // Subtract Resister with carry
-    static inline void SBC_B(Z80* ctx) { ctx->SBC_R(0b000); }
-    static inline void SBC_C(Z80* ctx) { ctx->SBC_R(0b001); }
-    static inline void SBC_D(Z80* ctx) { ctx->SBC_R(0b010); }
-    static inline void SBC_E(Z80* ctx) { ctx->SBC_R(0b011); }
-    static inline void SBC_H(Z80* ctx) { ctx->SBC_R(0b100); }
-    static inline void SBC_L(Z80* ctx) { ctx->SBC_R(0b101); }
-    static inline void SBC_A(Z80* ctx) { ctx->SBC_R(0b111); }
-    static inline void SBC_B_2(Z80* ctx) { ctx->SBC_R(0b000, 2); }
-    static inline void SBC_C_2(Z80* ctx) { ctx->SBC_R(0b001, 2); }
-    static inline void SBC_D_2(Z80* ctx) { ctx->SBC_R(0b010, 2); }
-    static inline void SBC_E_2(Z80* ctx) { ctx->SBC_R(0b011, 2); }
-    static inline void SBC_A_2(Z80* ctx) { ctx->SBC_R(0b111, 2); }
-    inline void SBC_R(unsigned char r, int pc = 1)
+    // Shift operand location (IY+d) Left Logical with load Reg.
+    static inline void SLL_IY_with_LD_B(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b000); }
+    static inline void SLL_IY_with_LD_C(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b001); }
+    static inline void SLL_IY_with_LD_D(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b010); }
+    static inline void SLL_IY_with_LD_E(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b011); }
+    static inline void SLL_IY_with_LD_H(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b100); }
+    static inline void SLL_IY_with_LD_L(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b101); }
+    static inline void SLL_IY_with_LD_A(Z80* ctx, signed char d) { ctx->SLL_IY_with_LD(d, 0b111); }
+    inline void SLL_IY_with_LD(signed char d, unsigned char r)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, %s <C:%s>", reg.PC - pc, registerDump(0b111), registerDump(r), isFlagC() ? "ON" : "OFF");
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SLL_IY(d, rp, buf);
+#else
+        SLL_IY(d, rp);
 #endif
-        subtract8(getRegister(r), isFlagC() ? 1 : 0);
     }
 
-    // Subtract IXH to Acc. with carry
-    static inline void SBC_IXH_(Z80* ctx) { ctx->SBC_IXH(); }
-    inline void SBC_IXH()
+    // Rotate memory (IY+d) Left Circular
+    static inline void RLC_IY_(Z80* ctx, signed char d) { ctx->RLC_IY(d); }
+    inline void RLC_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, IXH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXH(), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] RLC (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        subtract8(getIXH(), isFlagC() ? 1 : 0);
+        unsigned char result = RLC(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract IXL to Acc. with carry
-    static inline void SBC_IXL_(Z80* ctx) { ctx->SBC_IXL(); }
-    inline void SBC_IXL()
+    // Rotate memory (IY+d) Right Circular
+    static inline void RRC_IY_(Z80* ctx, signed char d) { ctx->RRC_IY(d); }
+    inline void RRC_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, IXL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXL(), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] RRC (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        subtract8(getIXL(), isFlagC() ? 1 : 0);
+        unsigned char result = RRC(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract IYH to Acc. with carry
-    static inline void SBC_IYH_(Z80* ctx) { ctx->SBC_IYH(); }
-    inline void SBC_IYH()
+    // Rotate Left memory
+    static inline void RL_IY_(Z80* ctx, signed char d) { ctx->RL_IY(d); }
+    inline void RL_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, IYH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYH(), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] RL (IY+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
 #endif
-        subtract8(getIYH(), isFlagC() ? 1 : 0);
+        unsigned char result = RL(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract IYL to Acc. with carry
-    static inline void SBC_IYL_(Z80* ctx) { ctx->SBC_IYL(); }
-    inline void SBC_IYL()
+    // Shift operand location (IY+d) left Arithmetic
+    static inline void SLA_IY_(Z80* ctx, signed char d) { ctx->SLA_IY(d); }
+    inline void SLA_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, IYL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYL(), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] SLA (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        subtract8(getIYL(), isFlagC() ? 1 : 0);
+        unsigned char result = SLA(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract immediate with carry
-    static inline void SBC_N(Z80* ctx)
+    // Rotate Right memory
+    static inline void RR_IY_(Z80* ctx, signed char d) { ctx->RR_IY(d); }
+    inline void RR_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char n = ctx->fetch(3);
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] SBC %s, $%02X <C:%s>", ctx->reg.PC - 2, ctx->registerDump(0b111), n, ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] RR (IY+d<$%04X>) = $%02X <C:%s>%s", reg.PC - 4, addr, n, isFlagC() ? "ON" : "OFF", extraLog ? extraLog : "");
 #endif
-        ctx->subtract8(n, ctx->isFlagC() ? 1 : 0);
+        unsigned char result = RR(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract memory with carry
-    static inline void SBC_HL(Z80* ctx)
+    // Shift operand location (IY+d) Right Arithmetic
+    static inline void SRA_IY_(Z80* ctx, signed char d) { ctx->SRA_IY(d); }
+    inline void SRA_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char n = ctx->readByte(ctx->getHL(), 3);
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] SBC %s, (%s) = $%02X <C:%s>", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n, ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] SRA (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        ctx->subtract8(n, ctx->isFlagC() ? 1 : 0);
+        unsigned char result = SRA(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract memory with carry
-    static inline void SBC_IX_(Z80* ctx) { ctx->SBC_IX(); }
-    inline void SBC_IX()
+    // Shift operand location (IY+d) Right Logical
+    static inline void SRL_IY_(Z80* ctx, signed char d) { ctx->SRL_IY(d); }
+    inline void SRL_IY(signed char d, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((unsigned short)(reg.IX + d));
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, (IX+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), n, isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] SRL (IY+d<$%04X>) = $%02X%s", reg.PC - 4, addr, n, extraLog ? extraLog : "");
 #endif
-        subtract8(n, isFlagC() ? 1 : 0);
-        consumeClock(3);
+        unsigned char result = SRL(n);
+        if (rp) *rp = result;
+        writeByte(addr, result, 3);
     }
 
-    // Subtract memory with carry
-    static inline void SBC_IY_(Z80* ctx) { ctx->SBC_IY(); }
-    inline void SBC_IY()
+    inline void addition8(int addition, int carry) { arithmetic8(false, addition, carry, true, true); }
+    inline void subtract8(int subtract, int carry, bool setCarry = true, bool setResult = true) { arithmetic8(true, subtract, carry, setCarry, setResult); }
+    inline void arithmetic8(bool negative, int addition, int carry, bool setCarry, bool setResult)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((unsigned short)(reg.IY + d));
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, (IY+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), n, isFlagC() ? "ON" : "OFF");
-#endif
-        subtract8(n, isFlagC() ? 1 : 0);
-        consumeClock(3);
+        int before = reg.pair.A;
+        int result = before + (negative ? -addition - carry : addition + carry);
+        int carryX = before ^ addition ^ result;
+        unsigned char finalResult = result & 0xFF;
+        setFlagZ(0 == finalResult);
+        setFlagN(negative);
+        setFlagS(0x80 & finalResult);
+        setFlagH(carryX & 0x10);
+        setFlagPV(((carryX << 1) ^ carryX) & 0x100);
+        if (setCarry) setFlagC(carryX & 0x100);
+        if (setResult) {
+            reg.pair.A = finalResult;
+            setFlagXY(reg.pair.A);
+        } else {
+            setFlagXY(addition);
+        }
     }
 
-    // Decrement Register
-    static inline void DEC_B(Z80* ctx) { ctx->DEC_R(0b000); }
-    static inline void DEC_C(Z80* ctx) { ctx->DEC_R(0b001); }
-    static inline void DEC_D(Z80* ctx) { ctx->DEC_R(0b010); }
-    static inline void DEC_E(Z80* ctx) { ctx->DEC_R(0b011); }
-    static inline void DEC_H(Z80* ctx) { ctx->DEC_R(0b100); }
-    static inline void DEC_L(Z80* ctx) { ctx->DEC_R(0b101); }
-    static inline void DEC_A(Z80* ctx) { ctx->DEC_R(0b111); }
-    static inline void DEC_B_2(Z80* ctx) { ctx->DEC_R(0b000, 2); }
-    static inline void DEC_C_2(Z80* ctx) { ctx->DEC_R(0b001, 2); }
-    static inline void DEC_D_2(Z80* ctx) { ctx->DEC_R(0b010, 2); }
-    static inline void DEC_E_2(Z80* ctx) { ctx->DEC_R(0b011, 2); }
-    static inline void DEC_A_2(Z80* ctx) { ctx->DEC_R(0b111, 2); }
-    inline void DEC_R(unsigned char r, int pc = 1)
+    inline void setFlagByIncrement(unsigned char before)
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC %s", reg.PC - pc, registerDump(r));
-#endif
-        setFlagByDecrement(*rp);
-        (*rp)--;
+        unsigned char finalResult = before + 1;
+        resetFlagN();
+        setFlagZ(0 == finalResult);
+        setFlagS(0x80 & finalResult);
+        setFlagH((finalResult & 0x0F) == 0x00);
+        setFlagPV(finalResult == 0x80);
+        setFlagXY(finalResult);
     }
 
-    // Decrement location (HL)
-    static inline void DEC_HL(Z80* ctx)
+    inline void setFlagByDecrement(unsigned char before)
     {
-        unsigned short addr = ctx->getHL();
-        unsigned char n = ctx->readByte(addr);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] DEC (%s) = $%02X", ctx->reg.PC - 1, ctx->registerPairDump(0b10), n);
-#endif
-        ctx->setFlagByDecrement(n);
-        ctx->writeByte(addr, n - 1, 3);
+        unsigned char finalResult = before - 1;
+        setFlagN();
+        setFlagZ(0 == finalResult);
+        setFlagS(0x80 & finalResult);
+        setFlagH((finalResult & 0x0F) == 0x0F);
+        setFlagPV(finalResult == 0x7F);
+        setFlagXY(finalResult);
     }
 
-    // Decrement location (IX+d)
-    static inline void DEC_IX_(Z80* ctx) { ctx->DEC_IX(); }
-    inline void DEC_IX()
+    // Add Reg. r to Acc.
+    static inline void ADD_B(Z80* ctx) { ctx->ADD_R(0b000); }
+    static inline void ADD_C(Z80* ctx) { ctx->ADD_R(0b001); }
+    static inline void ADD_D(Z80* ctx) { ctx->ADD_R(0b010); }
+    static inline void ADD_E(Z80* ctx) { ctx->ADD_R(0b011); }
+    static inline void ADD_H(Z80* ctx) { ctx->ADD_R(0b100); }
+    static inline void ADD_L(Z80* ctx) { ctx->ADD_R(0b101); }
+    static inline void ADD_A(Z80* ctx) { ctx->ADD_R(0b111); }
+    static inline void ADD_B_2(Z80* ctx) { ctx->ADD_R(0b000, 2); }
+    static inline void ADD_C_2(Z80* ctx) { ctx->ADD_R(0b001, 2); }
+    static inline void ADD_D_2(Z80* ctx) { ctx->ADD_R(0b010, 2); }
+    static inline void ADD_E_2(Z80* ctx) { ctx->ADD_R(0b011, 2); }
+    static inline void ADD_A_2(Z80* ctx) { ctx->ADD_R(0b111, 2); }
+    inline void ADD_R(unsigned char r, int pc = 1)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC (IX+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
+        if (isDebug()) log("[%04X] ADD %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
 #endif
-        setFlagByDecrement(n);
-        writeByte(addr, n - 1);
-        consumeClock(3);
+        unsigned char* rp = getRegisterPointer(r);
+        addition8(*rp, 0);
     }
 
-    // Decrement high 8 bits of IX
-    static inline void DEC_IXH_(Z80* ctx) { ctx->DEC_IXH(); }
-    inline void DEC_IXH()
+    // Add IXH to Acc.
+    static inline void ADD_IXH_(Z80* ctx) { ctx->ADD_IXH(); }
+    inline void ADD_IXH()
     {
-        unsigned char ixh = getIXH();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC IXH<$%02X>", reg.PC - 2, ixh);
+        if (isDebug()) log("[%04X] ADD %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
 #endif
-        setFlagByDecrement(ixh--);
-        setIXH(ixh);
+        addition8(getIXH(), 0);
     }
 
-    // Decrement low 8 bits of IX
-    static inline void DEC_IXL_(Z80* ctx) { ctx->DEC_IXL(); }
-    inline void DEC_IXL()
+    // Add IXL to Acc.
+    static inline void ADD_IXL_(Z80* ctx) { ctx->ADD_IXL(); }
+    inline void ADD_IXL()
     {
-        unsigned char ixl = getIXL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC IXL<$%02X>", reg.PC - 2, ixl);
+        if (isDebug()) log("[%04X] ADD %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
 #endif
-        setFlagByDecrement(ixl--);
-        setIXL(ixl);
+        addition8(getIXL(), 0);
     }
 
-    // Decrement location (IY+d)
-    static inline void DEC_IY_(Z80* ctx) { ctx->DEC_IY(); }
-    inline void DEC_IY()
+    // Add IYH to Acc.
+    static inline void ADD_IYH_(Z80* ctx) { ctx->ADD_IYH(); }
+    inline void ADD_IYH()
     {
-        signed char d = (signed char)fetch(4);
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC (IY+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
+        if (isDebug()) log("[%04X] ADD %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
 #endif
-        setFlagByDecrement(n);
-        writeByte(addr, n - 1);
-        consumeClock(3);
+        addition8(getIYH(), 0);
     }
 
-    // Decrement high 8 bits of IY
-    static inline void DEC_IYH_(Z80* ctx) { ctx->DEC_IYH(); }
-    inline void DEC_IYH()
+    // Add IYL to Acc.
+    static inline void ADD_IYL_(Z80* ctx) { ctx->ADD_IYL(); }
+    inline void ADD_IYL()
     {
-        unsigned char iyh = getIYH();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC IYH<$%02X>", reg.PC - 2, iyh);
+        if (isDebug()) log("[%04X] ADD %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
 #endif
-        setFlagByDecrement(iyh--);
-        setIYH(iyh);
+        addition8(getIYL(), 0);
     }
 
-    // Decrement low 8 bits of IY
-    static inline void DEC_IYL_(Z80* ctx) { ctx->DEC_IYL(); }
-    inline void DEC_IYL()
+    // Add value n to Acc.
+    static inline void ADD_N(Z80* ctx)
     {
-        unsigned char iyl = getIYL();
+        unsigned char n = ctx->fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC IYL<$%02X>", reg.PC - 2, iyl);
+        if (ctx->isDebug()) ctx->log("[%04X] ADD %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
 #endif
-        setFlagByDecrement(iyl--);
-        setIYL(iyl);
+        ctx->addition8(n, 0);
     }
 
-    inline void setFlagByAdd16(unsigned short before, unsigned short addition)
+    // Add location (HL) to Acc.
+    static inline void ADD_HL(Z80* ctx)
     {
-        int result = before + addition;
-        int carrybits = before ^ addition ^ result;
-        resetFlagN();
-        setFlagXY((result & 0xFF00) >> 8);
-        setFlagC((carrybits & 0x10000) != 0);
-        setFlagH((carrybits & 0x1000) != 0);
+        unsigned short addr = ctx->getHL();
+        unsigned char n = ctx->readByte(addr, 3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] ADD %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
+#endif
+        ctx->addition8(n, 0);
     }
 
-    inline void setFlagByAdc16(unsigned short before, unsigned short addition)
+    // Add location (IX+d) to Acc.
+    static inline void ADD_IX_(Z80* ctx) { ctx->ADD_IX(); }
+    inline void ADD_IX()
     {
-        int result = before + addition;
-        int carrybits = before ^ addition ^ result;
-        unsigned short finalResult = (unsigned short)(result);
-        // same as ADD
-        resetFlagN();
-        setFlagXY((finalResult & 0xFF00) >> 8);
-        setFlagC((carrybits & 0x10000) != 0);
-        setFlagH((carrybits & 0x1000) != 0);
-        // only ADC
-        setFlagS(finalResult & 0x8000);
-        setFlagZ(0 == finalResult);
-        setFlagPV((((carrybits << 1) ^ carrybits) & 0x10000) != 0);
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] ADD %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
+#endif
+        addition8(n, 0);
+        consumeClock(3);
     }
 
-    // Add register pair to H and L
-    static inline void ADD_HL_BC(Z80* ctx) { ctx->ADD_HL_RP(0b00); }
-    static inline void ADD_HL_DE(Z80* ctx) { ctx->ADD_HL_RP(0b01); }
-    static inline void ADD_HL_HL(Z80* ctx) { ctx->ADD_HL_RP(0b10); }
-    static inline void ADD_HL_SP(Z80* ctx) { ctx->ADD_HL_RP(0b11); }
-    inline void ADD_HL_RP(unsigned char rp)
+    // Add location (IY+d) to Acc.
+    static inline void ADD_IY_(Z80* ctx) { ctx->ADD_IY(); }
+    inline void ADD_IY()
     {
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD %s, %s", reg.PC - 1, registerPairDump(0b10), registerPairDump(rp));
+        if (isDebug()) log("[%04X] ADD %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
 #endif
-        unsigned short hl = getHL();
-        unsigned short nn = getRP(rp);
-        reg.WZ = nn + 1;
-        setFlagByAdd16(hl, nn);
-        setHL(hl + nn);
-        consumeClock(7);
+        addition8(n, 0);
+        consumeClock(3);
     }
 
-    // Add with carry register pair to HL
-    static inline void ADC_HL_BC(Z80* ctx) { ctx->ADC_HL_RP(0b00); }
-    static inline void ADC_HL_DE(Z80* ctx) { ctx->ADC_HL_RP(0b01); }
-    static inline void ADC_HL_HL(Z80* ctx) { ctx->ADC_HL_RP(0b10); }
-    static inline void ADC_HL_SP(Z80* ctx) { ctx->ADC_HL_RP(0b11); }
-    inline void ADC_HL_RP(unsigned char rp)
+    // Add Resister with carry
+    static inline void ADC_B(Z80* ctx) { ctx->ADC_R(0b000); }
+    static inline void ADC_C(Z80* ctx) { ctx->ADC_R(0b001); }
+    static inline void ADC_D(Z80* ctx) { ctx->ADC_R(0b010); }
+    static inline void ADC_E(Z80* ctx) { ctx->ADC_R(0b011); }
+    static inline void ADC_H(Z80* ctx) { ctx->ADC_R(0b100); }
+    static inline void ADC_L(Z80* ctx) { ctx->ADC_R(0b101); }
+    static inline void ADC_A(Z80* ctx) { ctx->ADC_R(0b111); }
+    static inline void ADC_B_2(Z80* ctx) { ctx->ADC_R(0b000, 2); }
+    static inline void ADC_C_2(Z80* ctx) { ctx->ADC_R(0b001, 2); }
+    static inline void ADC_D_2(Z80* ctx) { ctx->ADC_R(0b010, 2); }
+    static inline void ADC_E_2(Z80* ctx) { ctx->ADC_R(0b011, 2); }
+    static inline void ADC_A_2(Z80* ctx) { ctx->ADC_R(0b111, 2); }
+    inline void ADC_R(unsigned char r, int pc = 1)
     {
+        unsigned char* rp = getRegisterPointer(r);
+        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADC %s, %s <C:%s>", reg.PC - 2, registerPairDump(0b10), registerPairDump(rp), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] ADC %s, %s <C:%s>", reg.PC - pc, registerDump(0b111), registerDump(r), c ? "ON" : "OFF");
 #endif
-        unsigned short hl = getHL();
-        unsigned short nn = getRP(rp);
-        unsigned char c = isFlagC() ? 1 : 0;
-        reg.WZ = hl + 1;
-        setFlagByAdc16(hl, c + nn);
-        setHL(hl + c + nn);
-        consumeClock(7);
+        addition8(*rp, c);
     }
 
-    // Add register pair to IX
-    static inline void ADD_IX_BC(Z80* ctx) { ctx->ADD_IX_RP(0b00); }
-    static inline void ADD_IX_DE(Z80* ctx) { ctx->ADD_IX_RP(0b01); }
-    static inline void ADD_IX_IX(Z80* ctx) { ctx->ADD_IX_RP(0b10); }
-    static inline void ADD_IX_SP(Z80* ctx) { ctx->ADD_IX_RP(0b11); }
-    inline void ADD_IX_RP(unsigned char rp)
+    // Add IXH to Acc.
+    static inline void ADC_IXH_(Z80* ctx) { ctx->ADC_IXH(); }
+    inline void ADC_IXH()
     {
+        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD IX<$%04X>, %s", reg.PC - 2, reg.IX, registerPairDumpIX(rp));
+        if (isDebug()) log("[%04X] ADC %s, IXH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXH(), c ? "ON" : "OFF");
 #endif
-        unsigned short nn = getRPIX(rp);
-        setFlagByAdd16(reg.IX, nn);
-        reg.IX += nn;
-        consumeClock(7);
+        addition8(getIXH(), c);
     }
 
-    // Add register pair to IY
-    static inline void ADD_IY_BC(Z80* ctx) { ctx->ADD_IY_RP(0b00); }
-    static inline void ADD_IY_DE(Z80* ctx) { ctx->ADD_IY_RP(0b01); }
-    static inline void ADD_IY_IY(Z80* ctx) { ctx->ADD_IY_RP(0b10); }
-    static inline void ADD_IY_SP(Z80* ctx) { ctx->ADD_IY_RP(0b11); }
-    inline void ADD_IY_RP(unsigned char rp)
+    // Add IXL to Acc.
+    static inline void ADC_IXL_(Z80* ctx) { ctx->ADC_IXL(); }
+    inline void ADC_IXL()
     {
+        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] ADD IY<$%04X>, %s", reg.PC - 2, reg.IY, registerPairDumpIY(rp));
+        if (isDebug()) log("[%04X] ADC %s, IXL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXL(), c ? "ON" : "OFF");
 #endif
-        unsigned short nn = getRPIY(rp);
-        setFlagByAdd16(reg.IY, nn);
-        reg.IY += nn;
-        consumeClock(7);
+        addition8(getIXL(), c);
     }
 
-    // Increment register pair
-    static inline void INC_RP_BC(Z80* ctx) { ctx->INC_RP(0b00); }
-    static inline void INC_RP_DE(Z80* ctx) { ctx->INC_RP(0b01); }
-    static inline void INC_RP_HL(Z80* ctx) { ctx->INC_RP(0b10); }
-    static inline void INC_RP_SP(Z80* ctx) { ctx->INC_RP(0b11); }
-    inline void INC_RP(unsigned char rp)
+    // Add IYH to Acc.
+    static inline void ADC_IYH_(Z80* ctx) { ctx->ADC_IYH(); }
+    inline void ADC_IYH()
     {
+        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC %s", reg.PC - 1, registerPairDump(rp));
+        if (isDebug()) log("[%04X] ADC %s, IYH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYH(), c ? "ON" : "OFF");
 #endif
-        setRP(rp, getRP(rp) + 1);
-        consumeClock(2);
+        addition8(getIYH(), c);
     }
 
-    // Increment IX
-    static inline void INC_IX_reg_(Z80* ctx) { ctx->INC_IX_reg(); }
-    inline void INC_IX_reg()
+    // Add IYL to Acc.
+    static inline void ADC_IYL_(Z80* ctx) { ctx->ADC_IYL(); }
+    inline void ADC_IYL()
     {
+        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC IX<$%04X>", reg.PC - 2, reg.IX);
+        if (isDebug()) log("[%04X] ADC %s, IYL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYL(), c ? "ON" : "OFF");
 #endif
-        reg.IX++;
-        consumeClock(2);
+        addition8(getIYL(), c);
     }
 
-    // Increment IY
-    static inline void INC_IY_reg_(Z80* ctx) { ctx->INC_IY_reg(); }
-    inline void INC_IY_reg()
+    // Add immediate with carry
+    static inline void ADC_N(Z80* ctx)
     {
+        unsigned char n = ctx->fetch(3);
+        unsigned char c = ctx->isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] INC IY<$%04X>", reg.PC - 2, reg.IY);
+        if (ctx->isDebug()) ctx->log("[%04X] ADC %s, $%02X <C:%s>", ctx->reg.PC - 2, ctx->registerDump(0b111), n, c ? "ON" : "OFF");
 #endif
-        reg.IY++;
-        consumeClock(2);
+        ctx->addition8(n, c);
     }
 
-    // Decrement register pair
-    static inline void DEC_RP_BC(Z80* ctx) { ctx->DEC_RP(0b00); }
-    static inline void DEC_RP_DE(Z80* ctx) { ctx->DEC_RP(0b01); }
-    static inline void DEC_RP_HL(Z80* ctx) { ctx->DEC_RP(0b10); }
-    static inline void DEC_RP_SP(Z80* ctx) { ctx->DEC_RP(0b11); }
-    inline void DEC_RP(unsigned char rp)
+    // Add memory with carry
+    static inline void ADC_HL(Z80* ctx)
     {
+        unsigned short addr = ctx->getHL();
+        unsigned char n = ctx->readByte(addr, 3);
+        unsigned char c = ctx->isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC %s", reg.PC - 1, registerPairDump(rp));
+        if (ctx->isDebug()) ctx->log("[%04X] ADC %s, (%s) = $%02X <C:%s>", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n, c ? "ON" : "OFF");
 #endif
-        setRP(rp, getRP(rp) - 1);
-        consumeClock(2);
+        ctx->addition8(n, c);
     }
 
-    // Decrement IX
-    static inline void DEC_IX_reg_(Z80* ctx) { ctx->DEC_IX_reg(); }
-    inline void DEC_IX_reg()
+    // Add memory with carry
+    static inline void ADC_IX_(Z80* ctx) { ctx->ADC_IX(); }
+    inline void ADC_IX()
     {
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
+        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC IX<$%04X>", reg.PC - 2, reg.IX);
+        if (isDebug()) log("[%04X] ADC %s, (IX+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), addr, n, c ? "ON" : "OFF");
 #endif
-        reg.IX--;
-        consumeClock(2);
+        addition8(n, c);
+        consumeClock(3);
     }
 
-    // Decrement IY
-    static inline void DEC_IY_reg_(Z80* ctx) { ctx->DEC_IY_reg(); }
-    inline void DEC_IY_reg()
+    // Add memory with carry
+    static inline void ADC_IY_(Z80* ctx) { ctx->ADC_IY(); }
+    inline void ADC_IY()
     {
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
+        unsigned char c = isFlagC() ? 1 : 0;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DEC IY<$%04X>", reg.PC - 2, reg.IY);
+        if (isDebug()) log("[%04X] ADC %s, (IY+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), addr, n, c ? "ON" : "OFF");
 #endif
-        reg.IY--;
-        consumeClock(2);
-    }
-
-    inline void setFlagBySbc16(unsigned short before, unsigned short subtract)
-    {
-        int result = before - subtract;
-        int carrybits = before ^ subtract ^ result;
-        unsigned short finalResult = (unsigned short)result;
-        setFlagN();
-        setFlagXY((finalResult & 0xFF00) >> 8);
-        setFlagC((carrybits & 0x10000) != 0);
-        setFlagH((carrybits & 0x1000) != 0);
-        setFlagS(finalResult & 0x8000);
-        setFlagZ(0 == finalResult);
-        setFlagPV((((carrybits << 1) ^ carrybits) & 0x10000) != 0);
+        addition8(n, c);
+        consumeClock(3);
     }
 
-    // Subtract register pair from HL with carry
-    static inline void SBC_HL_BC(Z80* ctx) { ctx->SBC_HL_RP(0b00); }
-    static inline void SBC_HL_DE(Z80* ctx) { ctx->SBC_HL_RP(0b01); }
-    static inline void SBC_HL_HL(Z80* ctx) { ctx->SBC_HL_RP(0b10); }
-    static inline void SBC_HL_SP(Z80* ctx) { ctx->SBC_HL_RP(0b11); }
-    inline void SBC_HL_RP(unsigned char rp)
+    // Increment Register
+    static inline void INC_B(Z80* ctx) { ctx->INC_R(0b000); }
+    static inline void INC_C(Z80* ctx) { ctx->INC_R(0b001); }
+    static inline void INC_D(Z80* ctx) { ctx->INC_R(0b010); }
+    static inline void INC_E(Z80* ctx) { ctx->INC_R(0b011); }
+    static inline void INC_H(Z80* ctx) { ctx->INC_R(0b100); }
+    static inline void INC_L(Z80* ctx) { ctx->INC_R(0b101); }
+    static inline void INC_A(Z80* ctx) { ctx->INC_R(0b111); }
+    static inline void INC_B_2(Z80* ctx) { ctx->INC_R(0b000, 2); }
+    static inline void INC_C_2(Z80* ctx) { ctx->INC_R(0b001, 2); }
+    static inline void INC_D_2(Z80* ctx) { ctx->INC_R(0b010, 2); }
+    static inline void INC_E_2(Z80* ctx) { ctx->INC_R(0b011, 2); }
+    static inline void INC_A_2(Z80* ctx) { ctx->INC_R(0b111, 2); }
+    inline void INC_R(unsigned char r, int pc = 1)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SBC %s, %s <C:%s>", reg.PC - 2, registerPairDump(0b10), registerPairDump(rp), isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] INC %s", reg.PC - pc, registerDump(r));
 #endif
-        unsigned short hl = getHL();
-        unsigned short nn = getRP(rp);
-        unsigned char c = isFlagC() ? 1 : 0;
-        reg.WZ = hl + 1;
-        setFlagBySbc16(hl, c + nn);
-        setHL(hl - c - nn);
-        consumeClock(7);
+        setFlagByIncrement(*rp);
+        (*rp)++;
     }
 
-    inline void setFlagByLogical()
+    // Increment location (HL)
+    static inline void INC_HL(Z80* ctx)
     {
-        setFlagS(reg.pair.A & 0x80);
-        setFlagZ(reg.pair.A == 0);
-        setFlagXY(reg.pair.A);
-        setFlagPV(isEvenNumberBits(reg.pair.A));
-        resetFlagN();
-        resetFlagC();
+        unsigned short addr = ctx->getHL();
+        unsigned char n = ctx->readByte(addr);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] INC (%s) = $%02X", ctx->reg.PC - 1, ctx->registerPairDump(0b10), n);
+#endif
+        ctx->setFlagByIncrement(n);
+        ctx->writeByte(addr, n + 1, 3);
     }
 
-    inline void and8(unsigned char n)
+    // Increment location (IX+d)
+    static inline void INC_IX_(Z80* ctx) { ctx->INC_IX(); }
+    inline void INC_IX()
     {
-        reg.pair.A &= n;
-        setFlagByLogical();
-        setFlagH();
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] INC (IX+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
+#endif
+        setFlagByIncrement(n);
+        writeByte(addr, n + 1);
+        consumeClock(3);
     }
 
-    inline void or8(unsigned char n)
+    // Increment register high 8 bits of IX
+    static inline void INC_IXH_(Z80* ctx) { ctx->INC_IXH(); }
+    inline void INC_IXH()
     {
-        reg.pair.A |= n;
-        setFlagByLogical();
-        resetFlagH();
+        unsigned char ixh = getIXH();
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] INC IXH<$%02X>", reg.PC - 2, ixh);
+#endif
+        setFlagByIncrement(ixh++);
+        setIXH(ixh);
     }
 
-    inline void xor8(unsigned char n)
+    // Increment register low 8 bits of IX
+    static inline void INC_IXL_(Z80* ctx) { ctx->INC_IXL(); }
+    inline void INC_IXL()
     {
-        reg.pair.A ^= n;
-        setFlagByLogical();
-        resetFlagH();
+        unsigned char ixl = getIXL();
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] INC IXL<$%02X>", reg.PC - 2, ixl);
+#endif
+        setFlagByIncrement(ixl++);
+        setIXL(ixl);
     }
 
-    // AND Register
-    static inline void AND_B(Z80* ctx) { ctx->AND_R(0b000); }
-    static inline void AND_C(Z80* ctx) { ctx->AND_R(0b001); }
-    static inline void AND_D(Z80* ctx) { ctx->AND_R(0b010); }
-    static inline void AND_E(Z80* ctx) { ctx->AND_R(0b011); }
-    static inline void AND_H(Z80* ctx) { ctx->AND_R(0b100); }
-    static inline void AND_L(Z80* ctx) { ctx->AND_R(0b101); }
-    static inline void AND_A(Z80* ctx) { ctx->AND_R(0b111); }
-    static inline void AND_B_2(Z80* ctx) { ctx->AND_R(0b000, 2); }
-    static inline void AND_C_2(Z80* ctx) { ctx->AND_R(0b001, 2); }
-    static inline void AND_D_2(Z80* ctx) { ctx->AND_R(0b010, 2); }
-    static inline void AND_E_2(Z80* ctx) { ctx->AND_R(0b011, 2); }
-    static inline void AND_A_2(Z80* ctx) { ctx->AND_R(0b111, 2); }
-    inline void AND_R(unsigned char r, int pc = 1)
+    // Increment location (IY+d)
+    static inline void INC_IY_(Z80* ctx) { ctx->INC_IY(); }
+    inline void INC_IY()
     {
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] AND %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
+        if (isDebug()) log("[%04X] INC (IY+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
 #endif
-        and8(getRegister(r));
+        setFlagByIncrement(n);
+        writeByte(addr, n + 1);
+        consumeClock(3);
     }
 
-    // AND with register IXH
-    static inline void AND_IXH_(Z80* ctx) { ctx->AND_IXH(); }
-    inline void AND_IXH()
+    // Increment register high 8 bits of IY
+    static inline void INC_IYH_(Z80* ctx) { ctx->INC_IYH(); }
+    inline void INC_IYH()
     {
+        unsigned char iyh = getIYH();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] AND %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
+        if (isDebug()) log("[%04X] INC IYH<$%02X>", reg.PC - 2, iyh);
 #endif
-        and8(getIXH());
+        setFlagByIncrement(iyh++);
+        setIYH(iyh);
     }
 
-    // AND with register IXL
-    static inline void AND_IXL_(Z80* ctx) { ctx->AND_IXL(); }
-    inline void AND_IXL()
+    // Increment register low 8 bits of IY
+    static inline void INC_IYL_(Z80* ctx) { ctx->INC_IYL(); }
+    inline void INC_IYL()
     {
+        unsigned char iyl = getIYL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] AND %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
+        if (isDebug()) log("[%04X] INC IYL<$%02X>", reg.PC - 2, iyl);
 #endif
-        and8(getIXL());
+        setFlagByIncrement(iyl++);
+        setIYL(iyl);
     }
 
-    // AND with register IYH
-    static inline void AND_IYH_(Z80* ctx) { ctx->AND_IYH(); }
-    inline void AND_IYH()
+    // Subtract Register
+    static inline void SUB_B(Z80* ctx) { ctx->SUB_R(0b000); }
+    static inline void SUB_C(Z80* ctx) { ctx->SUB_R(0b001); }
+    static inline void SUB_D(Z80* ctx) { ctx->SUB_R(0b010); }
+    static inline void SUB_E(Z80* ctx) { ctx->SUB_R(0b011); }
+    static inline void SUB_H(Z80* ctx) { ctx->SUB_R(0b100); }
+    static inline void SUB_L(Z80* ctx) { ctx->SUB_R(0b101); }
+    static inline void SUB_A(Z80* ctx) { ctx->SUB_R(0b111); }
+    static inline void SUB_B_2(Z80* ctx) { ctx->SUB_R(0b000, 2); }
+    static inline void SUB_C_2(Z80* ctx) { ctx->SUB_R(0b001, 2); }
+    static inline void SUB_D_2(Z80* ctx) { ctx->SUB_R(0b010, 2); }
+    static inline void SUB_E_2(Z80* ctx) { ctx->SUB_R(0b011, 2); }
+    static inline void SUB_A_2(Z80* ctx) { ctx->SUB_R(0b111, 2); }
+    inline void SUB_R(unsigned char r, int pc = 1)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] AND %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
+        if (isDebug()) log("[%04X] SUB %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
 #endif
-        and8(getIYH());
+        unsigned char* rp = getRegisterPointer(r);
+        subtract8(*rp, 0);
     }
 
-    // AND with register IYL
-    static inline void AND_IYL_(Z80* ctx) { ctx->AND_IYL(); }
-    inline void AND_IYL()
+    // Subtract IXH to Acc.
+    static inline void SUB_IXH_(Z80* ctx) { ctx->SUB_IXH(); }
+    inline void SUB_IXH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] AND %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+        if (isDebug()) log("[%04X] SUB %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
 #endif
-        and8(getIYL());
+        subtract8(getIXH(), 0);
     }
 
-    // AND immediate
-    static inline void AND_N(Z80* ctx)
+    // Subtract IXL to Acc.
+    static inline void SUB_IXL_(Z80* ctx) { ctx->SUB_IXL(); }
+    inline void SUB_IXL()
     {
-        unsigned char n = ctx->fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] AND %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+        if (isDebug()) log("[%04X] SUB %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
 #endif
-        ctx->and8(n);
+        subtract8(getIXL(), 0);
     }
 
-    // AND Memory
-    static inline void AND_HL(Z80* ctx)
+    // Subtract IYH to Acc.
+    static inline void SUB_IYH_(Z80* ctx) { ctx->SUB_IYH(); }
+    inline void SUB_IYH()
     {
-        unsigned short addr = ctx->getHL();
-        unsigned char n = ctx->readByte(addr, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] AND %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
+        if (isDebug()) log("[%04X] SUB %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
 #endif
-        ctx->and8(n);
+        subtract8(getIYH(), 0);
     }
 
-    // AND Memory
-    static inline void AND_IX_(Z80* ctx) { ctx->AND_IX(); }
-    inline void AND_IX()
+    // Subtract IYL to Acc.
+    static inline void SUB_IYL_(Z80* ctx) { ctx->SUB_IYL(); }
+    inline void SUB_IYL()
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] SUB %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+#endif
+        subtract8(getIYL(), 0);
+    }
+
+    // Subtract immediate
+    static inline void SUB_N(Z80* ctx)
+    {
+        unsigned char n = ctx->fetch(3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] SUB %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+#endif
+        ctx->subtract8(n, 0);
+    }
+
+    // Subtract memory
+    static inline void SUB_HL(Z80* ctx)
+    {
+        unsigned short addr = ctx->getHL();
+        unsigned char n = ctx->readByte(addr, 3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] SUB %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
+#endif
+        ctx->subtract8(n, 0);
+    }
+
+    // Subtract memory
+    static inline void SUB_IX_(Z80* ctx) { ctx->SUB_IX(); }
+    inline void SUB_IX()
     {
         signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((unsigned short)(reg.IX + d));
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] AND %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), reg.pair.A & n);
+        if (isDebug()) log("[%04X] SUB %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
 #endif
-        and8(n);
+        subtract8(n, 0);
         consumeClock(3);
     }
 
-    // AND Memory
-    static inline void AND_IY_(Z80* ctx) { ctx->AND_IY(); }
-    inline void AND_IY()
+    // Subtract memory
+    static inline void SUB_IY_(Z80* ctx) { ctx->SUB_IY(); }
+    inline void SUB_IY()
     {
         signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((unsigned short)(reg.IY + d));
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] AND %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), reg.pair.A & n);
+        if (isDebug()) log("[%04X] SUB %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), addr, n);
 #endif
-        and8(n);
+        subtract8(n, 0);
         consumeClock(3);
     }
 
-    // OR Register
-    static inline void OR_B(Z80* ctx) { ctx->OR_R(0b000); }
-    static inline void OR_C(Z80* ctx) { ctx->OR_R(0b001); }
-    static inline void OR_D(Z80* ctx) { ctx->OR_R(0b010); }
-    static inline void OR_E(Z80* ctx) { ctx->OR_R(0b011); }
-    static inline void OR_H(Z80* ctx) { ctx->OR_R(0b100); }
-    static inline void OR_L(Z80* ctx) { ctx->OR_R(0b101); }
-    static inline void OR_A(Z80* ctx) { ctx->OR_R(0b111); }
-    static inline void OR_B_2(Z80* ctx) { ctx->OR_R(0b000, 2); }
-    static inline void OR_C_2(Z80* ctx) { ctx->OR_R(0b001, 2); }
-    static inline void OR_D_2(Z80* ctx) { ctx->OR_R(0b010, 2); }
-    static inline void OR_E_2(Z80* ctx) { ctx->OR_R(0b011, 2); }
-    static inline void OR_A_2(Z80* ctx) { ctx->OR_R(0b111, 2); }
-    inline void OR_R(unsigned char r, int pc = 1)
+    // Subtract Resister with carry
+    static inline void SBC_B(Z80* ctx) { ctx->SBC_R(0b000); }
+    static inline void SBC_C(Z80* ctx) { ctx->SBC_R(0b001); }
+    static inline void SBC_D(Z80* ctx) { ctx->SBC_R(0b010); }
+    static inline void SBC_E(Z80* ctx) { ctx->SBC_R(0b011); }
+    static inline void SBC_H(Z80* ctx) { ctx->SBC_R(0b100); }
+    static inline void SBC_L(Z80* ctx) { ctx->SBC_R(0b101); }
+    static inline void SBC_A(Z80* ctx) { ctx->SBC_R(0b111); }
+    static inline void SBC_B_2(Z80* ctx) { ctx->SBC_R(0b000, 2); }
+    static inline void SBC_C_2(Z80* ctx) { ctx->SBC_R(0b001, 2); }
+    static inline void SBC_D_2(Z80* ctx) { ctx->SBC_R(0b010, 2); }
+    static inline void SBC_E_2(Z80* ctx) { ctx->SBC_R(0b011, 2); }
+    static inline void SBC_A_2(Z80* ctx) { ctx->SBC_R(0b111, 2); }
+    inline void SBC_R(unsigned char r, int pc = 1)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] OR %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
+        if (isDebug()) log("[%04X] SBC %s, %s <C:%s>", reg.PC - pc, registerDump(0b111), registerDump(r), isFlagC() ? "ON" : "OFF");
 #endif
-        or8(getRegister(r));
+        subtract8(getRegister(r), isFlagC() ? 1 : 0);
     }
 
-    // OR with register IXH
-    static inline void OR_IXH_(Z80* ctx) { ctx->OR_IXH(); }
-    inline void OR_IXH()
+    // Subtract IXH to Acc. with carry
+    static inline void SBC_IXH_(Z80* ctx) { ctx->SBC_IXH(); }
+    inline void SBC_IXH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] OR %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
+        if (isDebug()) log("[%04X] SBC %s, IXH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXH(), isFlagC() ? "ON" : "OFF");
 #endif
-        or8(getIXH());
+        subtract8(getIXH(), isFlagC() ? 1 : 0);
     }
 
-    // OR with register IXL
-    static inline void OR_IXL_(Z80* ctx) { ctx->OR_IXL(); }
-    inline void OR_IXL()
+    // Subtract IXL to Acc. with carry
+    static inline void SBC_IXL_(Z80* ctx) { ctx->SBC_IXL(); }
+    inline void SBC_IXL()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] OR %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
+        if (isDebug()) log("[%04X] SBC %s, IXL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIXL(), isFlagC() ? "ON" : "OFF");
 #endif
-        or8(getIXL());
+        subtract8(getIXL(), isFlagC() ? 1 : 0);
     }
 
-    // OR with register IYH
-    static inline void OR_IYH_(Z80* ctx) { ctx->OR_IYH(); }
-    inline void OR_IYH()
+    // Subtract IYH to Acc. with carry
+    static inline void SBC_IYH_(Z80* ctx) { ctx->SBC_IYH(); }
+    inline void SBC_IYH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] OR %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
+        if (isDebug()) log("[%04X] SBC %s, IYH<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYH(), isFlagC() ? "ON" : "OFF");
 #endif
-        or8(getIYH());
+        subtract8(getIYH(), isFlagC() ? 1 : 0);
     }
 
-    // OR with register IYL
-    static inline void OR_IYL_(Z80* ctx) { ctx->OR_IYL(); }
-    inline void OR_IYL()
+    // Subtract IYL to Acc. with carry
+    static inline void SBC_IYL_(Z80* ctx) { ctx->SBC_IYL(); }
+    inline void SBC_IYL()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] OR %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+        if (isDebug()) log("[%04X] SBC %s, IYL<$%02X> <C:%s>", reg.PC - 2, registerDump(0b111), getIYL(), isFlagC() ? "ON" : "OFF");
 #endif
-        or8(getIYL());
+        subtract8(getIYL(), isFlagC() ? 1 : 0);
     }
 
-    // OR immediate
-    static inline void OR_N(Z80* ctx)
+    // Subtract immediate with carry
+    static inline void SBC_N(Z80* ctx)
     {
         unsigned char n = ctx->fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] OR %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+        if (ctx->isDebug()) ctx->log("[%04X] SBC %s, $%02X <C:%s>", ctx->reg.PC - 2, ctx->registerDump(0b111), n, ctx->isFlagC() ? "ON" : "OFF");
 #endif
-        ctx->or8(n);
+        ctx->subtract8(n, ctx->isFlagC() ? 1 : 0);
     }
 
-    // OR Memory
-    static inline void OR_HL(Z80* ctx)
+    // Subtract memory with carry
+    static inline void SBC_HL(Z80* ctx)
     {
         unsigned char n = ctx->readByte(ctx->getHL(), 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] OR %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), ctx->reg.pair.A | n);
+        if (ctx->isDebug()) ctx->log("[%04X] SBC %s, (%s) = $%02X <C:%s>", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n, ctx->isFlagC() ? "ON" : "OFF");
 #endif
-        ctx->or8(n);
+        ctx->subtract8(n, ctx->isFlagC() ? 1 : 0);
     }
 
-    // OR Memory
-    static inline void OR_IX_(Z80* ctx) { ctx->OR_IX(); }
-    inline void OR_IX()
+    // Subtract memory with carry
+    static inline void SBC_IX_(Z80* ctx) { ctx->SBC_IX(); }
+    inline void SBC_IX()
     {
         signed char d = (signed char)fetch(4);
         unsigned char n = readByte((unsigned short)(reg.IX + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] OR %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), reg.pair.A | n);
+        if (isDebug()) log("[%04X] SBC %s, (IX+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), n, isFlagC() ? "ON" : "OFF");
 #endif
-        or8(n);
+        subtract8(n, isFlagC() ? 1 : 0);
         consumeClock(3);
     }
 
-    // OR Memory
-    static inline void OR_IY_(Z80* ctx) { ctx->OR_IY(); }
-    inline void OR_IY()
+    // Subtract memory with carry
+    static inline void SBC_IY_(Z80* ctx) { ctx->SBC_IY(); }
+    inline void SBC_IY()
     {
         signed char d = (signed char)fetch(4);
         unsigned char n = readByte((unsigned short)(reg.IY + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] OR %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), reg.pair.A | n);
+        if (isDebug()) log("[%04X] SBC %s, (IY+d<$%04X>) = $%02X <C:%s>", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), n, isFlagC() ? "ON" : "OFF");
 #endif
-        or8(n);
+        subtract8(n, isFlagC() ? 1 : 0);
         consumeClock(3);
     }
 
-    // XOR Reigster
-    static inline void XOR_B(Z80* ctx) { ctx->XOR_R(0b000); }
-    static inline void XOR_C(Z80* ctx) { ctx->XOR_R(0b001); }
-    static inline void XOR_D(Z80* ctx) { ctx->XOR_R(0b010); }
-    static inline void XOR_E(Z80* ctx) { ctx->XOR_R(0b011); }
-    static inline void XOR_H(Z80* ctx) { ctx->XOR_R(0b100); }
-    static inline void XOR_L(Z80* ctx) { ctx->XOR_R(0b101); }
-    static inline void XOR_A(Z80* ctx) { ctx->XOR_R(0b111); }
-    static inline void XOR_B_2(Z80* ctx) { ctx->XOR_R(0b000, 2); }
-    static inline void XOR_C_2(Z80* ctx) { ctx->XOR_R(0b001, 2); }
-    static inline void XOR_D_2(Z80* ctx) { ctx->XOR_R(0b010, 2); }
-    static inline void XOR_E_2(Z80* ctx) { ctx->XOR_R(0b011, 2); }
-    static inline void XOR_A_2(Z80* ctx) { ctx->XOR_R(0b111, 2); }
-    inline void XOR_R(unsigned char r, int pc = 1)
+    // Decrement Register
+    static inline void DEC_B(Z80* ctx) { ctx->DEC_R(0b000); }
+    static inline void DEC_C(Z80* ctx) { ctx->DEC_R(0b001); }
+    static inline void DEC_D(Z80* ctx) { ctx->DEC_R(0b010); }
+    static inline void DEC_E(Z80* ctx) { ctx->DEC_R(0b011); }
+    static inline void DEC_H(Z80* ctx) { ctx->DEC_R(0b100); }
+    static inline void DEC_L(Z80* ctx) { ctx->DEC_R(0b101); }
+    static inline void DEC_A(Z80* ctx) { ctx->DEC_R(0b111); }
+    static inline void DEC_B_2(Z80* ctx) { ctx->DEC_R(0b000, 2); }
+    static inline void DEC_C_2(Z80* ctx) { ctx->DEC_R(0b001, 2); }
+    static inline void DEC_D_2(Z80* ctx) { ctx->DEC_R(0b010, 2); }
+    static inline void DEC_E_2(Z80* ctx) { ctx->DEC_R(0b011, 2); }
+    static inline void DEC_A_2(Z80* ctx) { ctx->DEC_R(0b111, 2); }
+    inline void DEC_R(unsigned char r, int pc = 1)
     {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] XOR %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
+        if (isDebug()) log("[%04X] DEC %s", reg.PC - pc, registerDump(r));
 #endif
-        xor8(getRegister(r));
+        setFlagByDecrement(*rp);
+        (*rp)--;
     }
 
-    // XOR with register IXH
-    static inline void XOR_IXH_(Z80* ctx) { ctx->XOR_IXH(); }
-    inline void XOR_IXH()
+    // Decrement location (HL)
+    static inline void DEC_HL(Z80* ctx)
     {
+        unsigned short addr = ctx->getHL();
+        unsigned char n = ctx->readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] XOR %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
+        if (ctx->isDebug()) ctx->log("[%04X] DEC (%s) = $%02X", ctx->reg.PC - 1, ctx->registerPairDump(0b10), n);
 #endif
-        xor8(getIXH());
+        ctx->setFlagByDecrement(n);
+        ctx->writeByte(addr, n - 1, 3);
     }
 
-    // XOR with register IXL
-    static inline void XOR_IXL_(Z80* ctx) { ctx->XOR_IXL(); }
-    inline void XOR_IXL()
+    // Decrement location (IX+d)
+    static inline void DEC_IX_(Z80* ctx) { ctx->DEC_IX(); }
+    inline void DEC_IX()
     {
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] XOR %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
+        if (isDebug()) log("[%04X] DEC (IX+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
 #endif
-        xor8(getIXL());
+        setFlagByDecrement(n);
+        writeByte(addr, n - 1);
+        consumeClock(3);
     }
 
-    // XOR with register IYH
-    static inline void XOR_IYH_(Z80* ctx) { ctx->XOR_IYH(); }
-    inline void XOR_IYH()
+    // Decrement high 8 bits of IX
+    static inline void DEC_IXH_(Z80* ctx) { ctx->DEC_IXH(); }
+    inline void DEC_IXH()
     {
+        unsigned char ixh = getIXH();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] XOR %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
+        if (isDebug()) log("[%04X] DEC IXH<$%02X>", reg.PC - 2, ixh);
 #endif
-        xor8(getIYH());
+        setFlagByDecrement(ixh--);
+        setIXH(ixh);
     }
 
-    // XOR with register IYL
-    static inline void XOR_IYL_(Z80* ctx) { ctx->XOR_IYL(); }
-    inline void XOR_IYL()
+    // Decrement low 8 bits of IX
+    static inline void DEC_IXL_(Z80* ctx) { ctx->DEC_IXL(); }
+    inline void DEC_IXL()
     {
+        unsigned char ixl = getIXL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] XOR %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+        if (isDebug()) log("[%04X] DEC IXL<$%02X>", reg.PC - 2, ixl);
 #endif
-        xor8(getIYL());
+        setFlagByDecrement(ixl--);
+        setIXL(ixl);
     }
 
-    // XOR immediate
-    static inline void XOR_N(Z80* ctx)
+    // Decrement location (IY+d)
+    static inline void DEC_IY_(Z80* ctx) { ctx->DEC_IY(); }
+    inline void DEC_IY()
     {
-        unsigned char n = ctx->fetch(3);
-#ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] XOR %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+        signed char d = (signed char)fetch(4);
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] DEC (IY+d<$%04X>) = $%02X", reg.PC - 3, addr, n);
 #endif
-        ctx->xor8(n);
+        setFlagByDecrement(n);
+        writeByte(addr, n - 1);
+        consumeClock(3);
     }
 
-    // XOR Memory
-    static inline void XOR_HL(Z80* ctx)
+    // Decrement high 8 bits of IY
+    static inline void DEC_IYH_(Z80* ctx) { ctx->DEC_IYH(); }
+    inline void DEC_IYH()
     {
-        unsigned char n = ctx->readByte(ctx->getHL(), 3);
+        unsigned char iyh = getIYH();
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] XOR %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), ctx->reg.pair.A ^ n);
+        if (isDebug()) log("[%04X] DEC IYH<$%02X>", reg.PC - 2, iyh);
 #endif
-        ctx->xor8(n);
+        setFlagByDecrement(iyh--);
+        setIYH(iyh);
     }
 
-    // XOR Memory
-    static inline void XOR_IX_(Z80* ctx) { ctx->XOR_IX(); }
-    inline void XOR_IX()
+    // Decrement low 8 bits of IY
+    static inline void DEC_IYL_(Z80* ctx) { ctx->DEC_IYL(); }
+    inline void DEC_IYL()
     {
-        signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((unsigned short)(reg.IX + d));
+        unsigned char iyl = getIYL();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] XOR %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), reg.pair.A ^ n);
+        if (isDebug()) log("[%04X] DEC IYL<$%02X>", reg.PC - 2, iyl);
 #endif
-        xor8(n);
-        consumeClock(3);
+        setFlagByDecrement(iyl--);
+        setIYL(iyl);
     }
 
-    // XOR Memory
-    static inline void XOR_IY_(Z80* ctx) { ctx->XOR_IY(); }
-    inline void XOR_IY()
+    inline void setFlagByAdd16(unsigned short before, unsigned short addition)
+    {
+        int result = before + addition;
+        int carrybits = before ^ addition ^ result;
+        resetFlagN();
+        setFlagXY((result & 0xFF00) >> 8);
+        setFlagC((carrybits & 0x10000) != 0);
+        setFlagH((carrybits & 0x1000) != 0);
+    }
+
+    inline void setFlagByAdc16(unsigned short before, unsigned short addition)
+    {
+        int result = before + addition;
+        int carrybits = before ^ addition ^ result;
+        unsigned short finalResult = (unsigned short)(result);
+        // same as ADD
+        resetFlagN();
+        setFlagXY((finalResult & 0xFF00) >> 8);
+        setFlagC((carrybits & 0x10000) != 0);
+        setFlagH((carrybits & 0x1000) != 0);
+        // only ADC
+        setFlagS(finalResult & 0x8000);
+        setFlagZ(0 == finalResult);
+        setFlagPV((((carrybits << 1) ^ carrybits) & 0x10000) != 0);
+    }
+
+    // Add register pair to H and L
+    static inline void ADD_HL_BC(Z80* ctx) { ctx->ADD_HL_RP(0b00); }
+    static inline void ADD_HL_DE(Z80* ctx) { ctx->ADD_HL_RP(0b01); }
+    static inline void ADD_HL_HL(Z80* ctx) { ctx->ADD_HL_RP(0b10); }
+    static inline void ADD_HL_SP(Z80* ctx) { ctx->ADD_HL_RP(0b11); }
+    inline void ADD_HL_RP(unsigned char rp)
     {
-        signed char d = (signed char)fetch(4);
-        unsigned char n = readByte((unsigned short)(reg.IY + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] XOR %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), reg.pair.A ^ n);
+        if (isDebug()) log("[%04X] ADD %s, %s", reg.PC - 1, registerPairDump(0b10), registerPairDump(rp));
 #endif
-        xor8(n);
-        consumeClock(3);
+        unsigned short hl = getHL();
+        unsigned short nn = getRP(rp);
+        reg.WZ = nn + 1;
+        setFlagByAdd16(hl, nn);
+        setHL(hl + nn);
+        consumeClock(7);
     }
 
-    // Complement acc. (1's Comp.)
-    static inline void CPL(Z80* ctx)
+    // Add with carry register pair to HL
+    static inline void ADC_HL_BC(Z80* ctx) { ctx->ADC_HL_RP(0b00); }
+    static inline void ADC_HL_DE(Z80* ctx) { ctx->ADC_HL_RP(0b01); }
+    static inline void ADC_HL_HL(Z80* ctx) { ctx->ADC_HL_RP(0b10); }
+    static inline void ADC_HL_SP(Z80* ctx) { ctx->ADC_HL_RP(0b11); }
+    inline void ADC_HL_RP(unsigned char rp)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] CPL %s", ctx->reg.PC - 1, ctx->registerDump(0b111));
+        if (isDebug()) log("[%04X] ADC %s, %s <C:%s>", reg.PC - 2, registerPairDump(0b10), registerPairDump(rp), isFlagC() ? "ON" : "OFF");
 #endif
-        ctx->reg.pair.A = ~ctx->reg.pair.A;
-        ctx->setFlagH();
-        ctx->setFlagN();
-        ctx->setFlagXY(ctx->reg.pair.A);
+        unsigned short hl = getHL();
+        unsigned short nn = getRP(rp);
+        unsigned char c = isFlagC() ? 1 : 0;
+        reg.WZ = hl + 1;
+        setFlagByAdc16(hl, c + nn);
+        setHL(hl + c + nn);
+        consumeClock(7);
     }
 
-    // Negate Acc. (2's Comp.)
-    static inline void NEG_(Z80* ctx) { ctx->NEG(); }
-    inline void NEG()
+    // Add register pair to IX
+    static inline void ADD_IX_BC(Z80* ctx) { ctx->ADD_IX_RP(0b00); }
+    static inline void ADD_IX_DE(Z80* ctx) { ctx->ADD_IX_RP(0b01); }
+    static inline void ADD_IX_IX(Z80* ctx) { ctx->ADD_IX_RP(0b10); }
+    static inline void ADD_IX_SP(Z80* ctx) { ctx->ADD_IX_RP(0b11); }
+    inline void ADD_IX_RP(unsigned char rp)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] NEG %s", reg.PC - 2, registerDump(0b111));
+        if (isDebug()) log("[%04X] ADD IX<$%04X>, %s", reg.PC - 2, reg.IX, registerPairDumpIX(rp));
 #endif
-        unsigned char a = reg.pair.A;
-        reg.pair.A = 0;
-        subtract8(a, 0);
+        unsigned short nn = getRPIX(rp);
+        setFlagByAdd16(reg.IX, nn);
+        reg.IX += nn;
+        consumeClock(7);
     }
 
-    // 　Complement Carry Flag
-    static inline void CCF(Z80* ctx)
+    // Add register pair to IY
+    static inline void ADD_IY_BC(Z80* ctx) { ctx->ADD_IY_RP(0b00); }
+    static inline void ADD_IY_DE(Z80* ctx) { ctx->ADD_IY_RP(0b01); }
+    static inline void ADD_IY_IY(Z80* ctx) { ctx->ADD_IY_RP(0b10); }
+    static inline void ADD_IY_SP(Z80* ctx) { ctx->ADD_IY_RP(0b11); }
+    inline void ADD_IY_RP(unsigned char rp)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] CCF <C:%s -> %s>", ctx->reg.PC - 1, ctx->isFlagC() ? "ON" : "OFF", !ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] ADD IY<$%04X>, %s", reg.PC - 2, reg.IY, registerPairDumpIY(rp));
 #endif
-        ctx->setFlagH(ctx->isFlagC());
-        ctx->resetFlagN();
-        ctx->setFlagC(!ctx->isFlagC());
-        ctx->setFlagXY(ctx->reg.pair.A);
+        unsigned short nn = getRPIY(rp);
+        setFlagByAdd16(reg.IY, nn);
+        reg.IY += nn;
+        consumeClock(7);
     }
 
-    // Set Carry Flag
-    static inline void SCF(Z80* ctx)
+    // Increment register pair
+    static inline void INC_RP_BC(Z80* ctx) { ctx->INC_RP(0b00); }
+    static inline void INC_RP_DE(Z80* ctx) { ctx->INC_RP(0b01); }
+    static inline void INC_RP_HL(Z80* ctx) { ctx->INC_RP(0b10); }
+    static inline void INC_RP_SP(Z80* ctx) { ctx->INC_RP(0b11); }
+    inline void INC_RP(unsigned char rp)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] SCF <C:%s -> ON>", ctx->reg.PC - 1, ctx->isFlagC() ? "ON" : "OFF");
+        if (isDebug()) log("[%04X] INC %s", reg.PC - 1, registerPairDump(rp));
 #endif
-        ctx->resetFlagH();
-        ctx->resetFlagN();
-        ctx->setFlagC();
-        ctx->setFlagXY(ctx->reg.pair.A);
+        setRP(rp, getRP(rp) + 1);
+        consumeClock(2);
     }
 
-    // Test BIT b of register r
-    static inline void BIT_B_0(Z80* ctx) { ctx->BIT_R(0b000, 0); }
-    static inline void BIT_B_1(Z80* ctx) { ctx->BIT_R(0b000, 1); }
-    static inline void BIT_B_2(Z80* ctx) { ctx->BIT_R(0b000, 2); }
-    static inline void BIT_B_3(Z80* ctx) { ctx->BIT_R(0b000, 3); }
-    static inline void BIT_B_4(Z80* ctx) { ctx->BIT_R(0b000, 4); }
-    static inline void BIT_B_5(Z80* ctx) { ctx->BIT_R(0b000, 5); }
-    static inline void BIT_B_6(Z80* ctx) { ctx->BIT_R(0b000, 6); }
-    static inline void BIT_B_7(Z80* ctx) { ctx->BIT_R(0b000, 7); }
-    static inline void BIT_C_0(Z80* ctx) { ctx->BIT_R(0b001, 0); }
-    static inline void BIT_C_1(Z80* ctx) { ctx->BIT_R(0b001, 1); }
-    static inline void BIT_C_2(Z80* ctx) { ctx->BIT_R(0b001, 2); }
-    static inline void BIT_C_3(Z80* ctx) { ctx->BIT_R(0b001, 3); }
-    static inline void BIT_C_4(Z80* ctx) { ctx->BIT_R(0b001, 4); }
-    static inline void BIT_C_5(Z80* ctx) { ctx->BIT_R(0b001, 5); }
-    static inline void BIT_C_6(Z80* ctx) { ctx->BIT_R(0b001, 6); }
-    static inline void BIT_C_7(Z80* ctx) { ctx->BIT_R(0b001, 7); }
-    static inline void BIT_D_0(Z80* ctx) { ctx->BIT_R(0b010, 0); }
-    static inline void BIT_D_1(Z80* ctx) { ctx->BIT_R(0b010, 1); }
-    static inline void BIT_D_2(Z80* ctx) { ctx->BIT_R(0b010, 2); }
-    static inline void BIT_D_3(Z80* ctx) { ctx->BIT_R(0b010, 3); }
-    static inline void BIT_D_4(Z80* ctx) { ctx->BIT_R(0b010, 4); }
-    static inline void BIT_D_5(Z80* ctx) { ctx->BIT_R(0b010, 5); }
-    static inline void BIT_D_6(Z80* ctx) { ctx->BIT_R(0b010, 6); }
-    static inline void BIT_D_7(Z80* ctx) { ctx->BIT_R(0b010, 7); }
-    static inline void BIT_E_0(Z80* ctx) { ctx->BIT_R(0b011, 0); }
-    static inline void BIT_E_1(Z80* ctx) { ctx->BIT_R(0b011, 1); }
-    static inline void BIT_E_2(Z80* ctx) { ctx->BIT_R(0b011, 2); }
-    static inline void BIT_E_3(Z80* ctx) { ctx->BIT_R(0b011, 3); }
-    static inline void BIT_E_4(Z80* ctx) { ctx->BIT_R(0b011, 4); }
-    static inline void BIT_E_5(Z80* ctx) { ctx->BIT_R(0b011, 5); }
-    static inline void BIT_E_6(Z80* ctx) { ctx->BIT_R(0b011, 6); }
-    static inline void BIT_E_7(Z80* ctx) { ctx->BIT_R(0b011, 7); }
-    static inline void BIT_H_0(Z80* ctx) { ctx->BIT_R(0b100, 0); }
-    static inline void BIT_H_1(Z80* ctx) { ctx->BIT_R(0b100, 1); }
-    static inline void BIT_H_2(Z80* ctx) { ctx->BIT_R(0b100, 2); }
-    static inline void BIT_H_3(Z80* ctx) { ctx->BIT_R(0b100, 3); }
-    static inline void BIT_H_4(Z80* ctx) { ctx->BIT_R(0b100, 4); }
-    static inline void BIT_H_5(Z80* ctx) { ctx->BIT_R(0b100, 5); }
-    static inline void BIT_H_6(Z80* ctx) { ctx->BIT_R(0b100, 6); }
-    static inline void BIT_H_7(Z80* ctx) { ctx->BIT_R(0b100, 7); }
-    static inline void BIT_L_0(Z80* ctx) { ctx->BIT_R(0b101, 0); }
-    static inline void BIT_L_1(Z80* ctx) { ctx->BIT_R(0b101, 1); }
-    static inline void BIT_L_2(Z80* ctx) { ctx->BIT_R(0b101, 2); }
-    static inline void BIT_L_3(Z80* ctx) { ctx->BIT_R(0b101, 3); }
-    static inline void BIT_L_4(Z80* ctx) { ctx->BIT_R(0b101, 4); }
-    static inline void BIT_L_5(Z80* ctx) { ctx->BIT_R(0b101, 5); }
-    static inline void BIT_L_6(Z80* ctx) { ctx->BIT_R(0b101, 6); }
-    static inline void BIT_L_7(Z80* ctx) { ctx->BIT_R(0b101, 7); }
-    static inline void BIT_A_0(Z80* ctx) { ctx->BIT_R(0b111, 0); }
-    static inline void BIT_A_1(Z80* ctx) { ctx->BIT_R(0b111, 1); }
-    static inline void BIT_A_2(Z80* ctx) { ctx->BIT_R(0b111, 2); }
-    static inline void BIT_A_3(Z80* ctx) { ctx->BIT_R(0b111, 3); }
-    static inline void BIT_A_4(Z80* ctx) { ctx->BIT_R(0b111, 4); }
-    static inline void BIT_A_5(Z80* ctx) { ctx->BIT_R(0b111, 5); }
-    static inline void BIT_A_6(Z80* ctx) { ctx->BIT_R(0b111, 6); }
-    static inline void BIT_A_7(Z80* ctx) { ctx->BIT_R(0b111, 7); }
-    inline void BIT_R(unsigned char r, unsigned char bit)
+    // Increment IX
+    static inline void INC_IX_reg_(Z80* ctx) { ctx->INC_IX_reg(); }
+    inline void INC_IX_reg()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] BIT %s of bit-%d", reg.PC - 2, registerDump(r), bit);
+        if (isDebug()) log("[%04X] INC IX<$%04X>", reg.PC - 2, reg.IX);
 #endif
-        unsigned char n = 0;
-        n = *rp & bits[bit];
-        setFlagZ(n ? false : true);
-        setFlagPV(isFlagZ());
-        setFlagS(!isFlagZ() && 7 == bit);
-        setFlagH();
-        resetFlagN();
-        setFlagXY(*rp);
+        reg.IX++;
+        consumeClock(2);
     }
 
-    // Test BIT b of location (HL)
-    static inline void BIT_HL_0(Z80* ctx) { ctx->BIT_HL(0); }
-    static inline void BIT_HL_1(Z80* ctx) { ctx->BIT_HL(1); }
-    static inline void BIT_HL_2(Z80* ctx) { ctx->BIT_HL(2); }
-    static inline void BIT_HL_3(Z80* ctx) { ctx->BIT_HL(3); }
-    static inline void BIT_HL_4(Z80* ctx) { ctx->BIT_HL(4); }
-    static inline void BIT_HL_5(Z80* ctx) { ctx->BIT_HL(5); }
-    static inline void BIT_HL_6(Z80* ctx) { ctx->BIT_HL(6); }
-    static inline void BIT_HL_7(Z80* ctx) { ctx->BIT_HL(7); }
-    inline void BIT_HL(unsigned char bit)
+    // Increment IY
+    static inline void INC_IY_reg_(Z80* ctx) { ctx->INC_IY_reg(); }
+    inline void INC_IY_reg()
     {
-        unsigned char n = readByte(getHL());
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] BIT (%s) = $%02X of bit-%d", reg.PC - 2, registerPairDump(0b10), n, bit);
+        if (isDebug()) log("[%04X] INC IY<$%04X>", reg.PC - 2, reg.IY);
 #endif
-        n &= bits[bit];
-        setFlagZ(!n);
-        setFlagPV(isFlagZ());
-        setFlagS(!isFlagZ() && 7 == bit);
-        setFlagH();
-        resetFlagN();
-        setFlagXY((reg.WZ & 0xFF00) >> 8);
+        reg.IY++;
+        consumeClock(2);
     }
 
-    // Test BIT b of location (IX+d)
-    static inline void BIT_IX_0(Z80* ctx, signed char d) { ctx->BIT_IX(d, 0); }
-    static inline void BIT_IX_1(Z80* ctx, signed char d) { ctx->BIT_IX(d, 1); }
-    static inline void BIT_IX_2(Z80* ctx, signed char d) { ctx->BIT_IX(d, 2); }
-    static inline void BIT_IX_3(Z80* ctx, signed char d) { ctx->BIT_IX(d, 3); }
-    static inline void BIT_IX_4(Z80* ctx, signed char d) { ctx->BIT_IX(d, 4); }
-    static inline void BIT_IX_5(Z80* ctx, signed char d) { ctx->BIT_IX(d, 5); }
-    static inline void BIT_IX_6(Z80* ctx, signed char d) { ctx->BIT_IX(d, 6); }
-    static inline void BIT_IX_7(Z80* ctx, signed char d) { ctx->BIT_IX(d, 7); }
-    inline void BIT_IX(signed char d, unsigned char bit)
+    // Decrement register pair
+    static inline void DEC_RP_BC(Z80* ctx) { ctx->DEC_RP(0b00); }
+    static inline void DEC_RP_DE(Z80* ctx) { ctx->DEC_RP(0b01); }
+    static inline void DEC_RP_HL(Z80* ctx) { ctx->DEC_RP(0b10); }
+    static inline void DEC_RP_SP(Z80* ctx) { ctx->DEC_RP(0b11); }
+    inline void DEC_RP(unsigned char rp)
     {
-        unsigned char n = readByte((unsigned short)(reg.IX + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] BIT (IX+d<$%04X>) = $%02X of bit-%d", reg.PC - 4, (unsigned short)(reg.IX + d), n, bit);
+        if (isDebug()) log("[%04X] DEC %s", reg.PC - 1, registerPairDump(rp));
 #endif
-        n &= bits[bit];
-        setFlagZ(!n);
-        setFlagPV(isFlagZ());
-        setFlagS(!isFlagZ() && 7 == bit);
-        setFlagH();
-        resetFlagN();
-        setFlagXY((reg.WZ & 0xFF00) >> 8);
+        setRP(rp, getRP(rp) - 1);
+        consumeClock(2);
     }
 
-    // Test BIT b of location (IY+d)
-    static inline void BIT_IY_0(Z80* ctx, signed char d) { ctx->BIT_IY(d, 0); }
-    static inline void BIT_IY_1(Z80* ctx, signed char d) { ctx->BIT_IY(d, 1); }
-    static inline void BIT_IY_2(Z80* ctx, signed char d) { ctx->BIT_IY(d, 2); }
-    static inline void BIT_IY_3(Z80* ctx, signed char d) { ctx->BIT_IY(d, 3); }
-    static inline void BIT_IY_4(Z80* ctx, signed char d) { ctx->BIT_IY(d, 4); }
-    static inline void BIT_IY_5(Z80* ctx, signed char d) { ctx->BIT_IY(d, 5); }
-    static inline void BIT_IY_6(Z80* ctx, signed char d) { ctx->BIT_IY(d, 6); }
-    static inline void BIT_IY_7(Z80* ctx, signed char d) { ctx->BIT_IY(d, 7); }
-    inline void BIT_IY(signed char d, unsigned char bit)
+    // Decrement IX
+    static inline void DEC_IX_reg_(Z80* ctx) { ctx->DEC_IX_reg(); }
+    inline void DEC_IX_reg()
     {
-        unsigned char n = readByte((unsigned short)(reg.IY + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] BIT (IY+d<$%04X>) = $%02X of bit-%d", reg.PC - 4, (unsigned short)(reg.IY + d), n, bit);
+        if (isDebug()) log("[%04X] DEC IX<$%04X>", reg.PC - 2, reg.IX);
 #endif
-        n &= bits[bit];
-        setFlagZ(!n);
-        setFlagPV(isFlagZ());
-        setFlagS(!isFlagZ() && 7 == bit);
-        setFlagH();
-        resetFlagN();
-        setFlagXY((reg.WZ & 0xFF00) >> 8);
+        reg.IX--;
+        consumeClock(2);
     }
 
-    // SET bit b of register r
-    static inline void SET_B_0(Z80* ctx) { ctx->SET_R(0b000, 0); }
-    static inline void SET_B_1(Z80* ctx) { ctx->SET_R(0b000, 1); }
-    static inline void SET_B_2(Z80* ctx) { ctx->SET_R(0b000, 2); }
-    static inline void SET_B_3(Z80* ctx) { ctx->SET_R(0b000, 3); }
-    static inline void SET_B_4(Z80* ctx) { ctx->SET_R(0b000, 4); }
-    static inline void SET_B_5(Z80* ctx) { ctx->SET_R(0b000, 5); }
-    static inline void SET_B_6(Z80* ctx) { ctx->SET_R(0b000, 6); }
-    static inline void SET_B_7(Z80* ctx) { ctx->SET_R(0b000, 7); }
-    static inline void SET_C_0(Z80* ctx) { ctx->SET_R(0b001, 0); }
-    static inline void SET_C_1(Z80* ctx) { ctx->SET_R(0b001, 1); }
-    static inline void SET_C_2(Z80* ctx) { ctx->SET_R(0b001, 2); }
-    static inline void SET_C_3(Z80* ctx) { ctx->SET_R(0b001, 3); }
-    static inline void SET_C_4(Z80* ctx) { ctx->SET_R(0b001, 4); }
-    static inline void SET_C_5(Z80* ctx) { ctx->SET_R(0b001, 5); }
-    static inline void SET_C_6(Z80* ctx) { ctx->SET_R(0b001, 6); }
-    static inline void SET_C_7(Z80* ctx) { ctx->SET_R(0b001, 7); }
-    static inline void SET_D_0(Z80* ctx) { ctx->SET_R(0b010, 0); }
-    static inline void SET_D_1(Z80* ctx) { ctx->SET_R(0b010, 1); }
-    static inline void SET_D_2(Z80* ctx) { ctx->SET_R(0b010, 2); }
-    static inline void SET_D_3(Z80* ctx) { ctx->SET_R(0b010, 3); }
-    static inline void SET_D_4(Z80* ctx) { ctx->SET_R(0b010, 4); }
-    static inline void SET_D_5(Z80* ctx) { ctx->SET_R(0b010, 5); }
-    static inline void SET_D_6(Z80* ctx) { ctx->SET_R(0b010, 6); }
-    static inline void SET_D_7(Z80* ctx) { ctx->SET_R(0b010, 7); }
-    static inline void SET_E_0(Z80* ctx) { ctx->SET_R(0b011, 0); }
-    static inline void SET_E_1(Z80* ctx) { ctx->SET_R(0b011, 1); }
-    static inline void SET_E_2(Z80* ctx) { ctx->SET_R(0b011, 2); }
-    static inline void SET_E_3(Z80* ctx) { ctx->SET_R(0b011, 3); }
-    static inline void SET_E_4(Z80* ctx) { ctx->SET_R(0b011, 4); }
-    static inline void SET_E_5(Z80* ctx) { ctx->SET_R(0b011, 5); }
-    static inline void SET_E_6(Z80* ctx) { ctx->SET_R(0b011, 6); }
-    static inline void SET_E_7(Z80* ctx) { ctx->SET_R(0b011, 7); }
-    static inline void SET_H_0(Z80* ctx) { ctx->SET_R(0b100, 0); }
-    static inline void SET_H_1(Z80* ctx) { ctx->SET_R(0b100, 1); }
-    static inline void SET_H_2(Z80* ctx) { ctx->SET_R(0b100, 2); }
-    static inline void SET_H_3(Z80* ctx) { ctx->SET_R(0b100, 3); }
-    static inline void SET_H_4(Z80* ctx) { ctx->SET_R(0b100, 4); }
-    static inline void SET_H_5(Z80* ctx) { ctx->SET_R(0b100, 5); }
-    static inline void SET_H_6(Z80* ctx) { ctx->SET_R(0b100, 6); }
-    static inline void SET_H_7(Z80* ctx) { ctx->SET_R(0b100, 7); }
-    static inline void SET_L_0(Z80* ctx) { ctx->SET_R(0b101, 0); }
-    static inline void SET_L_1(Z80* ctx) { ctx->SET_R(0b101, 1); }
-    static inline void SET_L_2(Z80* ctx) { ctx->SET_R(0b101, 2); }
-    static inline void SET_L_3(Z80* ctx) { ctx->SET_R(0b101, 3); }
-    static inline void SET_L_4(Z80* ctx) { ctx->SET_R(0b101, 4); }
-    static inline void SET_L_5(Z80* ctx) { ctx->SET_R(0b101, 5); }
-    static inline void SET_L_6(Z80* ctx) { ctx->SET_R(0b101, 6); }
-    static inline void SET_L_7(Z80* ctx) { ctx->SET_R(0b101, 7); }
-    static inline void SET_A_0(Z80* ctx) { ctx->SET_R(0b111, 0); }
-    static inline void SET_A_1(Z80* ctx) { ctx->SET_R(0b111, 1); }
-    static inline void SET_A_2(Z80* ctx) { ctx->SET_R(0b111, 2); }
-    static inline void SET_A_3(Z80* ctx) { ctx->SET_R(0b111, 3); }
-    static inline void SET_A_4(Z80* ctx) { ctx->SET_R(0b111, 4); }
-    static inline void SET_A_5(Z80* ctx) { ctx->SET_R(0b111, 5); }
-    static inline void SET_A_6(Z80* ctx) { ctx->SET_R(0b111, 6); }
-    static inline void SET_A_7(Z80* ctx) { ctx->SET_R(0b111, 7); }
-    inline void SET_R(unsigned char r, unsigned char bit)
+    // Decrement IY
+    static inline void DEC_IY_reg_(Z80* ctx) { ctx->DEC_IY_reg(); }
+    inline void DEC_IY_reg()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SET %s of bit-%d", reg.PC - 2, registerDump(r), bit);
+        if (isDebug()) log("[%04X] DEC IY<$%04X>", reg.PC - 2, reg.IY);
 #endif
-        *rp |= bits[bit];
+        reg.IY--;
+        consumeClock(2);
     }
 
-    // SET bit b of location (HL)
-    static inline void SET_HL_0(Z80* ctx) { ctx->SET_HL(0); }
-    static inline void SET_HL_1(Z80* ctx) { ctx->SET_HL(1); }
-    static inline void SET_HL_2(Z80* ctx) { ctx->SET_HL(2); }
-    static inline void SET_HL_3(Z80* ctx) { ctx->SET_HL(3); }
-    static inline void SET_HL_4(Z80* ctx) { ctx->SET_HL(4); }
-    static inline void SET_HL_5(Z80* ctx) { ctx->SET_HL(5); }
-    static inline void SET_HL_6(Z80* ctx) { ctx->SET_HL(6); }
-    static inline void SET_HL_7(Z80* ctx) { ctx->SET_HL(7); }
-    inline void SET_HL(unsigned char bit)
+    inline void setFlagBySbc16(unsigned short before, unsigned short subtract)
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SET (%s) = $%02X of bit-%d", reg.PC - 2, registerPairDump(0b10), n, bit);
-#endif
-        n |= bits[bit];
-        writeByte(addr, n, 3);
+        int result = before - subtract;
+        int carrybits = before ^ subtract ^ result;
+        unsigned short finalResult = (unsigned short)result;
+        setFlagN();
+        setFlagXY((finalResult & 0xFF00) >> 8);
+        setFlagC((carrybits & 0x10000) != 0);
+        setFlagH((carrybits & 0x1000) != 0);
+        setFlagS(finalResult & 0x8000);
+        setFlagZ(0 == finalResult);
+        setFlagPV((((carrybits << 1) ^ carrybits) & 0x10000) != 0);
     }
 
-    // SET bit b of location (IX+d)
-    static inline void SET_IX_0(Z80* ctx, signed char d) { ctx->SET_IX(d, 0); }
-    static inline void SET_IX_1(Z80* ctx, signed char d) { ctx->SET_IX(d, 1); }
-    static inline void SET_IX_2(Z80* ctx, signed char d) { ctx->SET_IX(d, 2); }
-    static inline void SET_IX_3(Z80* ctx, signed char d) { ctx->SET_IX(d, 3); }
-    static inline void SET_IX_4(Z80* ctx, signed char d) { ctx->SET_IX(d, 4); }
-    static inline void SET_IX_5(Z80* ctx, signed char d) { ctx->SET_IX(d, 5); }
-    static inline void SET_IX_6(Z80* ctx, signed char d) { ctx->SET_IX(d, 6); }
-    static inline void SET_IX_7(Z80* ctx, signed char d) { ctx->SET_IX(d, 7); }
-    inline void SET_IX(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // Subtract register pair from HL with carry
+    static inline void SBC_HL_BC(Z80* ctx) { ctx->SBC_HL_RP(0b00); }
+    static inline void SBC_HL_DE(Z80* ctx) { ctx->SBC_HL_RP(0b01); }
+    static inline void SBC_HL_HL(Z80* ctx) { ctx->SBC_HL_RP(0b10); }
+    static inline void SBC_HL_SP(Z80* ctx) { ctx->SBC_HL_RP(0b11); }
+    inline void SBC_HL_RP(unsigned char rp)
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SET (IX+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] SBC %s, %s <C:%s>", reg.PC - 2, registerPairDump(0b10), registerPairDump(rp), isFlagC() ? "ON" : "OFF");
 #endif
-        n |= bits[bit];
-        if (rp) *rp = n;
-        writeByte(addr, n, 3);
+        unsigned short hl = getHL();
+        unsigned short nn = getRP(rp);
+        unsigned char c = isFlagC() ? 1 : 0;
+        reg.WZ = hl + 1;
+        setFlagBySbc16(hl, c + nn);
+        setHL(hl - c - nn);
+        consumeClock(7);
     }
 
-    // SET bit b of location (IX+d) with load Reg.
-    static inline void SET_IX_0_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b000); }
-    static inline void SET_IX_1_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b000); }
-    static inline void SET_IX_2_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b000); }
-    static inline void SET_IX_3_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b000); }
-    static inline void SET_IX_4_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b000); }
-    static inline void SET_IX_5_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b000); }
-    static inline void SET_IX_6_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b000); }
-    static inline void SET_IX_7_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b000); }
-    static inline void SET_IX_0_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b001); }
-    static inline void SET_IX_1_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b001); }
-    static inline void SET_IX_2_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b001); }
-    static inline void SET_IX_3_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b001); }
-    static inline void SET_IX_4_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b001); }
-    static inline void SET_IX_5_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b001); }
-    static inline void SET_IX_6_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b001); }
-    static inline void SET_IX_7_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b001); }
-    static inline void SET_IX_0_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b010); }
-    static inline void SET_IX_1_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b010); }
-    static inline void SET_IX_2_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b010); }
-    static inline void SET_IX_3_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b010); }
-    static inline void SET_IX_4_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b010); }
-    static inline void SET_IX_5_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b010); }
-    static inline void SET_IX_6_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b010); }
-    static inline void SET_IX_7_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b010); }
-    static inline void SET_IX_0_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b011); }
-    static inline void SET_IX_1_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b011); }
-    static inline void SET_IX_2_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b011); }
-    static inline void SET_IX_3_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b011); }
-    static inline void SET_IX_4_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b011); }
-    static inline void SET_IX_5_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b011); }
-    static inline void SET_IX_6_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b011); }
-    static inline void SET_IX_7_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b011); }
-    static inline void SET_IX_0_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b100); }
-    static inline void SET_IX_1_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b100); }
-    static inline void SET_IX_2_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b100); }
-    static inline void SET_IX_3_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b100); }
-    static inline void SET_IX_4_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b100); }
-    static inline void SET_IX_5_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b100); }
-    static inline void SET_IX_6_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b100); }
-    static inline void SET_IX_7_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b100); }
-    static inline void SET_IX_0_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b101); }
-    static inline void SET_IX_1_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b101); }
-    static inline void SET_IX_2_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b101); }
-    static inline void SET_IX_3_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b101); }
-    static inline void SET_IX_4_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b101); }
-    static inline void SET_IX_5_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b101); }
-    static inline void SET_IX_6_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b101); }
-    static inline void SET_IX_7_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b101); }
-    static inline void SET_IX_0_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b111); }
-    static inline void SET_IX_1_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b111); }
-    static inline void SET_IX_2_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b111); }
-    static inline void SET_IX_3_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b111); }
-    static inline void SET_IX_4_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b111); }
-    static inline void SET_IX_5_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b111); }
-    static inline void SET_IX_6_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b111); }
-    static inline void SET_IX_7_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b111); }
-    inline void SET_IX_with_LD(signed char d, unsigned char bit, unsigned char r)
+    inline void setFlagByLogical()
     {
-        unsigned char* rp = getRegisterPointer(r);
-#ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SET_IX(d, bit, rp, buf);
-#else
-        SET_IX(d, bit, rp);
-#endif
+        setFlagS(reg.pair.A & 0x80);
+        setFlagZ(reg.pair.A == 0);
+        setFlagXY(reg.pair.A);
+        setFlagPV(isEvenNumberBits(reg.pair.A));
+        resetFlagN();
+        resetFlagC();
     }
 
-    // SET bit b of location (IY+d)
-    static inline void SET_IY_0(Z80* ctx, signed char d) { ctx->SET_IY(d, 0); }
-    static inline void SET_IY_1(Z80* ctx, signed char d) { ctx->SET_IY(d, 1); }
-    static inline void SET_IY_2(Z80* ctx, signed char d) { ctx->SET_IY(d, 2); }
-    static inline void SET_IY_3(Z80* ctx, signed char d) { ctx->SET_IY(d, 3); }
-    static inline void SET_IY_4(Z80* ctx, signed char d) { ctx->SET_IY(d, 4); }
-    static inline void SET_IY_5(Z80* ctx, signed char d) { ctx->SET_IY(d, 5); }
-    static inline void SET_IY_6(Z80* ctx, signed char d) { ctx->SET_IY(d, 6); }
-    static inline void SET_IY_7(Z80* ctx, signed char d) { ctx->SET_IY(d, 7); }
-    inline void SET_IY(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    inline void and8(unsigned char n)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
-#ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] SET (IY+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
-#endif
-        n |= bits[bit];
-        if (rp) *rp = n;
-        writeByte(addr, n, 3);
+        reg.pair.A &= n;
+        setFlagByLogical();
+        setFlagH();
     }
 
-    // SET bit b of location (IY+d) with load Reg.
-    static inline void SET_IY_0_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b000); }
-    static inline void SET_IY_1_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b000); }
-    static inline void SET_IY_2_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b000); }
-    static inline void SET_IY_3_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b000); }
-    static inline void SET_IY_4_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b000); }
-    static inline void SET_IY_5_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b000); }
-    static inline void SET_IY_6_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b000); }
-    static inline void SET_IY_7_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b000); }
-    static inline void SET_IY_0_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b001); }
-    static inline void SET_IY_1_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b001); }
-    static inline void SET_IY_2_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b001); }
-    static inline void SET_IY_3_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b001); }
-    static inline void SET_IY_4_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b001); }
-    static inline void SET_IY_5_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b001); }
-    static inline void SET_IY_6_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b001); }
-    static inline void SET_IY_7_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b001); }
-    static inline void SET_IY_0_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b010); }
-    static inline void SET_IY_1_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b010); }
-    static inline void SET_IY_2_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b010); }
-    static inline void SET_IY_3_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b010); }
-    static inline void SET_IY_4_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b010); }
-    static inline void SET_IY_5_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b010); }
-    static inline void SET_IY_6_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b010); }
-    static inline void SET_IY_7_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b010); }
-    static inline void SET_IY_0_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b011); }
-    static inline void SET_IY_1_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b011); }
-    static inline void SET_IY_2_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b011); }
-    static inline void SET_IY_3_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b011); }
-    static inline void SET_IY_4_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b011); }
-    static inline void SET_IY_5_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b011); }
-    static inline void SET_IY_6_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b011); }
-    static inline void SET_IY_7_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b011); }
-    static inline void SET_IY_0_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b100); }
-    static inline void SET_IY_1_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b100); }
-    static inline void SET_IY_2_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b100); }
-    static inline void SET_IY_3_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b100); }
-    static inline void SET_IY_4_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b100); }
-    static inline void SET_IY_5_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b100); }
-    static inline void SET_IY_6_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b100); }
-    static inline void SET_IY_7_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b100); }
-    static inline void SET_IY_0_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b101); }
-    static inline void SET_IY_1_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b101); }
-    static inline void SET_IY_2_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b101); }
-    static inline void SET_IY_3_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b101); }
-    static inline void SET_IY_4_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b101); }
-    static inline void SET_IY_5_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b101); }
-    static inline void SET_IY_6_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b101); }
-    static inline void SET_IY_7_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b101); }
-    static inline void SET_IY_0_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b111); }
-    static inline void SET_IY_1_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b111); }
-    static inline void SET_IY_2_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b111); }
-    static inline void SET_IY_3_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b111); }
-    static inline void SET_IY_4_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b111); }
-    static inline void SET_IY_5_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b111); }
-    static inline void SET_IY_6_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b111); }
-    static inline void SET_IY_7_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b111); }
-    inline void SET_IY_with_LD(signed char d, unsigned char bit, unsigned char r)
+    inline void or8(unsigned char n)
+    {
+        reg.pair.A |= n;
+        setFlagByLogical();
+        resetFlagH();
+    }
+
+    inline void xor8(unsigned char n)
+    {
+        reg.pair.A ^= n;
+        setFlagByLogical();
+        resetFlagH();
+    }
+
+    // AND Register
+    static inline void AND_B(Z80* ctx) { ctx->AND_R(0b000); }
+    static inline void AND_C(Z80* ctx) { ctx->AND_R(0b001); }
+    static inline void AND_D(Z80* ctx) { ctx->AND_R(0b010); }
+    static inline void AND_E(Z80* ctx) { ctx->AND_R(0b011); }
+    static inline void AND_H(Z80* ctx) { ctx->AND_R(0b100); }
+    static inline void AND_L(Z80* ctx) { ctx->AND_R(0b101); }
+    static inline void AND_A(Z80* ctx) { ctx->AND_R(0b111); }
+    static inline void AND_B_2(Z80* ctx) { ctx->AND_R(0b000, 2); }
+    static inline void AND_C_2(Z80* ctx) { ctx->AND_R(0b001, 2); }
+    static inline void AND_D_2(Z80* ctx) { ctx->AND_R(0b010, 2); }
+    static inline void AND_E_2(Z80* ctx) { ctx->AND_R(0b011, 2); }
+    static inline void AND_A_2(Z80* ctx) { ctx->AND_R(0b111, 2); }
+    inline void AND_R(unsigned char r, int pc = 1)
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        SET_IY(d, bit, rp, buf);
-#else
-        SET_IY(d, bit, rp);
+        if (isDebug()) log("[%04X] AND %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
 #endif
+        and8(getRegister(r));
     }
 
-    // RESET bit b of register r
-    static inline void RES_B_0(Z80* ctx) { ctx->RES_R(0b000, 0); }
-    static inline void RES_B_1(Z80* ctx) { ctx->RES_R(0b000, 1); }
-    static inline void RES_B_2(Z80* ctx) { ctx->RES_R(0b000, 2); }
-    static inline void RES_B_3(Z80* ctx) { ctx->RES_R(0b000, 3); }
-    static inline void RES_B_4(Z80* ctx) { ctx->RES_R(0b000, 4); }
-    static inline void RES_B_5(Z80* ctx) { ctx->RES_R(0b000, 5); }
-    static inline void RES_B_6(Z80* ctx) { ctx->RES_R(0b000, 6); }
-    static inline void RES_B_7(Z80* ctx) { ctx->RES_R(0b000, 7); }
-    static inline void RES_C_0(Z80* ctx) { ctx->RES_R(0b001, 0); }
-    static inline void RES_C_1(Z80* ctx) { ctx->RES_R(0b001, 1); }
-    static inline void RES_C_2(Z80* ctx) { ctx->RES_R(0b001, 2); }
-    static inline void RES_C_3(Z80* ctx) { ctx->RES_R(0b001, 3); }
-    static inline void RES_C_4(Z80* ctx) { ctx->RES_R(0b001, 4); }
-    static inline void RES_C_5(Z80* ctx) { ctx->RES_R(0b001, 5); }
-    static inline void RES_C_6(Z80* ctx) { ctx->RES_R(0b001, 6); }
-    static inline void RES_C_7(Z80* ctx) { ctx->RES_R(0b001, 7); }
-    static inline void RES_D_0(Z80* ctx) { ctx->RES_R(0b010, 0); }
-    static inline void RES_D_1(Z80* ctx) { ctx->RES_R(0b010, 1); }
-    static inline void RES_D_2(Z80* ctx) { ctx->RES_R(0b010, 2); }
-    static inline void RES_D_3(Z80* ctx) { ctx->RES_R(0b010, 3); }
-    static inline void RES_D_4(Z80* ctx) { ctx->RES_R(0b010, 4); }
-    static inline void RES_D_5(Z80* ctx) { ctx->RES_R(0b010, 5); }
-    static inline void RES_D_6(Z80* ctx) { ctx->RES_R(0b010, 6); }
-    static inline void RES_D_7(Z80* ctx) { ctx->RES_R(0b010, 7); }
-    static inline void RES_E_0(Z80* ctx) { ctx->RES_R(0b011, 0); }
-    static inline void RES_E_1(Z80* ctx) { ctx->RES_R(0b011, 1); }
-    static inline void RES_E_2(Z80* ctx) { ctx->RES_R(0b011, 2); }
-    static inline void RES_E_3(Z80* ctx) { ctx->RES_R(0b011, 3); }
-    static inline void RES_E_4(Z80* ctx) { ctx->RES_R(0b011, 4); }
-    static inline void RES_E_5(Z80* ctx) { ctx->RES_R(0b011, 5); }
-    static inline void RES_E_6(Z80* ctx) { ctx->RES_R(0b011, 6); }
-    static inline void RES_E_7(Z80* ctx) { ctx->RES_R(0b011, 7); }
-    static inline void RES_H_0(Z80* ctx) { ctx->RES_R(0b100, 0); }
-    static inline void RES_H_1(Z80* ctx) { ctx->RES_R(0b100, 1); }
-    static inline void RES_H_2(Z80* ctx) { ctx->RES_R(0b100, 2); }
-    static inline void RES_H_3(Z80* ctx) { ctx->RES_R(0b100, 3); }
-    static inline void RES_H_4(Z80* ctx) { ctx->RES_R(0b100, 4); }
-    static inline void RES_H_5(Z80* ctx) { ctx->RES_R(0b100, 5); }
-    static inline void RES_H_6(Z80* ctx) { ctx->RES_R(0b100, 6); }
-    static inline void RES_H_7(Z80* ctx) { ctx->RES_R(0b100, 7); }
-    static inline void RES_L_0(Z80* ctx) { ctx->RES_R(0b101, 0); }
-    static inline void RES_L_1(Z80* ctx) { ctx->RES_R(0b101, 1); }
-    static inline void RES_L_2(Z80* ctx) { ctx->RES_R(0b101, 2); }
-    static inline void RES_L_3(Z80* ctx) { ctx->RES_R(0b101, 3); }
-    static inline void RES_L_4(Z80* ctx) { ctx->RES_R(0b101, 4); }
-    static inline void RES_L_5(Z80* ctx) { ctx->RES_R(0b101, 5); }
-    static inline void RES_L_6(Z80* ctx) { ctx->RES_R(0b101, 6); }
-    static inline void RES_L_7(Z80* ctx) { ctx->RES_R(0b101, 7); }
-    static inline void RES_A_0(Z80* ctx) { ctx->RES_R(0b111, 0); }
-    static inline void RES_A_1(Z80* ctx) { ctx->RES_R(0b111, 1); }
-    static inline void RES_A_2(Z80* ctx) { ctx->RES_R(0b111, 2); }
-    static inline void RES_A_3(Z80* ctx) { ctx->RES_R(0b111, 3); }
-    static inline void RES_A_4(Z80* ctx) { ctx->RES_R(0b111, 4); }
-    static inline void RES_A_5(Z80* ctx) { ctx->RES_R(0b111, 5); }
-    static inline void RES_A_6(Z80* ctx) { ctx->RES_R(0b111, 6); }
-    static inline void RES_A_7(Z80* ctx) { ctx->RES_R(0b111, 7); }
-    inline void RES_R(unsigned char r, unsigned char bit)
+    // AND with register IXH
+    static inline void AND_IXH_(Z80* ctx) { ctx->AND_IXH(); }
+    inline void AND_IXH()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RES %s of bit-%d", reg.PC - 2, registerDump(r), bit);
+        if (isDebug()) log("[%04X] AND %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
 #endif
-        switch (bit) {
-            case 0: *rp &= 0b11111110; break;
-            case 1: *rp &= 0b11111101; break;
-            case 2: *rp &= 0b11111011; break;
-            case 3: *rp &= 0b11110111; break;
-            case 4: *rp &= 0b11101111; break;
-            case 5: *rp &= 0b11011111; break;
-            case 6: *rp &= 0b10111111; break;
-            case 7: *rp &= 0b01111111; break;
-        }
+        and8(getIXH());
     }
 
-    // RESET bit b of location (HL)
-    static inline void RES_HL_0(Z80* ctx) { ctx->RES_HL(0); }
-    static inline void RES_HL_1(Z80* ctx) { ctx->RES_HL(1); }
-    static inline void RES_HL_2(Z80* ctx) { ctx->RES_HL(2); }
-    static inline void RES_HL_3(Z80* ctx) { ctx->RES_HL(3); }
-    static inline void RES_HL_4(Z80* ctx) { ctx->RES_HL(4); }
-    static inline void RES_HL_5(Z80* ctx) { ctx->RES_HL(5); }
-    static inline void RES_HL_6(Z80* ctx) { ctx->RES_HL(6); }
-    static inline void RES_HL_7(Z80* ctx) { ctx->RES_HL(7); }
-    inline void RES_HL(unsigned char bit)
+    // AND with register IXL
+    static inline void AND_IXL_(Z80* ctx) { ctx->AND_IXL(); }
+    inline void AND_IXL()
     {
-        unsigned short addr = getHL();
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RES (%s) = $%02X of bit-%d", reg.PC - 2, registerPairDump(0b10), n, bit);
+        if (isDebug()) log("[%04X] AND %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
 #endif
-        switch (bit) {
-            case 0: n &= 0b11111110; break;
-            case 1: n &= 0b11111101; break;
-            case 2: n &= 0b11111011; break;
-            case 3: n &= 0b11110111; break;
-            case 4: n &= 0b11101111; break;
-            case 5: n &= 0b11011111; break;
-            case 6: n &= 0b10111111; break;
-            case 7: n &= 0b01111111; break;
-        }
-        writeByte(addr, n, 3);
+        and8(getIXL());
     }
 
-    // RESET bit b of location (IX+d)
-    static inline void RES_IX_0(Z80* ctx, signed char d) { ctx->RES_IX(d, 0); }
-    static inline void RES_IX_1(Z80* ctx, signed char d) { ctx->RES_IX(d, 1); }
-    static inline void RES_IX_2(Z80* ctx, signed char d) { ctx->RES_IX(d, 2); }
-    static inline void RES_IX_3(Z80* ctx, signed char d) { ctx->RES_IX(d, 3); }
-    static inline void RES_IX_4(Z80* ctx, signed char d) { ctx->RES_IX(d, 4); }
-    static inline void RES_IX_5(Z80* ctx, signed char d) { ctx->RES_IX(d, 5); }
-    static inline void RES_IX_6(Z80* ctx, signed char d) { ctx->RES_IX(d, 6); }
-    static inline void RES_IX_7(Z80* ctx, signed char d) { ctx->RES_IX(d, 7); }
-    inline void RES_IX(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // AND with register IYH
+    static inline void AND_IYH_(Z80* ctx) { ctx->AND_IYH(); }
+    inline void AND_IYH()
     {
-        unsigned short addr = (unsigned short)(reg.IX + d);
-        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RES (IX+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
+        if (isDebug()) log("[%04X] AND %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
 #endif
-        switch (bit) {
-            case 0: n &= 0b11111110; break;
-            case 1: n &= 0b11111101; break;
-            case 2: n &= 0b11111011; break;
-            case 3: n &= 0b11110111; break;
-            case 4: n &= 0b11101111; break;
-            case 5: n &= 0b11011111; break;
-            case 6: n &= 0b10111111; break;
-            case 7: n &= 0b01111111; break;
-        }
-        if (rp) *rp = n;
-        writeByte(addr, n, 3);
+        and8(getIYH());
     }
 
-    // RESET bit b of location (IX+d) with load Reg.
-    static inline void RES_IX_0_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b000); }
-    static inline void RES_IX_1_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b000); }
-    static inline void RES_IX_2_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b000); }
-    static inline void RES_IX_3_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b000); }
-    static inline void RES_IX_4_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b000); }
-    static inline void RES_IX_5_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b000); }
-    static inline void RES_IX_6_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b000); }
-    static inline void RES_IX_7_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b000); }
-    static inline void RES_IX_0_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b001); }
-    static inline void RES_IX_1_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b001); }
-    static inline void RES_IX_2_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b001); }
-    static inline void RES_IX_3_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b001); }
-    static inline void RES_IX_4_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b001); }
-    static inline void RES_IX_5_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b001); }
-    static inline void RES_IX_6_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b001); }
-    static inline void RES_IX_7_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b001); }
-    static inline void RES_IX_0_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b010); }
-    static inline void RES_IX_1_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b010); }
-    static inline void RES_IX_2_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b010); }
-    static inline void RES_IX_3_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b010); }
-    static inline void RES_IX_4_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b010); }
-    static inline void RES_IX_5_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b010); }
-    static inline void RES_IX_6_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b010); }
-    static inline void RES_IX_7_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b010); }
-    static inline void RES_IX_0_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b011); }
-    static inline void RES_IX_1_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b011); }
-    static inline void RES_IX_2_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b011); }
-    static inline void RES_IX_3_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b011); }
-    static inline void RES_IX_4_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b011); }
-    static inline void RES_IX_5_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b011); }
-    static inline void RES_IX_6_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b011); }
-    static inline void RES_IX_7_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b011); }
-    static inline void RES_IX_0_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b100); }
-    static inline void RES_IX_1_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b100); }
-    static inline void RES_IX_2_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b100); }
-    static inline void RES_IX_3_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b100); }
-    static inline void RES_IX_4_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b100); }
-    static inline void RES_IX_5_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b100); }
-    static inline void RES_IX_6_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b100); }
-    static inline void RES_IX_7_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b100); }
-    static inline void RES_IX_0_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b101); }
-    static inline void RES_IX_1_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b101); }
-    static inline void RES_IX_2_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b101); }
-    static inline void RES_IX_3_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b101); }
-    static inline void RES_IX_4_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b101); }
-    static inline void RES_IX_5_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b101); }
-    static inline void RES_IX_6_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b101); }
-    static inline void RES_IX_7_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b101); }
-    static inline void RES_IX_0_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b111); }
-    static inline void RES_IX_1_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b111); }
-    static inline void RES_IX_2_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b111); }
-    static inline void RES_IX_3_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b111); }
-    static inline void RES_IX_4_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b111); }
-    static inline void RES_IX_5_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b111); }
-    static inline void RES_IX_6_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b111); }
-    static inline void RES_IX_7_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b111); }
-    inline void RES_IX_with_LD(signed char d, unsigned char bit, unsigned char r)
+    // AND with register IYL
+    static inline void AND_IYL_(Z80* ctx) { ctx->AND_IYL(); }
+    inline void AND_IYL()
     {
-        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        RES_IX(d, bit, rp, buf);
-#else
-        RES_IX(d, bit, rp);
+        if (isDebug()) log("[%04X] AND %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
 #endif
+        and8(getIYL());
     }
 
-    // RESET bit b of location (IY+d) with load Reg.
-    static inline void RES_IY_0_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b000); }
-    static inline void RES_IY_1_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b000); }
-    static inline void RES_IY_2_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b000); }
-    static inline void RES_IY_3_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b000); }
-    static inline void RES_IY_4_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b000); }
-    static inline void RES_IY_5_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b000); }
-    static inline void RES_IY_6_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b000); }
-    static inline void RES_IY_7_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b000); }
-    static inline void RES_IY_0_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b001); }
-    static inline void RES_IY_1_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b001); }
-    static inline void RES_IY_2_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b001); }
-    static inline void RES_IY_3_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b001); }
-    static inline void RES_IY_4_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b001); }
-    static inline void RES_IY_5_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b001); }
-    static inline void RES_IY_6_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b001); }
-    static inline void RES_IY_7_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b001); }
-    static inline void RES_IY_0_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b010); }
-    static inline void RES_IY_1_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b010); }
-    static inline void RES_IY_2_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b010); }
-    static inline void RES_IY_3_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b010); }
-    static inline void RES_IY_4_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b010); }
-    static inline void RES_IY_5_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b010); }
-    static inline void RES_IY_6_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b010); }
-    static inline void RES_IY_7_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b010); }
-    static inline void RES_IY_0_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b011); }
-    static inline void RES_IY_1_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b011); }
-    static inline void RES_IY_2_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b011); }
-    static inline void RES_IY_3_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b011); }
-    static inline void RES_IY_4_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b011); }
-    static inline void RES_IY_5_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b011); }
-    static inline void RES_IY_6_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b011); }
-    static inline void RES_IY_7_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b011); }
-    static inline void RES_IY_0_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b100); }
-    static inline void RES_IY_1_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b100); }
-    static inline void RES_IY_2_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b100); }
-    static inline void RES_IY_3_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b100); }
-    static inline void RES_IY_4_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b100); }
-    static inline void RES_IY_5_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b100); }
-    static inline void RES_IY_6_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b100); }
-    static inline void RES_IY_7_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b100); }
-    static inline void RES_IY_0_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b101); }
-    static inline void RES_IY_1_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b101); }
-    static inline void RES_IY_2_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b101); }
-    static inline void RES_IY_3_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b101); }
-    static inline void RES_IY_4_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b101); }
-    static inline void RES_IY_5_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b101); }
-    static inline void RES_IY_6_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b101); }
-    static inline void RES_IY_7_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b101); }
-    static inline void RES_IY_0_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b111); }
-    static inline void RES_IY_1_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b111); }
-    static inline void RES_IY_2_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b111); }
-    static inline void RES_IY_3_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b111); }
-    static inline void RES_IY_4_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b111); }
-    static inline void RES_IY_5_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b111); }
-    static inline void RES_IY_6_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b111); }
-    static inline void RES_IY_7_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b111); }
-    inline void RES_IY_with_LD(signed char d, unsigned char bit, unsigned char r)
+    // AND immediate
+    static inline void AND_N(Z80* ctx)
     {
-        unsigned char* rp = getRegisterPointer(r);
+        unsigned char n = ctx->fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        char buf[80];
-        if (isDebug()) {
-            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
-        } else {
-            buf[0] = '\0';
-        }
-        RES_IY(d, bit, rp, buf);
-#else
-        RES_IY(d, bit, rp);
+        if (ctx->isDebug()) ctx->log("[%04X] AND %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
 #endif
+        ctx->and8(n);
     }
 
-    // RESET bit b of location (IY+d)
-    static inline void RES_IY_0(Z80* ctx, signed char d) { ctx->RES_IY(d, 0); }
-    static inline void RES_IY_1(Z80* ctx, signed char d) { ctx->RES_IY(d, 1); }
-    static inline void RES_IY_2(Z80* ctx, signed char d) { ctx->RES_IY(d, 2); }
-    static inline void RES_IY_3(Z80* ctx, signed char d) { ctx->RES_IY(d, 3); }
-    static inline void RES_IY_4(Z80* ctx, signed char d) { ctx->RES_IY(d, 4); }
-    static inline void RES_IY_5(Z80* ctx, signed char d) { ctx->RES_IY(d, 5); }
-    static inline void RES_IY_6(Z80* ctx, signed char d) { ctx->RES_IY(d, 6); }
-    static inline void RES_IY_7(Z80* ctx, signed char d) { ctx->RES_IY(d, 7); }
-    inline void RES_IY(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    // AND Memory
+    static inline void AND_HL(Z80* ctx)
     {
-        unsigned short addr = (unsigned short)(reg.IY + d);
-        unsigned char n = readByte(addr);
+        unsigned short addr = ctx->getHL();
+        unsigned char n = ctx->readByte(addr, 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RES (IY+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
+        if (ctx->isDebug()) ctx->log("[%04X] AND %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
 #endif
-        switch (bit) {
-            case 0: n &= 0b11111110; break;
-            case 1: n &= 0b11111101; break;
-            case 2: n &= 0b11111011; break;
-            case 3: n &= 0b11110111; break;
-            case 4: n &= 0b11101111; break;
-            case 5: n &= 0b11011111; break;
-            case 6: n &= 0b10111111; break;
-            case 7: n &= 0b01111111; break;
-        }
-        if (rp) *rp = n;
-        writeByte(addr, n, 3);
+        ctx->and8(n);
     }
 
-    // Compare location (HL) and A, increment/decrement HL and decrement BC
-    inline void repeatCP(bool isIncHL, bool isRepeat)
+    // AND Memory
+    static inline void AND_IX_(Z80* ctx) { ctx->AND_IX(); }
+    inline void AND_IX()
     {
-        unsigned short hl = getHL();
-        unsigned short bc = getBC();
-        unsigned char n = readByte(hl);
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((unsigned short)(reg.IX + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) {
-            if (isIncHL) {
-                log("[%04X] %s ... %s, %s = $%02X, %s", reg.PC - 2, isRepeat ? "CPIR" : "CPI", registerDump(0b111), registerPairDump(0b10), n, registerPairDump(0b00));
-            } else {
-                log("[%04X] %s ... %s, %s = $%02X, %s", reg.PC - 2, isRepeat ? "CPDR" : "CPD", registerDump(0b111), registerPairDump(0b10), n, registerPairDump(0b00));
-            }
-        }
+        if (isDebug()) log("[%04X] AND %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), reg.pair.A & n);
 #endif
-        subtract8(n, 0, false, false);
-        int nn = reg.pair.A;
-        nn -= n;
-        nn -= isFlagH() ? 1 : 0;
-        setFlagY(nn & 0b00000010);
-        setFlagX(nn & 0b00001000);
-        setHL((unsigned short)(hl + (isIncHL ? 1 : -1)));
-        bc--;
-        setBC(bc);
-        setFlagPV(0 != bc);
-        consumeClock(4);
-        if (isRepeat && !isFlagZ() && 0 != getBC()) {
-            reg.PC -= 2;
-            consumeClock(5);
-        }
-        reg.WZ += isIncHL ? 1 : -1;
+        and8(n);
+        consumeClock(3);
     }
-    static inline void CPI(Z80* ctx) { ctx->repeatCP(true, false); }
-    static inline void CPIR(Z80* ctx) { ctx->repeatCP(true, true); }
-    static inline void CPD(Z80* ctx) { ctx->repeatCP(false, false); }
-    static inline void CPDR(Z80* ctx) { ctx->repeatCP(false, true); }
 
-    // Compare Register
-    static inline void CP_B(Z80* ctx) { ctx->CP_R(0b000); }
-    static inline void CP_C(Z80* ctx) { ctx->CP_R(0b001); }
-    static inline void CP_D(Z80* ctx) { ctx->CP_R(0b010); }
-    static inline void CP_E(Z80* ctx) { ctx->CP_R(0b011); }
-    static inline void CP_H(Z80* ctx) { ctx->CP_R(0b100); }
-    static inline void CP_L(Z80* ctx) { ctx->CP_R(0b101); }
-    static inline void CP_A(Z80* ctx) { ctx->CP_R(0b111); }
-    static inline void CP_B_2(Z80* ctx) { ctx->CP_R(0b000, 2); }
-    static inline void CP_C_2(Z80* ctx) { ctx->CP_R(0b001, 2); }
-    static inline void CP_D_2(Z80* ctx) { ctx->CP_R(0b010, 2); }
-    static inline void CP_E_2(Z80* ctx) { ctx->CP_R(0b011, 2); }
-    static inline void CP_A_2(Z80* ctx) { ctx->CP_R(0b111, 2); }
-    inline void CP_R(unsigned char r, int pc = 1)
+    // AND Memory
+    static inline void AND_IY_(Z80* ctx) { ctx->AND_IY(); }
+    inline void AND_IY()
     {
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((unsigned short)(reg.IY + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CP %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
+        if (isDebug()) log("[%04X] AND %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), reg.pair.A & n);
 #endif
-        unsigned char* rp = getRegisterPointer(r);
-        subtract8(*rp, 0, true, false);
+        and8(n);
+        consumeClock(3);
     }
 
-    // Compare Register IXH
-    static inline void CP_IXH_(Z80* ctx) { ctx->CP_IXH(); }
-    inline void CP_IXH()
+    // OR Register
+    static inline void OR_B(Z80* ctx) { ctx->OR_R(0b000); }
+    static inline void OR_C(Z80* ctx) { ctx->OR_R(0b001); }
+    static inline void OR_D(Z80* ctx) { ctx->OR_R(0b010); }
+    static inline void OR_E(Z80* ctx) { ctx->OR_R(0b011); }
+    static inline void OR_H(Z80* ctx) { ctx->OR_R(0b100); }
+    static inline void OR_L(Z80* ctx) { ctx->OR_R(0b101); }
+    static inline void OR_A(Z80* ctx) { ctx->OR_R(0b111); }
+    static inline void OR_B_2(Z80* ctx) { ctx->OR_R(0b000, 2); }
+    static inline void OR_C_2(Z80* ctx) { ctx->OR_R(0b001, 2); }
+    static inline void OR_D_2(Z80* ctx) { ctx->OR_R(0b010, 2); }
+    static inline void OR_E_2(Z80* ctx) { ctx->OR_R(0b011, 2); }
+    static inline void OR_A_2(Z80* ctx) { ctx->OR_R(0b111, 2); }
+    inline void OR_R(unsigned char r, int pc = 1)
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CP %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
+        if (isDebug()) log("[%04X] OR %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
 #endif
-        subtract8(getIXH(), 0, true, false);
+        or8(getRegister(r));
     }
 
-    // Compare Register IXL
-    static inline void CP_IXL_(Z80* ctx) { ctx->CP_IXL(); }
-    inline void CP_IXL()
+    // OR with register IXH
+    static inline void OR_IXH_(Z80* ctx) { ctx->OR_IXH(); }
+    inline void OR_IXH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CP %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
+        if (isDebug()) log("[%04X] OR %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
 #endif
-        subtract8(getIXL(), 0, true, false);
+        or8(getIXH());
     }
 
-    // Compare Register IYH
-    static inline void CP_IYH_(Z80* ctx) { ctx->CP_IYH(); }
-    inline void CP_IYH()
+    // OR with register IXL
+    static inline void OR_IXL_(Z80* ctx) { ctx->OR_IXL(); }
+    inline void OR_IXL()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CP %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
+        if (isDebug()) log("[%04X] OR %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
 #endif
-        subtract8(getIYH(), 0, true, false);
+        or8(getIXL());
     }
 
-    // Compare Register IYL
-    static inline void CP_IYL_(Z80* ctx) { ctx->CP_IYL(); }
-    inline void CP_IYL()
+    // OR with register IYH
+    static inline void OR_IYH_(Z80* ctx) { ctx->OR_IYH(); }
+    inline void OR_IYH()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CP %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+        if (isDebug()) log("[%04X] OR %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
 #endif
-        subtract8(getIYL(), 0, true, false);
+        or8(getIYH());
     }
 
-    // Compare immediate
-    static inline void CP_N(Z80* ctx)
+    // OR with register IYL
+    static inline void OR_IYL_(Z80* ctx) { ctx->OR_IYL(); }
+    inline void OR_IYL()
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] OR %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+#endif
+        or8(getIYL());
+    }
+
+    // OR immediate
+    static inline void OR_N(Z80* ctx)
     {
         unsigned char n = ctx->fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] CP %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+        if (ctx->isDebug()) ctx->log("[%04X] OR %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
 #endif
-        ctx->subtract8(n, 0, true, false);
+        ctx->or8(n);
     }
 
-    // Compare memory
-    static inline void CP_HL(Z80* ctx)
+    // OR Memory
+    static inline void OR_HL(Z80* ctx)
     {
         unsigned char n = ctx->readByte(ctx->getHL(), 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] CP %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
+        if (ctx->isDebug()) ctx->log("[%04X] OR %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), ctx->reg.pair.A | n);
 #endif
-        ctx->subtract8(n, 0, true, false);
+        ctx->or8(n);
     }
 
-    // Compare memory
-    static inline void CP_IX_(Z80* ctx) { ctx->CP_IX(); }
-    inline void CP_IX()
+    // OR Memory
+    static inline void OR_IX_(Z80* ctx) { ctx->OR_IX(); }
+    inline void OR_IX()
     {
         signed char d = (signed char)fetch(4);
         unsigned char n = readByte((unsigned short)(reg.IX + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CP %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), n);
+        if (isDebug()) log("[%04X] OR %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), reg.pair.A | n);
 #endif
-        subtract8(n, 0, true, false);
+        or8(n);
         consumeClock(3);
     }
 
-    // Compare memory
-    static inline void CP_IY_(Z80* ctx) { ctx->CP_IY(); }
-    inline void CP_IY()
+    // OR Memory
+    static inline void OR_IY_(Z80* ctx) { ctx->OR_IY(); }
+    inline void OR_IY()
     {
         signed char d = (signed char)fetch(4);
         unsigned char n = readByte((unsigned short)(reg.IY + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CP %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), n);
+        if (isDebug()) log("[%04X] OR %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), reg.pair.A | n);
 #endif
-        subtract8(n, 0, true, false);
+        or8(n);
         consumeClock(3);
     }
 
-    // Jump
-    static inline void JP_NN(Z80* ctx)
+    // XOR Reigster
+    static inline void XOR_B(Z80* ctx) { ctx->XOR_R(0b000); }
+    static inline void XOR_C(Z80* ctx) { ctx->XOR_R(0b001); }
+    static inline void XOR_D(Z80* ctx) { ctx->XOR_R(0b010); }
+    static inline void XOR_E(Z80* ctx) { ctx->XOR_R(0b011); }
+    static inline void XOR_H(Z80* ctx) { ctx->XOR_R(0b100); }
+    static inline void XOR_L(Z80* ctx) { ctx->XOR_R(0b101); }
+    static inline void XOR_A(Z80* ctx) { ctx->XOR_R(0b111); }
+    static inline void XOR_B_2(Z80* ctx) { ctx->XOR_R(0b000, 2); }
+    static inline void XOR_C_2(Z80* ctx) { ctx->XOR_R(0b001, 2); }
+    static inline void XOR_D_2(Z80* ctx) { ctx->XOR_R(0b010, 2); }
+    static inline void XOR_E_2(Z80* ctx) { ctx->XOR_R(0b011, 2); }
+    static inline void XOR_A_2(Z80* ctx) { ctx->XOR_R(0b111, 2); }
+    inline void XOR_R(unsigned char r, int pc = 1)
     {
-        unsigned char l = ctx->fetch(3);
-        unsigned char h = ctx->fetch(3);
-        unsigned short addr = ctx->make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] JP $%04X", ctx->reg.PC - 3, addr);
+        if (isDebug()) log("[%04X] XOR %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
 #endif
-        ctx->reg.PC = addr;
-        ctx->reg.WZ = addr;
+        xor8(getRegister(r));
     }
 
-    // Conditional Jump
-    static inline void JP_C0_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NZ); }
-    static inline void JP_C1_NN(Z80* ctx) { ctx->JP_C_NN(Condition::Z); }
-    static inline void JP_C2_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NC); }
-    static inline void JP_C3_NN(Z80* ctx) { ctx->JP_C_NN(Condition::C); }
-    static inline void JP_C4_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NPV); }
-    static inline void JP_C5_NN(Z80* ctx) { ctx->JP_C_NN(Condition::PV); }
-    static inline void JP_C6_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NS); }
-    static inline void JP_C7_NN(Z80* ctx) { ctx->JP_C_NN(Condition::S); }
-    inline void JP_C_NN(Condition c)
+    // XOR with register IXH
+    static inline void XOR_IXH_(Z80* ctx) { ctx->XOR_IXH(); }
+    inline void XOR_IXH()
     {
-        unsigned char l = fetch(3);
-        unsigned char h = fetch(3);
-        unsigned short addr = make16BitsFromLE(l, h);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] JP %s, $%04X", reg.PC - 3, conditionDump(c), addr);
+        if (isDebug()) log("[%04X] XOR %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
 #endif
-        if (checkConditionFlag(c)) reg.PC = addr;
-        reg.WZ = addr;
+        xor8(getIXH());
     }
 
-    // Jump Relative to PC+e
-    static inline void JR_E(Z80* ctx)
+    // XOR with register IXL
+    static inline void XOR_IXL_(Z80* ctx) { ctx->XOR_IXL(); }
+    inline void XOR_IXL()
     {
-        signed char e = (signed char)ctx->fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] JR %s", ctx->reg.PC - 2, ctx->relativeDump(ctx->reg.PC - 2, e));
+        if (isDebug()) log("[%04X] XOR %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
 #endif
-        ctx->reg.PC += e;
-        ctx->consumeClock(5);
+        xor8(getIXL());
     }
 
-    // Jump Relative to PC+e, if condition
-    static inline void JR_NZ_E(Z80* ctx) { ctx->JR_CND_E(Condition::NZ); }
-    static inline void JR_Z_E(Z80* ctx) { ctx->JR_CND_E(Condition::Z); }
-    static inline void JR_NC_E(Z80* ctx) { ctx->JR_CND_E(Condition::NC); }
-    static inline void JR_C_E(Z80* ctx) { ctx->JR_CND_E(Condition::C); }
-    inline void JR_CND_E(Condition cnd)
+    // XOR with register IYH
+    static inline void XOR_IYH_(Z80* ctx) { ctx->XOR_IYH(); }
+    inline void XOR_IYH()
     {
-        signed char e = (signed char)fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] JR %s, %s <%s>", reg.PC - 2, conditionDump(cnd), relativeDump(reg.PC - 2, e), checkConditionFlag(cnd) ? "YES" : "NO");
+        if (isDebug()) log("[%04X] XOR %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
 #endif
-        if (checkConditionFlag(cnd)) {
-            reg.PC += e;
-            consumeClock(5);
-        }
+        xor8(getIYH());
     }
 
-    // Jump to HL
-    static inline void JP_HL(Z80* ctx)
+    // XOR with register IYL
+    static inline void XOR_IYL_(Z80* ctx) { ctx->XOR_IYL(); }
+    inline void XOR_IYL()
     {
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] JP %s", ctx->reg.PC - 1, ctx->registerPairDump(0b10));
+        if (isDebug()) log("[%04X] XOR %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
 #endif
-        ctx->reg.PC = ctx->getHL();
+        xor8(getIYL());
     }
 
-    // Jump to IX
-    static inline void JP_IX(Z80* ctx)
+    // XOR immediate
+    static inline void XOR_N(Z80* ctx)
     {
+        unsigned char n = ctx->fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] JP IX<$%04X>", ctx->reg.PC - 2, ctx->reg.IX);
+        if (ctx->isDebug()) ctx->log("[%04X] XOR %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
 #endif
-        ctx->reg.PC = ctx->reg.IX;
+        ctx->xor8(n);
     }
 
-    // Jump to IY
-    static inline void JP_IY(Z80* ctx)
+    // XOR Memory
+    static inline void XOR_HL(Z80* ctx)
     {
+        unsigned char n = ctx->readByte(ctx->getHL(), 3);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] JP IY<$%04X>", ctx->reg.PC - 2, ctx->reg.IY);
+        if (ctx->isDebug()) ctx->log("[%04X] XOR %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), ctx->reg.pair.A ^ n);
 #endif
-        ctx->reg.PC = ctx->reg.IY;
+        ctx->xor8(n);
     }
 
-    // 	Decrement B and Jump relative if B=0
-    static inline void DJNZ_E(Z80* ctx)
+    // XOR Memory
+    static inline void XOR_IX_(Z80* ctx) { ctx->XOR_IX(); }
+    inline void XOR_IX()
     {
-        signed char e = (signed char)ctx->fetch(4);
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((unsigned short)(reg.IX + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] DJNZ %s (%s)", ctx->reg.PC - 2, ctx->relativeDump(ctx->reg.PC - 2, e), ctx->registerDump(0b000));
+        if (isDebug()) log("[%04X] XOR %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), reg.pair.A ^ n);
 #endif
-        ctx->reg.pair.B--;
-        if (ctx->reg.pair.B) {
-            ctx->reg.PC += e;
-            ctx->consumeClock(5);
-        }
+        xor8(n);
+        consumeClock(3);
     }
 
-    // Call
-    static inline void CALL_NN(Z80* ctx)
+    // XOR Memory
+    static inline void XOR_IY_(Z80* ctx) { ctx->XOR_IY(); }
+    inline void XOR_IY()
     {
-        unsigned short addrL = ctx->fetch(4);
-        unsigned short addrH = ctx->fetch(3);
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((unsigned short)(reg.IY + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] CALL $%04X (%s)", ctx->reg.PC - 3, ctx->make16BitsFromLE(addrL, addrH), ctx->registerPairDump(0b11));
-#endif
-        ctx->push(ctx->getPCH(), 3);
-        ctx->setPCH(addrH);
-        ctx->push(ctx->getPCL(), 3);
-        ctx->setPCL(addrL);
-        ctx->reg.WZ = ctx->reg.PC;
-#ifndef Z80_DISABLE_NESTCHECK
-        ctx->invokeCallHandlers();
+        if (isDebug()) log("[%04X] XOR %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), reg.pair.A ^ n);
 #endif
+        xor8(n);
+        consumeClock(3);
     }
 
-    // Return
-    static inline void RET(Z80* ctx)
+    // Complement acc. (1's Comp.)
+    static inline void CPL(Z80* ctx)
     {
-#ifndef Z80_DISABLE_NESTCHECK
-        ctx->invokeReturnHandlers();
-#endif
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short pc = ctx->reg.PC - 1;
-        const char* dump = ctx->isDebug() ? ctx->registerPairDump(0b11) : "";
-#endif
-        ctx->setPCL(ctx->pop(3));
-        ctx->setPCH(ctx->pop(3));
-        ctx->reg.WZ = ctx->reg.PC;
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] RET to $%04X (%s)", pc, ctx->reg.PC, dump);
+        if (ctx->isDebug()) ctx->log("[%04X] CPL %s", ctx->reg.PC - 1, ctx->registerDump(0b111));
 #endif
+        ctx->reg.pair.A = ~ctx->reg.pair.A;
+        ctx->setFlagH();
+        ctx->setFlagN();
+        ctx->setFlagXY(ctx->reg.pair.A);
     }
 
-    // Call with condition
-    static inline void CALL_C0_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NZ); }
-    static inline void CALL_C1_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::Z); }
-    static inline void CALL_C2_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NC); }
-    static inline void CALL_C3_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::C); }
-    static inline void CALL_C4_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NPV); }
-    static inline void CALL_C5_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::PV); }
-    static inline void CALL_C6_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NS); }
-    static inline void CALL_C7_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::S); }
-    inline void CALL_C_NN(Condition c)
+    // Negate Acc. (2's Comp.)
+    static inline void NEG_(Z80* ctx) { ctx->NEG(); }
+    inline void NEG()
     {
-        bool execute = checkConditionFlag(c);
-        unsigned char nL = fetch(3);
-        unsigned char nH = fetch(3);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] CALL %s, $%04X (%s) <execute:%s>", reg.PC - 3, conditionDump(c), make16BitsFromLE(nL, nH), registerPairDump(0b11), execute ? "YES" : "NO");
+        if (isDebug()) log("[%04X] NEG %s", reg.PC - 2, registerDump(0b111));
 #endif
-        if (execute) {
-            push(getPCH(), 4);
-            setPCH(nH);
-            push(getPCL(), 3);
-            setPCL(nL);
-#ifndef Z80_DISABLE_NESTCHECK
-            invokeCallHandlers();
-#endif
-        }
-        reg.WZ = reg.PC;
+        unsigned char a = reg.pair.A;
+        reg.pair.A = 0;
+        subtract8(a, 0);
     }
 
-    //  with condition
-    static inline void RET_C0(Z80* ctx) { ctx->RET_C(Condition::NZ); }
-    static inline void RET_C1(Z80* ctx) { ctx->RET_C(Condition::Z); }
-    static inline void RET_C2(Z80* ctx) { ctx->RET_C(Condition::NC); }
-    static inline void RET_C3(Z80* ctx) { ctx->RET_C(Condition::C); }
-    static inline void RET_C4(Z80* ctx) { ctx->RET_C(Condition::NPV); }
-    static inline void RET_C5(Z80* ctx) { ctx->RET_C(Condition::PV); }
-    static inline void RET_C6(Z80* ctx) { ctx->RET_C(Condition::NS); }
-    static inline void RET_C7(Z80* ctx) { ctx->RET_C(Condition::S); }
-    inline void RET_C(Condition c)
+    // 　Complement Carry Flag
+    static inline void CCF(Z80* ctx)
     {
-        if (!checkConditionFlag(c)) {
-#ifndef Z80_DISABLE_DEBUG
-            if (isDebug()) log("[%04X] RET %s <execute:NO>", reg.PC - 1, conditionDump(c));
-#endif
-            consumeClock(1);
-            return;
-        }
-#ifndef Z80_DISABLE_NESTCHECK
-        invokeReturnHandlers();
-#endif
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short pc = reg.PC;
-        unsigned short sp = reg.SP;
-#endif
-        setPCL(pop(4));
-        setPCH(pop(3));
-        reg.WZ = reg.PC;
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RET %s to $%04X (SP<$%04X>) <execute:YES>", pc - 1, conditionDump(c), reg.PC, sp);
+        if (ctx->isDebug()) ctx->log("[%04X] CCF <C:%s -> %s>", ctx->reg.PC - 1, ctx->isFlagC() ? "ON" : "OFF", !ctx->isFlagC() ? "ON" : "OFF");
 #endif
+        ctx->setFlagH(ctx->isFlagC());
+        ctx->resetFlagN();
+        ctx->setFlagC(!ctx->isFlagC());
+        ctx->setFlagXY(ctx->reg.pair.A);
     }
 
-    // Return from interrupt
-    static inline void RETI_(Z80* ctx) { ctx->RETI(); }
-    inline void RETI()
+    // Set Carry Flag
+    static inline void SCF(Z80* ctx)
     {
-#ifndef Z80_DISABLE_NESTCHECK
-        invokeReturnHandlers();
-#endif
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short pc = reg.PC;
-        unsigned short sp = reg.SP;
-#endif
-        setPCL(pop(3));
-        setPCH(pop(3));
-        reg.WZ = reg.PC;
-        reg.IFF &= ~IFF_IRQ();
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RETI to $%04X (SP<$%04X>)", pc - 2, reg.PC, sp);
+        if (ctx->isDebug()) ctx->log("[%04X] SCF <C:%s -> ON>", ctx->reg.PC - 1, ctx->isFlagC() ? "ON" : "OFF");
 #endif
+        ctx->resetFlagH();
+        ctx->resetFlagN();
+        ctx->setFlagC();
+        ctx->setFlagXY(ctx->reg.pair.A);
     }
 
-    // Return from non maskable interrupt
-    static inline void RETN_(Z80* ctx) { ctx->RETN(); }
-    inline void RETN()
+    // Test BIT b of register r
+    static inline void BIT_B_0(Z80* ctx) { ctx->BIT_R(0b000, 0); }
+    static inline void BIT_B_1(Z80* ctx) { ctx->BIT_R(0b000, 1); }
+    static inline void BIT_B_2(Z80* ctx) { ctx->BIT_R(0b000, 2); }
+    static inline void BIT_B_3(Z80* ctx) { ctx->BIT_R(0b000, 3); }
+    static inline void BIT_B_4(Z80* ctx) { ctx->BIT_R(0b000, 4); }
+    static inline void BIT_B_5(Z80* ctx) { ctx->BIT_R(0b000, 5); }
+    static inline void BIT_B_6(Z80* ctx) { ctx->BIT_R(0b000, 6); }
+    static inline void BIT_B_7(Z80* ctx) { ctx->BIT_R(0b000, 7); }
+    static inline void BIT_C_0(Z80* ctx) { ctx->BIT_R(0b001, 0); }
+    static inline void BIT_C_1(Z80* ctx) { ctx->BIT_R(0b001, 1); }
+    static inline void BIT_C_2(Z80* ctx) { ctx->BIT_R(0b001, 2); }
+    static inline void BIT_C_3(Z80* ctx) { ctx->BIT_R(0b001, 3); }
+    static inline void BIT_C_4(Z80* ctx) { ctx->BIT_R(0b001, 4); }
+    static inline void BIT_C_5(Z80* ctx) { ctx->BIT_R(0b001, 5); }
+    static inline void BIT_C_6(Z80* ctx) { ctx->BIT_R(0b001, 6); }
+    static inline void BIT_C_7(Z80* ctx) { ctx->BIT_R(0b001, 7); }
+    static inline void BIT_D_0(Z80* ctx) { ctx->BIT_R(0b010, 0); }
+    static inline void BIT_D_1(Z80* ctx) { ctx->BIT_R(0b010, 1); }
+    static inline void BIT_D_2(Z80* ctx) { ctx->BIT_R(0b010, 2); }
+    static inline void BIT_D_3(Z80* ctx) { ctx->BIT_R(0b010, 3); }
+    static inline void BIT_D_4(Z80* ctx) { ctx->BIT_R(0b010, 4); }
+    static inline void BIT_D_5(Z80* ctx) { ctx->BIT_R(0b010, 5); }
+    static inline void BIT_D_6(Z80* ctx) { ctx->BIT_R(0b010, 6); }
+    static inline void BIT_D_7(Z80* ctx) { ctx->BIT_R(0b010, 7); }
+    static inline void BIT_E_0(Z80* ctx) { ctx->BIT_R(0b011, 0); }
+    static inline void BIT_E_1(Z80* ctx) { ctx->BIT_R(0b011, 1); }
+    static inline void BIT_E_2(Z80* ctx) { ctx->BIT_R(0b011, 2); }
+    static inline void BIT_E_3(Z80* ctx) { ctx->BIT_R(0b011, 3); }
+    static inline void BIT_E_4(Z80* ctx) { ctx->BIT_R(0b011, 4); }
+    static inline void BIT_E_5(Z80* ctx) { ctx->BIT_R(0b011, 5); }
+    static inline void BIT_E_6(Z80* ctx) { ctx->BIT_R(0b011, 6); }
+    static inline void BIT_E_7(Z80* ctx) { ctx->BIT_R(0b011, 7); }
+    static inline void BIT_H_0(Z80* ctx) { ctx->BIT_R(0b100, 0); }
+    static inline void BIT_H_1(Z80* ctx) { ctx->BIT_R(0b100, 1); }
+    static inline void BIT_H_2(Z80* ctx) { ctx->BIT_R(0b100, 2); }
+    static inline void BIT_H_3(Z80* ctx) { ctx->BIT_R(0b100, 3); }
+    static inline void BIT_H_4(Z80* ctx) { ctx->BIT_R(0b100, 4); }
+    static inline void BIT_H_5(Z80* ctx) { ctx->BIT_R(0b100, 5); }
+    static inline void BIT_H_6(Z80* ctx) { ctx->BIT_R(0b100, 6); }
+    static inline void BIT_H_7(Z80* ctx) { ctx->BIT_R(0b100, 7); }
+    static inline void BIT_L_0(Z80* ctx) { ctx->BIT_R(0b101, 0); }
+    static inline void BIT_L_1(Z80* ctx) { ctx->BIT_R(0b101, 1); }
+    static inline void BIT_L_2(Z80* ctx) { ctx->BIT_R(0b101, 2); }
+    static inline void BIT_L_3(Z80* ctx) { ctx->BIT_R(0b101, 3); }
+    static inline void BIT_L_4(Z80* ctx) { ctx->BIT_R(0b101, 4); }
+    static inline void BIT_L_5(Z80* ctx) { ctx->BIT_R(0b101, 5); }
+    static inline void BIT_L_6(Z80* ctx) { ctx->BIT_R(0b101, 6); }
+    static inline void BIT_L_7(Z80* ctx) { ctx->BIT_R(0b101, 7); }
+    static inline void BIT_A_0(Z80* ctx) { ctx->BIT_R(0b111, 0); }
+    static inline void BIT_A_1(Z80* ctx) { ctx->BIT_R(0b111, 1); }
+    static inline void BIT_A_2(Z80* ctx) { ctx->BIT_R(0b111, 2); }
+    static inline void BIT_A_3(Z80* ctx) { ctx->BIT_R(0b111, 3); }
+    static inline void BIT_A_4(Z80* ctx) { ctx->BIT_R(0b111, 4); }
+    static inline void BIT_A_5(Z80* ctx) { ctx->BIT_R(0b111, 5); }
+    static inline void BIT_A_6(Z80* ctx) { ctx->BIT_R(0b111, 6); }
+    static inline void BIT_A_7(Z80* ctx) { ctx->BIT_R(0b111, 7); }
+    inline void BIT_R(unsigned char r, unsigned char bit)
     {
-#ifndef Z80_DISABLE_NESTCHECK
-        invokeReturnHandlers();
-#endif
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short pc = reg.PC;
-        unsigned short sp = reg.SP;
-#endif
-        setPCL(pop(3));
-        setPCH(pop(3));
-        reg.WZ = reg.PC;
-        reg.IFF &= ~IFF_NMI();
-        if (!((reg.IFF & IFF1()) && (reg.IFF & IFF2()))) {
-            reg.IFF |= IFF1();
-        } else {
-            if (reg.IFF & IFF2()) {
-                reg.IFF |= IFF1();
-            } else {
-                reg.IFF &= ~IFF1();
-            }
-        }
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RETN to $%04X (SP<$%04X>)", pc - 2, reg.PC, sp);
+        if (isDebug()) log("[%04X] BIT %s of bit-%d", reg.PC - 2, registerDump(r), bit);
 #endif
+        unsigned char n = 0;
+        n = *rp & bits[bit];
+        setFlagZ(n ? false : true);
+        setFlagPV(isFlagZ());
+        setFlagS(!isFlagZ() && 7 == bit);
+        setFlagH();
+        resetFlagN();
+        setFlagXY(*rp);
     }
 
-    // Interrupt
-    static inline void RST00(Z80* ctx) { ctx->RST(0, true); }
-    static inline void RST08(Z80* ctx) { ctx->RST(1, true); }
-    static inline void RST10(Z80* ctx) { ctx->RST(2, true); }
-    static inline void RST18(Z80* ctx) { ctx->RST(3, true); }
-    static inline void RST20(Z80* ctx) { ctx->RST(4, true); }
-    static inline void RST28(Z80* ctx) { ctx->RST(5, true); }
-    static inline void RST30(Z80* ctx) { ctx->RST(6, true); }
-    static inline void RST38(Z80* ctx) { ctx->RST(7, true); }
-    inline void RST(unsigned char t, bool isOperand)
+    // Test BIT b of location (HL)
+    static inline void BIT_HL_0(Z80* ctx) { ctx->BIT_HL(0); }
+    static inline void BIT_HL_1(Z80* ctx) { ctx->BIT_HL(1); }
+    static inline void BIT_HL_2(Z80* ctx) { ctx->BIT_HL(2); }
+    static inline void BIT_HL_3(Z80* ctx) { ctx->BIT_HL(3); }
+    static inline void BIT_HL_4(Z80* ctx) { ctx->BIT_HL(4); }
+    static inline void BIT_HL_5(Z80* ctx) { ctx->BIT_HL(5); }
+    static inline void BIT_HL_6(Z80* ctx) { ctx->BIT_HL(6); }
+    static inline void BIT_HL_7(Z80* ctx) { ctx->BIT_HL(7); }
+    inline void BIT_HL(unsigned char bit)
     {
-        unsigned short addr = t * 8;
-#ifndef Z80_DISABLE_DEBUG
-        unsigned short sp = reg.SP;
-        unsigned short pc = reg.PC;
-#endif
-        push(getPCH(), 4);
-        setPCH(0);
-        push(getPCL(), 3);
-        reg.PC = addr;
-        reg.WZ = addr;
+        unsigned char n = readByte(getHL());
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RST $%04X (SP<$%04X>)", pc - (isOperand ? 1 : 0), addr, sp);
-#endif
-#ifndef Z80_DISABLE_NESTCHECK
-        invokeCallHandlers();
+        if (isDebug()) log("[%04X] BIT (%s) = $%02X of bit-%d", reg.PC - 2, registerPairDump(0b10), n, bit);
 #endif
+        n &= bits[bit];
+        setFlagZ(!n);
+        setFlagPV(isFlagZ());
+        setFlagS(!isFlagZ() && 7 == bit);
+        setFlagH();
+        resetFlagN();
+        setFlagXY((reg.WZ & 0xFF00) >> 8);
     }
 
-    // Input a byte form device n to accu.
-    static inline void IN_A_N(Z80* ctx)
+    // Test BIT b of location (IX+d)
+    static inline void BIT_IX_0(Z80* ctx, signed char d) { ctx->BIT_IX(d, 0); }
+    static inline void BIT_IX_1(Z80* ctx, signed char d) { ctx->BIT_IX(d, 1); }
+    static inline void BIT_IX_2(Z80* ctx, signed char d) { ctx->BIT_IX(d, 2); }
+    static inline void BIT_IX_3(Z80* ctx, signed char d) { ctx->BIT_IX(d, 3); }
+    static inline void BIT_IX_4(Z80* ctx, signed char d) { ctx->BIT_IX(d, 4); }
+    static inline void BIT_IX_5(Z80* ctx, signed char d) { ctx->BIT_IX(d, 5); }
+    static inline void BIT_IX_6(Z80* ctx, signed char d) { ctx->BIT_IX(d, 6); }
+    static inline void BIT_IX_7(Z80* ctx, signed char d) { ctx->BIT_IX(d, 7); }
+    inline void BIT_IX(signed char d, unsigned char bit)
     {
-        unsigned char n = ctx->fetch(3);
-        unsigned char i = ctx->inPortWithA(n);
+        unsigned char n = readByte((unsigned short)(reg.IX + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] IN %s, ($%02X) = $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n, i);
+        if (isDebug()) log("[%04X] BIT (IX+d<$%04X>) = $%02X of bit-%d", reg.PC - 4, (unsigned short)(reg.IX + d), n, bit);
 #endif
-        ctx->reg.pair.A = i;
+        n &= bits[bit];
+        setFlagZ(!n);
+        setFlagPV(isFlagZ());
+        setFlagS(!isFlagZ() && 7 == bit);
+        setFlagH();
+        resetFlagN();
+        setFlagXY((reg.WZ & 0xFF00) >> 8);
     }
 
-    // Input a byte form device (C) to register.
-    static inline void IN_B_C(Z80* ctx) { ctx->IN_R_C(0b000); }
-    static inline void IN_C_C(Z80* ctx) { ctx->IN_R_C(0b001); }
-    static inline void IN_D_C(Z80* ctx) { ctx->IN_R_C(0b010); }
-    static inline void IN_E_C(Z80* ctx) { ctx->IN_R_C(0b011); }
-    static inline void IN_H_C(Z80* ctx) { ctx->IN_R_C(0b100); }
-    static inline void IN_L_C(Z80* ctx) { ctx->IN_R_C(0b101); }
-    static inline void IN_C(Z80* ctx) { ctx->IN_R_C(0, false); }
-    static inline void IN_A_C(Z80* ctx) { ctx->IN_R_C(0b111); }
-    inline void IN_R_C(unsigned char r, bool setRegister = true)
+    // Test BIT b of location (IY+d)
+    static inline void BIT_IY_0(Z80* ctx, signed char d) { ctx->BIT_IY(d, 0); }
+    static inline void BIT_IY_1(Z80* ctx, signed char d) { ctx->BIT_IY(d, 1); }
+    static inline void BIT_IY_2(Z80* ctx, signed char d) { ctx->BIT_IY(d, 2); }
+    static inline void BIT_IY_3(Z80* ctx, signed char d) { ctx->BIT_IY(d, 3); }
+    static inline void BIT_IY_4(Z80* ctx, signed char d) { ctx->BIT_IY(d, 4); }
+    static inline void BIT_IY_5(Z80* ctx, signed char d) { ctx->BIT_IY(d, 5); }
+    static inline void BIT_IY_6(Z80* ctx, signed char d) { ctx->BIT_IY(d, 6); }
+    static inline void BIT_IY_7(Z80* ctx, signed char d) { ctx->BIT_IY(d, 7); }
+    inline void BIT_IY(signed char d, unsigned char bit)
     {
-        unsigned char* rp = setRegister ? getRegisterPointer(r) : nullptr;
-        unsigned char i = inPortWithB(reg.pair.C);
+        unsigned char n = readByte((unsigned short)(reg.IY + d));
 #ifndef Z80_DISABLE_DEBUG
-        if (rp) {
-            if (isDebug()) log("[%04X] IN %s, (%s) = $%02X", reg.PC - 2, registerDump(r), registerDump(0b001), i);
-            *rp = i;
-        } else {
-            if (isDebug()) log("[%04X] IN (%s) = $%02X", reg.PC - 2, registerDump(0b001), i);
-        }
-#else
-        if (rp) *rp = i;
+        if (isDebug()) log("[%04X] BIT (IY+d<$%04X>) = $%02X of bit-%d", reg.PC - 4, (unsigned short)(reg.IY + d), n, bit);
 #endif
-        setFlagS(i & 0x80);
-        setFlagZ(i == 0);
-        resetFlagH();
-        setFlagPV(isEvenNumberBits(i));
+        n &= bits[bit];
+        setFlagZ(!n);
+        setFlagPV(isFlagZ());
+        setFlagS(!isFlagZ() && 7 == bit);
+        setFlagH();
         resetFlagN();
-        setFlagXY(i);
+        setFlagXY((reg.WZ & 0xFF00) >> 8);
     }
 
-    inline void decrementB_forRepeatIO()
+    // SET bit b of register r
+    static inline void SET_B_0(Z80* ctx) { ctx->SET_R(0b000, 0); }
+    static inline void SET_B_1(Z80* ctx) { ctx->SET_R(0b000, 1); }
+    static inline void SET_B_2(Z80* ctx) { ctx->SET_R(0b000, 2); }
+    static inline void SET_B_3(Z80* ctx) { ctx->SET_R(0b000, 3); }
+    static inline void SET_B_4(Z80* ctx) { ctx->SET_R(0b000, 4); }
+    static inline void SET_B_5(Z80* ctx) { ctx->SET_R(0b000, 5); }
+    static inline void SET_B_6(Z80* ctx) { ctx->SET_R(0b000, 6); }
+    static inline void SET_B_7(Z80* ctx) { ctx->SET_R(0b000, 7); }
+    static inline void SET_C_0(Z80* ctx) { ctx->SET_R(0b001, 0); }
+    static inline void SET_C_1(Z80* ctx) { ctx->SET_R(0b001, 1); }
+    static inline void SET_C_2(Z80* ctx) { ctx->SET_R(0b001, 2); }
+    static inline void SET_C_3(Z80* ctx) { ctx->SET_R(0b001, 3); }
+    static inline void SET_C_4(Z80* ctx) { ctx->SET_R(0b001, 4); }
+    static inline void SET_C_5(Z80* ctx) { ctx->SET_R(0b001, 5); }
+    static inline void SET_C_6(Z80* ctx) { ctx->SET_R(0b001, 6); }
+    static inline void SET_C_7(Z80* ctx) { ctx->SET_R(0b001, 7); }
+    static inline void SET_D_0(Z80* ctx) { ctx->SET_R(0b010, 0); }
+    static inline void SET_D_1(Z80* ctx) { ctx->SET_R(0b010, 1); }
+    static inline void SET_D_2(Z80* ctx) { ctx->SET_R(0b010, 2); }
+    static inline void SET_D_3(Z80* ctx) { ctx->SET_R(0b010, 3); }
+    static inline void SET_D_4(Z80* ctx) { ctx->SET_R(0b010, 4); }
+    static inline void SET_D_5(Z80* ctx) { ctx->SET_R(0b010, 5); }
+    static inline void SET_D_6(Z80* ctx) { ctx->SET_R(0b010, 6); }
+    static inline void SET_D_7(Z80* ctx) { ctx->SET_R(0b010, 7); }
+    static inline void SET_E_0(Z80* ctx) { ctx->SET_R(0b011, 0); }
+    static inline void SET_E_1(Z80* ctx) { ctx->SET_R(0b011, 1); }
+    static inline void SET_E_2(Z80* ctx) { ctx->SET_R(0b011, 2); }
+    static inline void SET_E_3(Z80* ctx) { ctx->SET_R(0b011, 3); }
+    static inline void SET_E_4(Z80* ctx) { ctx->SET_R(0b011, 4); }
+    static inline void SET_E_5(Z80* ctx) { ctx->SET_R(0b011, 5); }
+    static inline void SET_E_6(Z80* ctx) { ctx->SET_R(0b011, 6); }
+    static inline void SET_E_7(Z80* ctx) { ctx->SET_R(0b011, 7); }
+    static inline void SET_H_0(Z80* ctx) { ctx->SET_R(0b100, 0); }
+    static inline void SET_H_1(Z80* ctx) { ctx->SET_R(0b100, 1); }
+    static inline void SET_H_2(Z80* ctx) { ctx->SET_R(0b100, 2); }
+    static inline void SET_H_3(Z80* ctx) { ctx->SET_R(0b100, 3); }
+    static inline void SET_H_4(Z80* ctx) { ctx->SET_R(0b100, 4); }
+    static inline void SET_H_5(Z80* ctx) { ctx->SET_R(0b100, 5); }
+    static inline void SET_H_6(Z80* ctx) { ctx->SET_R(0b100, 6); }
+    static inline void SET_H_7(Z80* ctx) { ctx->SET_R(0b100, 7); }
+    static inline void SET_L_0(Z80* ctx) { ctx->SET_R(0b101, 0); }
+    static inline void SET_L_1(Z80* ctx) { ctx->SET_R(0b101, 1); }
+    static inline void SET_L_2(Z80* ctx) { ctx->SET_R(0b101, 2); }
+    static inline void SET_L_3(Z80* ctx) { ctx->SET_R(0b101, 3); }
+    static inline void SET_L_4(Z80* ctx) { ctx->SET_R(0b101, 4); }
+    static inline void SET_L_5(Z80* ctx) { ctx->SET_R(0b101, 5); }
+    static inline void SET_L_6(Z80* ctx) { ctx->SET_R(0b101, 6); }
+    static inline void SET_L_7(Z80* ctx) { ctx->SET_R(0b101, 7); }
+    static inline void SET_A_0(Z80* ctx) { ctx->SET_R(0b111, 0); }
+    static inline void SET_A_1(Z80* ctx) { ctx->SET_R(0b111, 1); }
+    static inline void SET_A_2(Z80* ctx) { ctx->SET_R(0b111, 2); }
+    static inline void SET_A_3(Z80* ctx) { ctx->SET_R(0b111, 3); }
+    static inline void SET_A_4(Z80* ctx) { ctx->SET_R(0b111, 4); }
+    static inline void SET_A_5(Z80* ctx) { ctx->SET_R(0b111, 5); }
+    static inline void SET_A_6(Z80* ctx) { ctx->SET_R(0b111, 6); }
+    static inline void SET_A_7(Z80* ctx) { ctx->SET_R(0b111, 7); }
+    inline void SET_R(unsigned char r, unsigned char bit)
     {
-        reg.pair.B--;
-        reg.pair.F = 0;
-        setFlagC(isFlagC());
-        setFlagN();
-        setFlagZ(reg.pair.B == 0);
-        setFlagXY(reg.pair.B);
-        setFlagS(reg.pair.B & 0x80);
-        setFlagH((reg.pair.B & 0x0F) == 0x0F);
-        setFlagPV(reg.pair.B == 0x7F);
+        unsigned char* rp = getRegisterPointer(r);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] SET %s of bit-%d", reg.PC - 2, registerDump(r), bit);
+#endif
+        *rp |= bits[bit];
     }
 
-    // Load location (HL) with input from port (C); or increment/decrement HL and decrement B
-    inline void repeatIN(bool isIncHL, bool isRepeat)
+    // SET bit b of location (HL)
+    static inline void SET_HL_0(Z80* ctx) { ctx->SET_HL(0); }
+    static inline void SET_HL_1(Z80* ctx) { ctx->SET_HL(1); }
+    static inline void SET_HL_2(Z80* ctx) { ctx->SET_HL(2); }
+    static inline void SET_HL_3(Z80* ctx) { ctx->SET_HL(3); }
+    static inline void SET_HL_4(Z80* ctx) { ctx->SET_HL(4); }
+    static inline void SET_HL_5(Z80* ctx) { ctx->SET_HL(5); }
+    static inline void SET_HL_6(Z80* ctx) { ctx->SET_HL(6); }
+    static inline void SET_HL_7(Z80* ctx) { ctx->SET_HL(7); }
+    inline void SET_HL(unsigned char bit)
     {
-        reg.WZ = (unsigned short)(getBC() + (isIncHL ? 1 : -1));
-        unsigned char i = inPortWithB(reg.pair.C);
-        decrementB_forRepeatIO();
-        unsigned short hl = getHL();
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) {
-            if (isIncHL) {
-                log("[%04X] %s ... (%s) <- p(%s) = $%02X [%s]", reg.PC - 2, isRepeat ? "INIR" : "INI", registerPairDump(0b10), registerDump(0b001), i, registerDump(0b000));
-            } else {
-                log("[%04X] %s ... (%s) <- p(%s) = $%02X [%s]", reg.PC - 2, isRepeat ? "INDR" : "IND", registerPairDump(0b10), registerDump(0b001), i, registerDump(0b000));
-            }
-        }
+        if (isDebug()) log("[%04X] SET (%s) = $%02X of bit-%d", reg.PC - 2, registerPairDump(0b10), n, bit);
 #endif
-        writeByte(hl, i);
-        hl += isIncHL ? 1 : -1;
-        setHL(hl);
-        setFlagZ(reg.pair.B == 0);
-        setFlagN(i & 0x80);                                               // NOTE: undocumented
-        setFlagC(0xFF < i + ((reg.pair.C + 1) & 0xFF));                   // NOTE: undocumented
-        setFlagH(isFlagC());                                              // NOTE: undocumented
-        setFlagPV((i + (((reg.pair.C + 1) & 0xFF) & 0x07)) ^ reg.pair.B); // NOTE: undocumented
-        if (isRepeat && 0 != reg.pair.B) {
-            reg.PC -= 2;
-            consumeClock(5);
-        }
+        n |= bits[bit];
+        writeByte(addr, n, 3);
     }
-    static inline void INI(Z80* ctx) { ctx->repeatIN(true, false); }
-    static inline void INIR(Z80* ctx) { ctx->repeatIN(true, true); }
-    static inline void IND(Z80* ctx) { ctx->repeatIN(false, false); }
-    static inline void INDR(Z80* ctx) { ctx->repeatIN(false, true); }
 
-    // Load Output port (n) with Acc.
-    static inline void OUT_N_A(Z80* ctx)
+    // SET bit b of location (IX+d)
+    static inline void SET_IX_0(Z80* ctx, signed char d) { ctx->SET_IX(d, 0); }
+    static inline void SET_IX_1(Z80* ctx, signed char d) { ctx->SET_IX(d, 1); }
+    static inline void SET_IX_2(Z80* ctx, signed char d) { ctx->SET_IX(d, 2); }
+    static inline void SET_IX_3(Z80* ctx, signed char d) { ctx->SET_IX(d, 3); }
+    static inline void SET_IX_4(Z80* ctx, signed char d) { ctx->SET_IX(d, 4); }
+    static inline void SET_IX_5(Z80* ctx, signed char d) { ctx->SET_IX(d, 5); }
+    static inline void SET_IX_6(Z80* ctx, signed char d) { ctx->SET_IX(d, 6); }
+    static inline void SET_IX_7(Z80* ctx, signed char d) { ctx->SET_IX(d, 7); }
+    inline void SET_IX(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char n = ctx->fetch(3);
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (ctx->isDebug()) ctx->log("[%04X] OUT ($%02X), %s", ctx->reg.PC - 2, n, ctx->registerDump(0b111));
+        if (isDebug()) log("[%04X] SET (IX+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
 #endif
-        ctx->outPortWithA(n, ctx->reg.pair.A);
+        n |= bits[bit];
+        if (rp) *rp = n;
+        writeByte(addr, n, 3);
     }
 
-    // Output a byte to device (C) form register.
-    static inline void OUT_C_B(Z80* ctx) { ctx->OUT_C_R(0b000); }
-    static inline void OUT_C_C(Z80* ctx) { ctx->OUT_C_R(0b001); }
-    static inline void OUT_C_D(Z80* ctx) { ctx->OUT_C_R(0b010); }
-    static inline void OUT_C_E(Z80* ctx) { ctx->OUT_C_R(0b011); }
-    static inline void OUT_C_H(Z80* ctx) { ctx->OUT_C_R(0b100); }
-    static inline void OUT_C_L(Z80* ctx) { ctx->OUT_C_R(0b101); }
-    static inline void OUT_C_0(Z80* ctx) { ctx->OUT_C_R(0, true); }
-    static inline void OUT_C_A(Z80* ctx) { ctx->OUT_C_R(0b111); }
-    inline void OUT_C_R(unsigned char r, bool zero = false)
+    // SET bit b of location (IX+d) with load Reg.
+    static inline void SET_IX_0_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b000); }
+    static inline void SET_IX_1_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b000); }
+    static inline void SET_IX_2_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b000); }
+    static inline void SET_IX_3_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b000); }
+    static inline void SET_IX_4_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b000); }
+    static inline void SET_IX_5_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b000); }
+    static inline void SET_IX_6_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b000); }
+    static inline void SET_IX_7_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b000); }
+    static inline void SET_IX_0_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b001); }
+    static inline void SET_IX_1_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b001); }
+    static inline void SET_IX_2_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b001); }
+    static inline void SET_IX_3_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b001); }
+    static inline void SET_IX_4_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b001); }
+    static inline void SET_IX_5_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b001); }
+    static inline void SET_IX_6_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b001); }
+    static inline void SET_IX_7_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b001); }
+    static inline void SET_IX_0_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b010); }
+    static inline void SET_IX_1_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b010); }
+    static inline void SET_IX_2_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b010); }
+    static inline void SET_IX_3_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b010); }
+    static inline void SET_IX_4_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b010); }
+    static inline void SET_IX_5_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b010); }
+    static inline void SET_IX_6_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b010); }
+    static inline void SET_IX_7_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b010); }
+    static inline void SET_IX_0_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b011); }
+    static inline void SET_IX_1_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b011); }
+    static inline void SET_IX_2_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b011); }
+    static inline void SET_IX_3_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b011); }
+    static inline void SET_IX_4_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b011); }
+    static inline void SET_IX_5_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b011); }
+    static inline void SET_IX_6_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b011); }
+    static inline void SET_IX_7_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b011); }
+    static inline void SET_IX_0_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b100); }
+    static inline void SET_IX_1_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b100); }
+    static inline void SET_IX_2_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b100); }
+    static inline void SET_IX_3_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b100); }
+    static inline void SET_IX_4_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b100); }
+    static inline void SET_IX_5_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b100); }
+    static inline void SET_IX_6_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b100); }
+    static inline void SET_IX_7_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b100); }
+    static inline void SET_IX_0_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b101); }
+    static inline void SET_IX_1_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b101); }
+    static inline void SET_IX_2_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b101); }
+    static inline void SET_IX_3_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b101); }
+    static inline void SET_IX_4_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b101); }
+    static inline void SET_IX_5_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b101); }
+    static inline void SET_IX_6_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b101); }
+    static inline void SET_IX_7_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b101); }
+    static inline void SET_IX_0_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 0, 0b111); }
+    static inline void SET_IX_1_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 1, 0b111); }
+    static inline void SET_IX_2_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 2, 0b111); }
+    static inline void SET_IX_3_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 3, 0b111); }
+    static inline void SET_IX_4_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 4, 0b111); }
+    static inline void SET_IX_5_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 5, 0b111); }
+    static inline void SET_IX_6_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 6, 0b111); }
+    static inline void SET_IX_7_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IX_with_LD(d, 7, 0b111); }
+    inline void SET_IX_with_LD(signed char d, unsigned char bit, unsigned char r)
     {
-        if (zero) {
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-            if (isDebug()) log("[%04X] OUT (%s), 0", reg.PC - 2, registerDump(0b001));
-#endif
-            outPortWithB(reg.pair.C, 0);
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
         } else {
-#ifndef Z80_DISABLE_DEBUG
-            if (isDebug()) log("[%04X] OUT (%s), %s", reg.PC - 2, registerDump(0b001), registerDump(r));
-#endif
-            outPortWithB(reg.pair.C, getRegister(r));
+            buf[0] = '\0';
         }
+        SET_IX(d, bit, rp, buf);
+#else
+        SET_IX(d, bit, rp);
+#endif
     }
 
-    // Load Output port (C) with location (HL), increment/decrement HL and decrement B
-    inline void repeatOUT(bool isIncHL, bool isRepeat)
+    // SET bit b of location (IY+d)
+    static inline void SET_IY_0(Z80* ctx, signed char d) { ctx->SET_IY(d, 0); }
+    static inline void SET_IY_1(Z80* ctx, signed char d) { ctx->SET_IY(d, 1); }
+    static inline void SET_IY_2(Z80* ctx, signed char d) { ctx->SET_IY(d, 2); }
+    static inline void SET_IY_3(Z80* ctx, signed char d) { ctx->SET_IY(d, 3); }
+    static inline void SET_IY_4(Z80* ctx, signed char d) { ctx->SET_IY(d, 4); }
+    static inline void SET_IY_5(Z80* ctx, signed char d) { ctx->SET_IY(d, 5); }
+    static inline void SET_IY_6(Z80* ctx, signed char d) { ctx->SET_IY(d, 6); }
+    static inline void SET_IY_7(Z80* ctx, signed char d) { ctx->SET_IY(d, 7); }
+    inline void SET_IY(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
     {
-        unsigned char o = readByte(getHL());
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) {
-            if (isIncHL) {
-                log("[%04X] %s ... p(%s) <- (%s) <$%02x> [%s]", reg.PC - 2, isRepeat ? "OUTIR" : "OUTI", registerDump(0b001), registerPairDump(0b10), o, registerDump(0b000));
-            } else {
-                log("[%04X] %s ... p(%s) <- (%s) <$%02x> [%s]", reg.PC - 2, isRepeat ? "OUTDR" : "OUTD", registerDump(0b001), registerPairDump(0b10), o, registerDump(0b000));
-            }
-        }
+        if (isDebug()) log("[%04X] SET (IY+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
 #endif
-        decrementB_forRepeatIO();
-        outPortWithB(reg.pair.C, o);
-        reg.WZ = (unsigned short)(getBC() + (isIncHL ? 1 : -1));
-        setHL((unsigned short)(getHL() + (isIncHL ? 1 : -1)));
-        setFlagZ(reg.pair.B == 0);
-        setFlagN(o & 0x80);                                // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
-        setFlagH(reg.pair.L + o > 0xFF);                   // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
-        setFlagC(isFlagH());                               // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
-        setFlagPV(((reg.pair.H + o) & 0x07) ^ reg.pair.B); // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
-        if (isRepeat && 0 != reg.pair.B) {
-            reg.PC -= 2;
-            consumeClock(5);
-        }
+        n |= bits[bit];
+        if (rp) *rp = n;
+        writeByte(addr, n, 3);
     }
-    static inline void OUTI(Z80* ctx) { ctx->repeatOUT(true, false); }
-    static inline void OUTIR(Z80* ctx) { ctx->repeatOUT(true, true); }
-    static inline void OUTD(Z80* ctx) { ctx->repeatOUT(false, false); }
-    static inline void OUTDR(Z80* ctx) { ctx->repeatOUT(false, true); }
 
-    // Decimal Adjust Accumulator
-    static inline void DAA(Z80* ctx) { ctx->daa(); }
-    inline void daa()
+    // SET bit b of location (IY+d) with load Reg.
+    static inline void SET_IY_0_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b000); }
+    static inline void SET_IY_1_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b000); }
+    static inline void SET_IY_2_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b000); }
+    static inline void SET_IY_3_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b000); }
+    static inline void SET_IY_4_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b000); }
+    static inline void SET_IY_5_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b000); }
+    static inline void SET_IY_6_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b000); }
+    static inline void SET_IY_7_with_LD_B(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b000); }
+    static inline void SET_IY_0_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b001); }
+    static inline void SET_IY_1_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b001); }
+    static inline void SET_IY_2_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b001); }
+    static inline void SET_IY_3_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b001); }
+    static inline void SET_IY_4_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b001); }
+    static inline void SET_IY_5_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b001); }
+    static inline void SET_IY_6_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b001); }
+    static inline void SET_IY_7_with_LD_C(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b001); }
+    static inline void SET_IY_0_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b010); }
+    static inline void SET_IY_1_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b010); }
+    static inline void SET_IY_2_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b010); }
+    static inline void SET_IY_3_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b010); }
+    static inline void SET_IY_4_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b010); }
+    static inline void SET_IY_5_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b010); }
+    static inline void SET_IY_6_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b010); }
+    static inline void SET_IY_7_with_LD_D(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b010); }
+    static inline void SET_IY_0_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b011); }
+    static inline void SET_IY_1_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b011); }
+    static inline void SET_IY_2_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b011); }
+    static inline void SET_IY_3_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b011); }
+    static inline void SET_IY_4_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b011); }
+    static inline void SET_IY_5_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b011); }
+    static inline void SET_IY_6_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b011); }
+    static inline void SET_IY_7_with_LD_E(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b011); }
+    static inline void SET_IY_0_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b100); }
+    static inline void SET_IY_1_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b100); }
+    static inline void SET_IY_2_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b100); }
+    static inline void SET_IY_3_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b100); }
+    static inline void SET_IY_4_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b100); }
+    static inline void SET_IY_5_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b100); }
+    static inline void SET_IY_6_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b100); }
+    static inline void SET_IY_7_with_LD_H(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b100); }
+    static inline void SET_IY_0_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b101); }
+    static inline void SET_IY_1_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b101); }
+    static inline void SET_IY_2_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b101); }
+    static inline void SET_IY_3_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b101); }
+    static inline void SET_IY_4_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b101); }
+    static inline void SET_IY_5_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b101); }
+    static inline void SET_IY_6_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b101); }
+    static inline void SET_IY_7_with_LD_L(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b101); }
+    static inline void SET_IY_0_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 0, 0b111); }
+    static inline void SET_IY_1_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 1, 0b111); }
+    static inline void SET_IY_2_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 2, 0b111); }
+    static inline void SET_IY_3_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 3, 0b111); }
+    static inline void SET_IY_4_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 4, 0b111); }
+    static inline void SET_IY_5_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 5, 0b111); }
+    static inline void SET_IY_6_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 6, 0b111); }
+    static inline void SET_IY_7_with_LD_A(Z80* ctx, signed char d) { ctx->SET_IY_with_LD(d, 7, 0b111); }
+    inline void SET_IY_with_LD(signed char d, unsigned char bit, unsigned char r)
     {
-        int a = reg.pair.A;
-        bool c = isFlagC();
-        bool ac = reg.pair.A > 0x99;
-        int add = (isFlagH() || (a & 0x0F) > 9 ? 0x06 : 0x00) + (c || ac ? 0x60 : 0x00);
-        a += isFlagN() ? -add : add;
-        a &= 0xFF;
-        setFlagS(a & 0x80);
-        setFlagXY(a);
-        setFlagZ(0 == a);
-        setFlagH((a ^ reg.pair.A) & flagH());
-        setFlagPV(isEvenNumberBits(a));
-        setFlagC(c | ac);
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] DAA ... A: $%02X -> $%02X", reg.PC - 1, reg.pair.A, a);
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        SET_IY(d, bit, rp, buf);
+#else
+        SET_IY(d, bit, rp);
 #endif
-        reg.pair.A = a;
     }
 
-    // Rotate digit Left and right between Acc. and location (HL)
-    static inline void RLD_(Z80* ctx) { ctx->RLD(); }
-    inline void RLD()
+    // RESET bit b of register r
+    static inline void RES_B_0(Z80* ctx) { ctx->RES_R(0b000, 0); }
+    static inline void RES_B_1(Z80* ctx) { ctx->RES_R(0b000, 1); }
+    static inline void RES_B_2(Z80* ctx) { ctx->RES_R(0b000, 2); }
+    static inline void RES_B_3(Z80* ctx) { ctx->RES_R(0b000, 3); }
+    static inline void RES_B_4(Z80* ctx) { ctx->RES_R(0b000, 4); }
+    static inline void RES_B_5(Z80* ctx) { ctx->RES_R(0b000, 5); }
+    static inline void RES_B_6(Z80* ctx) { ctx->RES_R(0b000, 6); }
+    static inline void RES_B_7(Z80* ctx) { ctx->RES_R(0b000, 7); }
+    static inline void RES_C_0(Z80* ctx) { ctx->RES_R(0b001, 0); }
+    static inline void RES_C_1(Z80* ctx) { ctx->RES_R(0b001, 1); }
+    static inline void RES_C_2(Z80* ctx) { ctx->RES_R(0b001, 2); }
+    static inline void RES_C_3(Z80* ctx) { ctx->RES_R(0b001, 3); }
+    static inline void RES_C_4(Z80* ctx) { ctx->RES_R(0b001, 4); }
+    static inline void RES_C_5(Z80* ctx) { ctx->RES_R(0b001, 5); }
+    static inline void RES_C_6(Z80* ctx) { ctx->RES_R(0b001, 6); }
+    static inline void RES_C_7(Z80* ctx) { ctx->RES_R(0b001, 7); }
+    static inline void RES_D_0(Z80* ctx) { ctx->RES_R(0b010, 0); }
+    static inline void RES_D_1(Z80* ctx) { ctx->RES_R(0b010, 1); }
+    static inline void RES_D_2(Z80* ctx) { ctx->RES_R(0b010, 2); }
+    static inline void RES_D_3(Z80* ctx) { ctx->RES_R(0b010, 3); }
+    static inline void RES_D_4(Z80* ctx) { ctx->RES_R(0b010, 4); }
+    static inline void RES_D_5(Z80* ctx) { ctx->RES_R(0b010, 5); }
+    static inline void RES_D_6(Z80* ctx) { ctx->RES_R(0b010, 6); }
+    static inline void RES_D_7(Z80* ctx) { ctx->RES_R(0b010, 7); }
+    static inline void RES_E_0(Z80* ctx) { ctx->RES_R(0b011, 0); }
+    static inline void RES_E_1(Z80* ctx) { ctx->RES_R(0b011, 1); }
+    static inline void RES_E_2(Z80* ctx) { ctx->RES_R(0b011, 2); }
+    static inline void RES_E_3(Z80* ctx) { ctx->RES_R(0b011, 3); }
+    static inline void RES_E_4(Z80* ctx) { ctx->RES_R(0b011, 4); }
+    static inline void RES_E_5(Z80* ctx) { ctx->RES_R(0b011, 5); }
+    static inline void RES_E_6(Z80* ctx) { ctx->RES_R(0b011, 6); }
+    static inline void RES_E_7(Z80* ctx) { ctx->RES_R(0b011, 7); }
+    static inline void RES_H_0(Z80* ctx) { ctx->RES_R(0b100, 0); }
+    static inline void RES_H_1(Z80* ctx) { ctx->RES_R(0b100, 1); }
+    static inline void RES_H_2(Z80* ctx) { ctx->RES_R(0b100, 2); }
+    static inline void RES_H_3(Z80* ctx) { ctx->RES_R(0b100, 3); }
+    static inline void RES_H_4(Z80* ctx) { ctx->RES_R(0b100, 4); }
+    static inline void RES_H_5(Z80* ctx) { ctx->RES_R(0b100, 5); }
+    static inline void RES_H_6(Z80* ctx) { ctx->RES_R(0b100, 6); }
+    static inline void RES_H_7(Z80* ctx) { ctx->RES_R(0b100, 7); }
+    static inline void RES_L_0(Z80* ctx) { ctx->RES_R(0b101, 0); }
+    static inline void RES_L_1(Z80* ctx) { ctx->RES_R(0b101, 1); }
+    static inline void RES_L_2(Z80* ctx) { ctx->RES_R(0b101, 2); }
+    static inline void RES_L_3(Z80* ctx) { ctx->RES_R(0b101, 3); }
+    static inline void RES_L_4(Z80* ctx) { ctx->RES_R(0b101, 4); }
+    static inline void RES_L_5(Z80* ctx) { ctx->RES_R(0b101, 5); }
+    static inline void RES_L_6(Z80* ctx) { ctx->RES_R(0b101, 6); }
+    static inline void RES_L_7(Z80* ctx) { ctx->RES_R(0b101, 7); }
+    static inline void RES_A_0(Z80* ctx) { ctx->RES_R(0b111, 0); }
+    static inline void RES_A_1(Z80* ctx) { ctx->RES_R(0b111, 1); }
+    static inline void RES_A_2(Z80* ctx) { ctx->RES_R(0b111, 2); }
+    static inline void RES_A_3(Z80* ctx) { ctx->RES_R(0b111, 3); }
+    static inline void RES_A_4(Z80* ctx) { ctx->RES_R(0b111, 4); }
+    static inline void RES_A_5(Z80* ctx) { ctx->RES_R(0b111, 5); }
+    static inline void RES_A_6(Z80* ctx) { ctx->RES_R(0b111, 6); }
+    static inline void RES_A_7(Z80* ctx) { ctx->RES_R(0b111, 7); }
+    inline void RES_R(unsigned char r, unsigned char bit)
     {
-        unsigned short hl = getHL();
-        unsigned char beforeN = readByte(hl);
-        unsigned char nH = (beforeN & 0b11110000) >> 4;
-        unsigned char nL = beforeN & 0b00001111;
-        unsigned char aH = (reg.pair.A & 0b11110000) >> 4;
-        unsigned char aL = reg.pair.A & 0b00001111;
-#ifndef Z80_DISABLE_DEBUG
-        unsigned char beforeA = reg.pair.A;
-#endif
-        unsigned char afterA = (aH << 4) | nH;
-        unsigned char afterN = (nL << 4) | aL;
+        unsigned char* rp = getRegisterPointer(r);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RLD ... A: $%02X -> $%02X, ($%04X): $%02X -> $%02X", reg.PC - 2, beforeA, afterA, hl, beforeN, afterN);
+        if (isDebug()) log("[%04X] RES %s of bit-%d", reg.PC - 2, registerDump(r), bit);
 #endif
-        reg.pair.A = afterA;
-        writeByte(hl, afterN);
-        setFlagS(reg.pair.A & 0x80);
-        setFlagXY(reg.pair.A);
-        setFlagZ(reg.pair.A == 0);
-        resetFlagH();
-        setFlagPV(isEvenNumberBits(reg.pair.A));
-        resetFlagN();
-        consumeClock(2);
+        switch (bit) {
+            case 0: *rp &= 0b11111110; break;
+            case 1: *rp &= 0b11111101; break;
+            case 2: *rp &= 0b11111011; break;
+            case 3: *rp &= 0b11110111; break;
+            case 4: *rp &= 0b11101111; break;
+            case 5: *rp &= 0b11011111; break;
+            case 6: *rp &= 0b10111111; break;
+            case 7: *rp &= 0b01111111; break;
+        }
     }
 
-    // Rotate digit Right and right between Acc. and location (HL)
-    static inline void RRD_(Z80* ctx) { ctx->RRD(); }
-    inline void RRD()
+    // RESET bit b of location (HL)
+    static inline void RES_HL_0(Z80* ctx) { ctx->RES_HL(0); }
+    static inline void RES_HL_1(Z80* ctx) { ctx->RES_HL(1); }
+    static inline void RES_HL_2(Z80* ctx) { ctx->RES_HL(2); }
+    static inline void RES_HL_3(Z80* ctx) { ctx->RES_HL(3); }
+    static inline void RES_HL_4(Z80* ctx) { ctx->RES_HL(4); }
+    static inline void RES_HL_5(Z80* ctx) { ctx->RES_HL(5); }
+    static inline void RES_HL_6(Z80* ctx) { ctx->RES_HL(6); }
+    static inline void RES_HL_7(Z80* ctx) { ctx->RES_HL(7); }
+    inline void RES_HL(unsigned char bit)
     {
-        unsigned short hl = getHL();
-        unsigned char beforeN = readByte(hl);
-        unsigned char nH = (beforeN & 0b11110000) >> 4;
-        unsigned char nL = beforeN & 0b00001111;
-        unsigned char aH = (reg.pair.A & 0b11110000) >> 4;
-        unsigned char aL = reg.pair.A & 0b00001111;
-#ifndef Z80_DISABLE_DEBUG
-        unsigned char beforeA = reg.pair.A;
-#endif
-        unsigned char afterA = (aH << 4) | nL;
-        unsigned char afterN = (aL << 4) | nH;
+        unsigned short addr = getHL();
+        unsigned char n = readByte(addr);
 #ifndef Z80_DISABLE_DEBUG
-        if (isDebug()) log("[%04X] RRD ... A: $%02X -> $%02X, ($%04X): $%02X -> $%02X", reg.PC - 2, beforeA, afterA, hl, beforeN, afterN);
+        if (isDebug()) log("[%04X] RES (%s) = $%02X of bit-%d", reg.PC - 2, registerPairDump(0b10), n, bit);
 #endif
-        reg.pair.A = afterA;
-        writeByte(hl, afterN);
-        setFlagS(reg.pair.A & 0x80);
-        setFlagXY(reg.pair.A);
-        setFlagZ(reg.pair.A == 0);
-        resetFlagH();
-        setFlagPV(isEvenNumberBits(reg.pair.A));
-        resetFlagN();
-        consumeClock(2);
+        switch (bit) {
+            case 0: n &= 0b11111110; break;
+            case 1: n &= 0b11111101; break;
+            case 2: n &= 0b11111011; break;
+            case 3: n &= 0b11110111; break;
+            case 4: n &= 0b11101111; break;
+            case 5: n &= 0b11011111; break;
+            case 6: n &= 0b10111111; break;
+            case 7: n &= 0b01111111; break;
+        }
+        writeByte(addr, n, 3);
     }
 
-#ifndef Z80_DISABLE_BREAKPOINT
-    int opLength1[256] = {
+    // RESET bit b of location (IX+d)
+    static inline void RES_IX_0(Z80* ctx, signed char d) { ctx->RES_IX(d, 0); }
+    static inline void RES_IX_1(Z80* ctx, signed char d) { ctx->RES_IX(d, 1); }
+    static inline void RES_IX_2(Z80* ctx, signed char d) { ctx->RES_IX(d, 2); }
+    static inline void RES_IX_3(Z80* ctx, signed char d) { ctx->RES_IX(d, 3); }
+    static inline void RES_IX_4(Z80* ctx, signed char d) { ctx->RES_IX(d, 4); }
+    static inline void RES_IX_5(Z80* ctx, signed char d) { ctx->RES_IX(d, 5); }
+    static inline void RES_IX_6(Z80* ctx, signed char d) { ctx->RES_IX(d, 6); }
+    static inline void RES_IX_7(Z80* ctx, signed char d) { ctx->RES_IX(d, 7); }
+    inline void RES_IX(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    {
+        unsigned short addr = (unsigned short)(reg.IX + d);
+        unsigned char n = readByte(addr);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RES (IX+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
+#endif
+        switch (bit) {
+            case 0: n &= 0b11111110; break;
+            case 1: n &= 0b11111101; break;
+            case 2: n &= 0b11111011; break;
+            case 3: n &= 0b11110111; break;
+            case 4: n &= 0b11101111; break;
+            case 5: n &= 0b11011111; break;
+            case 6: n &= 0b10111111; break;
+            case 7: n &= 0b01111111; break;
+        }
+        if (rp) *rp = n;
+        writeByte(addr, n, 3);
+    }
+
+    // RESET bit b of location (IX+d) with load Reg.
+    static inline void RES_IX_0_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b000); }
+    static inline void RES_IX_1_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b000); }
+    static inline void RES_IX_2_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b000); }
+    static inline void RES_IX_3_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b000); }
+    static inline void RES_IX_4_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b000); }
+    static inline void RES_IX_5_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b000); }
+    static inline void RES_IX_6_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b000); }
+    static inline void RES_IX_7_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b000); }
+    static inline void RES_IX_0_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b001); }
+    static inline void RES_IX_1_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b001); }
+    static inline void RES_IX_2_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b001); }
+    static inline void RES_IX_3_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b001); }
+    static inline void RES_IX_4_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b001); }
+    static inline void RES_IX_5_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b001); }
+    static inline void RES_IX_6_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b001); }
+    static inline void RES_IX_7_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b001); }
+    static inline void RES_IX_0_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b010); }
+    static inline void RES_IX_1_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b010); }
+    static inline void RES_IX_2_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b010); }
+    static inline void RES_IX_3_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b010); }
+    static inline void RES_IX_4_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b010); }
+    static inline void RES_IX_5_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b010); }
+    static inline void RES_IX_6_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b010); }
+    static inline void RES_IX_7_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b010); }
+    static inline void RES_IX_0_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b011); }
+    static inline void RES_IX_1_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b011); }
+    static inline void RES_IX_2_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b011); }
+    static inline void RES_IX_3_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b011); }
+    static inline void RES_IX_4_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b011); }
+    static inline void RES_IX_5_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b011); }
+    static inline void RES_IX_6_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b011); }
+    static inline void RES_IX_7_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b011); }
+    static inline void RES_IX_0_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b100); }
+    static inline void RES_IX_1_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b100); }
+    static inline void RES_IX_2_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b100); }
+    static inline void RES_IX_3_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b100); }
+    static inline void RES_IX_4_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b100); }
+    static inline void RES_IX_5_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b100); }
+    static inline void RES_IX_6_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b100); }
+    static inline void RES_IX_7_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b100); }
+    static inline void RES_IX_0_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b101); }
+    static inline void RES_IX_1_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b101); }
+    static inline void RES_IX_2_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b101); }
+    static inline void RES_IX_3_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b101); }
+    static inline void RES_IX_4_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b101); }
+    static inline void RES_IX_5_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b101); }
+    static inline void RES_IX_6_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b101); }
+    static inline void RES_IX_7_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b101); }
+    static inline void RES_IX_0_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 0, 0b111); }
+    static inline void RES_IX_1_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 1, 0b111); }
+    static inline void RES_IX_2_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 2, 0b111); }
+    static inline void RES_IX_3_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 3, 0b111); }
+    static inline void RES_IX_4_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 4, 0b111); }
+    static inline void RES_IX_5_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 5, 0b111); }
+    static inline void RES_IX_6_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 6, 0b111); }
+    static inline void RES_IX_7_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IX_with_LD(d, 7, 0b111); }
+    inline void RES_IX_with_LD(signed char d, unsigned char bit, unsigned char r)
+    {
+        unsigned char* rp = getRegisterPointer(r);
+#ifndef Z80_DISABLE_DEBUG
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RES_IX(d, bit, rp, buf);
+#else
+        RES_IX(d, bit, rp);
+#endif
+    }
+
+    // RESET bit b of location (IY+d) with load Reg.
+    static inline void RES_IY_0_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b000); }
+    static inline void RES_IY_1_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b000); }
+    static inline void RES_IY_2_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b000); }
+    static inline void RES_IY_3_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b000); }
+    static inline void RES_IY_4_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b000); }
+    static inline void RES_IY_5_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b000); }
+    static inline void RES_IY_6_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b000); }
+    static inline void RES_IY_7_with_LD_B(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b000); }
+    static inline void RES_IY_0_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b001); }
+    static inline void RES_IY_1_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b001); }
+    static inline void RES_IY_2_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b001); }
+    static inline void RES_IY_3_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b001); }
+    static inline void RES_IY_4_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b001); }
+    static inline void RES_IY_5_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b001); }
+    static inline void RES_IY_6_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b001); }
+    static inline void RES_IY_7_with_LD_C(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b001); }
+    static inline void RES_IY_0_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b010); }
+    static inline void RES_IY_1_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b010); }
+    static inline void RES_IY_2_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b010); }
+    static inline void RES_IY_3_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b010); }
+    static inline void RES_IY_4_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b010); }
+    static inline void RES_IY_5_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b010); }
+    static inline void RES_IY_6_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b010); }
+    static inline void RES_IY_7_with_LD_D(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b010); }
+    static inline void RES_IY_0_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b011); }
+    static inline void RES_IY_1_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b011); }
+    static inline void RES_IY_2_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b011); }
+    static inline void RES_IY_3_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b011); }
+    static inline void RES_IY_4_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b011); }
+    static inline void RES_IY_5_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b011); }
+    static inline void RES_IY_6_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b011); }
+    static inline void RES_IY_7_with_LD_E(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b011); }
+    static inline void RES_IY_0_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b100); }
+    static inline void RES_IY_1_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b100); }
+    static inline void RES_IY_2_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b100); }
+    static inline void RES_IY_3_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b100); }
+    static inline void RES_IY_4_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b100); }
+    static inline void RES_IY_5_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b100); }
+    static inline void RES_IY_6_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b100); }
+    static inline void RES_IY_7_with_LD_H(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b100); }
+    static inline void RES_IY_0_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b101); }
+    static inline void RES_IY_1_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b101); }
+    static inline void RES_IY_2_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b101); }
+    static inline void RES_IY_3_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b101); }
+    static inline void RES_IY_4_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b101); }
+    static inline void RES_IY_5_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b101); }
+    static inline void RES_IY_6_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b101); }
+    static inline void RES_IY_7_with_LD_L(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b101); }
+    static inline void RES_IY_0_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 0, 0b111); }
+    static inline void RES_IY_1_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 1, 0b111); }
+    static inline void RES_IY_2_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 2, 0b111); }
+    static inline void RES_IY_3_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 3, 0b111); }
+    static inline void RES_IY_4_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 4, 0b111); }
+    static inline void RES_IY_5_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 5, 0b111); }
+    static inline void RES_IY_6_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 6, 0b111); }
+    static inline void RES_IY_7_with_LD_A(Z80* ctx, signed char d) { ctx->RES_IY_with_LD(d, 7, 0b111); }
+    inline void RES_IY_with_LD(signed char d, unsigned char bit, unsigned char r)
+    {
+        unsigned char* rp = getRegisterPointer(r);
+#ifndef Z80_DISABLE_DEBUG
+        char buf[80];
+        if (isDebug()) {
+            snprintf(buf, sizeof(buf), " --> %s", registerDump(r));
+        } else {
+            buf[0] = '\0';
+        }
+        RES_IY(d, bit, rp, buf);
+#else
+        RES_IY(d, bit, rp);
+#endif
+    }
+
+    // RESET bit b of location (IY+d)
+    static inline void RES_IY_0(Z80* ctx, signed char d) { ctx->RES_IY(d, 0); }
+    static inline void RES_IY_1(Z80* ctx, signed char d) { ctx->RES_IY(d, 1); }
+    static inline void RES_IY_2(Z80* ctx, signed char d) { ctx->RES_IY(d, 2); }
+    static inline void RES_IY_3(Z80* ctx, signed char d) { ctx->RES_IY(d, 3); }
+    static inline void RES_IY_4(Z80* ctx, signed char d) { ctx->RES_IY(d, 4); }
+    static inline void RES_IY_5(Z80* ctx, signed char d) { ctx->RES_IY(d, 5); }
+    static inline void RES_IY_6(Z80* ctx, signed char d) { ctx->RES_IY(d, 6); }
+    static inline void RES_IY_7(Z80* ctx, signed char d) { ctx->RES_IY(d, 7); }
+    inline void RES_IY(signed char d, unsigned char bit, unsigned char* rp = nullptr, const char* extraLog = nullptr)
+    {
+        unsigned short addr = (unsigned short)(reg.IY + d);
+        unsigned char n = readByte(addr);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RES (IY+d<$%04X>) = $%02X of bit-%d%s", reg.PC - 4, addr, n, bit, extraLog ? extraLog : "");
+#endif
+        switch (bit) {
+            case 0: n &= 0b11111110; break;
+            case 1: n &= 0b11111101; break;
+            case 2: n &= 0b11111011; break;
+            case 3: n &= 0b11110111; break;
+            case 4: n &= 0b11101111; break;
+            case 5: n &= 0b11011111; break;
+            case 6: n &= 0b10111111; break;
+            case 7: n &= 0b01111111; break;
+        }
+        if (rp) *rp = n;
+        writeByte(addr, n, 3);
+    }
+
+    // Compare location (HL) and A, increment/decrement HL and decrement BC
+    inline void repeatCP(bool isIncHL, bool isRepeat)
+    {
+        unsigned short hl = getHL();
+        unsigned short bc = getBC();
+        unsigned char n = readByte(hl);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) {
+            if (isIncHL) {
+                log("[%04X] %s ... %s, %s = $%02X, %s", reg.PC - 2, isRepeat ? "CPIR" : "CPI", registerDump(0b111), registerPairDump(0b10), n, registerPairDump(0b00));
+            } else {
+                log("[%04X] %s ... %s, %s = $%02X, %s", reg.PC - 2, isRepeat ? "CPDR" : "CPD", registerDump(0b111), registerPairDump(0b10), n, registerPairDump(0b00));
+            }
+        }
+#endif
+        subtract8(n, 0, false, false);
+        int nn = reg.pair.A;
+        nn -= n;
+        nn -= isFlagH() ? 1 : 0;
+        setFlagY(nn & 0b00000010);
+        setFlagX(nn & 0b00001000);
+        setHL((unsigned short)(hl + (isIncHL ? 1 : -1)));
+        bc--;
+        setBC(bc);
+        setFlagPV(0 != bc);
+        consumeClock(4);
+        if (isRepeat && !isFlagZ() && 0 != getBC()) {
+            reg.PC -= 2;
+            consumeClock(5);
+        }
+        reg.WZ += isIncHL ? 1 : -1;
+    }
+    static inline void CPI(Z80* ctx) { ctx->repeatCP(true, false); }
+    static inline void CPIR(Z80* ctx) { ctx->repeatCP(true, true); }
+    static inline void CPD(Z80* ctx) { ctx->repeatCP(false, false); }
+    static inline void CPDR(Z80* ctx) { ctx->repeatCP(false, true); }
+
+    // Compare Register
+    static inline void CP_B(Z80* ctx) { ctx->CP_R(0b000); }
+    static inline void CP_C(Z80* ctx) { ctx->CP_R(0b001); }
+    static inline void CP_D(Z80* ctx) { ctx->CP_R(0b010); }
+    static inline void CP_E(Z80* ctx) { ctx->CP_R(0b011); }
+    static inline void CP_H(Z80* ctx) { ctx->CP_R(0b100); }
+    static inline void CP_L(Z80* ctx) { ctx->CP_R(0b101); }
+    static inline void CP_A(Z80* ctx) { ctx->CP_R(0b111); }
+    static inline void CP_B_2(Z80* ctx) { ctx->CP_R(0b000, 2); }
+    static inline void CP_C_2(Z80* ctx) { ctx->CP_R(0b001, 2); }
+    static inline void CP_D_2(Z80* ctx) { ctx->CP_R(0b010, 2); }
+    static inline void CP_E_2(Z80* ctx) { ctx->CP_R(0b011, 2); }
+    static inline void CP_A_2(Z80* ctx) { ctx->CP_R(0b111, 2); }
+    inline void CP_R(unsigned char r, int pc = 1)
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CP %s, %s", reg.PC - pc, registerDump(0b111), registerDump(r));
+#endif
+        unsigned char* rp = getRegisterPointer(r);
+        subtract8(*rp, 0, true, false);
+    }
+
+    // Compare Register IXH
+    static inline void CP_IXH_(Z80* ctx) { ctx->CP_IXH(); }
+    inline void CP_IXH()
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CP %s, IXH<$%02X>", reg.PC - 2, registerDump(0b111), getIXH());
+#endif
+        subtract8(getIXH(), 0, true, false);
+    }
+
+    // Compare Register IXL
+    static inline void CP_IXL_(Z80* ctx) { ctx->CP_IXL(); }
+    inline void CP_IXL()
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CP %s, IXL<$%02X>", reg.PC - 2, registerDump(0b111), getIXL());
+#endif
+        subtract8(getIXL(), 0, true, false);
+    }
+
+    // Compare Register IYH
+    static inline void CP_IYH_(Z80* ctx) { ctx->CP_IYH(); }
+    inline void CP_IYH()
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CP %s, IYH<$%02X>", reg.PC - 2, registerDump(0b111), getIYH());
+#endif
+        subtract8(getIYH(), 0, true, false);
+    }
+
+    // Compare Register IYL
+    static inline void CP_IYL_(Z80* ctx) { ctx->CP_IYL(); }
+    inline void CP_IYL()
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CP %s, IYL<$%02X>", reg.PC - 2, registerDump(0b111), getIYL());
+#endif
+        subtract8(getIYL(), 0, true, false);
+    }
+
+    // Compare immediate
+    static inline void CP_N(Z80* ctx)
+    {
+        unsigned char n = ctx->fetch(3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] CP %s, $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n);
+#endif
+        ctx->subtract8(n, 0, true, false);
+    }
+
+    // Compare memory
+    static inline void CP_HL(Z80* ctx)
+    {
+        unsigned char n = ctx->readByte(ctx->getHL(), 3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] CP %s, (%s) = $%02X", ctx->reg.PC - 1, ctx->registerDump(0b111), ctx->registerPairDump(0b10), n);
+#endif
+        ctx->subtract8(n, 0, true, false);
+    }
+
+    // Compare memory
+    static inline void CP_IX_(Z80* ctx) { ctx->CP_IX(); }
+    inline void CP_IX()
+    {
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((unsigned short)(reg.IX + d));
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CP %s, (IX+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IX + d), n);
+#endif
+        subtract8(n, 0, true, false);
+        consumeClock(3);
+    }
+
+    // Compare memory
+    static inline void CP_IY_(Z80* ctx) { ctx->CP_IY(); }
+    inline void CP_IY()
+    {
+        signed char d = (signed char)fetch(4);
+        unsigned char n = readByte((unsigned short)(reg.IY + d));
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CP %s, (IY+d<$%04X>) = $%02X", reg.PC - 3, registerDump(0b111), (unsigned short)(reg.IY + d), n);
+#endif
+        subtract8(n, 0, true, false);
+        consumeClock(3);
+    }
+
+    // Jump
+    static inline void JP_NN(Z80* ctx)
+    {
+        unsigned char l = ctx->fetch(3);
+        unsigned char h = ctx->fetch(3);
+        unsigned short addr = ctx->make16BitsFromLE(l, h);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] JP $%04X", ctx->reg.PC - 3, addr);
+#endif
+        ctx->reg.PC = addr;
+        ctx->reg.WZ = addr;
+    }
+
+    // Conditional Jump
+    static inline void JP_C0_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NZ); }
+    static inline void JP_C1_NN(Z80* ctx) { ctx->JP_C_NN(Condition::Z); }
+    static inline void JP_C2_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NC); }
+    static inline void JP_C3_NN(Z80* ctx) { ctx->JP_C_NN(Condition::C); }
+    static inline void JP_C4_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NPV); }
+    static inline void JP_C5_NN(Z80* ctx) { ctx->JP_C_NN(Condition::PV); }
+    static inline void JP_C6_NN(Z80* ctx) { ctx->JP_C_NN(Condition::NS); }
+    static inline void JP_C7_NN(Z80* ctx) { ctx->JP_C_NN(Condition::S); }
+    inline void JP_C_NN(Condition c)
+    {
+        unsigned char l = fetch(3);
+        unsigned char h = fetch(3);
+        unsigned short addr = make16BitsFromLE(l, h);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] JP %s, $%04X", reg.PC - 3, conditionDump(c), addr);
+#endif
+        if (checkConditionFlag(c)) reg.PC = addr;
+        reg.WZ = addr;
+    }
+
+    // Jump Relative to PC+e
+    static inline void JR_E(Z80* ctx)
+    {
+        signed char e = (signed char)ctx->fetch(3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] JR %s", ctx->reg.PC - 2, ctx->relativeDump(ctx->reg.PC - 2, e));
+#endif
+        ctx->reg.PC += e;
+        ctx->consumeClock(5);
+    }
+
+    // Jump Relative to PC+e, if condition
+    static inline void JR_NZ_E(Z80* ctx) { ctx->JR_CND_E(Condition::NZ); }
+    static inline void JR_Z_E(Z80* ctx) { ctx->JR_CND_E(Condition::Z); }
+    static inline void JR_NC_E(Z80* ctx) { ctx->JR_CND_E(Condition::NC); }
+    static inline void JR_C_E(Z80* ctx) { ctx->JR_CND_E(Condition::C); }
+    inline void JR_CND_E(Condition cnd)
+    {
+        signed char e = (signed char)fetch(3);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] JR %s, %s <%s>", reg.PC - 2, conditionDump(cnd), relativeDump(reg.PC - 2, e), checkConditionFlag(cnd) ? "YES" : "NO");
+#endif
+        if (checkConditionFlag(cnd)) {
+            reg.PC += e;
+            consumeClock(5);
+        }
+    }
+
+    // Jump to HL
+    static inline void JP_HL(Z80* ctx)
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] JP %s", ctx->reg.PC - 1, ctx->registerPairDump(0b10));
+#endif
+        ctx->reg.PC = ctx->getHL();
+    }
+
+    // Jump to IX
+    static inline void JP_IX(Z80* ctx)
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] JP IX<$%04X>", ctx->reg.PC - 2, ctx->reg.IX);
+#endif
+        ctx->reg.PC = ctx->reg.IX;
+    }
+
+    // Jump to IY
+    static inline void JP_IY(Z80* ctx)
+    {
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] JP IY<$%04X>", ctx->reg.PC - 2, ctx->reg.IY);
+#endif
+        ctx->reg.PC = ctx->reg.IY;
+    }
+
+    // 	Decrement B and Jump relative if B=0
+    static inline void DJNZ_E(Z80* ctx)
+    {
+        signed char e = (signed char)ctx->fetch(4);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] DJNZ %s (%s)", ctx->reg.PC - 2, ctx->relativeDump(ctx->reg.PC - 2, e), ctx->registerDump(0b000));
+#endif
+        ctx->reg.pair.B--;
+        if (ctx->reg.pair.B) {
+            ctx->reg.PC += e;
+            ctx->consumeClock(5);
+        }
+    }
+
+    // Call
+    static inline void CALL_NN(Z80* ctx)
+    {
+        unsigned short addrL = ctx->fetch(4);
+        unsigned short addrH = ctx->fetch(3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] CALL $%04X (%s)", ctx->reg.PC - 3, ctx->make16BitsFromLE(addrL, addrH), ctx->registerPairDump(0b11));
+#endif
+        ctx->push(ctx->getPCH(), 3);
+        ctx->setPCH(addrH);
+        ctx->push(ctx->getPCL(), 3);
+        ctx->setPCL(addrL);
+        ctx->reg.WZ = ctx->reg.PC;
+#ifndef Z80_DISABLE_NESTCHECK
+        ctx->invokeCallHandlers();
+#endif
+    }
+
+    // Return
+    static inline void RET(Z80* ctx)
+    {
+#ifndef Z80_DISABLE_NESTCHECK
+        ctx->invokeReturnHandlers();
+#endif
+#ifndef Z80_DISABLE_DEBUG
+        unsigned short pc = ctx->reg.PC - 1;
+        const char* dump = ctx->isDebug() ? ctx->registerPairDump(0b11) : "";
+#endif
+        ctx->setPCL(ctx->pop(3));
+        ctx->setPCH(ctx->pop(3));
+        ctx->reg.WZ = ctx->reg.PC;
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] RET to $%04X (%s)", pc, ctx->reg.PC, dump);
+#endif
+    }
+
+    // Call with condition
+    static inline void CALL_C0_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NZ); }
+    static inline void CALL_C1_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::Z); }
+    static inline void CALL_C2_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NC); }
+    static inline void CALL_C3_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::C); }
+    static inline void CALL_C4_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NPV); }
+    static inline void CALL_C5_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::PV); }
+    static inline void CALL_C6_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::NS); }
+    static inline void CALL_C7_NN(Z80* ctx) { ctx->CALL_C_NN(Condition::S); }
+    inline void CALL_C_NN(Condition c)
+    {
+        bool execute = checkConditionFlag(c);
+        unsigned char nL = fetch(3);
+        unsigned char nH = fetch(3);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] CALL %s, $%04X (%s) <execute:%s>", reg.PC - 3, conditionDump(c), make16BitsFromLE(nL, nH), registerPairDump(0b11), execute ? "YES" : "NO");
+#endif
+        if (execute) {
+            push(getPCH(), 4);
+            setPCH(nH);
+            push(getPCL(), 3);
+            setPCL(nL);
+#ifndef Z80_DISABLE_NESTCHECK
+            invokeCallHandlers();
+#endif
+        }
+        reg.WZ = reg.PC;
+    }
+
+    //  with condition
+    static inline void RET_C0(Z80* ctx) { ctx->RET_C(Condition::NZ); }
+    static inline void RET_C1(Z80* ctx) { ctx->RET_C(Condition::Z); }
+    static inline void RET_C2(Z80* ctx) { ctx->RET_C(Condition::NC); }
+    static inline void RET_C3(Z80* ctx) { ctx->RET_C(Condition::C); }
+    static inline void RET_C4(Z80* ctx) { ctx->RET_C(Condition::NPV); }
+    static inline void RET_C5(Z80* ctx) { ctx->RET_C(Condition::PV); }
+    static inline void RET_C6(Z80* ctx) { ctx->RET_C(Condition::NS); }
+    static inline void RET_C7(Z80* ctx) { ctx->RET_C(Condition::S); }
+    inline void RET_C(Condition c)
+    {
+        if (!checkConditionFlag(c)) {
+#ifndef Z80_DISABLE_DEBUG
+            if (isDebug()) log("[%04X] RET %s <execute:NO>", reg.PC - 1, conditionDump(c));
+#endif
+            consumeClock(1);
+            return;
+        }
+#ifndef Z80_DISABLE_NESTCHECK
+        invokeReturnHandlers();
+#endif
+#ifndef Z80_DISABLE_DEBUG
+        unsigned short pc = reg.PC;
+        unsigned short sp = reg.SP;
+#endif
+        setPCL(pop(4));
+        setPCH(pop(3));
+        reg.WZ = reg.PC;
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RET %s to $%04X (SP<$%04X>) <execute:YES>", pc - 1, conditionDump(c), reg.PC, sp);
+#endif
+    }
+
+    // Return from interrupt
+    static inline void RETI_(Z80* ctx) { ctx->RETI(); }
+    inline void RETI()
+    {
+#ifndef Z80_DISABLE_NESTCHECK
+        invokeReturnHandlers();
+#endif
+#ifndef Z80_DISABLE_DEBUG
+        unsigned short pc = reg.PC;
+        unsigned short sp = reg.SP;
+#endif
+        setPCL(pop(3));
+        setPCH(pop(3));
+        reg.WZ = reg.PC;
+        reg.IFF &= ~IFF_IRQ();
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RETI to $%04X (SP<$%04X>)", pc - 2, reg.PC, sp);
+#endif
+    }
+
+    // Return from non maskable interrupt
+    static inline void RETN_(Z80* ctx) { ctx->RETN(); }
+    inline void RETN()
+    {
+#ifndef Z80_DISABLE_NESTCHECK
+        invokeReturnHandlers();
+#endif
+#ifndef Z80_DISABLE_DEBUG
+        unsigned short pc = reg.PC;
+        unsigned short sp = reg.SP;
+#endif
+        setPCL(pop(3));
+        setPCH(pop(3));
+        reg.WZ = reg.PC;
+        reg.IFF &= ~IFF_NMI();
+        if (!((reg.IFF & IFF1()) && (reg.IFF & IFF2()))) {
+            reg.IFF |= IFF1();
+        } else {
+            if (reg.IFF & IFF2()) {
+                reg.IFF |= IFF1();
+            } else {
+                reg.IFF &= ~IFF1();
+            }
+        }
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RETN to $%04X (SP<$%04X>)", pc - 2, reg.PC, sp);
+#endif
+    }
+
+    // Interrupt
+    static inline void RST00(Z80* ctx) { ctx->RST(0, true); }
+    static inline void RST08(Z80* ctx) { ctx->RST(1, true); }
+    static inline void RST10(Z80* ctx) { ctx->RST(2, true); }
+    static inline void RST18(Z80* ctx) { ctx->RST(3, true); }
+    static inline void RST20(Z80* ctx) { ctx->RST(4, true); }
+    static inline void RST28(Z80* ctx) { ctx->RST(5, true); }
+    static inline void RST30(Z80* ctx) { ctx->RST(6, true); }
+    static inline void RST38(Z80* ctx) { ctx->RST(7, true); }
+    inline void RST(unsigned char t, bool isOperand)
+    {
+        unsigned short addr = t * 8;
+#ifndef Z80_DISABLE_DEBUG
+        unsigned short sp = reg.SP;
+        unsigned short pc = reg.PC;
+#endif
+        push(getPCH(), 4);
+        setPCH(0);
+        push(getPCL(), 3);
+        reg.PC = addr;
+        reg.WZ = addr;
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RST $%04X (SP<$%04X>)", pc - (isOperand ? 1 : 0), addr, sp);
+#endif
+#ifndef Z80_DISABLE_NESTCHECK
+        invokeCallHandlers();
+#endif
+    }
+
+    // Input a byte form device n to accu.
+    static inline void IN_A_N(Z80* ctx)
+    {
+        unsigned char n = ctx->fetch(3);
+        unsigned char i = ctx->inPortWithA(n);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] IN %s, ($%02X) = $%02X", ctx->reg.PC - 2, ctx->registerDump(0b111), n, i);
+#endif
+        ctx->reg.pair.A = i;
+    }
+
+    // Input a byte form device (C) to register.
+    static inline void IN_B_C(Z80* ctx) { ctx->IN_R_C(0b000); }
+    static inline void IN_C_C(Z80* ctx) { ctx->IN_R_C(0b001); }
+    static inline void IN_D_C(Z80* ctx) { ctx->IN_R_C(0b010); }
+    static inline void IN_E_C(Z80* ctx) { ctx->IN_R_C(0b011); }
+    static inline void IN_H_C(Z80* ctx) { ctx->IN_R_C(0b100); }
+    static inline void IN_L_C(Z80* ctx) { ctx->IN_R_C(0b101); }
+    static inline void IN_C(Z80* ctx) { ctx->IN_R_C(0, false); }
+    static inline void IN_A_C(Z80* ctx) { ctx->IN_R_C(0b111); }
+    inline void IN_R_C(unsigned char r, bool setRegister = true)
+    {
+        unsigned char* rp = setRegister ? getRegisterPointer(r) : nullptr;
+        unsigned char i = inPortWithB(reg.pair.C);
+#ifndef Z80_DISABLE_DEBUG
+        if (rp) {
+            if (isDebug()) log("[%04X] IN %s, (%s) = $%02X", reg.PC - 2, registerDump(r), registerDump(0b001), i);
+            *rp = i;
+        } else {
+            if (isDebug()) log("[%04X] IN (%s) = $%02X", reg.PC - 2, registerDump(0b001), i);
+        }
+#else
+        if (rp) *rp = i;
+#endif
+        setFlagS(i & 0x80);
+        setFlagZ(i == 0);
+        resetFlagH();
+        setFlagPV(isEvenNumberBits(i));
+        resetFlagN();
+        setFlagXY(i);
+    }
+
+    inline void decrementB_forRepeatIO()
+    {
+        reg.pair.B--;
+        reg.pair.F = 0;
+        setFlagC(isFlagC());
+        setFlagN();
+        setFlagZ(reg.pair.B == 0);
+        setFlagXY(reg.pair.B);
+        setFlagS(reg.pair.B & 0x80);
+        setFlagH((reg.pair.B & 0x0F) == 0x0F);
+        setFlagPV(reg.pair.B == 0x7F);
+    }
+
+    // Load location (HL) with input from port (C); or increment/decrement HL and decrement B
+    inline void repeatIN(bool isIncHL, bool isRepeat)
+    {
+        reg.WZ = (unsigned short)(getBC() + (isIncHL ? 1 : -1));
+        unsigned char i = inPortWithB(reg.pair.C);
+        decrementB_forRepeatIO();
+        unsigned short hl = getHL();
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) {
+            if (isIncHL) {
+                log("[%04X] %s ... (%s) <- p(%s) = $%02X [%s]", reg.PC - 2, isRepeat ? "INIR" : "INI", registerPairDump(0b10), registerDump(0b001), i, registerDump(0b000));
+            } else {
+                log("[%04X] %s ... (%s) <- p(%s) = $%02X [%s]", reg.PC - 2, isRepeat ? "INDR" : "IND", registerPairDump(0b10), registerDump(0b001), i, registerDump(0b000));
+            }
+        }
+#endif
+        writeByte(hl, i);
+        hl += isIncHL ? 1 : -1;
+        setHL(hl);
+        setFlagZ(reg.pair.B == 0);
+        setFlagN(i & 0x80);                                               // NOTE: undocumented
+        setFlagC(0xFF < i + ((reg.pair.C + 1) & 0xFF));                   // NOTE: undocumented
+        setFlagH(isFlagC());                                              // NOTE: undocumented
+        setFlagPV((i + (((reg.pair.C + 1) & 0xFF) & 0x07)) ^ reg.pair.B); // NOTE: undocumented
+        if (isRepeat && 0 != reg.pair.B) {
+            reg.PC -= 2;
+            consumeClock(5);
+        }
+    }
+    static inline void INI(Z80* ctx) { ctx->repeatIN(true, false); }
+    static inline void INIR(Z80* ctx) { ctx->repeatIN(true, true); }
+    static inline void IND(Z80* ctx) { ctx->repeatIN(false, false); }
+    static inline void INDR(Z80* ctx) { ctx->repeatIN(false, true); }
+
+    // Load Output port (n) with Acc.
+    static inline void OUT_N_A(Z80* ctx)
+    {
+        unsigned char n = ctx->fetch(3);
+#ifndef Z80_DISABLE_DEBUG
+        if (ctx->isDebug()) ctx->log("[%04X] OUT ($%02X), %s", ctx->reg.PC - 2, n, ctx->registerDump(0b111));
+#endif
+        ctx->outPortWithA(n, ctx->reg.pair.A);
+    }
+
+    // Output a byte to device (C) form register.
+    static inline void OUT_C_B(Z80* ctx) { ctx->OUT_C_R(0b000); }
+    static inline void OUT_C_C(Z80* ctx) { ctx->OUT_C_R(0b001); }
+    static inline void OUT_C_D(Z80* ctx) { ctx->OUT_C_R(0b010); }
+    static inline void OUT_C_E(Z80* ctx) { ctx->OUT_C_R(0b011); }
+    static inline void OUT_C_H(Z80* ctx) { ctx->OUT_C_R(0b100); }
+    static inline void OUT_C_L(Z80* ctx) { ctx->OUT_C_R(0b101); }
+    static inline void OUT_C_0(Z80* ctx) { ctx->OUT_C_R(0, true); }
+    static inline void OUT_C_A(Z80* ctx) { ctx->OUT_C_R(0b111); }
+    inline void OUT_C_R(unsigned char r, bool zero = false)
+    {
+        if (zero) {
+#ifndef Z80_DISABLE_DEBUG
+            if (isDebug()) log("[%04X] OUT (%s), 0", reg.PC - 2, registerDump(0b001));
+#endif
+            outPortWithB(reg.pair.C, 0);
+        } else {
+#ifndef Z80_DISABLE_DEBUG
+            if (isDebug()) log("[%04X] OUT (%s), %s", reg.PC - 2, registerDump(0b001), registerDump(r));
+#endif
+            outPortWithB(reg.pair.C, getRegister(r));
+        }
+    }
+
+    // Load Output port (C) with location (HL), increment/decrement HL and decrement B
+    inline void repeatOUT(bool isIncHL, bool isRepeat)
+    {
+        unsigned char o = readByte(getHL());
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) {
+            if (isIncHL) {
+                log("[%04X] %s ... p(%s) <- (%s) <$%02x> [%s]", reg.PC - 2, isRepeat ? "OUTIR" : "OUTI", registerDump(0b001), registerPairDump(0b10), o, registerDump(0b000));
+            } else {
+                log("[%04X] %s ... p(%s) <- (%s) <$%02x> [%s]", reg.PC - 2, isRepeat ? "OUTDR" : "OUTD", registerDump(0b001), registerPairDump(0b10), o, registerDump(0b000));
+            }
+        }
+#endif
+        decrementB_forRepeatIO();
+        outPortWithB(reg.pair.C, o);
+        reg.WZ = (unsigned short)(getBC() + (isIncHL ? 1 : -1));
+        setHL((unsigned short)(getHL() + (isIncHL ? 1 : -1)));
+        setFlagZ(reg.pair.B == 0);
+        setFlagN(o & 0x80);                                // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
+        setFlagH(reg.pair.L + o > 0xFF);                   // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
+        setFlagC(isFlagH());                               // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
+        setFlagPV(((reg.pair.H + o) & 0x07) ^ reg.pair.B); // NOTE: ACTUAL FLAG CONDITION IS UNKNOWN
+        if (isRepeat && 0 != reg.pair.B) {
+            reg.PC -= 2;
+            consumeClock(5);
+        }
+    }
+    static inline void OUTI(Z80* ctx) { ctx->repeatOUT(true, false); }
+    static inline void OUTIR(Z80* ctx) { ctx->repeatOUT(true, true); }
+    static inline void OUTD(Z80* ctx) { ctx->repeatOUT(false, false); }
+    static inline void OUTDR(Z80* ctx) { ctx->repeatOUT(false, true); }
+
+    // Decimal Adjust Accumulator
+    static inline void DAA(Z80* ctx) { ctx->daa(); }
+    inline void daa()
+    {
+        int a = reg.pair.A;
+        bool c = isFlagC();
+        bool ac = reg.pair.A > 0x99;
+        int add = (isFlagH() || (a & 0x0F) > 9 ? 0x06 : 0x00) + (c || ac ? 0x60 : 0x00);
+        a += isFlagN() ? -add : add;
+        a &= 0xFF;
+        setFlagS(a & 0x80);
+        setFlagXY(a);
+        setFlagZ(0 == a);
+        setFlagH((a ^ reg.pair.A) & flagH());
+        setFlagPV(isEvenNumberBits(a));
+        setFlagC(c | ac);
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] DAA ... A: $%02X -> $%02X", reg.PC - 1, reg.pair.A, a);
+#endif
+        reg.pair.A = a;
+    }
+
+    // Rotate digit Left and right between Acc. and location (HL)
+    static inline void RLD_(Z80* ctx) { ctx->RLD(); }
+    inline void RLD()
+    {
+        unsigned short hl = getHL();
+        unsigned char beforeN = readByte(hl);
+        unsigned char nH = (beforeN & 0b11110000) >> 4;
+        unsigned char nL = beforeN & 0b00001111;
+        unsigned char aH = (reg.pair.A & 0b11110000) >> 4;
+        unsigned char aL = reg.pair.A & 0b00001111;
+#ifndef Z80_DISABLE_DEBUG
+        unsigned char beforeA = reg.pair.A;
+#endif
+        unsigned char afterA = (aH << 4) | nH;
+        unsigned char afterN = (nL << 4) | aL;
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RLD ... A: $%02X -> $%02X, ($%04X): $%02X -> $%02X", reg.PC - 2, beforeA, afterA, hl, beforeN, afterN);
+#endif
+        reg.pair.A = afterA;
+        writeByte(hl, afterN);
+        setFlagS(reg.pair.A & 0x80);
+        setFlagXY(reg.pair.A);
+        setFlagZ(reg.pair.A == 0);
+        resetFlagH();
+        setFlagPV(isEvenNumberBits(reg.pair.A));
+        resetFlagN();
+        consumeClock(2);
+    }
+
+    // Rotate digit Right and right between Acc. and location (HL)
+    static inline void RRD_(Z80* ctx) { ctx->RRD(); }
+    inline void RRD()
+    {
+        unsigned short hl = getHL();
+        unsigned char beforeN = readByte(hl);
+        unsigned char nH = (beforeN & 0b11110000) >> 4;
+        unsigned char nL = beforeN & 0b00001111;
+        unsigned char aH = (reg.pair.A & 0b11110000) >> 4;
+        unsigned char aL = reg.pair.A & 0b00001111;
+#ifndef Z80_DISABLE_DEBUG
+        unsigned char beforeA = reg.pair.A;
+#endif
+        unsigned char afterA = (aH << 4) | nL;
+        unsigned char afterN = (aL << 4) | nH;
+#ifndef Z80_DISABLE_DEBUG
+        if (isDebug()) log("[%04X] RRD ... A: $%02X -> $%02X, ($%04X): $%02X -> $%02X", reg.PC - 2, beforeA, afterA, hl, beforeN, afterN);
+#endif
+        reg.pair.A = afterA;
+        writeByte(hl, afterN);
+        setFlagS(reg.pair.A & 0x80);
+        setFlagXY(reg.pair.A);
+        setFlagZ(reg.pair.A == 0);
+        resetFlagH();
+        setFlagPV(isEvenNumberBits(reg.pair.A));
+        resetFlagN();
+        consumeClock(2);
+    }
+
+    int opLength1[256] = {
         1, 3, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 00 ~ 0F
         2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 10 ~ 1F
         2, 3, 3, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1, // 20 ~ 2F
@@ -5726,665 +7164,2340 @@ class Z80
         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // E0 ~ EF
         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // F0 ~ FF
     };
-    int opLengthIXY[256] = {
-        0, 0, 0, 0, 2, 2, 3, 0, 0, 2, 0, 0, 2, 2, 3, 0, // 00 ~ 0F
-        0, 0, 0, 0, 2, 2, 3, 0, 0, 2, 0, 0, 2, 2, 3, 0, // 10 ~ 1F
-        0, 4, 4, 2, 2, 2, 3, 0, 0, 2, 4, 2, 2, 2, 3, 0, // 20 ~ 2F
-        0, 0, 0, 0, 3, 3, 4, 0, 0, 2, 0, 0, 2, 2, 3, 0, // 30 ~ 3F
-        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 40 ~ 4F
-        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 50 ~ 5F
-        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 60 ~ 6F
-        3, 3, 3, 3, 3, 3, 0, 3, 2, 2, 2, 2, 2, 2, 3, 2, // 70 ~ 7F
-        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 80 ~ 8F
-        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 90 ~ 9F
-        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // A0 ~ AF
-        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // B0 ~ BF
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, // C0 ~ CF
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // D0 ~ DF
-        0, 2, 0, 2, 0, 2, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, // E0 ~ EF
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0  // F0 ~ FF
+    int opLengthIXY[256] = {
+        0, 0, 0, 0, 2, 2, 3, 0, 0, 2, 0, 0, 2, 2, 3, 0, // 00 ~ 0F
+        0, 0, 0, 0, 2, 2, 3, 0, 0, 2, 0, 0, 2, 2, 3, 0, // 10 ~ 1F
+        0, 4, 4, 2, 2, 2, 3, 0, 0, 2, 4, 2, 2, 2, 3, 0, // 20 ~ 2F
+        0, 0, 0, 0, 3, 3, 4, 0, 0, 2, 0, 0, 2, 2, 3, 0, // 30 ~ 3F
+        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 40 ~ 4F
+        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 50 ~ 5F
+        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 60 ~ 6F
+        3, 3, 3, 3, 3, 3, 0, 3, 2, 2, 2, 2, 2, 2, 3, 2, // 70 ~ 7F
+        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 80 ~ 8F
+        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // 90 ~ 9F
+        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // A0 ~ AF
+        2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2, 2, 3, 2, // B0 ~ BF
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, // C0 ~ CF
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // D0 ~ DF
+        0, 2, 0, 2, 0, 2, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, // E0 ~ EF
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0  // F0 ~ FF
+    };
+    void (*opSet1[256])(Z80* ctx) = {
+        NOP, LD_BC_NN, LD_BC_A, INC_RP_BC, INC_B, DEC_B, LD_B_N, RLCA, EX_AF_AF2, ADD_HL_BC, LD_A_BC, DEC_RP_BC, INC_C, DEC_C, LD_C_N, RRCA,
+        DJNZ_E, LD_DE_NN, LD_DE_A, INC_RP_DE, INC_D, DEC_D, LD_D_N, RLA, JR_E, ADD_HL_DE, LD_A_DE, DEC_RP_DE, INC_E, DEC_E, LD_E_N, RRA,
+        JR_NZ_E, LD_HL_NN, LD_ADDR_HL, INC_RP_HL, INC_H, DEC_H, LD_H_N, DAA, JR_Z_E, ADD_HL_HL, LD_HL_ADDR, DEC_RP_HL, INC_L, DEC_L, LD_L_N, CPL,
+        JR_NC_E, LD_SP_NN, LD_NN_A, INC_RP_SP, INC_HL, DEC_HL, LD_HL_N, SCF, JR_C_E, ADD_HL_SP, LD_A_NN, DEC_RP_SP, INC_A, DEC_A, LD_A_N, CCF,
+        LD_B_B, LD_B_C, LD_B_D, LD_B_E, LD_B_H, LD_B_L, LD_B_HL, LD_B_A, LD_C_B, LD_C_C, LD_C_D, LD_C_E, LD_C_H, LD_C_L, LD_C_HL, LD_C_A,
+        LD_D_B, LD_D_C, LD_D_D, LD_D_E, LD_D_H, LD_D_L, LD_D_HL, LD_D_A, LD_E_B, LD_E_C, LD_E_D, LD_E_E, LD_E_H, LD_E_L, LD_E_HL, LD_E_A,
+        LD_H_B, LD_H_C, LD_H_D, LD_H_E, LD_H_H, LD_H_L, LD_H_HL, LD_H_A, LD_L_B, LD_L_C, LD_L_D, LD_L_E, LD_L_H, LD_L_L, LD_L_HL, LD_L_A,
+        LD_HL_B, LD_HL_C, LD_HL_D, LD_HL_E, LD_HL_H, LD_HL_L, HALT, LD_HL_A, LD_A_B, LD_A_C, LD_A_D, LD_A_E, LD_A_H, LD_A_L, LD_A_HL, LD_A_A,
+        ADD_B, ADD_C, ADD_D, ADD_E, ADD_H, ADD_L, ADD_HL, ADD_A, ADC_B, ADC_C, ADC_D, ADC_E, ADC_H, ADC_L, ADC_HL, ADC_A,
+        SUB_B, SUB_C, SUB_D, SUB_E, SUB_H, SUB_L, SUB_HL, SUB_A, SBC_B, SBC_C, SBC_D, SBC_E, SBC_H, SBC_L, SBC_HL, SBC_A,
+        AND_B, AND_C, AND_D, AND_E, AND_H, AND_L, AND_HL, AND_A, XOR_B, XOR_C, XOR_D, XOR_E, XOR_H, XOR_L, XOR_HL, XOR_A,
+        OR_B, OR_C, OR_D, OR_E, OR_H, OR_L, OR_HL, OR_A, CP_B, CP_C, CP_D, CP_E, CP_H, CP_L, CP_HL, CP_A,
+        RET_C0, POP_BC, JP_C0_NN, JP_NN, CALL_C0_NN, PUSH_BC, ADD_N, RST00, RET_C1, RET, JP_C1_NN, OP_CB, CALL_C1_NN, CALL_NN, ADC_N, RST08,
+        RET_C2, POP_DE, JP_C2_NN, OUT_N_A, CALL_C2_NN, PUSH_DE, SUB_N, RST10, RET_C3, EXX, JP_C3_NN, IN_A_N, CALL_C3_NN, OP_IX, SBC_N, RST18,
+        RET_C4, POP_HL, JP_C4_NN, EX_SP_HL, CALL_C4_NN, PUSH_HL, AND_N, RST20, RET_C5, JP_HL, JP_C5_NN, EX_DE_HL, CALL_C5_NN, OP_ED, XOR_N, RST28,
+        RET_C6, POP_AF, JP_C6_NN, DI, CALL_C6_NN, PUSH_AF, OR_N, RST30, RET_C7, LD_SP_HL, JP_C7_NN, EI, CALL_C7_NN, OP_IY, CP_N, RST38};
+    void (*opSetCB[256])(Z80* ctx) = {
+        RLC_B, RLC_C, RLC_D, RLC_E, RLC_H, RLC_L, RLC_HL_, RLC_A,
+        RRC_B, RRC_C, RRC_D, RRC_E, RRC_H, RRC_L, RRC_HL_, RRC_A,
+        RL_B, RL_C, RL_D, RL_E, RL_H, RL_L, RL_HL_, RL_A,
+        RR_B, RR_C, RR_D, RR_E, RR_H, RR_L, RR_HL_, RR_A,
+        SLA_B, SLA_C, SLA_D, SLA_E, SLA_H, SLA_L, SLA_HL_, SLA_A,
+        SRA_B, SRA_C, SRA_D, SRA_E, SRA_H, SRA_L, SRA_HL_, SRA_A,
+        SLL_B, SLL_C, SLL_D, SLL_E, SLL_H, SLL_L, SLL_HL_, SLL_A,
+        SRL_B, SRL_C, SRL_D, SRL_E, SRL_H, SRL_L, SRL_HL_, SRL_A,
+        BIT_B_0, BIT_C_0, BIT_D_0, BIT_E_0, BIT_H_0, BIT_L_0, BIT_HL_0, BIT_A_0,
+        BIT_B_1, BIT_C_1, BIT_D_1, BIT_E_1, BIT_H_1, BIT_L_1, BIT_HL_1, BIT_A_1,
+        BIT_B_2, BIT_C_2, BIT_D_2, BIT_E_2, BIT_H_2, BIT_L_2, BIT_HL_2, BIT_A_2,
+        BIT_B_3, BIT_C_3, BIT_D_3, BIT_E_3, BIT_H_3, BIT_L_3, BIT_HL_3, BIT_A_3,
+        BIT_B_4, BIT_C_4, BIT_D_4, BIT_E_4, BIT_H_4, BIT_L_4, BIT_HL_4, BIT_A_4,
+        BIT_B_5, BIT_C_5, BIT_D_5, BIT_E_5, BIT_H_5, BIT_L_5, BIT_HL_5, BIT_A_5,
+        BIT_B_6, BIT_C_6, BIT_D_6, BIT_E_6, BIT_H_6, BIT_L_6, BIT_HL_6, BIT_A_6,
+        BIT_B_7, BIT_C_7, BIT_D_7, BIT_E_7, BIT_H_7, BIT_L_7, BIT_HL_7, BIT_A_7,
+        RES_B_0, RES_C_0, RES_D_0, RES_E_0, RES_H_0, RES_L_0, RES_HL_0, RES_A_0,
+        RES_B_1, RES_C_1, RES_D_1, RES_E_1, RES_H_1, RES_L_1, RES_HL_1, RES_A_1,
+        RES_B_2, RES_C_2, RES_D_2, RES_E_2, RES_H_2, RES_L_2, RES_HL_2, RES_A_2,
+        RES_B_3, RES_C_3, RES_D_3, RES_E_3, RES_H_3, RES_L_3, RES_HL_3, RES_A_3,
+        RES_B_4, RES_C_4, RES_D_4, RES_E_4, RES_H_4, RES_L_4, RES_HL_4, RES_A_4,
+        RES_B_5, RES_C_5, RES_D_5, RES_E_5, RES_H_5, RES_L_5, RES_HL_5, RES_A_5,
+        RES_B_6, RES_C_6, RES_D_6, RES_E_6, RES_H_6, RES_L_6, RES_HL_6, RES_A_6,
+        RES_B_7, RES_C_7, RES_D_7, RES_E_7, RES_H_7, RES_L_7, RES_HL_7, RES_A_7,
+        SET_B_0, SET_C_0, SET_D_0, SET_E_0, SET_H_0, SET_L_0, SET_HL_0, SET_A_0,
+        SET_B_1, SET_C_1, SET_D_1, SET_E_1, SET_H_1, SET_L_1, SET_HL_1, SET_A_1,
+        SET_B_2, SET_C_2, SET_D_2, SET_E_2, SET_H_2, SET_L_2, SET_HL_2, SET_A_2,
+        SET_B_3, SET_C_3, SET_D_3, SET_E_3, SET_H_3, SET_L_3, SET_HL_3, SET_A_3,
+        SET_B_4, SET_C_4, SET_D_4, SET_E_4, SET_H_4, SET_L_4, SET_HL_4, SET_A_4,
+        SET_B_5, SET_C_5, SET_D_5, SET_E_5, SET_H_5, SET_L_5, SET_HL_5, SET_A_5,
+        SET_B_6, SET_C_6, SET_D_6, SET_E_6, SET_H_6, SET_L_6, SET_HL_6, SET_A_6,
+        SET_B_7, SET_C_7, SET_D_7, SET_E_7, SET_H_7, SET_L_7, SET_HL_7, SET_A_7};
+    void (*opSetED[256])(Z80* ctx) = {
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        IN_B_C, OUT_C_B, SBC_HL_BC, LD_ADDR_RP_BC, NEG_, RETN_, IM0, LD_I_A_,
+        IN_C_C, OUT_C_C, ADC_HL_BC, LD_RP_ADDR_BC, nullptr, RETI_, nullptr, LD_R_A_,
+        IN_D_C, OUT_C_D, SBC_HL_DE, LD_ADDR_RP_DE, nullptr, nullptr, IM1, LD_A_I_,
+        IN_E_C, OUT_C_E, ADC_HL_DE, LD_RP_ADDR_DE, nullptr, nullptr, IM2, LD_A_R_,
+        IN_H_C, OUT_C_H, SBC_HL_HL, LD_ADDR_RP_HL, nullptr, nullptr, nullptr, RRD_,
+        IN_L_C, OUT_C_L, ADC_HL_HL, LD_RP_ADDR_HL, nullptr, nullptr, nullptr, RLD_,
+        IN_C, OUT_C_0, SBC_HL_SP, LD_ADDR_RP_SP, nullptr, nullptr, nullptr, nullptr,
+        IN_A_C, OUT_C_A, ADC_HL_SP, LD_RP_ADDR_SP, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        LDI, CPI, INI, OUTI, nullptr, nullptr, nullptr, nullptr,
+        LDD, CPD, IND, OUTD, nullptr, nullptr, nullptr, nullptr,
+        LDIR, CPIR, INIR, OUTIR, nullptr, nullptr, nullptr, nullptr,
+        LDDR, CPDR, INDR, OUTDR, nullptr, nullptr, nullptr, nullptr};
+    void (*opSetIX[256])(Z80* ctx) = {
+        nullptr, nullptr, nullptr, nullptr, INC_B_2, DEC_B_2, LD_B_N_3, nullptr,
+        nullptr, ADD_IX_BC, nullptr, nullptr, INC_C_2, DEC_C_2, LD_C_N_3, nullptr,
+        nullptr, nullptr, nullptr, nullptr, INC_D_2, DEC_D_2, LD_D_N_3, nullptr,
+        nullptr, ADD_IX_DE, nullptr, nullptr, INC_E_2, DEC_E_2, LD_E_N_3, nullptr,
+        nullptr, LD_IX_NN_, LD_ADDR_IX_, INC_IX_reg_, INC_IXH_, DEC_IXH_, LD_IXH_N_, nullptr,
+        nullptr, ADD_IX_IX, LD_IX_ADDR_, DEC_IX_reg_, INC_IXL_, DEC_IXL_, LD_IXL_N_, nullptr,
+        nullptr, nullptr, nullptr, nullptr, INC_IX_, DEC_IX_, LD_IX_N_, nullptr,
+        nullptr, ADD_IX_SP, nullptr, nullptr, INC_A_2, DEC_A_2, LD_A_N_3, nullptr,
+        LD_B_B_2, LD_B_C_2, LD_B_D_2, LD_B_E_2, LD_B_IXH, LD_B_IXL, LD_B_IX, LD_B_A_2,
+        LD_C_B_2, LD_C_C_2, LD_C_D_2, LD_C_E_2, LD_C_IXH, LD_C_IXL, LD_C_IX, LD_C_A_2,
+        LD_D_B_2, LD_D_C_2, LD_D_D_2, LD_D_E_2, LD_D_IXH, LD_D_IXL, LD_D_IX, LD_D_A_2,
+        LD_E_B_2, LD_E_C_2, LD_E_D_2, LD_E_E_2, LD_E_IXH, LD_E_IXL, LD_E_IX, LD_E_A_2,
+        LD_IXH_B, LD_IXH_C, LD_IXH_D, LD_IXH_E, LD_IXH_IXH_, LD_IXH_IXL_, LD_H_IX, LD_IXH_A,
+        LD_IXL_B, LD_IXL_C, LD_IXL_D, LD_IXL_E, LD_IXL_IXH_, LD_IXL_IXL_, LD_L_IX, LD_IXL_A,
+        LD_IX_B, LD_IX_C, LD_IX_D, LD_IX_E, LD_IX_H, LD_IX_L, nullptr, LD_IX_A,
+        LD_A_B_2, LD_A_C_2, LD_A_D_2, LD_A_E_2, LD_A_IXH, LD_A_IXL, LD_A_IX, LD_A_A_2,
+        ADD_B_2, ADD_C_2, ADD_D_2, ADD_E_2, ADD_IXH_, ADD_IXL_, ADD_IX_, ADD_A_2,
+        ADC_B_2, ADC_C_2, ADC_D_2, ADC_E_2, ADC_IXH_, ADC_IXL_, ADC_IX_, ADC_A_2,
+        SUB_B_2, SUB_C_2, SUB_D_2, SUB_E_2, SUB_IXH_, SUB_IXL_, SUB_IX_, SUB_A_2,
+        SBC_B_2, SBC_C_2, SBC_D_2, SBC_E_2, SBC_IXH_, SBC_IXL_, SBC_IX_, SBC_A_2,
+        AND_B_2, AND_C_2, AND_D_2, AND_E_2, AND_IXH_, AND_IXL_, AND_IX_, AND_A_2,
+        XOR_B_2, XOR_C_2, XOR_D_2, XOR_E_2, XOR_IXH_, XOR_IXL_, XOR_IX_, XOR_A_2,
+        OR_B_2, OR_C_2, OR_D_2, OR_E_2, OR_IXH_, OR_IXL_, OR_IX_, OR_A_2,
+        CP_B_2, CP_C_2, CP_D_2, CP_E_2, CP_IXH_, CP_IXL_, CP_IX_, CP_A_2,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, OP_IX4, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, POP_IX_, nullptr, EX_SP_IX_, nullptr, PUSH_IX_, nullptr, nullptr,
+        nullptr, JP_IX, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, LD_SP_IX_, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+    void (*opSetIY[256])(Z80* ctx) = {
+        nullptr, nullptr, nullptr, nullptr, INC_B_2, DEC_B_2, LD_B_N_3, nullptr,
+        nullptr, ADD_IY_BC, nullptr, nullptr, INC_C_2, DEC_C_2, LD_C_N_3, nullptr,
+        nullptr, nullptr, nullptr, nullptr, INC_D_2, DEC_D_2, LD_D_N_3, nullptr,
+        nullptr, ADD_IY_DE, nullptr, nullptr, INC_E_2, DEC_E_2, LD_E_N_3, nullptr,
+        nullptr, LD_IY_NN_, LD_ADDR_IY_, INC_IY_reg_, INC_IYH_, DEC_IYH_, LD_IYH_N_, nullptr,
+        nullptr, ADD_IY_IY, LD_IY_ADDR_, DEC_IY_reg_, INC_IYL_, DEC_IYL_, LD_IYL_N_, nullptr,
+        nullptr, nullptr, nullptr, nullptr, INC_IY_, DEC_IY_, LD_IY_N_, nullptr,
+        nullptr, ADD_IY_SP, nullptr, nullptr, INC_A_2, DEC_A_2, LD_A_N_3, nullptr,
+        LD_B_B_2, LD_B_C_2, LD_B_D_2, LD_B_E_2, LD_B_IYH, LD_B_IYL, LD_B_IY, LD_B_A_2,
+        LD_C_B_2, LD_C_C_2, LD_C_D_2, LD_C_E_2, LD_C_IYH, LD_C_IYL, LD_C_IY, LD_C_A_2,
+        LD_D_B_2, LD_D_C_2, LD_D_D_2, LD_D_E_2, LD_D_IYH, LD_D_IYL, LD_D_IY, LD_D_A_2,
+        LD_E_B_2, LD_E_C_2, LD_E_D_2, LD_E_E_2, LD_E_IYH, LD_E_IYL, LD_E_IY, LD_E_A_2,
+        LD_IYH_B, LD_IYH_C, LD_IYH_D, LD_IYH_E, LD_IYH_IYH_, LD_IYH_IYL_, LD_H_IY, LD_IYH_A,
+        LD_IYL_B, LD_IYL_C, LD_IYL_D, LD_IYL_E, LD_IYL_IYH_, LD_IYL_IYL_, LD_L_IY, LD_IYL_A,
+        LD_IY_B, LD_IY_C, LD_IY_D, LD_IY_E, LD_IY_H, LD_IY_L, nullptr, LD_IY_A,
+        LD_A_B_2, LD_A_C_2, LD_A_D_2, LD_A_E_2, LD_A_IYH, LD_A_IYL, LD_A_IY, LD_A_A_2,
+        ADD_B_2, ADD_C_2, ADD_D_2, ADD_E_2, ADD_IYH_, ADD_IYL_, ADD_IY_, ADD_A_2,
+        ADC_B_2, ADC_C_2, ADC_D_2, ADC_E_2, ADC_IYH_, ADC_IYL_, ADC_IY_, ADC_A_2,
+        SUB_B_2, SUB_C_2, SUB_D_2, SUB_E_2, SUB_IYH_, SUB_IYL_, SUB_IY_, SUB_A_2,
+        SBC_B_2, SBC_C_2, SBC_D_2, SBC_E_2, SBC_IYH_, SBC_IYL_, SBC_IY_, SBC_A_2,
+        AND_B_2, AND_C_2, AND_D_2, AND_E_2, AND_IYH_, AND_IYL_, AND_IY_, AND_A_2,
+        XOR_B_2, XOR_C_2, XOR_D_2, XOR_E_2, XOR_IYH_, XOR_IYL_, XOR_IY_, XOR_A_2,
+        OR_B_2, OR_C_2, OR_D_2, OR_E_2, OR_IYH_, OR_IYL_, OR_IY_, OR_A_2,
+        CP_B_2, CP_C_2, CP_D_2, CP_E_2, CP_IYH_, CP_IYL_, CP_IY_, CP_A_2,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, OP_IY4, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, POP_IY_, nullptr, EX_SP_IY_, nullptr, PUSH_IY_, nullptr, nullptr,
+        nullptr, JP_IY, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, LD_SP_IY_, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+    void (*opSetIX4[256])(Z80* ctx, signed char d) = {
+        RLC_IX_with_LD_B, RLC_IX_with_LD_C, RLC_IX_with_LD_D, RLC_IX_with_LD_E, RLC_IX_with_LD_H, RLC_IX_with_LD_L, RLC_IX_, RLC_IX_with_LD_A,
+        RRC_IX_with_LD_B, RRC_IX_with_LD_C, RRC_IX_with_LD_D, RRC_IX_with_LD_E, RRC_IX_with_LD_H, RRC_IX_with_LD_L, RRC_IX_, RRC_IX_with_LD_A,
+        RL_IX_with_LD_B, RL_IX_with_LD_C, RL_IX_with_LD_D, RL_IX_with_LD_E, RL_IX_with_LD_H, RL_IX_with_LD_L, RL_IX_, RL_IX_with_LD_A,
+        RR_IX_with_LD_B, RR_IX_with_LD_C, RR_IX_with_LD_D, RR_IX_with_LD_E, RR_IX_with_LD_H, RR_IX_with_LD_L, RR_IX_, RR_IX_with_LD_A,
+        SLA_IX_with_LD_B, SLA_IX_with_LD_C, SLA_IX_with_LD_D, SLA_IX_with_LD_E, SLA_IX_with_LD_H, SLA_IX_with_LD_L, SLA_IX_, SLA_IX_with_LD_A,
+        SRA_IX_with_LD_B, SRA_IX_with_LD_C, SRA_IX_with_LD_D, SRA_IX_with_LD_E, SRA_IX_with_LD_H, SRA_IX_with_LD_L, SRA_IX_, SRA_IX_with_LD_A,
+        SLL_IX_with_LD_B, SLL_IX_with_LD_C, SLL_IX_with_LD_D, SLL_IX_with_LD_E, SLL_IX_with_LD_H, SLL_IX_with_LD_L, SLL_IX_, SLL_IX_with_LD_A,
+        SRL_IX_with_LD_B, SRL_IX_with_LD_C, SRL_IX_with_LD_D, SRL_IX_with_LD_E, SRL_IX_with_LD_H, SRL_IX_with_LD_L, SRL_IX_, SRL_IX_with_LD_A,
+        BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0,
+        BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1,
+        BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2,
+        BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3,
+        BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4,
+        BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5,
+        BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6,
+        BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7,
+        RES_IX_0_with_LD_B, RES_IX_0_with_LD_C, RES_IX_0_with_LD_D, RES_IX_0_with_LD_E, RES_IX_0_with_LD_H, RES_IX_0_with_LD_L, RES_IX_0, RES_IX_0_with_LD_A,
+        RES_IX_1_with_LD_B, RES_IX_1_with_LD_C, RES_IX_1_with_LD_D, RES_IX_1_with_LD_E, RES_IX_1_with_LD_H, RES_IX_1_with_LD_L, RES_IX_1, RES_IX_1_with_LD_A,
+        RES_IX_2_with_LD_B, RES_IX_2_with_LD_C, RES_IX_2_with_LD_D, RES_IX_2_with_LD_E, RES_IX_2_with_LD_H, RES_IX_2_with_LD_L, RES_IX_2, RES_IX_2_with_LD_A,
+        RES_IX_3_with_LD_B, RES_IX_3_with_LD_C, RES_IX_3_with_LD_D, RES_IX_3_with_LD_E, RES_IX_3_with_LD_H, RES_IX_3_with_LD_L, RES_IX_3, RES_IX_3_with_LD_A,
+        RES_IX_4_with_LD_B, RES_IX_4_with_LD_C, RES_IX_4_with_LD_D, RES_IX_4_with_LD_E, RES_IX_4_with_LD_H, RES_IX_4_with_LD_L, RES_IX_4, RES_IX_4_with_LD_A,
+        RES_IX_5_with_LD_B, RES_IX_5_with_LD_C, RES_IX_5_with_LD_D, RES_IX_5_with_LD_E, RES_IX_5_with_LD_H, RES_IX_5_with_LD_L, RES_IX_5, RES_IX_5_with_LD_A,
+        RES_IX_6_with_LD_B, RES_IX_6_with_LD_C, RES_IX_6_with_LD_D, RES_IX_6_with_LD_E, RES_IX_6_with_LD_H, RES_IX_6_with_LD_L, RES_IX_6, RES_IX_6_with_LD_A,
+        RES_IX_7_with_LD_B, RES_IX_7_with_LD_C, RES_IX_7_with_LD_D, RES_IX_7_with_LD_E, RES_IX_7_with_LD_H, RES_IX_7_with_LD_L, RES_IX_7, RES_IX_7_with_LD_A,
+        SET_IX_0_with_LD_B, SET_IX_0_with_LD_C, SET_IX_0_with_LD_D, SET_IX_0_with_LD_E, SET_IX_0_with_LD_H, SET_IX_0_with_LD_L, SET_IX_0, SET_IX_0_with_LD_A,
+        SET_IX_1_with_LD_B, SET_IX_1_with_LD_C, SET_IX_1_with_LD_D, SET_IX_1_with_LD_E, SET_IX_1_with_LD_H, SET_IX_1_with_LD_L, SET_IX_1, SET_IX_1_with_LD_A,
+        SET_IX_2_with_LD_B, SET_IX_2_with_LD_C, SET_IX_2_with_LD_D, SET_IX_2_with_LD_E, SET_IX_2_with_LD_H, SET_IX_2_with_LD_L, SET_IX_2, SET_IX_2_with_LD_A,
+        SET_IX_3_with_LD_B, SET_IX_3_with_LD_C, SET_IX_3_with_LD_D, SET_IX_3_with_LD_E, SET_IX_3_with_LD_H, SET_IX_3_with_LD_L, SET_IX_3, SET_IX_3_with_LD_A,
+        SET_IX_4_with_LD_B, SET_IX_4_with_LD_C, SET_IX_4_with_LD_D, SET_IX_4_with_LD_E, SET_IX_4_with_LD_H, SET_IX_4_with_LD_L, SET_IX_4, SET_IX_4_with_LD_A,
+        SET_IX_5_with_LD_B, SET_IX_5_with_LD_C, SET_IX_5_with_LD_D, SET_IX_5_with_LD_E, SET_IX_5_with_LD_H, SET_IX_5_with_LD_L, SET_IX_5, SET_IX_5_with_LD_A,
+        SET_IX_6_with_LD_B, SET_IX_6_with_LD_C, SET_IX_6_with_LD_D, SET_IX_6_with_LD_E, SET_IX_6_with_LD_H, SET_IX_6_with_LD_L, SET_IX_6, SET_IX_6_with_LD_A,
+        SET_IX_7_with_LD_B, SET_IX_7_with_LD_C, SET_IX_7_with_LD_D, SET_IX_7_with_LD_E, SET_IX_7_with_LD_H, SET_IX_7_with_LD_L, SET_IX_7, SET_IX_7_with_LD_A};
+    void (*opSetIY4[256])(Z80* ctx, signed char d) = {
+        RLC_IY_with_LD_B, RLC_IY_with_LD_C, RLC_IY_with_LD_D, RLC_IY_with_LD_E, RLC_IY_with_LD_H, RLC_IY_with_LD_L, RLC_IY_, RLC_IY_with_LD_A,
+        RRC_IY_with_LD_B, RRC_IY_with_LD_C, RRC_IY_with_LD_D, RRC_IY_with_LD_E, RRC_IY_with_LD_H, RRC_IY_with_LD_L, RRC_IY_, RRC_IY_with_LD_A,
+        RL_IY_with_LD_B, RL_IY_with_LD_C, RL_IY_with_LD_D, RL_IY_with_LD_E, RL_IY_with_LD_H, RL_IY_with_LD_L, RL_IY_, RL_IY_with_LD_A,
+        RR_IY_with_LD_B, RR_IY_with_LD_C, RR_IY_with_LD_D, RR_IY_with_LD_E, RR_IY_with_LD_H, RR_IY_with_LD_L, RR_IY_, RR_IY_with_LD_A,
+        SLA_IY_with_LD_B, SLA_IY_with_LD_C, SLA_IY_with_LD_D, SLA_IY_with_LD_E, SLA_IY_with_LD_H, SLA_IY_with_LD_L, SLA_IY_, SLA_IY_with_LD_A,
+        SRA_IY_with_LD_B, SRA_IY_with_LD_C, SRA_IY_with_LD_D, SRA_IY_with_LD_E, SRA_IY_with_LD_H, SRA_IY_with_LD_L, SRA_IY_, SRA_IY_with_LD_A,
+        SLL_IY_with_LD_B, SLL_IY_with_LD_C, SLL_IY_with_LD_D, SLL_IY_with_LD_E, SLL_IY_with_LD_H, SLL_IY_with_LD_L, SLL_IY_, SLL_IY_with_LD_A,
+        SRL_IY_with_LD_B, SRL_IY_with_LD_C, SRL_IY_with_LD_D, SRL_IY_with_LD_E, SRL_IY_with_LD_H, SRL_IY_with_LD_L, SRL_IY_, SRL_IY_with_LD_A,
+        BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0,
+        BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1,
+        BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2,
+        BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3,
+        BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4,
+        BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5,
+        BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6,
+        BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7,
+        RES_IY_0_with_LD_B, RES_IY_0_with_LD_C, RES_IY_0_with_LD_D, RES_IY_0_with_LD_E, RES_IY_0_with_LD_H, RES_IY_0_with_LD_L, RES_IY_0, RES_IY_0_with_LD_A,
+        RES_IY_1_with_LD_B, RES_IY_1_with_LD_C, RES_IY_1_with_LD_D, RES_IY_1_with_LD_E, RES_IY_1_with_LD_H, RES_IY_1_with_LD_L, RES_IY_1, RES_IY_1_with_LD_A,
+        RES_IY_2_with_LD_B, RES_IY_2_with_LD_C, RES_IY_2_with_LD_D, RES_IY_2_with_LD_E, RES_IY_2_with_LD_H, RES_IY_2_with_LD_L, RES_IY_2, RES_IY_2_with_LD_A,
+        RES_IY_3_with_LD_B, RES_IY_3_with_LD_C, RES_IY_3_with_LD_D, RES_IY_3_with_LD_E, RES_IY_3_with_LD_H, RES_IY_3_with_LD_L, RES_IY_3, RES_IY_3_with_LD_A,
+        RES_IY_4_with_LD_B, RES_IY_4_with_LD_C, RES_IY_4_with_LD_D, RES_IY_4_with_LD_E, RES_IY_4_with_LD_H, RES_IY_4_with_LD_L, RES_IY_4, RES_IY_4_with_LD_A,
+        RES_IY_5_with_LD_B, RES_IY_5_with_LD_C, RES_IY_5_with_LD_D, RES_IY_5_with_LD_E, RES_IY_5_with_LD_H, RES_IY_5_with_LD_L, RES_IY_5, RES_IY_5_with_LD_A,
+        RES_IY_6_with_LD_B, RES_IY_6_with_LD_C, RES_IY_6_with_LD_D, RES_IY_6_with_LD_E, RES_IY_6_with_LD_H, RES_IY_6_with_LD_L, RES_IY_6, RES_IY_6_with_LD_A,
+        RES_IY_7_with_LD_B, RES_IY_7_with_LD_C, RES_IY_7_with_LD_D, RES_IY_7_with_LD_E, RES_IY_7_with_LD_H, RES_IY_7_with_LD_L, RES_IY_7, RES_IY_7_with_LD_A,
+        SET_IY_0_with_LD_B, SET_IY_0_with_LD_C, SET_IY_0_with_LD_D, SET_IY_0_with_LD_E, SET_IY_0_with_LD_H, SET_IY_0_with_LD_L, SET_IY_0, SET_IY_0_with_LD_A,
+        SET_IY_1_with_LD_B, SET_IY_1_with_LD_C, SET_IY_1_with_LD_D, SET_IY_1_with_LD_E, SET_IY_1_with_LD_H, SET_IY_1_with_LD_L, SET_IY_1, SET_IY_1_with_LD_A,
+        SET_IY_2_with_LD_B, SET_IY_2_with_LD_C, SET_IY_2_with_LD_D, SET_IY_2_with_LD_E, SET_IY_2_with_LD_H, SET_IY_2_with_LD_L, SET_IY_2, SET_IY_2_with_LD_A,
+        SET_IY_3_with_LD_B, SET_IY_3_with_LD_C, SET_IY_3_with_LD_D, SET_IY_3_with_LD_E, SET_IY_3_with_LD_H, SET_IY_3_with_LD_L, SET_IY_3, SET_IY_3_with_LD_A,
+        SET_IY_4_with_LD_B, SET_IY_4_with_LD_C, SET_IY_4_with_LD_D, SET_IY_4_with_LD_E, SET_IY_4_with_LD_H, SET_IY_4_with_LD_L, SET_IY_4, SET_IY_4_with_LD_A,
+        SET_IY_5_with_LD_B, SET_IY_5_with_LD_C, SET_IY_5_with_LD_D, SET_IY_5_with_LD_E, SET_IY_5_with_LD_H, SET_IY_5_with_LD_L, SET_IY_5, SET_IY_5_with_LD_A,
+        SET_IY_6_with_LD_B, SET_IY_6_with_LD_C, SET_IY_6_with_LD_D, SET_IY_6_with_LD_E, SET_IY_6_with_LD_H, SET_IY_6_with_LD_L, SET_IY_6, SET_IY_6_with_LD_A,
+        SET_IY_7_with_LD_B, SET_IY_7_with_LD_C, SET_IY_7_with_LD_D, SET_IY_7_with_LD_E, SET_IY_7_with_LD_H, SET_IY_7_with_LD_L, SET_IY_7, SET_IY_7_with_LD_A};
+
+    // apply the interrupt signals (posted by postIRQ, postCancelIRQ and postNMI) to the registers
+    void foldSignals()
+    {
+        unsigned int pending = clearSignals(~signalBreak) & ~signalBreak;
+#ifndef Z80_DISABLE_RECORD
+        if (RecorderMode::Replay == recorder.mode) return; // ignore the signals while replaying
+#endif
+#ifdef Z80_NO_ATOMIC
+        unsigned char vector = signals.vector;
+        unsigned short addrN = signals.addrN;
+#else
+        unsigned char vector = signals.vector.load(std::memory_order_relaxed);
+        unsigned short addrN = signals.addrN.load(std::memory_order_relaxed);
+#endif
+        if (pending & signalCancelIRQ) {
+#ifndef Z80_DISABLE_RECORD
+            if (RecorderMode::Record == recorder.mode) recordEvent(RecordEvent::CancelIRQ, 0);
+#endif
+            reg.interrupt &= 0b10111111;
+        }
+        if (pending & signalIRQ) {
+#ifndef Z80_DISABLE_RECORD
+            if (RecorderMode::Record == recorder.mode) recordEvent(RecordEvent::IRQ, vector);
+#endif
+            reg.interrupt |= 0b01000000;
+            reg.interruptVector = vector;
+        }
+        if (pending & signalNMI) {
+#ifndef Z80_DISABLE_RECORD
+            if (RecorderMode::Record == recorder.mode) recordEvent(RecordEvent::NMI, addrN);
+#endif
+            reg.interrupt |= 0b10000000;
+            reg.interruptAddrN = addrN;
+        }
+    }
+
+    inline void checkInterrupt()
+    {
+#ifndef Z80_DISABLE_COMMANDQUEUE
+        if (commandQueue.buffer) drainCommands();
+#endif
+#ifndef Z80_DISABLE_RECORD
+        if (RecorderMode::Replay == recorder.mode) replayEvents();
+#endif
+        if (getSignals() & ~signalBreak) foldSignals();
+        instructionCount++; // NOTE: checkInterrupt is called once per instruction
+#ifndef Z80_DISABLE_RECORD
+        if (RecorderMode::Replay == recorder.mode) checkReplayEnd();
+#endif
+        // Interrupt processing is not executed by the instruction immediately after executing EI.
+        if (reg.execEI) {
+            return;
+        }
+        // check interrupt flag
+        if (reg.interrupt & 0b10000000) {
+            // execute NMI
+            if (reg.IFF & IFF_NMI()) {
+                return;
+            }
+            reg.interrupt &= 0b01111111;
+#ifndef Z80_DISABLE_TIMELINE
+            if (reg.IFF & IFF_HALT()) logTimeline(TimelineType::HaltEnd, reg.PC);
+            logTimeline(TimelineType::NMI, reg.PC);
+#endif
+            reg.IFF &= ~IFF_HALT();
+#ifndef Z80_DISABLE_DEBUG
+            if (isDebug()) log("EXECUTE NMI: $%04X", reg.interruptAddrN);
+#endif
+            reg.R = ((reg.R + 1) & 0x7F) | (reg.R & 0x80);
+            reg.IFF |= IFF_NMI();
+            reg.IFF &= ~IFF1();
+            push(getPCH(), 4);
+            push(getPCL(), 4);
+            reg.PC = reg.interruptAddrN;
+            consumeClock(11);
+#ifndef Z80_DISABLE_NESTCHECK
+            invokeCallHandlers();
+#endif
+        } else if (reg.interrupt & 0b01000000) {
+            // execute IRQ
+            if (!(reg.IFF & IFF1())) {
+                return;
+            }
+            reg.interrupt &= 0b10111111;
+#ifndef Z80_DISABLE_BUSLOG
+            logBus(BusType::Acknowledge, make16BitsFromLE((unsigned char)reg.interruptVector, reg.I), (unsigned char)reg.interruptVector);
+#endif
+#ifndef Z80_DISABLE_TIMELINE
+            if (reg.IFF & IFF_HALT()) logTimeline(TimelineType::HaltEnd, reg.PC);
+            logTimeline(TimelineType::IRQ, reg.PC, reg.interrupt & 0b00000011);
+#endif
+            reg.IFF &= ~IFF_HALT();
+            reg.IFF |= IFF_IRQ();
+            reg.IFF &= ~(IFF1() | IFF2());
+            reg.R = ((reg.R + 1) & 0x7F) | (reg.R & 0x80);
+            switch (reg.interrupt & 0b00000011) {
+                case 0: // mode 0
+#ifndef Z80_DISABLE_DEBUG
+                    if (isDebug()) log("EXECUTE INT MODE1 (RST TO $%04X)", reg.interruptVector * 8);
+#endif
+                    if (reg.interruptVector == 0xCD) {
+                        consumeClock(7);
+                    }
+                    RST(reg.interruptVector, false);
+                    break;
+                case 1: // mode 1 (13Hz)
+#ifndef Z80_DISABLE_DEBUG
+                    if (isDebug()) log("EXECUTE INT MODE1 (RST TO $0038)");
+#endif
+                    consumeClock(1);
+                    RST(7, false);
+                    break;
+                case 2: { // mode 2
+                    writeByte(reg.SP - 1, getPCH());
+                    writeByte(reg.SP - 2, getPCL());
+                    reg.SP -= 2;
+                    unsigned short addr = make16BitsFromLE(reg.interruptVector, reg.I);
+                    unsigned short pc = make16BitsFromLE(readByte(addr), readByte(addr + 1));
+#ifndef Z80_DISABLE_DEBUG
+                    if (isDebug()) log("EXECUTE INT MODE2: ($%04X) = $%04X", addr, pc);
+#endif
+                    reg.PC = pc;
+                    consumeClock(3);
+#ifndef Z80_DISABLE_NESTCHECK
+                    invokeCallHandlers();
+#endif
+                    break;
+                }
+            }
+        }
+    }
+
+    inline void updateRefreshRegister()
+    {
+        reg.R = ((reg.R + 1) & 0x7F) | (reg.R & 0x80);
+        consumeClock(2);
+    }
+
+#ifndef Z80_DISABLE_RECORD
+    // record stream binary format: header (magic, version, state size), state, events
+    static const unsigned int recordMagic = 0x5230385A; // "Z80R"
+    static const unsigned short recordVersion = 1;
+    static const unsigned short recordHeaderSize = 8;
+
+    // event: instruction count delta (varint), type, payload
+    enum class RecordEvent : unsigned char {
+        In = 0,    // payload: value
+        IRQ,       // payload: vector
+        NMI,       // payload: address (16 bits)
+        CancelIRQ, // payload: none
+        End,       // payload: none (recording stopped)
+    };
+
+    enum class RecorderMode : unsigned char {
+        Off = 0,
+        Record,
+        Replay,
     };
+
+    struct Recorder {
+        RecorderMode mode = RecorderMode::Off;
+        std::vector<unsigned char> stream;     // recorded stream
+        const unsigned char* replayPtr = nullptr; // next event in the replay stream
+        const unsigned char* replayEnd = nullptr;
+        unsigned long long lastCount = 0; // instruction count of the previous event
+        unsigned long long nextCount = 0; // instruction count of the next replay event
+        RecordEvent nextEvent = RecordEvent::In;
+        bool desync = false;
+    } recorder;
+
+    // returns true if the event should be applied (i.e., not replaying)
+    inline bool hookExternalEvent(RecordEvent event, unsigned short payload)
+    {
+        if (RecorderMode::Record == recorder.mode) recordEvent(event, payload);
+        return RecorderMode::Replay != recorder.mode;
+    }
+
+    inline void recordEvent(RecordEvent event, unsigned short payload)
+    {
+        unsigned long long delta = instructionCount - recorder.lastCount;
+        recorder.lastCount = instructionCount;
+        while (0x80 <= delta) {
+            recorder.stream.push_back((unsigned char)(delta | 0x80));
+            delta >>= 7;
+        }
+        recorder.stream.push_back((unsigned char)delta);
+        recorder.stream.push_back((unsigned char)event);
+        switch (event) {
+            case RecordEvent::In:
+            case RecordEvent::IRQ:
+                recorder.stream.push_back((unsigned char)payload);
+                break;
+            case RecordEvent::NMI:
+                recorder.stream.push_back((unsigned char)(payload & 0xFF));
+                recorder.stream.push_back((unsigned char)(payload >> 8));
+                break;
+            case RecordEvent::CancelIRQ:
+            case RecordEvent::End:
+                break;
+        }
+    }
+
+    // read the stamp and the type of the next replay event (stop replay at the end of the stream)
+    void readNextReplayEvent()
+    {
+        if (recorder.replayEnd <= recorder.replayPtr) {
+            recorder.mode = RecorderMode::Off;
+            return;
+        }
+        unsigned long long delta = 0;
+        int shift = 0;
+        while (recorder.replayPtr < recorder.replayEnd && (*recorder.replayPtr & 0x80)) {
+            delta |= (unsigned long long)(*recorder.replayPtr++ & 0x7F) << shift;
+            shift += 7;
+        }
+        if (recorder.replayEnd <= recorder.replayPtr + 1) {
+            stopReplayWithDesync();
+            return;
+        }
+        delta |= (unsigned long long)(*recorder.replayPtr++) << shift;
+        recorder.nextCount = recorder.lastCount + delta;
+        recorder.lastCount = recorder.nextCount;
+        recorder.nextEvent = (RecordEvent)(*recorder.replayPtr++);
+    }
+
+    void stopReplayWithDesync()
+    {
+        recorder.mode = RecorderMode::Off;
+        recorder.desync = true;
+    }
+
+    inline unsigned char getReplayPayload8()
+    {
+        if (recorder.replayEnd <= recorder.replayPtr) {
+            stopReplayWithDesync();
+            return 0;
+        }
+        return *recorder.replayPtr++;
+    }
+
+    // apply the interrupt events stamped at or before the current instruction
+    Z80_NOINLINE void replayEvents()
+    {
+        while (RecorderMode::Replay == recorder.mode && recorder.nextCount <= instructionCount) {
+            switch (recorder.nextEvent) {
+                case RecordEvent::In:
+                case RecordEvent::End:
+                    return;
+                case RecordEvent::IRQ:
+                    reg.interrupt |= 0b01000000;
+                    reg.interruptVector = getReplayPayload8();
+                    break;
+                case RecordEvent::NMI: {
+                    unsigned char low = getReplayPayload8();
+                    reg.interrupt |= 0b10000000;
+                    reg.interruptAddrN = make16BitsFromLE(low, getReplayPayload8());
+                    break;
+                }
+                case RecordEvent::CancelIRQ:
+                    reg.interrupt &= 0b10111111;
+                    break;
+                default:
+                    stopReplayWithDesync();
+                    return;
+            }
+            if (RecorderMode::Replay == recorder.mode) readNextReplayEvent();
+        }
+    }
+
+    // stop the replay at the End event (the instruction count is reached)
+    Z80_NOINLINE void checkReplayEnd()
+    {
+        if (RecordEvent::End != recorder.nextEvent || instructionCount < recorder.nextCount) return;
+        recorder.mode = RecorderMode::Off;
+        postSignals(signalBreak);
+    }
+
+    unsigned char readPortWithRecorder(unsigned short port)
+    {
+        if (RecorderMode::Record == recorder.mode) {
+            unsigned char value = CB.in(CB.arg, port);
+            recordEvent(RecordEvent::In, value);
+            return value;
+        }
+        replayEvents();
+        if (RecorderMode::Replay == recorder.mode && RecordEvent::In == recorder.nextEvent && recorder.nextCount == instructionCount) {
+            unsigned char value = getReplayPayload8();
+            if (RecorderMode::Replay == recorder.mode) readNextReplayEvent();
+            return value;
+        }
+        if (RecorderMode::Replay == recorder.mode) stopReplayWithDesync();
+        return CB.in(CB.arg, port);
+    }
+#endif
+
+    // save state binary format (little endian)
+    static const unsigned int stateMagic = 0x5330385A; // "Z80S"
+    static const unsigned short stateVersion = 1;
+    static const unsigned short stateHeaderSize = 8;
+    static const unsigned short stateBodySize = 75;
+
+    static inline void putState8(unsigned char*& ptr, unsigned char value) { *ptr++ = value; }
+    static inline void putState16(unsigned char*& ptr, unsigned short value)
+    {
+        *ptr++ = (unsigned char)(value & 0xFF);
+        *ptr++ = (unsigned char)(value >> 8);
+    }
+    static inline void putState32(unsigned char*& ptr, unsigned int value)
+    {
+        putState16(ptr, (unsigned short)(value & 0xFFFF));
+        putState16(ptr, (unsigned short)(value >> 16));
+    }
+    static inline void putState64(unsigned char*& ptr, unsigned long long value)
+    {
+        putState32(ptr, (unsigned int)(value & 0xFFFFFFFF));
+        putState32(ptr, (unsigned int)(value >> 32));
+    }
+    static inline unsigned char getState8(const unsigned char*& ptr) { return *ptr++; }
+    static inline unsigned short getState16(const unsigned char*& ptr)
+    {
+        unsigned short value = ptr[0] | (ptr[1] << 8);
+        ptr += 2;
+        return value;
+    }
+    static inline unsigned int getState32(const unsigned char*& ptr)
+    {
+        unsigned int value = getState16(ptr);
+        return value | ((unsigned int)getState16(ptr) << 16);
+    }
+    static inline unsigned long long getState64(const unsigned char*& ptr)
+    {
+        unsigned long long value = getState32(ptr);
+        return value | ((unsigned long long)getState32(ptr) << 32);
+    }
+
+    inline void putStateRegisterPair(unsigned char*& ptr, const RegisterPair& pair)
+    {
+        putState8(ptr, pair.A);
+        putState8(ptr, pair.F);
+        putState8(ptr, pair.B);
+        putState8(ptr, pair.C);
+        putState8(ptr, pair.D);
+        putState8(ptr, pair.E);
+        putState8(ptr, pair.H);
+        putState8(ptr, pair.L);
+    }
+
+    inline void getStateRegisterPair(const unsigned char*& ptr, RegisterPair& pair)
+    {
+        pair.A = getState8(ptr);
+        pair.F = getState8(ptr);
+        pair.B = getState8(ptr);
+        pair.C = getState8(ptr);
+        pair.D = getState8(ptr);
+        pair.E = getState8(ptr);
+        pair.H = getState8(ptr);
+        pair.L = getState8(ptr);
+    }
+
+    // copy the state and the callbacks of the source CPU (this instance must not own any hooks)
+    void copyFrom(const Z80& src, bool withHooks)
+    {
+        reg = src.reg;
+        wtc = src.wtc;
+        CB = src.CB;
+        CB.hooks = nullptr;
+        copyCodePages(src.CB.hooks);
+        copySignals(src);
+        totalClocks = src.totalClocks;
+        instructionCount = src.instructionCount;
+        speculative = src.speculative;
+        suppressOut = src.suppressOut;
+        suppressClock = src.suppressClock;
+        instructionPC = src.instructionPC;
+#ifndef Z80_DISABLE_RECORD
+        recorder = src.recorder;
+#endif
+#ifndef Z80_DISABLE_CONTENTION
+        contention = src.contention;
+#endif
+#ifndef Z80_DISABLE_BUSLOG
+        busLog = src.busLog;
+        if (src.busLog.events) {
+            busLog.events = new BusEvent[src.busLog.capacity];
+            memcpy(busLog.events, src.busLog.events, sizeof(BusEvent) * (size_t)src.busLog.capacity);
+        }
+#endif
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        decodeCache.entries = nullptr;
+        if (src.decodeCache.entries) enableDisassembleCache(); // the copy may have the different memory
+#endif
+#ifndef Z80_DISABLE_TRACE
+        trace = src.trace;
+        trace.fp = nullptr; // the copy does not write to the same stream
+        if (src.trace.records) {
+            trace.records = new TraceRecord[src.trace.capacity];
+            memcpy(trace.records, src.trace.records, sizeof(TraceRecord) * (size_t)src.trace.capacity);
+        }
+#endif
+#ifndef Z80_DISABLE_PROFILER
+        profiler.counts = nullptr;
+        profiler.clocks = nullptr;
+        if (src.profiler.counts) {
+            enableProfiler();
+            memcpy(profiler.counts, src.profiler.counts, sizeof(unsigned long long) * 0x10000);
+            memcpy(profiler.clocks, src.profiler.clocks, sizeof(unsigned long long) * 0x10000);
+        }
+#endif
+#ifndef Z80_DISABLE_COVERAGE
+        coverage.maps = nullptr;
+        if (src.coverage.maps) {
+            enableCoverage();
+            memcpy(coverage.maps, src.coverage.maps, sizeof(unsigned int) * 0x1800);
+        }
+#endif
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        opcodeHistogram.counters = nullptr;
+        opcodeHistogram.current = nullptr;
+        if (src.opcodeHistogram.counters) {
+            enableOpcodeHistogram();
+            memcpy(opcodeHistogram.counters, src.opcodeHistogram.counters, sizeof(OpcodeCounter) * 7 * 256);
+        }
+#endif
+#ifndef Z80_DISABLE_BREAKPOINT
+        CB.breakPointId = src.CB.breakPointId;
+        if (withHooks && src.CB.hooks) {
+            const HookTables* srcHooks = src.CB.hooks;
+            HookTables* hooks = getHooks();
+            memcpy(hooks->breakPointBitmap, srcHooks->breakPointBitmap, sizeof(hooks->breakPointBitmap));
+            for (int i = 0; i < 256; i++) {
+                if (!srcHooks->breakPointPages[i]) continue;
+                hooks->breakPointPages[i] = new std::vector<BreakPoint*>[256];
+                for (int j = 0; j < 256; j++) {
+                    for (auto bp : srcHooks->breakPointPages[i][j]) hooks->breakPointPages[i][j].push_back(new BreakPoint(*bp));
+                }
+            }
+            for (int i = 0; i < 7; i++) {
+                for (int j = 0; j < 256; j++) {
+                    if (!srcHooks->breakOperands[i][j]) continue;
+                    hooks->breakOperands[i][j] = new std::vector<BreakOperand*>();
+                    for (auto bo : *srcHooks->breakOperands[i][j]) hooks->breakOperands[i][j]->push_back(new BreakOperand(*bo));
+                }
+            }
+        }
+#endif
+#ifndef Z80_DISABLE_NESTCHECK
+        callGraph = src.callGraph;
+        CB.returnHandlers.clear();
+        CB.callHandlers.clear();
+        if (withHooks) {
+            for (auto handler : src.CB.returnHandlers) CB.returnHandlers.push_back(new SimpleHandler(*handler));
+            for (auto handler : src.CB.callHandlers) CB.callHandlers.push_back(new SimpleHandler(*handler));
+        }
+#endif
+        updateBusHooked();
+        updateInstrumented();
+    }
+
+    // take over the hooks and the buffers of the source CPU
+    void moveFrom(Z80& src)
+    {
+#ifndef Z80_DISABLE_PROFILER
+        Profiler srcProfiler = src.profiler;
+        src.profiler.counts = nullptr;
+        src.profiler.clocks = nullptr;
+#endif
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        OpcodeCounter* srcCounters = src.opcodeHistogram.counters;
+        src.opcodeHistogram.counters = nullptr;
+#endif
+#ifndef Z80_DISABLE_COVERAGE
+        unsigned int* srcMaps = src.coverage.maps;
+        src.coverage.maps = nullptr;
+#endif
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        DecodedInstruction* srcEntries = src.decodeCache.entries;
+        src.decodeCache.entries = nullptr;
+#endif
+#ifndef Z80_DISABLE_TRACE
+        Trace srcTrace = src.trace;
+        src.trace.records = nullptr;
+        src.trace.fp = nullptr;
+        src.trace.capacity = 0;
+        src.clearTrace();
+#endif
+#ifndef Z80_DISABLE_BUSLOG
+        BusEvent* events = src.busLog.events;
+        src.busLog.events = nullptr;
+        copyFrom(src, false);
+        busLog.events = events;
+        src.busLog.capacity = 0;
+        src.clearBusLog();
+#else
+        copyFrom(src, false);
+#endif
+#ifndef Z80_DISABLE_TRACE
+        trace = srcTrace;
+#endif
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        decodeCache.entries = srcEntries;
+#endif
+#ifndef Z80_DISABLE_PROFILER
+        profiler = srcProfiler;
+#endif
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        opcodeHistogram.counters = srcCounters;
+#endif
+#ifndef Z80_DISABLE_COVERAGE
+        coverage.maps = srcMaps;
+#endif
+        // take over the tables, and the source keeps only the mapping of the code pages
+        delete CB.hooks;
+        CB.hooks = src.CB.hooks;
+        src.CB.hooks = nullptr;
+        src.copyCodePages(CB.hooks);
+#ifndef Z80_DISABLE_NESTCHECK
+        CB.returnHandlers.swap(src.CB.returnHandlers);
+        CB.callHandlers.swap(src.CB.callHandlers);
+#endif
+#ifndef Z80_DISABLE_COMMANDQUEUE
+        commandQueue.buffer = src.commandQueue.buffer;
+        commandQueue.capacity = src.commandQueue.capacity;
+#ifdef Z80_NO_ATOMIC
+        commandQueue.head = src.commandQueue.head;
+        commandQueue.tail = src.commandQueue.tail;
+#else
+        commandQueue.head.store(src.commandQueue.head.load());
+        commandQueue.tail.store(src.commandQueue.tail.load());
+#endif
+        src.commandQueue.buffer = nullptr;
+        src.commandQueue.capacity = 0;
+#endif
+#ifndef Z80_DISABLE_TIMELINE
+        timeline.events = src.timeline.events;
+        timeline.capacity = src.timeline.capacity;
+#ifdef Z80_NO_ATOMIC
+        timeline.head = src.timeline.head;
+        timeline.tail = src.timeline.tail;
+        timeline.lost = src.timeline.lost;
+#else
+        timeline.head.store(src.timeline.head.load());
+        timeline.tail.store(src.timeline.tail.load());
+        timeline.lost.store(src.timeline.lost.load());
+#endif
+        src.timeline.events = nullptr;
+        src.timeline.capacity = 0;
+#endif
+        updateBusHooked();
+        updateInstrumented();
+        src.updateBusHooked();
+        src.updateInstrumented();
+    }
+
+    void releaseHooks()
+    {
+#ifndef Z80_DISABLE_BUSLOG
+        disableBusLog();
+#endif
+#ifndef Z80_DISABLE_TRACE
+        disableTrace();
+#endif
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        disableDisassembleCache();
+#endif
+#ifndef Z80_DISABLE_PROFILER
+        disableProfiler();
+#endif
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+        disableOpcodeHistogram();
+#endif
+#ifndef Z80_DISABLE_COVERAGE
+        disableCoverage();
+#endif
+#ifndef Z80_DISABLE_COMMANDQUEUE
+        disableCommandQueue();
+#endif
+#ifndef Z80_DISABLE_TIMELINE
+        disableTimeline();
+#endif
+#ifndef Z80_DISABLE_BREAKPOINT
+        removeAllBreakOperands();
+        removeAllBreakPoints();
+#endif
+#ifndef Z80_DISABLE_NESTCHECK
+        removeAllCallHandlers();
+        removeAllReturnHandlers();
+#endif
+        delete CB.hooks;
+        CB.hooks = nullptr;
+    }
+
+  public: // API functions
+#ifdef Z80_NO_FUNCTIONAL
+    Z80(unsigned char (*read)(void* arg, unsigned short addr),
+        void (*write)(void* arg, unsigned short addr, unsigned char value),
+        unsigned char (*in)(void* arg, unsigned short port),
+        void (*out)(void* arg, unsigned short port, unsigned char value),
+        void* arg,
+        bool returnPortAs16Bits = false)
+#else
+    Z80(std::function<unsigned char(void*, unsigned short)> read,
+        std::function<void(void*, unsigned short, unsigned char)> write,
+        std::function<unsigned char(void*, unsigned short)> in,
+        std::function<void(void*, unsigned short, unsigned char)> out,
+        void* arg,
+        bool returnPortAs16Bits = false)
+#endif
+    {
+        this->CB.arg = arg;
+        initialize();
+        setupCallback(read, write, in, out, returnPortAs16Bits);
+    }
+
+    // without setup callbacks
+    Z80(void* arg)
+    {
+        this->CB.arg = arg;
+        initialize();
+    }
+
+    Z80()
+    {
+        initialize();
+    }
+
+    // copy the CPU (withHooks = false: without the break points, break operands, call handlers and return handlers)
+    Z80(const Z80& src, bool withHooks = true)
+    {
+        copyFrom(src, withHooks);
+    }
+
+    Z80(Z80&& src)
+    {
+        moveFrom(src);
+    }
+
+    Z80& operator=(const Z80& src)
+    {
+        if (this != &src) {
+            releaseHooks();
+            copyFrom(src, true);
+        }
+        return *this;
+    }
+
+    Z80& operator=(Z80&& src)
+    {
+        if (this != &src) {
+            releaseHooks();
+            moveFrom(src);
+        }
+        return *this;
+    }
+
+    // create an independent copy of this CPU on the heap (release it with delete)
+    Z80* clone(bool withHooks = true)
+    {
+        return new Z80(*this, withHooks);
+    }
+
+#ifndef Z80_NO_FUNCTIONAL
+    void setupCallback(std::function<unsigned char(void*, unsigned short)> read,
+                       std::function<void(void*, unsigned short, unsigned char)> write,
+                       std::function<unsigned char(void*, unsigned short)> in,
+                       std::function<void(void*, unsigned short, unsigned char)> out,
+                       void* arg,
+                       bool returnPortAs16Bits = false)
+    {
+        CB.arg = arg;
+        setupCallback(read, write, in, out, returnPortAs16Bits);
+    }
+
+    void setupCallback(std::function<unsigned char(void*, unsigned short)> read,
+                       std::function<void(void*, unsigned short, unsigned char)> write,
+                       std::function<unsigned char(void*, unsigned short)> in,
+                       std::function<void(void*, unsigned short, unsigned char)> out,
+                       bool returnPortAs16Bits = false)
+    {
+        setupMemoryCallback(read, write);
+        setupDeviceCallback(in, out, returnPortAs16Bits);
+    }
+
+    void setupMemoryCallback(std::function<unsigned char(void*, unsigned short)> read,
+                             std::function<void(void*, unsigned short, unsigned char)> write)
+    {
+        CB.read = read;
+        CB.write = write;
+    }
+
+    void setupDeviceCallback(std::function<unsigned char(void*, unsigned short)> in,
+                             std::function<void(void*, unsigned short, unsigned char)> out,
+                             bool returnPortAs16Bits)
+    {
+        CB.in = in;
+        CB.out = out;
+#ifndef Z80_UNSUPPORT_16BIT_PORT
+        CB.returnPortAs16Bits = returnPortAs16Bits;
+#endif
+    }
+
+#else
+    void setupCallback(unsigned char (*read)(void* arg, unsigned short addr),
+                       void (*write)(void* arg, unsigned short addr, unsigned char value),
+                       unsigned char (*in)(void* arg, unsigned short port),
+                       void (*out)(void* arg, unsigned short port, unsigned char value),
+                       void* arg,
+                       bool returnPortAs16Bits = false)
+    {
+        CB.arg = arg;
+        setupCallback(read, write, in, out, returnPortAs16Bits);
+    }
+
+    void setupCallback(unsigned char (*read)(void* arg, unsigned short addr),
+                       void (*write)(void* arg, unsigned short addr, unsigned char value),
+                       unsigned char (*in)(void* arg, unsigned short port),
+                       void (*out)(void* arg, unsigned short port, unsigned char value),
+                       bool returnPortAs16Bits = false)
+    {
+        setupMemoryCallback(read, write);
+        setupDeviceCallback(in, out, returnPortAs16Bits);
+    }
+
+    void setupMemoryCallback(unsigned char (*read)(void* arg, unsigned short addr),
+                             void (*write)(void* arg, unsigned short addr, unsigned char value))
+    {
+        CB.read = read;
+        CB.write = write;
+    }
+
+    void setupDeviceCallback(unsigned char (*in)(void* arg, unsigned short addr),
+                             void (*out)(void* arg, unsigned short addr, unsigned char value),
+                             bool returnPortAs16Bits)
+    {
+        CB.in = in;
+        CB.out = out;
+#ifndef Z80_UNSUPPORT_16BIT_PORT
+        CB.returnPortAs16Bits = returnPortAs16Bits;
+#endif
+    }
+#endif
+
+    void initialize()
+    {
+        resetConsumeClockCallback();
+        resetFetchCallback();
+        resetPeekCallback();
+        unmapCodePages(0, 0x10000);
+#ifndef Z80_DISABLE_DEBUG
+        resetDebugMessage();
+        resetDebugEvent();
+#endif
+        ::memset(&reg, 0, sizeof(reg));
+        reg.pair.A = 0xff;
+        reg.pair.F = 0xff;
+        reg.SP = 0xffff;
+        memset(&wtc, 0, sizeof(wtc));
+        clearSignals(~0U);
+        totalClocks = 0;
+        instructionCount = 0;
+        speculative = false;
+        suppressOut = false;
+        suppressClock = false;
+        instructionPC = 0;
+#ifndef Z80_DISABLE_RECORD
+        recorder.mode = RecorderMode::Off;
+        recorder.stream.clear();
+        recorder.desync = false;
+#endif
+#ifndef Z80_DISABLE_CONTENTION
+        resetContention();
+#endif
+    }
+
+    ~Z80()
+    {
+        releaseHooks();
+    }
+
+    void setCallbackArg(void* arg)
+    {
+        CB.arg = arg;
+    }
+
+#ifndef Z80_DISABLE_DEBUG
+#ifdef Z80_NO_FUNCTIONAL
+    void setDebugMessage(void (*debugMessage)(void* arg, const char* msg))
+#else
+    void setDebugMessage(std::function<void(void*, const char*)> debugMessage)
+#endif
+    {
+        CB.debugMessageEnabled = true;
+        CB.debugMessage = debugMessage;
+    }
+
+    void resetDebugMessage()
+    {
+        CB.debugMessageEnabled = false;
+#ifdef Z80_NO_FUNCTIONAL
+        CB.debugMessage = nullptr;
+#endif
+    }
+
+    // receive the structured event (address, bytes, mnemonic ID, operands and registers) per instruction instead of the text
+#ifdef Z80_NO_FUNCTIONAL
+    void setDebugEvent(void (*debugEvent)(void* arg, const DebugEvent* event))
+#else
+    void setDebugEvent(std::function<void(void*, const DebugEvent*)> debugEvent)
+#endif
+    {
+        CB.debugEventEnabled = true;
+        CB.debugEvent = debugEvent;
+        updateInstrumented();
+        updateBusHooked();
+    }
+
+    void resetDebugEvent()
+    {
+        CB.debugEventEnabled = false;
+#ifdef Z80_NO_FUNCTIONAL
+        CB.debugEvent = nullptr;
+#endif
+        updateInstrumented();
+        updateBusHooked();
+    }
+
+    // format the debug event into the text (e.g. "[0004] LD IX, $8000"), it can be used without the instance
+    static void formatDebugEvent(const DebugEvent& event, char* buf, size_t size)
+    {
+        char instruction[32];
+        decodeInstruction(event.pc, event.bytes, instruction, sizeof(instruction));
+        snprintf(buf, size, "[%04X] %s", event.pc, instruction);
+    }
+
+    inline bool isDebug()
+    {
+        return CB.debugMessageEnabled && !speculative;
+    }
+#endif
+
+    inline unsigned short make16BitsFromLE(unsigned char low, unsigned char high)
+    {
+        unsigned short n = high;
+        n <<= 8;
+        n |= low;
+        return n;
+    }
+
+    inline void splitTo8BitsPair(unsigned short value, unsigned char* high, unsigned char* low)
+    {
+        *high = (value & 0xFF00) >> 8;
+        *low = value & 0xFF;
+    }
+
+#ifndef Z80_DISABLE_BREAKPOINT
+    // add the break point (returns the id to remove only this break point with removeBreakPoint(addr, id))
+#ifdef Z80_NO_FUNCTIONAL
+    int addBreakPoint(unsigned short addr, void (*callback)(void*))
+#else
+    int addBreakPoint(unsigned short addr, std::function<void(void*)> callback)
+#endif
+    {
+        return insertBreakPoint(new BreakPoint(addr, callback));
+    }
+
+    // add the break point that calls back only when the condition is true (returns the id, or 0 if the condition is invalid)
+    //   ex: "A == 0 && HL > $C000", "ZF || [IX+5] != $FF"
+    //   ignoreCount: number of the hits (the condition was true) to skip the callback
+#ifdef Z80_NO_FUNCTIONAL
+    int addBreakPoint(unsigned short addr, const char* condition, void (*callback)(void*), unsigned long long ignoreCount = 0)
+#else
+    int addBreakPoint(unsigned short addr, const char* condition, std::function<void(void*)> callback, unsigned long long ignoreCount = 0)
+#endif
+    {
+        BreakPoint* bp = new BreakPoint(addr, callback);
+        if (!compileCondition(condition, bp->condition)) {
+            delete bp;
+            return 0;
+        }
+        bp->ignoreCount = ignoreCount;
+        return insertBreakPoint(bp);
+    }
+
+    // returns the total number of the hits of the break points at the address
+    unsigned long long getBreakPointHitCount(unsigned short addr)
+    {
+        unsigned long long hitCount = 0;
+        auto page = CB.hooks ? CB.hooks->breakPointPages[addr >> 8] : nullptr;
+        if (page) {
+            for (auto bp : page[addr & 0xFF]) hitCount += bp->hitCount;
+        }
+        return hitCount;
+    }
+
+    void resetBreakPointHitCount(unsigned short addr)
+    {
+        auto page = CB.hooks ? CB.hooks->breakPointPages[addr >> 8] : nullptr;
+        if (page) {
+            for (auto bp : page[addr & 0xFF]) bp->hitCount = 0;
+        }
+    }
+
+    // stop the execute before the instruction at the break point (call it in the break point callback)
+    //   NOTE: requestBreak stops after the instruction at the break point
+    void requestBreakBefore()
+    {
+        breakBefore = true;
+    }
+
+    // skip the break points at PC for the next instruction (call it before the execute to resume from requestBreakBefore)
+    //   NOTE: the callbacks at PC were already called, and their hit counts were already counted when it stopped
+    void skipBreakPointOnce()
+    {
+        breakSkip = CB.hooks && 0 != (CB.hooks->breakPointBitmap[reg.PC >> 5] & (1U << (reg.PC & 31)));
+    }
+
+    void removeBreakPoint(unsigned short addr)
+    {
+        if (!CB.hooks) return;
+        auto& page = CB.hooks->breakPointPages[addr >> 8];
+        if (!page) return;
+        for (auto bp : page[addr & 0xFF]) delete bp;
+        page[addr & 0xFF].clear();
+        CB.hooks->breakPointBitmap[addr >> 5] &= ~(1U << (addr & 31));
+        for (int i = 0; i < 8; i++) {
+            if (CB.hooks->breakPointBitmap[((addr >> 8) << 3) + i]) return;
+        }
+        delete[] page; // release the page that has no break points
+        page = nullptr;
+    }
+
+    // remove only the break point of the id returned by addBreakPoint (returns false if not found)
+    bool removeBreakPoint(unsigned short addr, int id)
+    {
+        auto page = CB.hooks ? CB.hooks->breakPointPages[addr >> 8] : nullptr;
+        if (!page) return false;
+        auto& list = page[addr & 0xFF];
+        for (auto it = list.begin(); it != list.end(); it++) {
+            if ((*it)->id != id) continue;
+            delete *it;
+            list.erase(it);
+            if (list.empty()) removeBreakPoint(addr); // clear the bitmap and release the empty page
+            return true;
+        }
+        return false;
+    }
+
+    void removeAllBreakPoints()
+    {
+        if (!CB.hooks) return;
+        for (int i = 0; i < 256; i++) {
+            if (!CB.hooks->breakPointPages[i]) continue;
+            for (int j = 0; j < 256; j++) {
+                for (auto bp : CB.hooks->breakPointPages[i][j]) delete bp;
+            }
+            delete[] CB.hooks->breakPointPages[i];
+            CB.hooks->breakPointPages[i] = nullptr;
+        }
+        memset(CB.hooks->breakPointBitmap, 0, sizeof(CB.hooks->breakPointBitmap));
+    }
+
+#ifdef Z80_NO_FUNCTIONAL
+    void addBreakOperand(int operandNumber, void (*callback)(void*, unsigned char*, int))
+#else
+    void addBreakOperand(int operandNumber, std::function<void(void*, unsigned char*, int)> callback)
 #endif
-    void (*opSet1[256])(Z80* ctx) = {
-        NOP, LD_BC_NN, LD_BC_A, INC_RP_BC, INC_B, DEC_B, LD_B_N, RLCA, EX_AF_AF2, ADD_HL_BC, LD_A_BC, DEC_RP_BC, INC_C, DEC_C, LD_C_N, RRCA,
-        DJNZ_E, LD_DE_NN, LD_DE_A, INC_RP_DE, INC_D, DEC_D, LD_D_N, RLA, JR_E, ADD_HL_DE, LD_A_DE, DEC_RP_DE, INC_E, DEC_E, LD_E_N, RRA,
-        JR_NZ_E, LD_HL_NN, LD_ADDR_HL, INC_RP_HL, INC_H, DEC_H, LD_H_N, DAA, JR_Z_E, ADD_HL_HL, LD_HL_ADDR, DEC_RP_HL, INC_L, DEC_L, LD_L_N, CPL,
-        JR_NC_E, LD_SP_NN, LD_NN_A, INC_RP_SP, INC_HL, DEC_HL, LD_HL_N, SCF, JR_C_E, ADD_HL_SP, LD_A_NN, DEC_RP_SP, INC_A, DEC_A, LD_A_N, CCF,
-        LD_B_B, LD_B_C, LD_B_D, LD_B_E, LD_B_H, LD_B_L, LD_B_HL, LD_B_A, LD_C_B, LD_C_C, LD_C_D, LD_C_E, LD_C_H, LD_C_L, LD_C_HL, LD_C_A,
-        LD_D_B, LD_D_C, LD_D_D, LD_D_E, LD_D_H, LD_D_L, LD_D_HL, LD_D_A, LD_E_B, LD_E_C, LD_E_D, LD_E_E, LD_E_H, LD_E_L, LD_E_HL, LD_E_A,
-        LD_H_B, LD_H_C, LD_H_D, LD_H_E, LD_H_H, LD_H_L, LD_H_HL, LD_H_A, LD_L_B, LD_L_C, LD_L_D, LD_L_E, LD_L_H, LD_L_L, LD_L_HL, LD_L_A,
-        LD_HL_B, LD_HL_C, LD_HL_D, LD_HL_E, LD_HL_H, LD_HL_L, HALT, LD_HL_A, LD_A_B, LD_A_C, LD_A_D, LD_A_E, LD_A_H, LD_A_L, LD_A_HL, LD_A_A,
-        ADD_B, ADD_C, ADD_D, ADD_E, ADD_H, ADD_L, ADD_HL, ADD_A, ADC_B, ADC_C, ADC_D, ADC_E, ADC_H, ADC_L, ADC_HL, ADC_A,
-        SUB_B, SUB_C, SUB_D, SUB_E, SUB_H, SUB_L, SUB_HL, SUB_A, SBC_B, SBC_C, SBC_D, SBC_E, SBC_H, SBC_L, SBC_HL, SBC_A,
-        AND_B, AND_C, AND_D, AND_E, AND_H, AND_L, AND_HL, AND_A, XOR_B, XOR_C, XOR_D, XOR_E, XOR_H, XOR_L, XOR_HL, XOR_A,
-        OR_B, OR_C, OR_D, OR_E, OR_H, OR_L, OR_HL, OR_A, CP_B, CP_C, CP_D, CP_E, CP_H, CP_L, CP_HL, CP_A,
-        RET_C0, POP_BC, JP_C0_NN, JP_NN, CALL_C0_NN, PUSH_BC, ADD_N, RST00, RET_C1, RET, JP_C1_NN, OP_CB, CALL_C1_NN, CALL_NN, ADC_N, RST08,
-        RET_C2, POP_DE, JP_C2_NN, OUT_N_A, CALL_C2_NN, PUSH_DE, SUB_N, RST10, RET_C3, EXX, JP_C3_NN, IN_A_N, CALL_C3_NN, OP_IX, SBC_N, RST18,
-        RET_C4, POP_HL, JP_C4_NN, EX_SP_HL, CALL_C4_NN, PUSH_HL, AND_N, RST20, RET_C5, JP_HL, JP_C5_NN, EX_DE_HL, CALL_C5_NN, OP_ED, XOR_N, RST28,
-        RET_C6, POP_AF, JP_C6_NN, DI, CALL_C6_NN, PUSH_AF, OR_N, RST30, RET_C7, LD_SP_HL, JP_C7_NN, EI, CALL_C7_NN, OP_IY, CP_N, RST38};
-    void (*opSetCB[256])(Z80* ctx) = {
-        RLC_B, RLC_C, RLC_D, RLC_E, RLC_H, RLC_L, RLC_HL_, RLC_A,
-        RRC_B, RRC_C, RRC_D, RRC_E, RRC_H, RRC_L, RRC_HL_, RRC_A,
-        RL_B, RL_C, RL_D, RL_E, RL_H, RL_L, RL_HL_, RL_A,
-        RR_B, RR_C, RR_D, RR_E, RR_H, RR_L, RR_HL_, RR_A,
-        SLA_B, SLA_C, SLA_D, SLA_E, SLA_H, SLA_L, SLA_HL_, SLA_A,
-        SRA_B, SRA_C, SRA_D, SRA_E, SRA_H, SRA_L, SRA_HL_, SRA_A,
-        SLL_B, SLL_C, SLL_D, SLL_E, SLL_H, SLL_L, SLL_HL_, SLL_A,
-        SRL_B, SRL_C, SRL_D, SRL_E, SRL_H, SRL_L, SRL_HL_, SRL_A,
-        BIT_B_0, BIT_C_0, BIT_D_0, BIT_E_0, BIT_H_0, BIT_L_0, BIT_HL_0, BIT_A_0,
-        BIT_B_1, BIT_C_1, BIT_D_1, BIT_E_1, BIT_H_1, BIT_L_1, BIT_HL_1, BIT_A_1,
-        BIT_B_2, BIT_C_2, BIT_D_2, BIT_E_2, BIT_H_2, BIT_L_2, BIT_HL_2, BIT_A_2,
-        BIT_B_3, BIT_C_3, BIT_D_3, BIT_E_3, BIT_H_3, BIT_L_3, BIT_HL_3, BIT_A_3,
-        BIT_B_4, BIT_C_4, BIT_D_4, BIT_E_4, BIT_H_4, BIT_L_4, BIT_HL_4, BIT_A_4,
-        BIT_B_5, BIT_C_5, BIT_D_5, BIT_E_5, BIT_H_5, BIT_L_5, BIT_HL_5, BIT_A_5,
-        BIT_B_6, BIT_C_6, BIT_D_6, BIT_E_6, BIT_H_6, BIT_L_6, BIT_HL_6, BIT_A_6,
-        BIT_B_7, BIT_C_7, BIT_D_7, BIT_E_7, BIT_H_7, BIT_L_7, BIT_HL_7, BIT_A_7,
-        RES_B_0, RES_C_0, RES_D_0, RES_E_0, RES_H_0, RES_L_0, RES_HL_0, RES_A_0,
-        RES_B_1, RES_C_1, RES_D_1, RES_E_1, RES_H_1, RES_L_1, RES_HL_1, RES_A_1,
-        RES_B_2, RES_C_2, RES_D_2, RES_E_2, RES_H_2, RES_L_2, RES_HL_2, RES_A_2,
-        RES_B_3, RES_C_3, RES_D_3, RES_E_3, RES_H_3, RES_L_3, RES_HL_3, RES_A_3,
-        RES_B_4, RES_C_4, RES_D_4, RES_E_4, RES_H_4, RES_L_4, RES_HL_4, RES_A_4,
-        RES_B_5, RES_C_5, RES_D_5, RES_E_5, RES_H_5, RES_L_5, RES_HL_5, RES_A_5,
-        RES_B_6, RES_C_6, RES_D_6, RES_E_6, RES_H_6, RES_L_6, RES_HL_6, RES_A_6,
-        RES_B_7, RES_C_7, RES_D_7, RES_E_7, RES_H_7, RES_L_7, RES_HL_7, RES_A_7,
-        SET_B_0, SET_C_0, SET_D_0, SET_E_0, SET_H_0, SET_L_0, SET_HL_0, SET_A_0,
-        SET_B_1, SET_C_1, SET_D_1, SET_E_1, SET_H_1, SET_L_1, SET_HL_1, SET_A_1,
-        SET_B_2, SET_C_2, SET_D_2, SET_E_2, SET_H_2, SET_L_2, SET_HL_2, SET_A_2,
-        SET_B_3, SET_C_3, SET_D_3, SET_E_3, SET_H_3, SET_L_3, SET_HL_3, SET_A_3,
-        SET_B_4, SET_C_4, SET_D_4, SET_E_4, SET_H_4, SET_L_4, SET_HL_4, SET_A_4,
-        SET_B_5, SET_C_5, SET_D_5, SET_E_5, SET_H_5, SET_L_5, SET_HL_5, SET_A_5,
-        SET_B_6, SET_C_6, SET_D_6, SET_E_6, SET_H_6, SET_L_6, SET_HL_6, SET_A_6,
-        SET_B_7, SET_C_7, SET_D_7, SET_E_7, SET_H_7, SET_L_7, SET_HL_7, SET_A_7};
-    void (*opSetED[256])(Z80* ctx) = {
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        IN_B_C, OUT_C_B, SBC_HL_BC, LD_ADDR_RP_BC, NEG_, RETN_, IM0, LD_I_A_,
-        IN_C_C, OUT_C_C, ADC_HL_BC, LD_RP_ADDR_BC, nullptr, RETI_, nullptr, LD_R_A_,
-        IN_D_C, OUT_C_D, SBC_HL_DE, LD_ADDR_RP_DE, nullptr, nullptr, IM1, LD_A_I_,
-        IN_E_C, OUT_C_E, ADC_HL_DE, LD_RP_ADDR_DE, nullptr, nullptr, IM2, LD_A_R_,
-        IN_H_C, OUT_C_H, SBC_HL_HL, LD_ADDR_RP_HL, nullptr, nullptr, nullptr, RRD_,
-        IN_L_C, OUT_C_L, ADC_HL_HL, LD_RP_ADDR_HL, nullptr, nullptr, nullptr, RLD_,
-        IN_C, OUT_C_0, SBC_HL_SP, LD_ADDR_RP_SP, nullptr, nullptr, nullptr, nullptr,
-        IN_A_C, OUT_C_A, ADC_HL_SP, LD_RP_ADDR_SP, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        LDI, CPI, INI, OUTI, nullptr, nullptr, nullptr, nullptr,
-        LDD, CPD, IND, OUTD, nullptr, nullptr, nullptr, nullptr,
-        LDIR, CPIR, INIR, OUTIR, nullptr, nullptr, nullptr, nullptr,
-        LDDR, CPDR, INDR, OUTDR, nullptr, nullptr, nullptr, nullptr};
-    void (*opSetIX[256])(Z80* ctx) = {
-        nullptr, nullptr, nullptr, nullptr, INC_B_2, DEC_B_2, LD_B_N_3, nullptr,
-        nullptr, ADD_IX_BC, nullptr, nullptr, INC_C_2, DEC_C_2, LD_C_N_3, nullptr,
-        nullptr, nullptr, nullptr, nullptr, INC_D_2, DEC_D_2, LD_D_N_3, nullptr,
-        nullptr, ADD_IX_DE, nullptr, nullptr, INC_E_2, DEC_E_2, LD_E_N_3, nullptr,
-        nullptr, LD_IX_NN_, LD_ADDR_IX_, INC_IX_reg_, INC_IXH_, DEC_IXH_, LD_IXH_N_, nullptr,
-        nullptr, ADD_IX_IX, LD_IX_ADDR_, DEC_IX_reg_, INC_IXL_, DEC_IXL_, LD_IXL_N_, nullptr,
-        nullptr, nullptr, nullptr, nullptr, INC_IX_, DEC_IX_, LD_IX_N_, nullptr,
-        nullptr, ADD_IX_SP, nullptr, nullptr, INC_A_2, DEC_A_2, LD_A_N_3, nullptr,
-        LD_B_B_2, LD_B_C_2, LD_B_D_2, LD_B_E_2, LD_B_IXH, LD_B_IXL, LD_B_IX, LD_B_A_2,
-        LD_C_B_2, LD_C_C_2, LD_C_D_2, LD_C_E_2, LD_C_IXH, LD_C_IXL, LD_C_IX, LD_C_A_2,
-        LD_D_B_2, LD_D_C_2, LD_D_D_2, LD_D_E_2, LD_D_IXH, LD_D_IXL, LD_D_IX, LD_D_A_2,
-        LD_E_B_2, LD_E_C_2, LD_E_D_2, LD_E_E_2, LD_E_IXH, LD_E_IXL, LD_E_IX, LD_E_A_2,
-        LD_IXH_B, LD_IXH_C, LD_IXH_D, LD_IXH_E, LD_IXH_IXH_, LD_IXH_IXL_, LD_H_IX, LD_IXH_A,
-        LD_IXL_B, LD_IXL_C, LD_IXL_D, LD_IXL_E, LD_IXL_IXH_, LD_IXL_IXL_, LD_L_IX, LD_IXL_A,
-        LD_IX_B, LD_IX_C, LD_IX_D, LD_IX_E, LD_IX_H, LD_IX_L, nullptr, LD_IX_A,
-        LD_A_B_2, LD_A_C_2, LD_A_D_2, LD_A_E_2, LD_A_IXH, LD_A_IXL, LD_A_IX, LD_A_A_2,
-        ADD_B_2, ADD_C_2, ADD_D_2, ADD_E_2, ADD_IXH_, ADD_IXL_, ADD_IX_, ADD_A_2,
-        ADC_B_2, ADC_C_2, ADC_D_2, ADC_E_2, ADC_IXH_, ADC_IXL_, ADC_IX_, ADC_A_2,
-        SUB_B_2, SUB_C_2, SUB_D_2, SUB_E_2, SUB_IXH_, SUB_IXL_, SUB_IX_, SUB_A_2,
-        SBC_B_2, SBC_C_2, SBC_D_2, SBC_E_2, SBC_IXH_, SBC_IXL_, SBC_IX_, SBC_A_2,
-        AND_B_2, AND_C_2, AND_D_2, AND_E_2, AND_IXH_, AND_IXL_, AND_IX_, AND_A_2,
-        XOR_B_2, XOR_C_2, XOR_D_2, XOR_E_2, XOR_IXH_, XOR_IXL_, XOR_IX_, XOR_A_2,
-        OR_B_2, OR_C_2, OR_D_2, OR_E_2, OR_IXH_, OR_IXL_, OR_IX_, OR_A_2,
-        CP_B_2, CP_C_2, CP_D_2, CP_E_2, CP_IXH_, CP_IXL_, CP_IX_, CP_A_2,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, OP_IX4, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, POP_IX_, nullptr, EX_SP_IX_, nullptr, PUSH_IX_, nullptr, nullptr,
-        nullptr, JP_IX, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, LD_SP_IX_, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
-    void (*opSetIY[256])(Z80* ctx) = {
-        nullptr, nullptr, nullptr, nullptr, INC_B_2, DEC_B_2, LD_B_N_3, nullptr,
-        nullptr, ADD_IY_BC, nullptr, nullptr, INC_C_2, DEC_C_2, LD_C_N_3, nullptr,
-        nullptr, nullptr, nullptr, nullptr, INC_D_2, DEC_D_2, LD_D_N_3, nullptr,
-        nullptr, ADD_IY_DE, nullptr, nullptr, INC_E_2, DEC_E_2, LD_E_N_3, nullptr,
-        nullptr, LD_IY_NN_, LD_ADDR_IY_, INC_IY_reg_, INC_IYH_, DEC_IYH_, LD_IYH_N_, nullptr,
-        nullptr, ADD_IY_IY, LD_IY_ADDR_, DEC_IY_reg_, INC_IYL_, DEC_IYL_, LD_IYL_N_, nullptr,
-        nullptr, nullptr, nullptr, nullptr, INC_IY_, DEC_IY_, LD_IY_N_, nullptr,
-        nullptr, ADD_IY_SP, nullptr, nullptr, INC_A_2, DEC_A_2, LD_A_N_3, nullptr,
-        LD_B_B_2, LD_B_C_2, LD_B_D_2, LD_B_E_2, LD_B_IYH, LD_B_IYL, LD_B_IY, LD_B_A_2,
-        LD_C_B_2, LD_C_C_2, LD_C_D_2, LD_C_E_2, LD_C_IYH, LD_C_IYL, LD_C_IY, LD_C_A_2,
-        LD_D_B_2, LD_D_C_2, LD_D_D_2, LD_D_E_2, LD_D_IYH, LD_D_IYL, LD_D_IY, LD_D_A_2,
-        LD_E_B_2, LD_E_C_2, LD_E_D_2, LD_E_E_2, LD_E_IYH, LD_E_IYL, LD_E_IY, LD_E_A_2,
-        LD_IYH_B, LD_IYH_C, LD_IYH_D, LD_IYH_E, LD_IYH_IYH_, LD_IYH_IYL_, LD_H_IY, LD_IYH_A,
-        LD_IYL_B, LD_IYL_C, LD_IYL_D, LD_IYL_E, LD_IYL_IYH_, LD_IYL_IYL_, LD_L_IY, LD_IYL_A,
-        LD_IY_B, LD_IY_C, LD_IY_D, LD_IY_E, LD_IY_H, LD_IY_L, nullptr, LD_IY_A,
-        LD_A_B_2, LD_A_C_2, LD_A_D_2, LD_A_E_2, LD_A_IYH, LD_A_IYL, LD_A_IY, LD_A_A_2,
-        ADD_B_2, ADD_C_2, ADD_D_2, ADD_E_2, ADD_IYH_, ADD_IYL_, ADD_IY_, ADD_A_2,
-        ADC_B_2, ADC_C_2, ADC_D_2, ADC_E_2, ADC_IYH_, ADC_IYL_, ADC_IY_, ADC_A_2,
-        SUB_B_2, SUB_C_2, SUB_D_2, SUB_E_2, SUB_IYH_, SUB_IYL_, SUB_IY_, SUB_A_2,
-        SBC_B_2, SBC_C_2, SBC_D_2, SBC_E_2, SBC_IYH_, SBC_IYL_, SBC_IY_, SBC_A_2,
-        AND_B_2, AND_C_2, AND_D_2, AND_E_2, AND_IYH_, AND_IYL_, AND_IY_, AND_A_2,
-        XOR_B_2, XOR_C_2, XOR_D_2, XOR_E_2, XOR_IYH_, XOR_IYL_, XOR_IY_, XOR_A_2,
-        OR_B_2, OR_C_2, OR_D_2, OR_E_2, OR_IYH_, OR_IYL_, OR_IY_, OR_A_2,
-        CP_B_2, CP_C_2, CP_D_2, CP_E_2, CP_IYH_, CP_IYL_, CP_IY_, CP_A_2,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, OP_IY4, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, POP_IY_, nullptr, EX_SP_IY_, nullptr, PUSH_IY_, nullptr, nullptr,
-        nullptr, JP_IY, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, LD_SP_IY_, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
-    void (*opSetIX4[256])(Z80* ctx, signed char d) = {
-        RLC_IX_with_LD_B, RLC_IX_with_LD_C, RLC_IX_with_LD_D, RLC_IX_with_LD_E, RLC_IX_with_LD_H, RLC_IX_with_LD_L, RLC_IX_, RLC_IX_with_LD_A,
-        RRC_IX_with_LD_B, RRC_IX_with_LD_C, RRC_IX_with_LD_D, RRC_IX_with_LD_E, RRC_IX_with_LD_H, RRC_IX_with_LD_L, RRC_IX_, RRC_IX_with_LD_A,
-        RL_IX_with_LD_B, RL_IX_with_LD_C, RL_IX_with_LD_D, RL_IX_with_LD_E, RL_IX_with_LD_H, RL_IX_with_LD_L, RL_IX_, RL_IX_with_LD_A,
-        RR_IX_with_LD_B, RR_IX_with_LD_C, RR_IX_with_LD_D, RR_IX_with_LD_E, RR_IX_with_LD_H, RR_IX_with_LD_L, RR_IX_, RR_IX_with_LD_A,
-        SLA_IX_with_LD_B, SLA_IX_with_LD_C, SLA_IX_with_LD_D, SLA_IX_with_LD_E, SLA_IX_with_LD_H, SLA_IX_with_LD_L, SLA_IX_, SLA_IX_with_LD_A,
-        SRA_IX_with_LD_B, SRA_IX_with_LD_C, SRA_IX_with_LD_D, SRA_IX_with_LD_E, SRA_IX_with_LD_H, SRA_IX_with_LD_L, SRA_IX_, SRA_IX_with_LD_A,
-        SLL_IX_with_LD_B, SLL_IX_with_LD_C, SLL_IX_with_LD_D, SLL_IX_with_LD_E, SLL_IX_with_LD_H, SLL_IX_with_LD_L, SLL_IX_, SLL_IX_with_LD_A,
-        SRL_IX_with_LD_B, SRL_IX_with_LD_C, SRL_IX_with_LD_D, SRL_IX_with_LD_E, SRL_IX_with_LD_H, SRL_IX_with_LD_L, SRL_IX_, SRL_IX_with_LD_A,
-        BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0, BIT_IX_0,
-        BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1, BIT_IX_1,
-        BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2, BIT_IX_2,
-        BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3, BIT_IX_3,
-        BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4, BIT_IX_4,
-        BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5, BIT_IX_5,
-        BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6, BIT_IX_6,
-        BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7, BIT_IX_7,
-        RES_IX_0_with_LD_B, RES_IX_0_with_LD_C, RES_IX_0_with_LD_D, RES_IX_0_with_LD_E, RES_IX_0_with_LD_H, RES_IX_0_with_LD_L, RES_IX_0, RES_IX_0_with_LD_A,
-        RES_IX_1_with_LD_B, RES_IX_1_with_LD_C, RES_IX_1_with_LD_D, RES_IX_1_with_LD_E, RES_IX_1_with_LD_H, RES_IX_1_with_LD_L, RES_IX_1, RES_IX_1_with_LD_A,
-        RES_IX_2_with_LD_B, RES_IX_2_with_LD_C, RES_IX_2_with_LD_D, RES_IX_2_with_LD_E, RES_IX_2_with_LD_H, RES_IX_2_with_LD_L, RES_IX_2, RES_IX_2_with_LD_A,
-        RES_IX_3_with_LD_B, RES_IX_3_with_LD_C, RES_IX_3_with_LD_D, RES_IX_3_with_LD_E, RES_IX_3_with_LD_H, RES_IX_3_with_LD_L, RES_IX_3, RES_IX_3_with_LD_A,
-        RES_IX_4_with_LD_B, RES_IX_4_with_LD_C, RES_IX_4_with_LD_D, RES_IX_4_with_LD_E, RES_IX_4_with_LD_H, RES_IX_4_with_LD_L, RES_IX_4, RES_IX_4_with_LD_A,
-        RES_IX_5_with_LD_B, RES_IX_5_with_LD_C, RES_IX_5_with_LD_D, RES_IX_5_with_LD_E, RES_IX_5_with_LD_H, RES_IX_5_with_LD_L, RES_IX_5, RES_IX_5_with_LD_A,
-        RES_IX_6_with_LD_B, RES_IX_6_with_LD_C, RES_IX_6_with_LD_D, RES_IX_6_with_LD_E, RES_IX_6_with_LD_H, RES_IX_6_with_LD_L, RES_IX_6, RES_IX_6_with_LD_A,
-        RES_IX_7_with_LD_B, RES_IX_7_with_LD_C, RES_IX_7_with_LD_D, RES_IX_7_with_LD_E, RES_IX_7_with_LD_H, RES_IX_7_with_LD_L, RES_IX_7, RES_IX_7_with_LD_A,
-        SET_IX_0_with_LD_B, SET_IX_0_with_LD_C, SET_IX_0_with_LD_D, SET_IX_0_with_LD_E, SET_IX_0_with_LD_H, SET_IX_0_with_LD_L, SET_IX_0, SET_IX_0_with_LD_A,
-        SET_IX_1_with_LD_B, SET_IX_1_with_LD_C, SET_IX_1_with_LD_D, SET_IX_1_with_LD_E, SET_IX_1_with_LD_H, SET_IX_1_with_LD_L, SET_IX_1, SET_IX_1_with_LD_A,
-        SET_IX_2_with_LD_B, SET_IX_2_with_LD_C, SET_IX_2_with_LD_D, SET_IX_2_with_LD_E, SET_IX_2_with_LD_H, SET_IX_2_with_LD_L, SET_IX_2, SET_IX_2_with_LD_A,
-        SET_IX_3_with_LD_B, SET_IX_3_with_LD_C, SET_IX_3_with_LD_D, SET_IX_3_with_LD_E, SET_IX_3_with_LD_H, SET_IX_3_with_LD_L, SET_IX_3, SET_IX_3_with_LD_A,
-        SET_IX_4_with_LD_B, SET_IX_4_with_LD_C, SET_IX_4_with_LD_D, SET_IX_4_with_LD_E, SET_IX_4_with_LD_H, SET_IX_4_with_LD_L, SET_IX_4, SET_IX_4_with_LD_A,
-        SET_IX_5_with_LD_B, SET_IX_5_with_LD_C, SET_IX_5_with_LD_D, SET_IX_5_with_LD_E, SET_IX_5_with_LD_H, SET_IX_5_with_LD_L, SET_IX_5, SET_IX_5_with_LD_A,
-        SET_IX_6_with_LD_B, SET_IX_6_with_LD_C, SET_IX_6_with_LD_D, SET_IX_6_with_LD_E, SET_IX_6_with_LD_H, SET_IX_6_with_LD_L, SET_IX_6, SET_IX_6_with_LD_A,
-        SET_IX_7_with_LD_B, SET_IX_7_with_LD_C, SET_IX_7_with_LD_D, SET_IX_7_with_LD_E, SET_IX_7_with_LD_H, SET_IX_7_with_LD_L, SET_IX_7, SET_IX_7_with_LD_A};
-    void (*opSetIY4[256])(Z80* ctx, signed char d) = {
-        RLC_IY_with_LD_B, RLC_IY_with_LD_C, RLC_IY_with_LD_D, RLC_IY_with_LD_E, RLC_IY_with_LD_H, RLC_IY_with_LD_L, RLC_IY_, RLC_IY_with_LD_A,
-        RRC_IY_with_LD_B, RRC_IY_with_LD_C, RRC_IY_with_LD_D, RRC_IY_with_LD_E, RRC_IY_with_LD_H, RRC_IY_with_LD_L, RRC_IY_, RRC_IY_with_LD_A,
-        RL_IY_with_LD_B, RL_IY_with_LD_C, RL_IY_with_LD_D, RL_IY_with_LD_E, RL_IY_with_LD_H, RL_IY_with_LD_L, RL_IY_, RL_IY_with_LD_A,
-        RR_IY_with_LD_B, RR_IY_with_LD_C, RR_IY_with_LD_D, RR_IY_with_LD_E, RR_IY_with_LD_H, RR_IY_with_LD_L, RR_IY_, RR_IY_with_LD_A,
-        SLA_IY_with_LD_B, SLA_IY_with_LD_C, SLA_IY_with_LD_D, SLA_IY_with_LD_E, SLA_IY_with_LD_H, SLA_IY_with_LD_L, SLA_IY_, SLA_IY_with_LD_A,
-        SRA_IY_with_LD_B, SRA_IY_with_LD_C, SRA_IY_with_LD_D, SRA_IY_with_LD_E, SRA_IY_with_LD_H, SRA_IY_with_LD_L, SRA_IY_, SRA_IY_with_LD_A,
-        SLL_IY_with_LD_B, SLL_IY_with_LD_C, SLL_IY_with_LD_D, SLL_IY_with_LD_E, SLL_IY_with_LD_H, SLL_IY_with_LD_L, SLL_IY_, SLL_IY_with_LD_A,
-        SRL_IY_with_LD_B, SRL_IY_with_LD_C, SRL_IY_with_LD_D, SRL_IY_with_LD_E, SRL_IY_with_LD_H, SRL_IY_with_LD_L, SRL_IY_, SRL_IY_with_LD_A,
-        BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0, BIT_IY_0,
-        BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1, BIT_IY_1,
-        BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2, BIT_IY_2,
-        BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3, BIT_IY_3,
-        BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4, BIT_IY_4,
-        BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5, BIT_IY_5,
-        BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6, BIT_IY_6,
-        BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7, BIT_IY_7,
-        RES_IY_0_with_LD_B, RES_IY_0_with_LD_C, RES_IY_0_with_LD_D, RES_IY_0_with_LD_E, RES_IY_0_with_LD_H, RES_IY_0_with_LD_L, RES_IY_0, RES_IY_0_with_LD_A,
-        RES_IY_1_with_LD_B, RES_IY_1_with_LD_C, RES_IY_1_with_LD_D, RES_IY_1_with_LD_E, RES_IY_1_with_LD_H, RES_IY_1_with_LD_L, RES_IY_1, RES_IY_1_with_LD_A,
-        RES_IY_2_with_LD_B, RES_IY_2_with_LD_C, RES_IY_2_with_LD_D, RES_IY_2_with_LD_E, RES_IY_2_with_LD_H, RES_IY_2_with_LD_L, RES_IY_2, RES_IY_2_with_LD_A,
-        RES_IY_3_with_LD_B, RES_IY_3_with_LD_C, RES_IY_3_with_LD_D, RES_IY_3_with_LD_E, RES_IY_3_with_LD_H, RES_IY_3_with_LD_L, RES_IY_3, RES_IY_3_with_LD_A,
-        RES_IY_4_with_LD_B, RES_IY_4_with_LD_C, RES_IY_4_with_LD_D, RES_IY_4_with_LD_E, RES_IY_4_with_LD_H, RES_IY_4_with_LD_L, RES_IY_4, RES_IY_4_with_LD_A,
-        RES_IY_5_with_LD_B, RES_IY_5_with_LD_C, RES_IY_5_with_LD_D, RES_IY_5_with_LD_E, RES_IY_5_with_LD_H, RES_IY_5_with_LD_L, RES_IY_5, RES_IY_5_with_LD_A,
-        RES_IY_6_with_LD_B, RES_IY_6_with_LD_C, RES_IY_6_with_LD_D, RES_IY_6_with_LD_E, RES_IY_6_with_LD_H, RES_IY_6_with_LD_L, RES_IY_6, RES_IY_6_with_LD_A,
-        RES_IY_7_with_LD_B, RES_IY_7_with_LD_C, RES_IY_7_with_LD_D, RES_IY_7_with_LD_E, RES_IY_7_with_LD_H, RES_IY_7_with_LD_L, RES_IY_7, RES_IY_7_with_LD_A,
-        SET_IY_0_with_LD_B, SET_IY_0_with_LD_C, SET_IY_0_with_LD_D, SET_IY_0_with_LD_E, SET_IY_0_with_LD_H, SET_IY_0_with_LD_L, SET_IY_0, SET_IY_0_with_LD_A,
-        SET_IY_1_with_LD_B, SET_IY_1_with_LD_C, SET_IY_1_with_LD_D, SET_IY_1_with_LD_E, SET_IY_1_with_LD_H, SET_IY_1_with_LD_L, SET_IY_1, SET_IY_1_with_LD_A,
-        SET_IY_2_with_LD_B, SET_IY_2_with_LD_C, SET_IY_2_with_LD_D, SET_IY_2_with_LD_E, SET_IY_2_with_LD_H, SET_IY_2_with_LD_L, SET_IY_2, SET_IY_2_with_LD_A,
-        SET_IY_3_with_LD_B, SET_IY_3_with_LD_C, SET_IY_3_with_LD_D, SET_IY_3_with_LD_E, SET_IY_3_with_LD_H, SET_IY_3_with_LD_L, SET_IY_3, SET_IY_3_with_LD_A,
-        SET_IY_4_with_LD_B, SET_IY_4_with_LD_C, SET_IY_4_with_LD_D, SET_IY_4_with_LD_E, SET_IY_4_with_LD_H, SET_IY_4_with_LD_L, SET_IY_4, SET_IY_4_with_LD_A,
-        SET_IY_5_with_LD_B, SET_IY_5_with_LD_C, SET_IY_5_with_LD_D, SET_IY_5_with_LD_E, SET_IY_5_with_LD_H, SET_IY_5_with_LD_L, SET_IY_5, SET_IY_5_with_LD_A,
-        SET_IY_6_with_LD_B, SET_IY_6_with_LD_C, SET_IY_6_with_LD_D, SET_IY_6_with_LD_E, SET_IY_6_with_LD_H, SET_IY_6_with_LD_L, SET_IY_6, SET_IY_6_with_LD_A,
-        SET_IY_7_with_LD_B, SET_IY_7_with_LD_C, SET_IY_7_with_LD_D, SET_IY_7_with_LD_E, SET_IY_7_with_LD_H, SET_IY_7_with_LD_L, SET_IY_7, SET_IY_7_with_LD_A};
+    {
+        addBreakOperand(0, operandNumber, callback);
+    }
 
-    inline void checkInterrupt()
+#ifdef Z80_NO_FUNCTIONAL
+    void addBreakOperand(int prefixNumber, int operandNumber, void (*callback)(void*, unsigned char*, int))
+#else
+    void addBreakOperand(int prefixNumber, int operandNumber, std::function<void(void*, unsigned char*, int)> callback)
+#endif
     {
-        // Interrupt processing is not executed by the instruction immediately after executing EI.
-        if (reg.execEI) {
-            return;
+        int table = getPrefixTable(prefixNumber);
+        if (table < 0) return; // the prefix that never be fetched
+        auto& breakOperands = getHooks()->breakOperands[table][operandNumber & 0xFF];
+        if (!breakOperands) {
+            breakOperands = new std::vector<BreakOperand*>();
         }
-        // check interrupt flag
-        if (reg.interrupt & 0b10000000) {
-            // execute NMI
-            if (reg.IFF & IFF_NMI()) {
-                return;
+        breakOperands->push_back(new BreakOperand(prefixNumber, (unsigned char)operandNumber, callback));
+    }
+
+#ifdef Z80_NO_FUNCTIONAL
+    void addBreakOperand(unsigned char prefixNumber1, unsigned char prefixNumber2, unsigned char operandNumber, void (*callback)(void*, unsigned char*, int))
+#else
+    void addBreakOperand(unsigned char prefixNumber1, unsigned char prefixNumber2, unsigned char operandNumber, std::function<void(void*, unsigned char*, int)> callback)
+#endif
+    {
+        int n = make16BitsFromLE(prefixNumber2, prefixNumber1);
+        int prefixNumber = n;
+        n <<= 8;
+        n |= operandNumber;
+        addBreakOperand(prefixNumber, n, callback);
+    }
+
+    void removeBreakOperand(int operandNumber)
+    {
+        int table = getPrefixTable(operandNumber >> 8);
+        if (table < 0 || !CB.hooks) return;
+        auto& breakOperands = CB.hooks->breakOperands[table][operandNumber & 0xFF];
+        if (!breakOperands) return;
+        for (auto bo : *breakOperands) delete bo;
+        delete breakOperands;
+        breakOperands = nullptr;
+    }
+
+    void removeBreakOperand(unsigned char prefixNumber, unsigned char operandNumber)
+    {
+        removeBreakOperand(make16BitsFromLE(operandNumber, prefixNumber));
+    }
+
+    void removeBreakOperand(unsigned char prefixNumber1, unsigned char prefixNumber2, unsigned char operandNumber)
+    {
+        int n = make16BitsFromLE(prefixNumber2, prefixNumber1);
+        n <<= 8;
+        n |= operandNumber;
+        removeBreakOperand(n);
+    }
+
+    void removeAllBreakOperands()
+    {
+        if (!CB.hooks) return;
+        for (int i = 0; i < 7; i++) {
+            for (int j = 0; j < 256; j++) {
+                if (!CB.hooks->breakOperands[i][j]) continue;
+                for (auto bo : *CB.hooks->breakOperands[i][j]) delete bo;
+                delete CB.hooks->breakOperands[i][j];
+                CB.hooks->breakOperands[i][j] = nullptr;
             }
-            reg.interrupt &= 0b01111111;
-            reg.IFF &= ~IFF_HALT();
-#ifndef Z80_DISABLE_DEBUG
-            if (isDebug()) log("EXECUTE NMI: $%04X", reg.interruptAddrN);
+        }
+    }
 #endif
-            reg.R = ((reg.R + 1) & 0x7F) | (reg.R & 0x80);
-            reg.IFF |= IFF_NMI();
-            reg.IFF &= ~IFF1();
-            push(getPCH(), 4);
-            push(getPCL(), 4);
-            reg.PC = reg.interruptAddrN;
-            consumeClock(11);
+
 #ifndef Z80_DISABLE_NESTCHECK
-            invokeCallHandlers();
+#ifdef Z80_NO_FUNCTIONAL
+    void addReturnHandler(void (*callback)(void*))
+#else
+    void addReturnHandler(std::function<void(void*)> callback)
 #endif
-        } else if (reg.interrupt & 0b01000000) {
-            // execute IRQ
-            if (!(reg.IFF & IFF1())) {
-                return;
+    {
+        CB.returnHandlers.push_back(new SimpleHandler(callback));
+    }
+
+    void removeAllReturnHandlers()
+    {
+        for (auto handler : CB.returnHandlers) delete handler;
+        CB.returnHandlers.clear();
+    }
+
+#ifdef Z80_NO_FUNCTIONAL
+    void addCallHandler(void (*callback)(void*))
+#else
+    void addCallHandler(std::function<void(void*)> callback)
+#endif
+    {
+        CB.callHandlers.push_back(new SimpleHandler(callback));
+    }
+
+    void removeAllCallHandlers()
+    {
+        for (auto handler : CB.callHandlers) delete handler;
+        CB.callHandlers.clear();
+    }
+
+    // maintain the shadow call stack on CALL, RST, interrupts and returns (the statistics are cleared)
+    void enableCallGraph()
+    {
+        callGraph.enabled = true;
+        clearCallGraph();
+    }
+
+    void disableCallGraph()
+    {
+        callGraph.enabled = false;
+        callGraph.nodes.clear();
+        callGraph.frames.clear();
+    }
+
+    // NOTE: the current frames are forgotten (the returns from them are ignored)
+    void clearCallGraph()
+    {
+        if (!callGraph.enabled) return;
+        CallGraphNode root;
+        root.addr = reg.PC;
+        root.parent = -1;
+        root.firstChild = -1;
+        root.nextSibling = -1;
+        root.calls = 0;
+        root.inclusive = 0;
+        root.exclusive = 0;
+        callGraph.nodes.clear();
+        callGraph.nodes.push_back(root);
+        CallGraphFrame frame;
+        frame.node = 0;
+        frame.sp = 0;
+        frame.start = getTotalClocks();
+        frame.children = 0;
+        callGraph.frames.clear();
+        callGraph.frames.push_back(frame);
+    }
+
+    bool isCallGraphEnabled() { return callGraph.enabled; }
+
+    // number of the frames in the shadow call stack (0: not in any call)
+    int getCallGraphDepth() { return callGraph.frames.empty() ? 0 : (int)callGraph.frames.size() - 1; }
+
+    // get the callees in descending order of the clocks (byInclusive = false: by the exclusive clocks)
+    int getCallGraphTop(CallGraphEntry* entries, int max, bool byInclusive = true)
+    {
+        if (!callGraph.enabled || max < 1) return 0;
+        std::vector<unsigned long long> inclusive;
+        std::vector<unsigned long long> exclusive;
+        getCallGraphClocks(inclusive, exclusive);
+        std::vector<CallGraphEntry> callees;
+        for (size_t i = 1; i < callGraph.nodes.size(); i++) {
+            auto& node = callGraph.nodes[i];
+            // the inclusive clocks of the recursive calls are counted at the outermost call
+            bool recursive = false;
+            for (int parent = node.parent; 0 < parent && !recursive; parent = callGraph.nodes[(size_t)parent].parent) {
+                recursive = callGraph.nodes[(size_t)parent].addr == node.addr;
             }
-            reg.interrupt &= 0b10111111;
-            reg.IFF &= ~IFF_HALT();
-            reg.IFF |= IFF_IRQ();
-            reg.IFF &= ~(IFF1() | IFF2());
-            reg.R = ((reg.R + 1) & 0x7F) | (reg.R & 0x80);
-            switch (reg.interrupt & 0b00000011) {
-                case 0: // mode 0
-#ifndef Z80_DISABLE_DEBUG
-                    if (isDebug()) log("EXECUTE INT MODE1 (RST TO $%04X)", reg.interruptVector * 8);
+            size_t index = 0;
+            while (index < callees.size() && callees[index].addr != node.addr) index++;
+            if (index == callees.size()) {
+                CallGraphEntry entry;
+                entry.addr = node.addr;
+                entry.calls = 0;
+                entry.inclusive = 0;
+                entry.exclusive = 0;
+                callees.push_back(entry);
+            }
+            callees[index].calls += node.calls;
+            callees[index].exclusive += exclusive[i];
+            if (!recursive) callees[index].inclusive += inclusive[i];
+        }
+        int n = 0;
+        for (auto& callee : callees) {
+            unsigned long long value = byInclusive ? callee.inclusive : callee.exclusive;
+            if (n == max && value <= (byInclusive ? entries[n - 1].inclusive : entries[n - 1].exclusive)) continue;
+            int i = n < max ? n++ : n - 1;
+            for (; 0 < i && (byInclusive ? entries[i - 1].inclusive : entries[i - 1].exclusive) < value; i--) {
+                entries[i] = entries[i - 1];
+            }
+            entries[i] = callee;
+        }
+        return n;
+    }
+
+    // write the exclusive clocks per call stack in the folded format of flame graph (e.g. "$0000;$1234;$5678 120")
+    int exportCallGraph(FILE* fp)
+    {
+        if (!callGraph.enabled) return 0;
+        std::vector<unsigned long long> inclusive;
+        std::vector<unsigned long long> exclusive;
+        getCallGraphClocks(inclusive, exclusive);
+        int lines = 0;
+        std::vector<unsigned short> path;
+        for (size_t i = 0; i < callGraph.nodes.size(); i++) {
+            if (!exclusive[i]) continue;
+            path.clear();
+            for (int node = (int)i; -1 != node; node = callGraph.nodes[(size_t)node].parent) {
+                path.push_back(callGraph.nodes[(size_t)node].addr);
+            }
+            for (size_t j = path.size(); 0 < j; j--) {
+                fprintf(fp, j == path.size() ? "$%04X" : ";$%04X", path[j - 1]);
+            }
+            fprintf(fp, " %llu\n", exclusive[i]);
+            lines++;
+        }
+        return lines;
+    }
 #endif
-                    if (reg.interruptVector == 0xCD) {
-                        consumeClock(7);
-                    }
-                    RST(reg.interruptVector, false);
-                    break;
-                case 1: // mode 1 (13Hz)
-#ifndef Z80_DISABLE_DEBUG
-                    if (isDebug()) log("EXECUTE INT MODE1 (RST TO $0038)");
+
+#ifdef Z80_NO_FUNCTIONAL
+    void setConsumeClockCallback(void (*consumeClock_)(void* arg, int clocks))
+#else
+    void setConsumeClockCallback(std::function<void(void* arg, int clocks)> consumeClock_)
 #endif
-                    consumeClock(1);
-                    RST(7, false);
-                    break;
-                case 2: { // mode 2
-                    writeByte(reg.SP - 1, getPCH());
-                    writeByte(reg.SP - 2, getPCL());
-                    reg.SP -= 2;
-                    unsigned short addr = make16BitsFromLE(reg.interruptVector, reg.I);
-                    unsigned short pc = make16BitsFromLE(readByte(addr), readByte(addr + 1));
-#ifndef Z80_DISABLE_DEBUG
-                    if (isDebug()) log("EXECUTE INT MODE2: ($%04X) = $%04X", addr, pc);
+    {
+        CB.consumeClockEnabled = true;
+        CB.consumeClock = consumeClock_;
+    }
+
+    void resetConsumeClockCallback()
+    {
+        CB.consumeClockEnabled = false;
+#ifdef Z80_NO_FUNCTIONAL
+        CB.consumeClock = nullptr;
 #endif
-                    reg.PC = pc;
-                    consumeClock(3);
-#ifndef Z80_DISABLE_NESTCHECK
-                    invokeCallHandlers();
+    }
+
+#ifdef Z80_NO_FUNCTIONAL
+    void setFetchCallback(unsigned char (*fetch_)(void* arg, unsigned short addr))
+#else
+    void setFetchCallback(std::function<unsigned char(void* arg, unsigned short addr)> fetch_)
 #endif
-                    break;
-                }
-            }
-        }
+    {
+        CB.fetchEnabled = true;
+        CB.fetch = fetch_;
+        updateBusHooked();
     }
 
-    inline void updateRefreshRegister()
+    void resetFetchCallback()
     {
-        reg.R = ((reg.R + 1) & 0x7F) | (reg.R & 0x80);
-        consumeClock(2);
+        CB.fetchEnabled = false;
+#ifdef Z80_NO_FUNCTIONAL
+        CB.fetch = nullptr;
+#endif
+        updateBusHooked();
     }
 
-  public: // API functions
+    // read the memory without the side effects (e.g. the memory-mapped I/O) for disassemble, the break conditions and the break operands
 #ifdef Z80_NO_FUNCTIONAL
-    Z80(unsigned char (*read)(void* arg, unsigned short addr),
-        void (*write)(void* arg, unsigned short addr, unsigned char value),
-        unsigned char (*in)(void* arg, unsigned short port),
-        void (*out)(void* arg, unsigned short port, unsigned char value),
-        void* arg,
-        bool returnPortAs16Bits = false)
+    void setPeekCallback(unsigned char (*peek_)(void* arg, unsigned short addr))
 #else
-    Z80(std::function<unsigned char(void*, unsigned short)> read,
-        std::function<void(void*, unsigned short, unsigned char)> write,
-        std::function<unsigned char(void*, unsigned short)> in,
-        std::function<void(void*, unsigned short, unsigned char)> out,
-        void* arg,
-        bool returnPortAs16Bits = false)
+    void setPeekCallback(std::function<unsigned char(void* arg, unsigned short addr)> peek_)
 #endif
     {
-        this->CB.arg = arg;
-        initialize();
-        setupCallback(read, write, in, out, returnPortAs16Bits);
+        CB.peekEnabled = true;
+        CB.peek = peek_;
     }
 
-    // without setup callbacks
-    Z80(void* arg)
+    void resetPeekCallback()
     {
-        this->CB.arg = arg;
-        initialize();
+        CB.peekEnabled = false;
+#ifdef Z80_NO_FUNCTIONAL
+        CB.peek = nullptr;
+#endif
+    }
+
+    void mapCodePages(unsigned short addr, int size, unsigned char* memory)
+    {
+        if (!memory && !CB.hooks) return; // nothing is mapped
+        HookTables* hooks = getHooks();
+        for (int offset = 0; offset < size && addr + offset < 0x10000; offset += 0x100) {
+            hooks->codePages[(addr + offset) >> 8] = memory ? memory + offset : nullptr;
+        }
+        updateBusHooked();
+    }
+
+    void unmapCodePages(unsigned short addr, int size)
+    {
+        mapCodePages(addr, size, nullptr);
+    }
+
+    unsigned long long getTotalClocks()
+    {
+        return totalClocks + reg.consumeClockCounter; // the clocks of the executing instruction are added at the boundary
+    }
+
+    // the callbacks suppressed in the speculative mode (the flags of setSpeculative)
+    static const int speculativeOut = 0b01;   // out callback
+    static const int speculativeClock = 0b10; // consumeClock callback
+
+    /**
+     * Speculative mode (e.g., for run-ahead): the debug messages, the debug events, the trace and the timeline are suppressed.
+     * suppress: the callbacks to be suppressed additionally (speculativeOut and/or speculativeClock)
+     * NOTE: the other callbacks are called as usual to drive the devices of the speculative instance (check isSpeculative in them if needed)
+     */
+    void setSpeculative(bool speculative_, int suppress = 0)
+    {
+        speculative = speculative_;
+        suppressOut = speculative_ && (suppress & speculativeOut);
+        suppressClock = speculative_ && (suppress & speculativeClock);
+    }
+
+    bool isSpeculative()
+    {
+        return speculative;
+    }
+
+    // number of the executed instructions since initialize (the HALT cycle is also counted as an instruction)
+    unsigned long long getInstructionCount()
+    {
+        return instructionCount;
+    }
+
+#ifndef Z80_DISABLE_CONTENTION
+    void setupContention(const unsigned char* delayTable, int frameClocks)
+    {
+        contention.table = 0 < frameClocks ? delayTable : nullptr;
+        contention.frameClocks = frameClocks;
+        contention.frameStart = getTotalClocks();
+        updateBusHooked();
+    }
+
+    void resetContention()
+    {
+        contention = Contention();
+        updateBusHooked();
+    }
+
+    void setContendedMemory(unsigned short addr, int size, bool contended)
+    {
+        for (int offset = 0; offset < size && addr + offset < 0x10000; offset += 0x100) {
+            contention.memoryPages[(addr + offset) >> 8] = contended;
+        }
+    }
+
+    void setContendedPorts(unsigned short port, int size, bool contended)
+    {
+        for (int offset = 0; offset < size && port + offset < 0x10000; offset += 0x100) {
+            contention.portPages[(port + offset) >> 8] = contended;
+        }
+    }
+
+    void setContentionFrameClock(int frameClock)
+    {
+        contention.frameStart = getTotalClocks() - (unsigned int)frameClock;
+    }
+
+    int getContentionFrameClock()
+    {
+        if (!contention.table) return 0;
+        return (int)((getTotalClocks() - contention.frameStart) % (unsigned int)contention.frameClocks);
+    }
+#endif
+
+#ifndef Z80_DISABLE_BUSLOG
+    void enableBusLog(int capacity)
+    {
+        disableBusLog();
+        if (capacity < 1) return;
+        busLog.events = new BusEvent[capacity];
+        busLog.capacity = capacity;
+        updateBusHooked();
+    }
+
+    void disableBusLog()
+    {
+        if (busLog.events) delete[] busLog.events;
+        busLog.events = nullptr;
+        busLog.capacity = 0;
+        clearBusLog();
+        updateBusHooked();
+    }
+
+    void clearBusLog()
+    {
+        busLog.head = 0;
+        busLog.count = 0;
+        busLog.lost = 0;
+    }
+
+    int getBusLogCount() { return busLog.count; }
+    unsigned long long getBusLogLost() { return busLog.lost; }
+
+    // NOTE: the bus log is not thread-safe, call the methods below on the thread of execute (between the executions)
+    // copy the bus events (oldest first) without removing them
+    int snapshotBusLog(BusEvent* events, int max)
+    {
+        int n = busLog.count < max ? busLog.count : max;
+        int tail = busLog.head - busLog.count;
+        if (tail < 0) tail += busLog.capacity;
+        for (int i = 0; i < n; i++) {
+            events[i] = busLog.events[tail];
+            if (++tail == busLog.capacity) tail = 0;
+        }
+        return n;
+    }
+
+    // copy and remove the bus events (oldest first)
+    int drainBusLog(BusEvent* events, int max)
+    {
+        int n = snapshotBusLog(events, max);
+        busLog.count -= n;
+        return n;
+    }
+#endif
+
+#ifndef Z80_DISABLE_TRACE
+    // record the registers and the opcode bytes of each instruction in the binary trace records
+    //   fp == nullptr: ring buffer (the oldest records are overwritten)
+    //   fp != nullptr: the records are written to the stream (fwrite) when the buffer is full, and at flushTrace or disableTrace
+    void enableTrace(int capacity, FILE* fp = nullptr)
+    {
+        disableTrace();
+        if (capacity < 1) return;
+        trace.records = new TraceRecord[capacity];
+        trace.capacity = capacity;
+        trace.fp = fp;
+        updateInstrumented();
+        updateBusHooked();
+    }
+
+    void disableTrace()
+    {
+        flushTrace();
+        if (trace.records) delete[] trace.records;
+        trace.records = nullptr;
+        trace.fp = nullptr;
+        trace.capacity = 0;
+        clearTrace();
+        updateInstrumented();
+        updateBusHooked();
+    }
+
+    void clearTrace()
+    {
+        trace.head = 0;
+        trace.count = 0;
+        trace.lost = 0;
+    }
+
+    bool isTraceEnabled() { return nullptr != trace.records; }
+    int getTraceCount() { return trace.count; }
+    unsigned long long getTraceLost() { return trace.lost; }
+
+    // write the buffered records to the stream (returns the number of the written records)
+    int flushTrace()
+    {
+        if (!trace.fp || !trace.count) return 0;
+        int tail = trace.head - trace.count;
+        if (tail < 0) tail += trace.capacity;
+        int first = trace.capacity - tail < trace.count ? trace.capacity - tail : trace.count;
+        fwrite(&trace.records[tail], sizeof(TraceRecord), (size_t)first, trace.fp);
+        if (first < trace.count) fwrite(trace.records, sizeof(TraceRecord), (size_t)(trace.count - first), trace.fp);
+        int n = trace.count;
+        trace.count = 0;
+        return n;
+    }
+
+    // copy the records (oldest first) without removing them
+    int snapshotTrace(TraceRecord* records, int max)
+    {
+        int n = trace.count < max ? trace.count : max;
+        int tail = trace.head - trace.count;
+        if (tail < 0) tail += trace.capacity;
+        for (int i = 0; i < n; i++) {
+            records[i] = trace.records[tail];
+            if (++tail == trace.capacity) tail = 0;
+        }
+        return n;
+    }
+
+    // copy and remove the records (oldest first)
+    int drainTrace(TraceRecord* records, int max)
+    {
+        int n = snapshotTrace(records, max);
+        trace.count -= n;
+        return n;
+    }
+#endif
+
+    // read or write the memory with the callbacks but without the clocks (e.g. for the debuggers)
+    unsigned char peekMemory(unsigned short addr)
+    {
+        return CB.read(CB.arg, addr);
+    }
+
+    void pokeMemory(unsigned short addr, unsigned char value)
+    {
+        CB.write(CB.arg, addr, value);
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        if (decodeCache.entries) invalidateDecodeCache(addr);
+#endif
+    }
+
+    // disassemble the instruction at the address without executing it (returns the length, e.g. "LD (IX+$05), $12")
+    //   the unknown opcodes are disassembled as "DB $ED, $00" (length: 2)
+    int disassemble(unsigned short addr, char* buf, size_t size)
+    {
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        DecodedInstruction* cached = decodeCache.entries ? &decodeCache.entries[addr] : nullptr;
+        if (cached && cached->length) {
+            snprintf(buf, size, "%s", cached->text);
+            return cached->length;
+        }
+#endif
+        unsigned char bytes[4];
+        for (int i = 0; i < 4; i++) bytes[i] = peekCode((unsigned short)(addr + i));
+        int length; // 0: not supported by this core
+        switch (bytes[0]) {
+            case 0xCB: length = 2; break;
+            case 0xED: length = opSetED[bytes[1]] ? opLengthED[bytes[1]] : 0; break;
+            case 0xDD: length = opSetIX[bytes[1]] ? opLengthIXY[bytes[1]] : 0; break;
+            case 0xFD: length = opSetIY[bytes[1]] ? opLengthIXY[bytes[1]] : 0; break;
+            default: length = opLength1[bytes[0]];
+        }
+        char text[30];
+        if (length) {
+            decodeInstruction(addr, bytes, text, sizeof(text));
+        } else {
+            snprintf(text, sizeof(text), "DB $%02X, $%02X", bytes[0], bytes[1]);
+            length = 2;
+        }
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+        if (cached) {
+            snprintf(cached->text, sizeof(cached->text), "%s", text);
+            cached->length = (unsigned char)length;
+        }
+#endif
+        snprintf(buf, size, "%s", text);
+        return length;
     }
 
-    Z80()
+#ifndef Z80_DISABLE_DISASSEMBLE_CACHE
+    // cache the results of disassemble per address (invalidated by the writes of the CPU and postCommand)
+    void enableDisassembleCache()
     {
-        initialize();
+        if (!decodeCache.entries) decodeCache.entries = new DecodedInstruction[0x10000];
+        clearDisassembleCache();
+        updateBusHooked();
     }
 
-#ifndef Z80_NO_FUNCTIONAL
-    void setupCallback(std::function<unsigned char(void*, unsigned short)> read,
-                       std::function<void(void*, unsigned short, unsigned char)> write,
-                       std::function<unsigned char(void*, unsigned short)> in,
-                       std::function<void(void*, unsigned short, unsigned char)> out,
-                       void* arg,
-                       bool returnPortAs16Bits = false)
+    void disableDisassembleCache()
     {
-        CB.arg = arg;
-        setupCallback(read, write, in, out, returnPortAs16Bits);
+        if (decodeCache.entries) delete[] decodeCache.entries;
+        decodeCache.entries = nullptr;
+        updateBusHooked();
     }
 
-    void setupCallback(std::function<unsigned char(void*, unsigned short)> read,
-                       std::function<void(void*, unsigned short, unsigned char)> write,
-                       std::function<unsigned char(void*, unsigned short)> in,
-                       std::function<void(void*, unsigned short, unsigned char)> out,
-                       bool returnPortAs16Bits = false)
+    void clearDisassembleCache()
     {
-        setupMemoryCallback(read, write);
-        setupDeviceCallback(in, out, returnPortAs16Bits);
+        if (decodeCache.entries) memset(decodeCache.entries, 0, sizeof(DecodedInstruction) * 0x10000);
     }
 
-    void setupMemoryCallback(std::function<unsigned char(void*, unsigned short)> read,
-                             std::function<void(void*, unsigned short, unsigned char)> write)
+    // call it when the memory is changed out of the CPU (e.g. DMA, loading a file or switching a bank)
+    void invalidateDisassembleCache(unsigned short addr, int size = 1)
     {
-        CB.read = read;
-        CB.write = write;
+        if (!decodeCache.entries) return;
+        for (int i = 0; i < size; i++) invalidateDecodeCache((unsigned short)(addr + i));
     }
 
-    void setupDeviceCallback(std::function<unsigned char(void*, unsigned short)> in,
-                             std::function<void(void*, unsigned short, unsigned char)> out,
-                             bool returnPortAs16Bits)
-    {
-        CB.in = in;
-        CB.out = out;
-#ifndef Z80_UNSUPPORT_16BIT_PORT
-        CB.returnPortAs16Bits = returnPortAs16Bits;
+    bool isDisassembleCacheEnabled() { return nullptr != decodeCache.entries; }
 #endif
+
+    // format the trace record into the text (e.g. "[0000] LD A, $12 <AF=0000 BC=...>"), it can be used without the instance
+    static void formatTraceRecord(const TraceRecord& record, char* buf, size_t size)
+    {
+        char instruction[32];
+        decodeInstruction(record.pc, record.opcode, instruction, sizeof(instruction));
+        snprintf(buf, size, "[%04X] %-18s <AF=%04X BC=%04X DE=%04X HL=%04X IX=%04X IY=%04X SP=%04X> %llu",
+                 record.pc, instruction, record.af, record.bc, record.de, record.hl, record.ix, record.iy, record.sp, record.clock);
     }
 
-#else
-    void setupCallback(unsigned char (*read)(void* arg, unsigned short addr),
-                       void (*write)(void* arg, unsigned short addr, unsigned char value),
-                       unsigned char (*in)(void* arg, unsigned short port),
-                       void (*out)(void* arg, unsigned short port, unsigned char value),
-                       void* arg,
-                       bool returnPortAs16Bits = false)
+#ifndef Z80_DISABLE_PROFILER
+    // count the executions and the clocks per instruction address (the counters are cleared)
+    void enableProfiler()
     {
-        CB.arg = arg;
-        setupCallback(read, write, in, out, returnPortAs16Bits);
+        if (!profiler.counts) {
+            profiler.counts = new unsigned long long[0x10000];
+            profiler.clocks = new unsigned long long[0x10000];
+        }
+        clearProfiler();
+        updateInstrumented();
     }
 
-    void setupCallback(unsigned char (*read)(void* arg, unsigned short addr),
-                       void (*write)(void* arg, unsigned short addr, unsigned char value),
-                       unsigned char (*in)(void* arg, unsigned short port),
-                       void (*out)(void* arg, unsigned short port, unsigned char value),
-                       bool returnPortAs16Bits = false)
+    void disableProfiler()
     {
-        setupMemoryCallback(read, write);
-        setupDeviceCallback(in, out, returnPortAs16Bits);
+        if (profiler.counts) delete[] profiler.counts;
+        if (profiler.clocks) delete[] profiler.clocks;
+        profiler.counts = nullptr;
+        profiler.clocks = nullptr;
+        updateInstrumented();
     }
 
-    void setupMemoryCallback(unsigned char (*read)(void* arg, unsigned short addr),
-                             void (*write)(void* arg, unsigned short addr, unsigned char value))
+    void clearProfiler()
     {
-        CB.read = read;
-        CB.write = write;
+        if (!profiler.counts) return;
+        memset(profiler.counts, 0, sizeof(unsigned long long) * 0x10000);
+        memset(profiler.clocks, 0, sizeof(unsigned long long) * 0x10000);
     }
 
-    void setupDeviceCallback(unsigned char (*in)(void* arg, unsigned short addr),
-                             void (*out)(void* arg, unsigned short addr, unsigned char value),
-                             bool returnPortAs16Bits)
+    bool isProfilerEnabled() { return nullptr != profiler.counts; }
+
+    // raw counters indexed by the instruction address (65536 entries, nullptr: disabled)
+    const unsigned long long* getProfilerCounts() { return profiler.counts; }
+    const unsigned long long* getProfilerClocks() { return profiler.clocks; }
+
+    // get the hottest addresses in descending order (byClocks = false: by the number of the executions)
+    int getProfilerTop(ProfileEntry* entries, int max, bool byClocks = true)
     {
-        CB.in = in;
-        CB.out = out;
-#ifndef Z80_UNSUPPORT_16BIT_PORT
-        CB.returnPortAs16Bits = returnPortAs16Bits;
-#endif
+        if (!profiler.counts || max < 1) return 0;
+        const unsigned long long* values = byClocks ? profiler.clocks : profiler.counts;
+        int n = 0;
+        for (int addr = 0; addr < 0x10000; addr++) {
+            unsigned long long value = values[addr];
+            if (!value) continue;
+            if (n == max && value <= (byClocks ? entries[n - 1].clocks : entries[n - 1].count)) continue;
+            int i = n < max ? n++ : n - 1;
+            for (; 0 < i && (byClocks ? entries[i - 1].clocks : entries[i - 1].count) < value; i--) {
+                entries[i] = entries[i - 1];
+            }
+            entries[i].addr = (unsigned short)addr;
+            entries[i].count = profiler.counts[addr];
+            entries[i].clocks = profiler.clocks[addr];
+        }
+        return n;
     }
 #endif
 
-    void initialize()
+#ifndef Z80_DISABLE_OPCODE_HISTOGRAM
+    // count the executions and the clocks per opcode of each prefix table (the counters are cleared)
+    void enableOpcodeHistogram()
     {
-        resetConsumeClockCallback();
-#ifndef Z80_DISABLE_DEBUG
-        resetDebugMessage();
-#endif
-        ::memset(&reg, 0, sizeof(reg));
-        reg.pair.A = 0xff;
-        reg.pair.F = 0xff;
-        reg.SP = 0xffff;
-        memset(&wtc, 0, sizeof(wtc));
+        if (!opcodeHistogram.counters) opcodeHistogram.counters = new OpcodeCounter[7 * 256];
+        clearOpcodeHistogram();
+        updateInstrumented();
     }
 
-    ~Z80()
+    void disableOpcodeHistogram()
     {
-#ifndef Z80_DISABLE_BREAKPOINT
-        removeAllBreakOperands();
-        removeAllBreakPoints();
-#endif
-#ifndef Z80_DISABLE_NESTCHECK
-        removeAllCallHandlers();
-        removeAllReturnHandlers();
-#endif
+        if (opcodeHistogram.counters) delete[] opcodeHistogram.counters;
+        opcodeHistogram.counters = nullptr;
+        opcodeHistogram.current = nullptr;
+        updateInstrumented();
     }
 
-#ifndef Z80_DISABLE_DEBUG
-#ifdef Z80_NO_FUNCTIONAL
-    void setDebugMessage(void (*debugMessage)(void* arg, const char* msg))
-#else
-    void setDebugMessage(std::function<void(void*, const char*)> debugMessage)
-#endif
+    void clearOpcodeHistogram()
     {
-        CB.debugMessageEnabled = true;
-        CB.debugMessage = debugMessage;
+        if (!opcodeHistogram.counters) return;
+        memset(opcodeHistogram.counters, 0, sizeof(OpcodeCounter) * 7 * 256);
+        opcodeHistogram.current = nullptr;
     }
 
-    void resetDebugMessage()
+    bool isOpcodeHistogramEnabled() { return nullptr != opcodeHistogram.counters; }
+
+    // NOTE: the prefix bytes are counted in the outer table, and the clocks are counted in the innermost table
+    unsigned long long getOpcodeCount(int prefix, unsigned char opcode)
     {
-        CB.debugMessageEnabled = false;
-#ifdef Z80_NO_FUNCTIONAL
-        CB.debugMessage = nullptr;
-#endif
+        int table = getPrefixTable(prefix);
+        if (!opcodeHistogram.counters || table < 0) return 0;
+        return opcodeHistogram.counters[(table << 8) | opcode].count;
     }
 
-    inline bool isDebug()
+    unsigned long long getOpcodeClocks(int prefix, unsigned char opcode)
     {
-        return CB.debugMessageEnabled;
+        int table = getPrefixTable(prefix);
+        if (!opcodeHistogram.counters || table < 0) return 0;
+        return opcodeHistogram.counters[(table << 8) | opcode].clocks;
     }
-#endif
 
-    inline unsigned short make16BitsFromLE(unsigned char low, unsigned char high)
+    // get the most frequent opcodes in descending order (byClocks = true: by the clocks)
+    int getOpcodeHistogramTop(OpcodeEntry* entries, int max, bool byClocks = false)
     {
-        unsigned short n = high;
-        n <<= 8;
-        n |= low;
+        static const int prefixes[7] = {0x00, 0xCB, 0xED, 0xDD, 0xFD, 0xDDCB, 0xFDCB};
+        if (!opcodeHistogram.counters || max < 1) return 0;
+        int n = 0;
+        for (int index = 0; index < 7 * 256; index++) {
+            OpcodeCounter* counter = &opcodeHistogram.counters[index];
+            unsigned long long value = byClocks ? counter->clocks : counter->count;
+            if (!value) continue;
+            if (n == max && value <= (byClocks ? entries[n - 1].clocks : entries[n - 1].count)) continue;
+            int i = n < max ? n++ : n - 1;
+            for (; 0 < i && (byClocks ? entries[i - 1].clocks : entries[i - 1].count) < value; i--) {
+                entries[i] = entries[i - 1];
+            }
+            entries[i].prefix = prefixes[index >> 8];
+            entries[i].opcode = (unsigned char)(index & 0xFF);
+            entries[i].count = counter->count;
+            entries[i].clocks = counter->clocks;
+            formatMnemonic(index >> 8, entries[i].opcode, entries[i].mnemonic, sizeof(entries[i].mnemonic));
+        }
         return n;
     }
+#endif
 
-    inline void splitTo8BitsPair(unsigned short value, unsigned char* high, unsigned char* low)
+#ifndef Z80_DISABLE_COVERAGE
+    // mark the executed instructions and the outcomes of the conditional branches (the bitmaps are cleared)
+    void enableCoverage()
     {
-        *high = (value & 0xFF00) >> 8;
-        *low = value & 0xFF;
+        if (!coverage.maps) coverage.maps = new unsigned int[0x1800];
+        clearCoverage();
+        updateInstrumented();
     }
 
-#ifndef Z80_DISABLE_BREAKPOINT
-#ifdef Z80_NO_FUNCTIONAL
-    void addBreakPoint(unsigned short addr, void (*callback)(void*))
-#else
-    void addBreakPoint(unsigned short addr, std::function<void(void*)> callback)
-#endif
+    void disableCoverage()
     {
-        auto it = CB.breakPoints.find(addr);
-        if (it == CB.breakPoints.end()) {
-            CB.breakPoints[addr] = new std::vector<BreakPoint*>();
-        }
-        CB.breakPoints[addr]->push_back(new BreakPoint(addr, callback));
+        if (coverage.maps) delete[] coverage.maps;
+        coverage.maps = nullptr;
+        updateInstrumented();
     }
 
-    void removeBreakPoint(unsigned short addr)
+    void clearCoverage()
     {
-        auto it = CB.breakPoints.find(addr);
-        if (it == CB.breakPoints.end()) return;
-        for (auto bp : *CB.breakPoints[addr]) delete bp;
-        delete CB.breakPoints[addr];
-        CB.breakPoints.erase(it);
+        if (coverage.maps) memset(coverage.maps, 0, sizeof(unsigned int) * 0x1800);
     }
 
-    void removeAllBreakPoints()
+    bool isCoverageEnabled() { return nullptr != coverage.maps; }
+
+    bool isCovered(unsigned short addr, CoverageMap map = CoverageMap::Executed)
     {
-        std::vector<int> keys;
-        for (auto it = CB.breakPoints.begin(); it != CB.breakPoints.end(); it++) {
-            keys.push_back(it->first);
-        }
-        for (auto key : keys) {
-            removeBreakPoint(key);
+        if (!coverage.maps) return false;
+        return coverage.maps[((int)map << 11) + (addr >> 5)] & (1U << (addr & 31));
+    }
+
+    // number of the marked addresses in the bitmap
+    int getCoveredCount(CoverageMap map = CoverageMap::Executed)
+    {
+        if (!coverage.maps) return 0;
+        int count = 0;
+        for (int i = 0; i < 0x800; i++) {
+            for (unsigned int word = coverage.maps[((int)map << 11) + i]; word; word &= word - 1) count++;
         }
+        return count;
     }
 
-#ifdef Z80_NO_FUNCTIONAL
-    void addBreakOperand(int operandNumber, void (*callback)(void*, unsigned char*, int))
-#else
-    void addBreakOperand(int operandNumber, std::function<void(void*, unsigned char*, int)> callback)
-#endif
+    // raw bitmap of 2048 words (bit n of word i is the address i * 32 + n, nullptr: disabled)
+    const unsigned int* getCoverageMap(CoverageMap map) { return coverage.maps ? &coverage.maps[(int)map << 11] : nullptr; }
+
+    // merge the raw bitmap (e.g. saved by the other process) into this CPU
+    void mergeCoverage(CoverageMap map, const unsigned int* words)
     {
-        addBreakOperand(0, operandNumber, callback);
+        if (!coverage.maps || !words) return;
+        unsigned int* dst = &coverage.maps[(int)map << 11];
+        for (int i = 0; i < 0x800; i++) dst[i] |= words[i];
     }
 
-#ifdef Z80_NO_FUNCTIONAL
-    void addBreakOperand(int prefixNumber, int operandNumber, void (*callback)(void*, unsigned char*, int))
-#else
-    void addBreakOperand(int prefixNumber, int operandNumber, std::function<void(void*, unsigned char*, int)> callback)
-#endif
+    void mergeCoverage(const Z80& src)
     {
-        auto op = (prefixNumber << 8) | operandNumber;
-        auto it = CB.breakOperands.find(op);
-        if (it == CB.breakOperands.end()) {
-            CB.breakOperands[op] = new std::vector<BreakOperand*>();
-        }
-        CB.breakOperands[op]->push_back(new BreakOperand(prefixNumber, operandNumber, callback));
+        if (!coverage.maps || !src.coverage.maps) return;
+        for (int i = 0; i < 0x1800; i++) coverage.maps[i] |= src.coverage.maps[i];
     }
 
+    // write the coverage in the lcov-like text format (returns the number of the covered addresses)
+    //   symbol: returns the name of the routine that contains the address (nullptr: "z80")
+    //   DA:<address>,1 for each executed address, BRDA:<address>,0,<0: taken, 1: not taken>,<1 or 0> for each conditional branch
 #ifdef Z80_NO_FUNCTIONAL
-    void addBreakOperand(unsigned char prefixNumber1, unsigned char prefixNumber2, unsigned char operandNumber, void (*callback)(void*, unsigned char*, int))
+    int exportCoverage(FILE* fp, const char* (*symbol)(void* arg, unsigned short addr) = nullptr)
 #else
-    void addBreakOperand(unsigned char prefixNumber1, unsigned char prefixNumber2, unsigned char operandNumber, std::function<void(void*, unsigned char*, int)> callback)
+    int exportCoverage(FILE* fp, std::function<const char*(void* arg, unsigned short addr)> symbol = nullptr)
+#endif
+    {
+        if (!coverage.maps) return 0;
+        const char* current = nullptr;
+        int count = 0;
+        for (int addr = 0; addr < 0x10000; addr++) {
+            if (!isCovered((unsigned short)addr)) continue;
+            const char* name = symbol ? symbol(CB.arg, (unsigned short)addr) : nullptr;
+            if (!name) name = "z80";
+            if (!current || 0 != strcmp(current, name)) {
+                if (current) fprintf(fp, "end_of_record\n");
+                fprintf(fp, "SF:%s\n", name);
+                current = name;
+            }
+            fprintf(fp, "DA:%d,1\n", addr);
+            bool taken = isCovered((unsigned short)addr, CoverageMap::BranchTaken);
+            bool notTaken = isCovered((unsigned short)addr, CoverageMap::BranchNotTaken);
+            if (taken || notTaken) {
+                fprintf(fp, "BRDA:%d,0,0,%d\n", addr, taken ? 1 : 0);
+                fprintf(fp, "BRDA:%d,0,1,%d\n", addr, notTaken ? 1 : 0);
+            }
+            count++;
+        }
+        if (current) fprintf(fp, "end_of_record\n");
+        return count;
+    }
 #endif
+
+    // get the mnemonic of the opcode (returns false if the prefix is not supported)
+    //   prefix: 0x00 (no prefix), 0xCB, 0xED, 0xDD, 0xFD, 0xDDCB or 0xFDCB
+    //   the operands are written in lower case: n (8-bit), nn (16-bit), d (displacement) and e (relative address)
+    bool getOpcodeMnemonic(int prefix, unsigned char opcode, char* buf, size_t size)
     {
-        int n = make16BitsFromLE(prefixNumber2, prefixNumber1);
-        int prefixNumber = n;
-        n <<= 8;
-        n |= operandNumber;
-        addBreakOperand(prefixNumber, n, callback);
+        int table = getPrefixTable(prefix);
+        if (table < 0 || !size) return false;
+        formatMnemonic(table, opcode, buf, size);
+        return true;
     }
 
-    void removeBreakOperand(int operandNumber)
+#ifndef Z80_DISABLE_COMMANDQUEUE
+    // NOTE: call it before starting the producer thread (capacity is rounded up to the power of 2)
+    void enableCommandQueue(int capacity)
     {
-        auto it = CB.breakOperands.find(operandNumber);
-        if (it == CB.breakOperands.end()) return;
-        for (auto bo : *CB.breakOperands[operandNumber]) delete bo;
-        delete CB.breakOperands[operandNumber];
-        CB.breakOperands.erase(it);
+        disableCommandQueue();
+        if (capacity < 1) return;
+        unsigned int size = 1;
+        while (size < (unsigned int)capacity) size <<= 1;
+        commandQueue.buffer = new Command[size];
+        commandQueue.capacity = size;
+        commandQueue.head = 0;
+        commandQueue.tail = 0;
     }
 
-    void removeBreakOperand(unsigned char prefixNumber, unsigned char operandNumber)
+    void disableCommandQueue()
     {
-        removeBreakOperand(make16BitsFromLE(operandNumber, prefixNumber));
+        if (commandQueue.buffer) delete[] commandQueue.buffer;
+        commandQueue.buffer = nullptr;
+        commandQueue.capacity = 0;
+        commandQueue.head = 0;
+        commandQueue.tail = 0;
     }
 
-    void removeBreakOperand(unsigned char prefixNumber1, unsigned char prefixNumber2, unsigned char operandNumber)
+    /**
+     * Post a command from the producer thread (only one thread can post).
+     * The command is executed at the instruction boundary after getTotalClocks() reaches to the clock (0: as soon as possible).
+     * The commands are executed in the order of posting, so the clocks should be in ascending order.
+     * returns false if the queue is full or disabled
+     */
+    bool postCommand(CommandType type, unsigned long long clock, unsigned short addr = 0, unsigned char value = 0)
     {
-        int n = make16BitsFromLE(prefixNumber2, prefixNumber1);
-        n <<= 8;
-        n |= operandNumber;
-        removeBreakOperand(n);
+        if (!commandQueue.buffer) return false;
+#ifdef Z80_NO_ATOMIC
+        unsigned int tail = commandQueue.tail;
+        if (tail - commandQueue.head == commandQueue.capacity) return false;
+#else
+        unsigned int tail = commandQueue.tail.load(std::memory_order_relaxed);
+        if (tail - commandQueue.head.load(std::memory_order_acquire) == commandQueue.capacity) return false;
+#endif
+        Command* command = &commandQueue.buffer[tail & (commandQueue.capacity - 1)];
+        command->clock = clock;
+        command->addr = addr;
+        command->type = type;
+        command->value = value;
+#ifdef Z80_NO_ATOMIC
+        commandQueue.tail = tail + 1;
+#else
+        commandQueue.tail.store(tail + 1, std::memory_order_release);
+#endif
+        return true;
     }
 
-    void removeAllBreakOperands()
+    // number of the commands waiting in the queue
+    int getCommandCount()
     {
-        std::vector<int> keys;
-        for (auto it = CB.breakOperands.begin(); it != CB.breakOperands.end(); it++) {
-            keys.push_back(it->first);
-        }
-        for (auto key : keys) {
-            removeBreakOperand(key);
-        }
+#ifdef Z80_NO_ATOMIC
+        return (int)(commandQueue.tail - commandQueue.head);
+#else
+        return (int)(commandQueue.tail.load(std::memory_order_acquire) - commandQueue.head.load(std::memory_order_acquire));
+#endif
     }
 #endif
 
-#ifndef Z80_DISABLE_NESTCHECK
-#ifdef Z80_NO_FUNCTIONAL
-    void addReturnHandler(void (*callback)(void*))
-#else
-    void addReturnHandler(std::function<void(void*)> callback)
-#endif
+#ifndef Z80_DISABLE_TIMELINE
+    // record the timeline events (execute, interrupts, HALT, break points and the user-defined events) with the clocks
+    void enableTimeline(int capacity)
     {
-        CB.returnHandlers.push_back(new SimpleHandler(callback));
+        disableTimeline();
+        if (capacity < 1) return;
+        unsigned int size = 1;
+        while (size < (unsigned int)capacity) size <<= 1;
+        timeline.events = new TimelineEvent[size];
+        timeline.capacity = size;
+        timeline.head = 0;
+        timeline.tail = 0;
+        timeline.lost = 0;
     }
 
-    void removeAllReturnHandlers()
+    void disableTimeline()
     {
-        for (auto handler : CB.returnHandlers) delete handler;
-        CB.returnHandlers.clear();
+        if (timeline.events) delete[] timeline.events;
+        timeline.events = nullptr;
+        timeline.capacity = 0;
+        timeline.head = 0;
+        timeline.tail = 0;
     }
 
-#ifdef Z80_NO_FUNCTIONAL
-    void addCallHandler(void (*callback)(void*))
+    bool isTimelineEnabled() { return nullptr != timeline.events; }
+
+    // number of the events dropped because the buffer was full
+#ifdef Z80_NO_ATOMIC
+    unsigned long long getTimelineLost() { return timeline.lost; }
 #else
-    void addCallHandler(std::function<void(void*)> callback)
+    unsigned long long getTimelineLost() { return timeline.lost.load(std::memory_order_relaxed); }
 #endif
-    {
-        CB.callHandlers.push_back(new SimpleHandler(callback));
-    }
 
-    void removeAllCallHandlers()
+    // user-defined events (call them on the CPU thread, e.g. in the callbacks of the devices)
+    //   name: must be valid until the event is drained (e.g. a string literal)
+    void beginTimelineSpan(const char* name) { logTimeline(TimelineType::SpanBegin, reg.PC, 0, name); }
+    void endTimelineSpan(const char* name) { logTimeline(TimelineType::SpanEnd, reg.PC, 0, name); }
+    void markTimeline(const char* name) { logTimeline(TimelineType::Instant, reg.PC, 0, name); }
+
+    /**
+     * Copy and remove the events (oldest first) from the consumer thread (only one thread can drain).
+     * returns the number of the copied events
+     */
+    int drainTimeline(TimelineEvent* events, int max)
     {
-        for (auto handler : CB.callHandlers) delete handler;
-        CB.callHandlers.clear();
-    }
+        if (!timeline.events) return 0;
+#ifdef Z80_NO_ATOMIC
+        unsigned int head = timeline.head;
+        unsigned int tail = timeline.tail;
+#else
+        unsigned int head = timeline.head.load(std::memory_order_relaxed);
+        unsigned int tail = timeline.tail.load(std::memory_order_acquire);
 #endif
-
-#ifdef Z80_NO_FUNCTIONAL
-    void setConsumeClockCallback(void (*consumeClock_)(void* arg, int clocks))
+        int n = 0;
+        while (head != tail && n < max) {
+            events[n++] = timeline.events[head & (timeline.capacity - 1)];
+            head++;
+        }
+#ifdef Z80_NO_ATOMIC
+        timeline.head = head;
 #else
-    void setConsumeClockCallback(std::function<void(void* arg, int clocks)> consumeClock_)
+        timeline.head.store(head, std::memory_order_release);
 #endif
-    {
-        CB.consumeClockEnabled = true;
-        CB.consumeClock = consumeClock_;
+        return n;
     }
+#endif
 
-    void resetConsumeClockCallback()
-    {
-        CB.consumeClockEnabled = false;
-#ifdef Z80_NO_FUNCTIONAL
-        CB.consumeClock = nullptr;
+    size_t getStateSize()
+    {
+        return stateHeaderSize + stateBodySize;
+    }
+
+    // returns the written size (0: buffer too small)
+    size_t saveState(void* buffer, size_t size)
+    {
+        if (size < getStateSize()) return 0;
+        if (getSignals() & ~signalBreak) foldSignals(); // the pending interrupts are saved as the registers
+        unsigned char* ptr = (unsigned char*)buffer;
+        putState32(ptr, stateMagic);
+        putState16(ptr, stateVersion);
+        putState16(ptr, stateBodySize);
+        putStateRegisterPair(ptr, reg.pair);
+        putStateRegisterPair(ptr, reg.back);
+        putState16(ptr, reg.PC);
+        putState16(ptr, reg.SP);
+        putState16(ptr, reg.IX);
+        putState16(ptr, reg.IY);
+        putState16(ptr, reg.interruptVector);
+        putState16(ptr, reg.interruptAddrN);
+        putState16(ptr, reg.WZ);
+        putState16(ptr, reg.reserved16);
+        putState8(ptr, reg.R);
+        putState8(ptr, reg.I);
+        putState8(ptr, reg.IFF);
+        putState8(ptr, reg.interrupt);
+        putState8(ptr, reg.consumeClockCounter);
+        putState8(ptr, reg.execEI);
+        putState8(ptr, reg.reserved8[0]);
+        putState8(ptr, reg.reserved8[1]);
+        putState32(ptr, (unsigned int)wtc.fetch);
+        putState32(ptr, (unsigned int)wtc.fetchM);
+        putState32(ptr, (unsigned int)wtc.read);
+        putState32(ptr, (unsigned int)wtc.write);
+        putState8(ptr, isBreakRequested() ? 1 : 0);
+        putState64(ptr, totalClocks);
+        putState16(ptr, instructionPC);
+#ifndef Z80_DISABLE_CONTENTION
+        putState64(ptr, getTotalClocks() - contention.frameStart);
+#else
+        putState64(ptr, 0);
+#endif
+        return (size_t)(ptr - (unsigned char*)buffer);
+    }
+
+    // returns false if the buffer is not a valid save state
+    bool loadState(const void* buffer, size_t size)
+    {
+        const unsigned char* ptr = (const unsigned char*)buffer;
+        if (size < stateHeaderSize) return false;
+        if (getState32(ptr) != stateMagic) return false;
+        unsigned short version = getState16(ptr);
+        unsigned short bodySize = getState16(ptr);
+        if (version < 1 || version > stateVersion || bodySize < stateBodySize || size < stateHeaderSize + (size_t)bodySize) return false;
+        getStateRegisterPair(ptr, reg.pair);
+        getStateRegisterPair(ptr, reg.back);
+        reg.PC = getState16(ptr);
+        reg.SP = getState16(ptr);
+        reg.IX = getState16(ptr);
+        reg.IY = getState16(ptr);
+        reg.interruptVector = getState16(ptr);
+        reg.interruptAddrN = getState16(ptr);
+        reg.WZ = getState16(ptr);
+        reg.reserved16 = getState16(ptr);
+        reg.R = getState8(ptr);
+        reg.I = getState8(ptr);
+        reg.IFF = getState8(ptr);
+        reg.interrupt = getState8(ptr);
+        reg.consumeClockCounter = getState8(ptr);
+        reg.execEI = getState8(ptr);
+        reg.reserved8[0] = getState8(ptr);
+        reg.reserved8[1] = getState8(ptr);
+        wtc.fetch = (int)getState32(ptr);
+        wtc.fetchM = (int)getState32(ptr);
+        wtc.read = (int)getState32(ptr);
+        wtc.write = (int)getState32(ptr);
+        clearSignals(~0U); // discard the pending signals
+        if (getState8(ptr)) postSignals(signalBreak);
+        totalClocks = getState64(ptr);
+        instructionPC = getState16(ptr);
+#ifndef Z80_DISABLE_CONTENTION
+        contention.frameStart = getTotalClocks() - getState64(ptr);
+#else
+        getState64(ptr);
 #endif
+        return true;
     }
 
+    // NOTE: requestBreak can be called from the other threads (unless Z80_NO_ATOMIC)
     void requestBreak()
     {
-        requestBreakFlag = true;
+        postSignals(signalBreak);
     }
 
+    // NOTE: generateIRQ, cancelIRQ and generateNMI must be called on the CPU thread (use postIRQ, postCancelIRQ and postNMI from the other threads)
     void generateIRQ(unsigned char vector)
     {
+#ifndef Z80_DISABLE_RECORD
+        if (RecorderMode::Off != recorder.mode && !hookExternalEvent(RecordEvent::IRQ, vector)) return;
+#endif
         reg.interrupt |= 0b01000000;
         reg.interruptVector = vector;
     }
 
     void cancelIRQ()
     {
+#ifndef Z80_DISABLE_RECORD
+        if (RecorderMode::Off != recorder.mode && !hookExternalEvent(RecordEvent::CancelIRQ, 0)) return;
+#endif
         reg.interrupt &= 0b10111111;
     }
 
     void generateNMI(unsigned short addr)
     {
+#ifndef Z80_DISABLE_RECORD
+        if (RecorderMode::Off != recorder.mode && !hookExternalEvent(RecordEvent::NMI, addr)) return;
+#endif
         reg.interrupt |= 0b10000000;
         reg.interruptAddrN = addr;
     }
 
+    // post the interrupt requests from the other threads (unless Z80_NO_ATOMIC), they are applied at the instruction boundary
+    void postIRQ(unsigned char vector)
+    {
+#ifdef Z80_NO_ATOMIC
+        signals.vector = vector;
+#else
+        signals.vector.store(vector, std::memory_order_relaxed);
+#endif
+        postSignals(signalIRQ);
+    }
+
+    void postCancelIRQ()
+    {
+#ifdef Z80_NO_ATOMIC
+        signals.pending = (signals.pending & ~signalIRQ) | signalCancelIRQ;
+#else
+        unsigned int pending = signals.pending.load(std::memory_order_relaxed);
+        while (!signals.pending.compare_exchange_weak(pending, (pending & ~signalIRQ) | signalCancelIRQ, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+#endif
+    }
+
+    void postNMI(unsigned short addr)
+    {
+#ifdef Z80_NO_ATOMIC
+        signals.addrN = addr;
+#else
+        signals.addrN.store(addr, std::memory_order_relaxed);
+#endif
+        postSignals(signalNMI);
+    }
+
+#ifndef Z80_DISABLE_RECORD
+    // start recording the external inputs (the stream begins with the current CPU state)
+    void startRecording()
+    {
+        recorder.mode = RecorderMode::Off;
+        recorder.stream.resize(recordHeaderSize + getStateSize());
+        unsigned char* ptr = recorder.stream.data();
+        putState32(ptr, recordMagic);
+        putState16(ptr, recordVersion);
+        putState16(ptr, (unsigned short)getStateSize());
+        saveState(ptr, getStateSize());
+        recorder.lastCount = instructionCount;
+        recorder.mode = RecorderMode::Record;
+    }
+
+    void stopRecording()
+    {
+        if (RecorderMode::Record != recorder.mode) return;
+        recordEvent(RecordEvent::End, 0);
+        recorder.mode = RecorderMode::Off;
+    }
+
+    const void* getRecordData() { return recorder.stream.data(); }
+    size_t getRecordSize() { return recorder.stream.size(); }
+
+    // start replaying the recorded stream (the stream must be kept until the replay finishes)
+    bool startReplay(const void* data, size_t size)
+    {
+        recorder.mode = RecorderMode::Off;
+        recorder.desync = false;
+        const unsigned char* ptr = (const unsigned char*)data;
+        if (size < recordHeaderSize) return false;
+        if (recordMagic != getState32(ptr)) return false;
+        if (recordVersion != getState16(ptr)) return false;
+        size_t stateSize = getState16(ptr);
+        if (size < recordHeaderSize + stateSize || !loadState(ptr, stateSize)) return false;
+        recorder.replayPtr = ptr + stateSize;
+        recorder.replayEnd = (const unsigned char*)data + size;
+        recorder.lastCount = instructionCount;
+        recorder.mode = RecorderMode::Replay;
+        readNextReplayEvent();
+        return true;
+    }
+
+    void stopReplay()
+    {
+        if (RecorderMode::Replay == recorder.mode) recorder.mode = RecorderMode::Off;
+    }
+
+    bool isRecording() { return RecorderMode::Record == recorder.mode; }
+    bool isReplaying() { return RecorderMode::Replay == recorder.mode; }
+
+    // returns true if the replay has been stopped by the mismatch between the stream and the execution
+    bool isReplayDesynced() { return recorder.desync; }
+#endif
+
     inline unsigned char fetch(int clocks)
     {
-        unsigned char result = readByte(reg.PC, clocks);
+        unsigned char result = readCode(reg.PC, clocks);
+        reg.PC++;
+        return result;
+    }
+
+    inline unsigned char fetchM1(int clocks)
+    {
+        unsigned char result = readOpcode(reg.PC, clocks);
         reg.PC++;
         return result;
     }
@@ -6392,20 +9505,27 @@ class Z80
     inline int execute(int clock)
     {
         int executed = 0;
-        requestBreakFlag = false;
+        clearSignals(signalBreak);
+        totalClocks += reg.consumeClockCounter;
         reg.consumeClockCounter = 0;
-        while (0 < clock && !requestBreakFlag) {
-            // execute NOP while halt
-            if (reg.IFF & IFF_HALT()) {
+#ifndef Z80_DISABLE_TIMELINE
+        logTimeline(TimelineType::ExecuteBegin, reg.PC);
+#endif
+        while (0 < clock && !isBreakRequested()) {
+            instructionPC = reg.PC;
+            if (instrumented) {
+                if (!executeInstrumented(true)) break;
+            } else if (reg.IFF & IFF_HALT()) {
+                // execute NOP while halt
                 reg.execEI = 0;
-                readByte(reg.PC); // NOTE: read and discard (to be consumed 4Hz)
+                readOpcode(reg.PC, 4); // NOTE: read and discard (to be consumed 4Hz)
             } else {
-                if (wtc.fetch) consumeClock(wtc.fetch);
 #ifndef Z80_DISABLE_BREAKPOINT
-                checkBreakPoint();
+                if (checkBreakPoint()) break;
 #endif
+                if (wtc.fetch) consumeClock(wtc.fetch);
                 reg.execEI = 0;
-                int operandNumber = fetch(2);
+                int operandNumber = fetchM1(2);
                 updateRefreshRegister();
 #ifndef Z80_DISABLE_BREAKPOINT
                 checkBreakOperand(operandNumber);
@@ -6419,34 +9539,47 @@ class Z80
 #ifdef Z80_CALLBACK_WITHOUT_CHECK
             CB.consumeClock(CB.arg, reg.consumeClockCounter);
 #else
-            if (CB.consumeClockEnabled) CB.consumeClock(CB.arg, reg.consumeClockCounter);
+            if (CB.consumeClockEnabled && !suppressClock) CB.consumeClock(CB.arg, reg.consumeClockCounter);
 #endif
+            totalClocks += reg.consumeClockCounter;
             reg.consumeClockCounter = 0;
 #else
+            totalClocks += reg.consumeClockCounter;
             reg.consumeClockCounter = 0;
             checkInterrupt();
 #endif
         }
+#ifndef Z80_DISABLE_BREAKPOINT
+        breakSkip = false;
+#endif
+#ifndef Z80_DISABLE_TIMELINE
+        logTimeline(TimelineType::ExecuteEnd, reg.PC);
+#endif
         return executed;
     }
 
     inline void execute()
     {
-        requestBreakFlag = false;
-        while (!requestBreakFlag) {
-#ifdef Z80_CALLBACK_PER_INSTRUCTION
-            reg.consumeClockCounter = 0;
+        clearSignals(signalBreak);
+#ifndef Z80_DISABLE_TIMELINE
+        logTimeline(TimelineType::ExecuteBegin, reg.PC);
 #endif
-            // execute NOP while halt
-            if (reg.IFF & IFF_HALT()) {
+        while (!isBreakRequested()) {
+            totalClocks += reg.consumeClockCounter;
+            reg.consumeClockCounter = 0;
+            instructionPC = reg.PC;
+            if (instrumented) {
+                if (!executeInstrumented(false)) break;
+            } else if (reg.IFF & IFF_HALT()) {
+                // execute NOP while halt
                 reg.execEI = 0;
-                readByte(reg.PC); // NOTE: read and discard (to be consumed 4Hz)
+                readOpcode(reg.PC, 4); // NOTE: read and discard (to be consumed 4Hz)
             } else {
 #ifndef Z80_DISABLE_BREAKPOINT
-                checkBreakPoint();
+                if (checkBreakPoint()) break;
 #endif
                 reg.execEI = 0;
-                int operandNumber = fetch(2 + wtc.fetch);
+                int operandNumber = fetchM1(2 + wtc.fetch);
                 updateRefreshRegister();
 #ifndef Z80_DISABLE_BREAKPOINT
                 checkBreakOperand(operandNumber);
@@ -6458,10 +9591,16 @@ class Z80
 #ifdef Z80_CALLBACK_WITHOUT_CHECK
             CB.consumeClock(CB.arg, reg.consumeClockCounter);
 #else
-            if (CB.consumeClockEnabled) CB.consumeClock(CB.arg, reg.consumeClockCounter);
+            if (CB.consumeClockEnabled && !suppressClock) CB.consumeClock(CB.arg, reg.consumeClockCounter);
 #endif
 #endif
         }
+#ifndef Z80_DISABLE_BREAKPOINT
+        breakSkip = false;
+#endif
+#ifndef Z80_DISABLE_TIMELINE
+        logTimeline(TimelineType::ExecuteEnd, reg.PC);
+#endif
     }
 
     int executeTick4MHz()
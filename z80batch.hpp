@@ -0,0 +1,308 @@
+/**
+ * SUZUKI PLAN - Z80 Emulator (Batch)
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Yoji Suzuki.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_Z80BATCH_HPP
+#define INCLUDE_Z80BATCH_HPP
+#include "z80.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+class Z80Batch
+{
+  public:
+    // execution context of a job (each worker thread has its own arena)
+    class Worker
+    {
+        friend class Z80Batch;
+
+      private:
+        struct Destructor {
+            void* ptr;
+            void (*destroy)(void*);
+        };
+        int index;
+        unsigned char* arena;
+        size_t arenaSize;
+        size_t arenaUsed;
+        std::vector<Destructor> destructors;
+
+        template <typename T>
+        static void destroy(void* ptr) { ((T*)ptr)->~T(); }
+
+        // called after each job
+        void release()
+        {
+            for (auto it = destructors.rbegin(); it != destructors.rend(); it++) {
+                it->destroy(it->ptr);
+            }
+            destructors.clear();
+            arenaUsed = 0;
+        }
+
+        Worker(int index_, size_t arenaSize_)
+        {
+            this->index = index_;
+            this->arenaSize = arenaSize_;
+            this->arena = new unsigned char[arenaSize];
+            this->arenaUsed = 0;
+        }
+
+        ~Worker()
+        {
+            release();
+            delete[] arena;
+        }
+
+      public:
+        int getIndex() { return index; }
+
+        // allocate from the worker arena (released when the job is finished, nullptr: arena overflow)
+        void* allocate(size_t size, size_t align = 16)
+        {
+            size_t offset = (arenaUsed + align - 1) / align * align;
+            if (arenaSize < offset || arenaSize - offset < size) return nullptr;
+            arenaUsed = offset + size;
+            return arena + offset;
+        }
+
+        // construct an object in the worker arena (destructed when the job is finished, nullptr: arena overflow)
+        template <typename T, typename... Args>
+        T* create(Args&&... args)
+        {
+            void* ptr = allocate(sizeof(T), alignof(T));
+            if (!ptr) return nullptr;
+            T* result = new (ptr) T(std::forward<Args>(args)...);
+            Destructor d;
+            d.ptr = result;
+            d.destroy = &destroy<T>;
+            destructors.push_back(d);
+            return result;
+        }
+    };
+
+    // returns the status code of the job
+    typedef std::function<int(Worker&)> Job;
+
+    struct Result {
+        size_t id;  // returned by submit
+        int worker; // index of the worker that executed the job
+        int status; // returned by the job (-1: uncaught exception)
+    };
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::pair<size_t, Job>> jobs;
+    };
+
+    std::vector<Worker*> workers;
+    std::vector<Queue*> queues;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable resultAvailable;
+    std::deque<Result> results;
+    std::atomic<size_t> queued;
+    size_t nextId;
+    size_t submitted;
+    size_t finished;
+    size_t taken;
+    bool stopping;
+
+    // the owner takes the newest job (LIFO)
+    bool pop(int index, std::pair<size_t, Job>& job)
+    {
+        Queue* queue = queues[(size_t)index];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (queue->jobs.empty()) return false;
+        job = std::move(queue->jobs.back());
+        queue->jobs.pop_back();
+        return true;
+    }
+
+    // the thieves take the oldest job (FIFO)
+    bool steal(int index, std::pair<size_t, Job>& job)
+    {
+        size_t count = queues.size();
+        for (size_t i = 1; i < count; i++) {
+            Queue* queue = queues[((size_t)index + i) % count];
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (queue->jobs.empty()) continue;
+            job = std::move(queue->jobs.front());
+            queue->jobs.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void run(int index)
+    {
+        Worker* worker = workers[(size_t)index];
+        while (true) {
+            std::pair<size_t, Job> job;
+            if (pop(index, job) || steal(index, job)) {
+                queued--;
+                Result result;
+                result.id = job.first;
+                result.worker = index;
+#ifdef Z80_NO_EXCEPTION
+                result.status = job.second(*worker);
+#else
+                try {
+                    result.status = job.second(*worker);
+                } catch (...) {
+                    result.status = -1;
+                }
+#endif
+                worker->release();
+                std::lock_guard<std::mutex> lock(mutex);
+                results.push_back(result);
+                finished++;
+                resultAvailable.notify_all();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this] { return stopping || 0 < queued; });
+            if (stopping && 0 == queued) return;
+        }
+    }
+
+    static void pin(std::thread& thread, int index)
+    {
+#ifdef __linux__
+        cpu_set_t cpus;
+        if (0 != sched_getaffinity(0, sizeof(cpus), &cpus)) return;
+        int count = CPU_COUNT(&cpus);
+        if (count < 1) return;
+        int target = index % count;
+        for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (!CPU_ISSET(cpu, &cpus)) continue;
+            if (0 == target--) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+                return;
+            }
+        }
+#else
+        (void)thread;
+        (void)index;
+#endif
+    }
+
+  public:
+    /**
+     * threadCount: number of the worker threads (0: number of the hardware threads)
+     * arenaSize: size of the arena per worker
+     * pinThreads: pin each worker thread to a core (Linux only)
+     */
+    Z80Batch(int threadCount = 0, size_t arenaSize = 1024 * 1024, bool pinThreads = true)
+    {
+        if (threadCount < 1) threadCount = (int)std::thread::hardware_concurrency();
+        if (threadCount < 1) threadCount = 1;
+        this->queued = 0;
+        this->nextId = 0;
+        this->submitted = 0;
+        this->finished = 0;
+        this->taken = 0;
+        this->stopping = false;
+        for (int i = 0; i < threadCount; i++) {
+            workers.push_back(new Worker(i, arenaSize));
+            queues.push_back(new Queue());
+        }
+        for (int i = 0; i < threadCount; i++) {
+            threads.push_back(std::thread(&Z80Batch::run, this, i));
+            if (pinThreads) pin(threads.back(), i);
+        }
+    }
+
+    // wait for the all jobs and stop the workers
+    ~Z80Batch()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto& thread : threads) thread.join();
+        for (auto worker : workers) delete worker;
+        for (auto queue : queues) delete queue;
+    }
+
+    int getThreadCount() { return (int)threads.size(); }
+
+    // returns the job id
+    size_t submit(const Job& job)
+    {
+        size_t id;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = nextId++;
+            submitted++;
+            queued++;
+        }
+        Queue* queue = queues[id % queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->jobs.push_back(std::make_pair(id, job));
+        }
+        workAvailable.notify_one();
+        return id;
+    }
+
+    // wait for the next finished job (in the order of completion, false: no jobs to wait for)
+    bool waitResult(Result* result)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (submitted == taken) return false;
+        resultAvailable.wait(lock, [this] { return !results.empty(); });
+        *result = results.front();
+        results.pop_front();
+        taken++;
+        return true;
+    }
+
+    // wait for the all submitted jobs (the results are kept for waitResult)
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        resultAvailable.wait(lock, [this] { return submitted == finished; });
+    }
+};
+
+#endif // INCLUDE_Z80BATCH_HPP
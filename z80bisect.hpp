@@ -0,0 +1,336 @@
+/**
+ * SUZUKI PLAN - Z80 Emulator (Bisect)
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Yoji Suzuki.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_Z80BISECT_HPP
+#define INCLUDE_Z80BISECT_HPP
+#include "z80.hpp"
+#include <vector>
+
+// a run to be compared (implement it to compare the other emulators or the other builds)
+//   NOTE: the other compile-flag build of z80.hpp must run in the other process (e.g. controlled via a pipe),
+//         because linking it into this program violates the one definition rule of the Z80 class
+class Z80BisectTarget
+{
+  public:
+    virtual ~Z80BisectTarget() {}
+
+    // restart the run from the initial state
+    virtual void reset() = 0;
+
+    // execute the specified number of the instructions
+    virtual void step(unsigned long long instructions) = 0;
+
+    // write the CPU state in the Z80::saveState format (returns the written size)
+    virtual size_t getState(void* buffer, size_t size) = 0;
+
+    virtual const unsigned char* getMemory() = 0;
+    virtual size_t getMemorySize() = 0;
+
+    // save/restore the current position (return false if not supported: the bisector replays from reset)
+    virtual bool saveCheckpoint() { return false; }
+    virtual bool restoreCheckpoint() { return false; }
+};
+
+// a run of the Z80 instance in this build
+class Z80BisectCpu : public Z80BisectTarget
+{
+  protected:
+    Z80* cpu;
+    unsigned char* memory;
+    size_t memorySize;
+    size_t stateSize;
+    unsigned char* initial;    // state + memory at the construction
+    unsigned char* checkpoint; // state + memory at saveCheckpoint
+
+    void save(unsigned char* image)
+    {
+        cpu->saveState(image, stateSize);
+        memcpy(image + stateSize, memory, memorySize);
+    }
+
+    void load(const unsigned char* image)
+    {
+        cpu->loadState(image, stateSize);
+        memcpy(memory, image + stateSize, memorySize);
+    }
+
+  public:
+    Z80BisectCpu(Z80* cpu_, unsigned char* memory_, size_t memorySize_)
+    {
+        this->cpu = cpu_;
+        this->memory = memory_;
+        this->memorySize = memorySize_;
+        this->stateSize = cpu->getStateSize();
+        this->initial = new unsigned char[stateSize + memorySize];
+        this->checkpoint = new unsigned char[stateSize + memorySize];
+        save(initial);
+    }
+
+    ~Z80BisectCpu()
+    {
+        delete[] initial;
+        delete[] checkpoint;
+    }
+
+    // the buffers are owned by this instance (not copyable)
+    Z80BisectCpu(const Z80BisectCpu&) = delete;
+    Z80BisectCpu& operator=(const Z80BisectCpu&) = delete;
+
+    void reset() override { load(initial); }
+
+    void step(unsigned long long instructions) override
+    {
+        unsigned long long end = cpu->getInstructionCount() + instructions;
+        while (cpu->getInstructionCount() < end) {
+            unsigned long long count = cpu->getInstructionCount();
+            cpu->execute(1);
+            if (count != cpu->getInstructionCount()) continue;
+#ifndef Z80_DISABLE_BREAKPOINT
+            // stopped before the instruction by requestBreakBefore: execute it without calling the break points again
+            cpu->skipBreakPointOnce();
+            cpu->execute(1);
+#endif
+            if (count == cpu->getInstructionCount()) return; // no progress (bail out instead of the infinite loop)
+        }
+    }
+
+    size_t getState(void* buffer, size_t size) override { return cpu->saveState(buffer, size); }
+    const unsigned char* getMemory() override { return memory; }
+    size_t getMemorySize() override { return memorySize; }
+
+    bool saveCheckpoint() override
+    {
+        save(checkpoint);
+        return true;
+    }
+
+    bool restoreCheckpoint() override
+    {
+        load(checkpoint);
+        return true;
+    }
+};
+
+class Z80Bisector
+{
+  public:
+    struct MemoryDelta {
+        size_t addr;
+        unsigned char a;
+        unsigned char b;
+    };
+
+    struct Result {
+        bool diverged;
+        unsigned long long instruction; // the runs differ after executing this number of the instructions
+        int comparisons;                // number of the full comparisons
+        unsigned char stateBefore[256]; // common state before the divergence
+        unsigned char stateA[256];
+        unsigned char stateB[256];
+        size_t stateSize;
+        std::vector<MemoryDelta> memory; // memory delta at the divergence (up to maxMemoryDelta)
+        size_t memoryDeltaCount;         // total number of the differing bytes
+    };
+
+  private:
+    Z80BisectTarget* a;
+    Z80BisectTarget* b;
+    size_t maxMemoryDelta;
+    bool checkpointSupported;
+    unsigned long long checkpointPosition;
+    unsigned long long position;
+
+    static unsigned long long hash(Z80BisectTarget* target)
+    {
+        unsigned char state[256];
+        size_t size = target->getState(state, sizeof(state));
+        unsigned long long h = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; i++) h = (h ^ state[i]) * 1099511628211ULL;
+        const unsigned char* memory = target->getMemory();
+        size_t memorySize = target->getMemorySize();
+        for (size_t i = 0; i < memorySize; i++) h = (h ^ memory[i]) * 1099511628211ULL;
+        return h;
+    }
+
+    bool compare(Result* result)
+    {
+        result->comparisons++;
+        return hash(a) == hash(b);
+    }
+
+    void stepBoth(unsigned long long instructions)
+    {
+        a->step(instructions);
+        b->step(instructions);
+        position += instructions;
+    }
+
+    void saveCheckpoint()
+    {
+        checkpointSupported = a->saveCheckpoint() && b->saveCheckpoint();
+        checkpointPosition = position;
+    }
+
+    // move both runs to the latest checkpoint
+    void rollback()
+    {
+        if (checkpointSupported && a->restoreCheckpoint() && b->restoreCheckpoint()) {
+            position = checkpointPosition;
+        } else {
+            a->reset();
+            b->reset();
+            position = 0;
+            stepBoth(checkpointPosition);
+        }
+    }
+
+    void makeReport(Result* result)
+    {
+        result->stateSize = b->getState(result->stateB, sizeof(result->stateB));
+        a->getState(result->stateA, sizeof(result->stateA));
+        result->memory.clear();
+        result->memoryDeltaCount = 0;
+        const unsigned char* ma = a->getMemory();
+        const unsigned char* mb = b->getMemory();
+        size_t size = a->getMemorySize() < b->getMemorySize() ? a->getMemorySize() : b->getMemorySize();
+        for (size_t i = 0; i < size; i++) {
+            if (ma[i] == mb[i]) continue;
+            if (result->memoryDeltaCount++ < maxMemoryDelta) {
+                MemoryDelta delta;
+                delta.addr = i;
+                delta.a = ma[i];
+                delta.b = mb[i];
+                result->memory.push_back(delta);
+            }
+        }
+    }
+
+    static void printRegisters(FILE* fp, const char* name, const unsigned char* state, size_t stateSize)
+    {
+        Z80 z80;
+        if (!z80.loadState(state, stateSize)) {
+            fprintf(fp, "%s: invalid state\n", name);
+            return;
+        }
+        fprintf(fp, "%s: PC=$%04X SP=$%04X AF=$%02X%02X BC=$%02X%02X DE=$%02X%02X HL=$%02X%02X IX=$%04X IY=$%04X I=$%02X R=$%02X IFF=$%02X\n",
+                name, z80.reg.PC, z80.reg.SP, z80.reg.pair.A, z80.reg.pair.F, z80.reg.pair.B, z80.reg.pair.C, z80.reg.pair.D, z80.reg.pair.E, z80.reg.pair.H, z80.reg.pair.L, z80.reg.IX, z80.reg.IY, z80.reg.I, z80.reg.R, z80.reg.IFF);
+        fprintf(fp, "%s: AF'=$%02X%02X BC'=$%02X%02X DE'=$%02X%02X HL'=$%02X%02X WZ=$%04X, %llu clocks\n",
+                name, z80.reg.back.A, z80.reg.back.F, z80.reg.back.B, z80.reg.back.C, z80.reg.back.D, z80.reg.back.E, z80.reg.back.H, z80.reg.back.L, z80.reg.WZ, z80.getTotalClocks());
+    }
+
+  public:
+    /**
+     * a, b: the runs to be compared (both of them must be at the initial state)
+     * maxMemoryDelta: maximum number of the memory delta to be reported
+     */
+    Z80Bisector(Z80BisectTarget* a_, Z80BisectTarget* b_, size_t maxMemoryDelta_ = 16)
+    {
+        this->a = a_;
+        this->b = b_;
+        this->maxMemoryDelta = maxMemoryDelta_;
+    }
+
+    /**
+     * Run both targets in lockstep and find the first instruction that makes the difference.
+     * The runs are compared at the exponentially growing checkpoints (1, 2, 4, 8...) and then
+     * the last interval is binary searched, so the full comparisons are O(log N).
+     * returns true if the runs diverged within maxInstructions
+     */
+    bool run(unsigned long long maxInstructions, Result* result)
+    {
+        result->diverged = false;
+        result->instruction = 0;
+        result->comparisons = 0;
+        result->stateSize = 0;
+        result->memory.clear();
+        result->memoryDeltaCount = 0;
+        a->reset();
+        b->reset();
+        position = 0;
+        saveCheckpoint();
+        if (!compare(result)) {
+            makeReport(result);
+            result->diverged = true;
+            return true; // the initial states are different
+        }
+        // gallop: find the interval (good, bad]
+        unsigned long long good = 0;
+        unsigned long long bad = 0;
+        unsigned long long interval = 1;
+        while (position < maxInstructions) {
+            unsigned long long next = position + interval;
+            if (maxInstructions < next) next = maxInstructions;
+            stepBoth(next - position);
+            if (!compare(result)) {
+                bad = position;
+                break;
+            }
+            good = position;
+            saveCheckpoint();
+            interval <<= 1;
+        }
+        if (!bad) return false;
+        // bisect: keep the checkpoint at the good position
+        while (good + 1 < bad) {
+            unsigned long long mid = good + (bad - good) / 2;
+            rollback();
+            stepBoth(mid - position);
+            if (compare(result)) {
+                good = mid;
+                saveCheckpoint();
+            } else {
+                bad = mid;
+            }
+        }
+        rollback();
+        a->getState(result->stateBefore, sizeof(result->stateBefore));
+        stepBoth(1);
+        makeReport(result);
+        result->diverged = true;
+        result->instruction = bad;
+        return true;
+    }
+
+    void print(FILE* fp, const Result* result)
+    {
+        if (!result->diverged) {
+            fprintf(fp, "not diverged (%d comparisons)\n", result->comparisons);
+            return;
+        }
+        fprintf(fp, "diverged at instruction #%llu (%d comparisons)\n", result->instruction, result->comparisons);
+        if (result->instruction) printRegisters(fp, "before", result->stateBefore, result->stateSize);
+        printRegisters(fp, "A", result->stateA, result->stateSize);
+        printRegisters(fp, "B", result->stateB, result->stateSize);
+        for (auto& delta : result->memory) {
+            fprintf(fp, "memory[$%04X]: A=$%02X B=$%02X\n", (unsigned int)delta.addr, delta.a, delta.b);
+        }
+        if (result->memory.size() < result->memoryDeltaCount) {
+            fprintf(fp, "... and %d more bytes\n", (int)(result->memoryDeltaCount - result->memory.size()));
+        }
+    }
+};
+
+#endif // INCLUDE_Z80BISECT_HPP
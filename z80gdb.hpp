@@ -0,0 +1,458 @@
+/**
+ * SUZUKI PLAN - Z80 Emulator (GDB remote serial protocol stub)
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Yoji Suzuki.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_Z80GDB_HPP
+#define INCLUDE_Z80GDB_HPP
+#include "z80.hpp"
+#include <arpa/inet.h>
+#include <functional>
+#include <map>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+#if defined(Z80_NO_FUNCTIONAL) || defined(Z80_DISABLE_BREAKPOINT)
+#error "z80gdb.hpp requires std::function and the break points"
+#endif
+
+class Z80GdbStub
+{
+  private:
+    Z80* cpu;
+    std::function<void(Z80* cpu)> runSlice;
+    int listenFd;
+    int fd;
+    bool stopped;          // a break point of the debugger was reached (the CPU is stopped before it)
+    unsigned short stopPC; // the address of the break point that stopped the CPU
+    bool stepping;         // the break points of the debugger are ignored while stepping
+    std::map<unsigned short, int> breakPoints; // the ids of the break points inserted by the debugger (per address)
+
+    bool isBreakPoint(unsigned short addr) { return breakPoints.end() != breakPoints.find(addr); }
+
+    static int fromHex(char c)
+    {
+        if ('0' <= c && c <= '9') return c - '0';
+        if ('a' <= c && c <= 'f') return c - 'a' + 10;
+        if ('A' <= c && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static unsigned int parseHex(const char** ptr)
+    {
+        unsigned int value = 0;
+        for (int digit = fromHex(**ptr); 0 <= digit; digit = fromHex(*++(*ptr))) value = (value << 4) | (unsigned int)digit;
+        return value;
+    }
+
+    static void appendHex8(std::string& out, unsigned char value)
+    {
+        static const char hex[] = "0123456789abcdef";
+        out += hex[value >> 4];
+        out += hex[value & 0x0F];
+    }
+
+    // the registers are sent in the little endian
+    static void appendHex16(std::string& out, unsigned short value)
+    {
+        appendHex8(out, (unsigned char)(value & 0xFF));
+        appendHex8(out, (unsigned char)(value >> 8));
+    }
+
+    static unsigned short parseHex16(const char** ptr)
+    {
+        unsigned short value = 0;
+        for (int i = 0; i < 2; i++) {
+            int high = fromHex((*ptr)[0]);
+            int low = fromHex((*ptr)[1]);
+            if (high < 0 || low < 0) break;
+            value |= (unsigned short)(((high << 4) | low) << (i * 8));
+            *ptr += 2;
+        }
+        return value;
+    }
+
+    // GDB register numbers of Z80: af, bc, de, hl, sp, pc, ix, iy, af', bc', de', hl', ir
+    unsigned short getRegister(int number)
+    {
+        Z80::Register& reg = cpu->reg;
+        switch (number) {
+            case 0: return (unsigned short)((reg.pair.A << 8) | reg.pair.F);
+            case 1: return (unsigned short)((reg.pair.B << 8) | reg.pair.C);
+            case 2: return (unsigned short)((reg.pair.D << 8) | reg.pair.E);
+            case 3: return (unsigned short)((reg.pair.H << 8) | reg.pair.L);
+            case 4: return reg.SP;
+            case 5: return reg.PC;
+            case 6: return reg.IX;
+            case 7: return reg.IY;
+            case 8: return (unsigned short)((reg.back.A << 8) | reg.back.F);
+            case 9: return (unsigned short)((reg.back.B << 8) | reg.back.C);
+            case 10: return (unsigned short)((reg.back.D << 8) | reg.back.E);
+            case 11: return (unsigned short)((reg.back.H << 8) | reg.back.L);
+            default: return (unsigned short)((reg.I << 8) | reg.R);
+        }
+    }
+
+    static void setPair(unsigned char* high, unsigned char* low, unsigned short value)
+    {
+        *high = (unsigned char)(value >> 8);
+        *low = (unsigned char)(value & 0xFF);
+    }
+
+    void setRegister(int number, unsigned short value)
+    {
+        Z80::Register& reg = cpu->reg;
+        switch (number) {
+            case 0: setPair(&reg.pair.A, &reg.pair.F, value); break;
+            case 1: setPair(&reg.pair.B, &reg.pair.C, value); break;
+            case 2: setPair(&reg.pair.D, &reg.pair.E, value); break;
+            case 3: setPair(&reg.pair.H, &reg.pair.L, value); break;
+            case 4: reg.SP = value; break;
+            case 5: reg.PC = value; break;
+            case 6: reg.IX = value; break;
+            case 7: reg.IY = value; break;
+            case 8: setPair(&reg.back.A, &reg.back.F, value); break;
+            case 9: setPair(&reg.back.B, &reg.back.C, value); break;
+            case 10: setPair(&reg.back.D, &reg.back.E, value); break;
+            case 11: setPair(&reg.back.H, &reg.back.L, value); break;
+            case 12: setPair(&reg.I, &reg.R, value); break;
+        }
+    }
+
+    bool sendPacket(const std::string& data)
+    {
+        std::string packet = "$" + data + "#";
+        unsigned char sum = 0;
+        for (char c : data) sum = (unsigned char)(sum + (unsigned char)c);
+        appendHex8(packet, sum);
+        for (int retry = 0; retry < 3; retry++) {
+            if (::send(fd, packet.data(), packet.size(), 0) != (ssize_t)packet.size()) return false;
+            char ack;
+            do {
+                if (::recv(fd, &ack, 1, 0) != 1) return false;
+            } while ('+' != ack && '-' != ack);
+            if ('+' == ack) return true;
+        }
+        return false;
+    }
+
+    // receive a packet (returns false if disconnected, data is "\x03" if the debugger requested an interrupt)
+    bool receivePacket(std::string& data)
+    {
+        char c;
+        while (true) {
+            do {
+                if (::recv(fd, &c, 1, 0) != 1) return false;
+                if (0x03 == c) {
+                    data = "\x03";
+                    return true;
+                }
+            } while ('$' != c);
+            data.clear();
+            unsigned char sum = 0;
+            while (true) {
+                if (::recv(fd, &c, 1, 0) != 1) return false;
+                if ('#' == c) break;
+                data += c;
+                sum = (unsigned char)(sum + (unsigned char)c);
+            }
+            char checksum[2];
+            for (int i = 0; i < 2; i++) {
+                if (::recv(fd, &checksum[i], 1, 0) != 1) return false;
+            }
+            bool valid = fromHex(checksum[0]) * 16 + fromHex(checksum[1]) == sum;
+            if (::send(fd, valid ? "+" : "-", 1, 0) != 1) return false;
+            if (valid) return true;
+        }
+    }
+
+    bool isInterruptRequested()
+    {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 0) <= 0) return false;
+        char c;
+        if (::recv(fd, &c, 1, MSG_PEEK) != 1) return true; // disconnected
+        if (0x03 != c) return false;
+        ::recv(fd, &c, 1, 0);
+        return true;
+    }
+
+    void onBreakPoint()
+    {
+        if (stepping) return;
+        stopped = true;
+        stopPC = cpu->reg.PC;
+        cpu->requestBreakBefore();
+    }
+
+    void insertBreakPoint(unsigned short addr)
+    {
+        if (isBreakPoint(addr)) return;
+        breakPoints[addr] = cpu->addBreakPoint(addr, [this](void* arg) { onBreakPoint(); });
+    }
+
+    void eraseBreakPoint(unsigned short addr)
+    {
+        auto it = breakPoints.find(addr);
+        if (breakPoints.end() == it) return;
+        cpu->removeBreakPoint(addr, it->second); // only the break point of the stub (your break points remain)
+        breakPoints.erase(it);
+    }
+
+    std::string step()
+    {
+        if (stopped && stopPC == cpu->reg.PC) cpu->skipBreakPointOnce(); // the callbacks at PC were called when it stopped
+        stopped = false;
+        stepping = true;
+        cpu->execute(1);
+        stepping = false;
+        return "S05";
+    }
+
+    std::string resume()
+    {
+        if (stopped || isBreakPoint(cpu->reg.PC)) step(); // leave the break point that stopped the CPU
+        while (true) {
+            runSlice(cpu);
+            if (stopped) return "S05"; // SIGTRAP
+            if (isInterruptRequested()) return "S02"; // SIGINT
+        }
+    }
+
+    std::string readMemory(const char* args)
+    {
+        unsigned int addr = parseHex(&args);
+        if (',' != *args++) return "E01";
+        unsigned int length = parseHex(&args);
+        std::string out;
+        for (unsigned int i = 0; i < length; i++) appendHex8(out, cpu->peekMemory((unsigned short)(addr + i)));
+        return out;
+    }
+
+    std::string writeMemory(const char* args)
+    {
+        unsigned int addr = parseHex(&args);
+        if (',' != *args++) return "E01";
+        unsigned int length = parseHex(&args);
+        if (':' != *args++) return "E01";
+        for (unsigned int i = 0; i < length; i++) {
+            int high = fromHex(args[i * 2]);
+            int low = 0 <= high ? fromHex(args[i * 2 + 1]) : -1;
+            if (low < 0) return "E01";
+            cpu->pokeMemory((unsigned short)(addr + i), (unsigned char)((high << 4) | low));
+        }
+        return "OK";
+    }
+
+    std::string handleBreakPoint(const char* args, bool insert)
+    {
+        if ('0' != args[0] && '1' != args[0]) return ""; // only the software and the hardware break points
+        if (',' != args[1]) return "E01";
+        args += 2;
+        unsigned short addr = (unsigned short)parseHex(&args);
+        if (insert) {
+            insertBreakPoint(addr);
+        } else {
+            eraseBreakPoint(addr);
+        }
+        return "OK";
+    }
+
+    // returns false if the debugger detached or killed
+    bool handlePacket(const std::string& packet, std::string& reply)
+    {
+        const char* args = packet.c_str() + 1;
+        reply.clear();
+        switch (packet[0]) {
+            case '?': reply = "S05"; break;
+            case 'g':
+                for (int i = 0; i < 13; i++) appendHex16(reply, getRegister(i));
+                break;
+            case 'G':
+                for (int i = 0; i < 13 && *args; i++) setRegister(i, parseHex16(&args));
+                reply = "OK";
+                break;
+            case 'p': {
+                int number = (int)parseHex(&args);
+                if (13 <= number) {
+                    reply = "E01";
+                } else {
+                    appendHex16(reply, getRegister(number));
+                }
+                break;
+            }
+            case 'P': {
+                int number = (int)parseHex(&args);
+                if ('=' != *args++ || 13 <= number) {
+                    reply = "E01";
+                } else {
+                    setRegister(number, parseHex16(&args));
+                    reply = "OK";
+                }
+                break;
+            }
+            case 'm': reply = readMemory(args); break;
+            case 'M': reply = writeMemory(args); break;
+            case 'c':
+                if (*args) cpu->reg.PC = (unsigned short)parseHex(&args);
+                reply = resume();
+                break;
+            case 's':
+                if (*args) cpu->reg.PC = (unsigned short)parseHex(&args);
+                reply = step();
+                break;
+            case 'Z': reply = handleBreakPoint(args, true); break;
+            case 'z': reply = handleBreakPoint(args, false); break;
+            case 'H': reply = "OK"; break;
+            case 'T': reply = "OK"; break;
+            case 'q':
+                if (0 == packet.compare(0, 10, "qSupported")) {
+                    reply = "PacketSize=1000";
+                } else if (packet == "qAttached") {
+                    reply = "1";
+                } else if (packet == "qC") {
+                    reply = "QC1";
+                } else if (packet == "qfThreadInfo") {
+                    reply = "m1";
+                } else if (packet == "qsThreadInfo") {
+                    reply = "l";
+                }
+                break;
+            case 'D':
+                sendPacket("OK");
+                return false;
+            case 'k': return false;
+        }
+        return true;
+    }
+
+  public:
+    /**
+     * cpu: the CPU to be debugged
+     * run: executes a slice of the CPU while continuing (default: execute 10000 clocks)
+     *      call the devices in it if they are synchronized with the CPU
+     */
+    Z80GdbStub(Z80* cpu_, const std::function<void(Z80* cpu)>& run = nullptr)
+    {
+        this->cpu = cpu_;
+        this->runSlice = run ? run : [](Z80* c) { c->execute(10000); };
+        this->listenFd = -1;
+        this->fd = -1;
+        this->stopped = false;
+        this->stopPC = 0;
+        this->stepping = false;
+    }
+
+    ~Z80GdbStub()
+    {
+        close();
+        if (0 <= listenFd) ::close(listenFd);
+        for (auto& bp : breakPoints) cpu->removeBreakPoint(bp.first, bp.second);
+    }
+
+    // listen on the local TCP port (127.0.0.1)
+    bool listenTcp(unsigned short port)
+    {
+        listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        int reuse = 1;
+        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(listenFd, 1) < 0) {
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        return true;
+    }
+
+    // listen on the UNIX domain socket
+    bool listenUnix(const char* path)
+    {
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+        ::unlink(path);
+        if (::bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(listenFd, 1) < 0) {
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        return true;
+    }
+
+    // wait for the debugger to connect
+    bool accept()
+    {
+        if (listenFd < 0) return false;
+        close();
+        fd = ::accept(listenFd, nullptr, nullptr);
+        return 0 <= fd;
+    }
+
+    // use the connected socket (e.g. socketpair), the stub closes it
+    void attach(int fd_)
+    {
+        close();
+        fd = fd_;
+    }
+
+    void close()
+    {
+        if (0 <= fd) ::close(fd);
+        fd = -1;
+    }
+
+    bool isConnected() { return 0 <= fd; }
+
+    // process the packets until the debugger detaches or disconnects (the CPU runs only while continuing)
+    void serve()
+    {
+        std::string packet;
+        std::string reply;
+        while (isConnected() && receivePacket(packet)) {
+            if ("\x03" == packet) {
+                sendPacket("S02"); // already stopped
+                continue;
+            }
+            if (packet.empty()) continue;
+            if (!handlePacket(packet, reply) || !sendPacket(reply)) break;
+        }
+        close();
+    }
+};
+
+#endif // INCLUDE_Z80GDB_HPP
@@ -0,0 +1,294 @@
+/**
+ * SUZUKI PLAN - Z80 Emulator (Rewind)
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Yoji Suzuki.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_Z80REWIND_HPP
+#define INCLUDE_Z80REWIND_HPP
+#include "z80.hpp"
+
+class Z80Rewind
+{
+  private:
+    // frame record in the arena
+    struct Record {
+        size_t offset;
+        size_t size;
+        bool key;
+    };
+
+    Z80* cpu;
+    unsigned char* memory;
+    size_t memorySize;
+    size_t stateSize;
+    size_t imageSize;   // stateSize + memorySize
+    unsigned char* current; // image of the latest captured frame
+    unsigned char* work;    // image of the frame to be captured or restored
+    unsigned char* encoded; // encode buffer (worst case size)
+    size_t encodedCapacity;
+    unsigned char* arena;
+    size_t arenaSize;
+    size_t arenaHead; // next write offset
+    Record* records;  // ring buffer of the records (oldest first)
+    int recordCapacity;
+    int recordTail; // index of the oldest record
+    int recordCount;
+    int keyFrameInterval;
+    int framesSinceKey;
+    size_t usedSize;
+
+    inline Record* getRecord(int index) { return &records[(recordTail + index) % recordCapacity]; }
+
+    static inline void putVarint(unsigned char*& ptr, size_t value)
+    {
+        while (0x80 <= value) {
+            *ptr++ = (unsigned char)(value | 0x80);
+            value >>= 7;
+        }
+        *ptr++ = (unsigned char)value;
+    }
+
+    static inline size_t getVarint(const unsigned char*& ptr)
+    {
+        size_t value = 0;
+        int shift = 0;
+        while (*ptr & 0x80) {
+            value |= (size_t)(*ptr++ & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= (size_t)(*ptr++) << shift;
+        return value;
+    }
+
+    // encode as the sequence of {zero run length, literal length, literal bytes}
+    // key frame: value = image, delta frame: value = image XOR base
+    size_t encode(const unsigned char* image, const unsigned char* base)
+    {
+        unsigned char* ptr = encoded;
+        size_t i = 0;
+        while (i < imageSize) {
+            size_t zeroStart = i;
+            while (i < imageSize && image[i] == (base ? base[i] : 0)) i++;
+            size_t literalStart = i;
+            // continue the literal until a zero run of 4 bytes appears
+            size_t zeros = 0;
+            while (i < imageSize) {
+                if (image[i] == (base ? base[i] : 0)) {
+                    if (4 == ++zeros) break;
+                } else {
+                    zeros = 0;
+                }
+                i++;
+            }
+            size_t literalEnd = 4 == zeros ? i - 3 : i - zeros;
+            putVarint(ptr, literalStart - zeroStart);
+            putVarint(ptr, literalEnd - literalStart);
+            for (size_t j = literalStart; j < literalEnd; j++) {
+                *ptr++ = base ? image[j] ^ base[j] : image[j];
+            }
+            i = literalEnd;
+        }
+        return (size_t)(ptr - encoded);
+    }
+
+    void decode(const Record* record, unsigned char* image)
+    {
+        const unsigned char* ptr = arena + record->offset;
+        const unsigned char* end = ptr + record->size;
+        size_t i = 0;
+        while (ptr < end) {
+            size_t zeros = getVarint(ptr);
+            if (record->key) memset(image + i, 0, zeros);
+            i += zeros;
+            size_t literals = getVarint(ptr);
+            if (record->key) {
+                memcpy(image + i, ptr, literals);
+            } else {
+                for (size_t j = 0; j < literals; j++) image[i + j] ^= ptr[j];
+            }
+            i += literals;
+            ptr += literals;
+        }
+    }
+
+    void removeOldestRecord()
+    {
+        usedSize -= getRecord(0)->size;
+        recordTail = (recordTail + 1) % recordCapacity;
+        recordCount--;
+        if (0 == recordCount) {
+            recordTail = 0;
+            arenaHead = 0;
+        }
+    }
+
+    // remove the oldest key frame and its delta frames
+    void removeOldestFrames()
+    {
+        do {
+            removeOldestRecord();
+        } while (recordCount && !getRecord(0)->key);
+    }
+
+    bool allocate(size_t size, size_t* offset)
+    {
+        if (arenaSize < size) return false;
+        while (true) {
+            if (recordCount < recordCapacity) {
+                if (0 == recordCount) {
+                    *offset = 0;
+                    return true;
+                }
+                size_t tail = getRecord(0)->offset;
+                if (tail < arenaHead) {
+                    if (arenaHead + size <= arenaSize) {
+                        *offset = arenaHead;
+                        return true;
+                    } else if (size <= tail) {
+                        *offset = 0;
+                        return true;
+                    }
+                } else if (arenaHead + size <= tail) {
+                    *offset = arenaHead;
+                    return true;
+                }
+            }
+            removeOldestFrames();
+        }
+    }
+
+  public:
+    /**
+     * cpu: the CPU to be captured and restored
+     * memory: the memory (RAM) to be captured and restored
+     * memorySize: size of the memory
+     * arenaSize: size of the arena to store the frames
+     * keyFrameInterval: number of the frames between the key frames
+     * maxFrames: maximum number of the frames to be stored
+     */
+    Z80Rewind(Z80* cpu_, unsigned char* memory_, size_t memorySize_, size_t arenaSize_, int keyFrameInterval_ = 60, int maxFrames = 3600)
+    {
+        this->cpu = cpu_;
+        this->memory = memory_;
+        this->memorySize = memorySize_;
+        this->stateSize = cpu->getStateSize();
+        this->imageSize = stateSize + memorySize;
+        this->current = new unsigned char[imageSize];
+        this->work = new unsigned char[imageSize];
+        this->encodedCapacity = imageSize + imageSize / 2 + 32;
+        this->encoded = new unsigned char[encodedCapacity];
+        this->arenaSize = arenaSize_;
+        this->arena = new unsigned char[arenaSize];
+        this->recordCapacity = 0 < maxFrames ? maxFrames : 1;
+        this->records = new Record[recordCapacity];
+        this->keyFrameInterval = 0 < keyFrameInterval_ ? keyFrameInterval_ : 1;
+        clear();
+    }
+
+    ~Z80Rewind()
+    {
+        delete[] current;
+        delete[] work;
+        delete[] encoded;
+        delete[] arena;
+        delete[] records;
+    }
+
+    // the buffers are owned by this instance (not copyable)
+    Z80Rewind(const Z80Rewind&) = delete;
+    Z80Rewind& operator=(const Z80Rewind&) = delete;
+
+    void clear()
+    {
+        arenaHead = 0;
+        recordTail = 0;
+        recordCount = 0;
+        framesSinceKey = 0;
+        usedSize = 0;
+    }
+
+    // capture the current frame (call once per frame)
+    bool capture()
+    {
+        cpu->saveState(work, stateSize);
+        memcpy(work + stateSize, memory, memorySize);
+        bool key = 0 == recordCount || keyFrameInterval <= framesSinceKey;
+        size_t size = encode(work, key ? nullptr : current);
+        size_t offset;
+        if (!allocate(size, &offset)) return false;
+        if (!key && 0 == recordCount) {
+            // the base key frame has been removed
+            key = true;
+            size = encode(work, nullptr);
+            if (!allocate(size, &offset)) return false;
+        }
+        memcpy(arena + offset, encoded, size);
+        Record* record = getRecord(recordCount++);
+        record->offset = offset;
+        record->size = size;
+        record->key = key;
+        arenaHead = offset + size;
+        usedSize += size;
+        framesSinceKey = key ? 1 : framesSinceKey + 1;
+        unsigned char* swap = current;
+        current = work;
+        work = swap;
+        return true;
+    }
+
+    // restore the frame captured the specified number of frames before the latest one (0: latest)
+    bool rewind(int frames = 1)
+    {
+        if (frames < 0 || recordCount <= frames) return false;
+        int target = recordCount - 1 - frames;
+        int key = target;
+        while (!getRecord(key)->key) key--;
+        for (int i = key; i <= target; i++) {
+            decode(getRecord(i), current);
+        }
+        cpu->loadState(current, stateSize);
+        memcpy(memory, current + stateSize, memorySize);
+        // discard the frames after the target
+        while (target + 1 < recordCount) {
+            recordCount--;
+            usedSize -= getRecord(recordCount)->size;
+        }
+        Record* last = getRecord(target);
+        arenaHead = last->offset + last->size;
+        framesSinceKey = target - key + 1;
+        return true;
+    }
+
+    int getFrameCount() { return recordCount; }
+    size_t getUsedSize() { return usedSize; }
+    size_t getArenaSize() { return arenaSize; }
+
+    // total heap memory used by this instance
+    size_t getMemoryUsage()
+    {
+        return arenaSize + imageSize * 2 + encodedCapacity + sizeof(Record) * (size_t)recordCapacity;
+    }
+};
+
+#endif // INCLUDE_Z80REWIND_HPP
@@ -0,0 +1,122 @@
+/**
+ * SUZUKI PLAN - Z80 Emulator (Run-ahead)
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Yoji Suzuki.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_Z80RUNAHEAD_HPP
+#define INCLUDE_Z80RUNAHEAD_HPP
+#include "z80.hpp"
+#include <functional>
+
+class Z80RunAhead
+{
+  private:
+    Z80* primary;
+    unsigned char* primaryMemory;
+    Z80* speculative;
+    unsigned char* speculativeMemory;
+    size_t memorySize;
+    int frames;
+    bool valid; // the speculative CPU is ahead with the current input
+    unsigned char* state;
+    size_t stateSize;
+    std::function<void()> synchronize;
+    unsigned long long emulatedFrames;
+    unsigned long long displayedFrames;
+    unsigned long long rollbacks;
+
+    void rollback()
+    {
+        primary->saveState(state, stateSize);
+        speculative->loadState(state, stateSize);
+        memcpy(speculativeMemory, primaryMemory, memorySize);
+        if (synchronize) synchronize();
+        rollbacks++;
+    }
+
+  public:
+    /**
+     * primary: the CPU that executes the confirmed frames (with side effects)
+     * speculative: the CPU that executes the frames ahead (e.g., a clone of the primary that uses speculativeMemory)
+     *              its callbacks drive its own devices (check isSpeculative in them to skip the outputs to the host)
+     * frames: number of the frames to run ahead
+     * synchronize: called after copying the CPU state and the memory from the primary (copy the other device states in it)
+     */
+    Z80RunAhead(Z80* primary_, unsigned char* primaryMemory_, Z80* speculative_, unsigned char* speculativeMemory_, size_t memorySize_, int frames_, const std::function<void()>& synchronize_ = nullptr)
+    {
+        this->primary = primary_;
+        this->primaryMemory = primaryMemory_;
+        this->speculative = speculative_;
+        this->speculativeMemory = speculativeMemory_;
+        this->memorySize = memorySize_;
+        this->frames = 0 < frames_ ? frames_ : 1;
+        this->valid = false;
+        this->stateSize = primary->getStateSize();
+        this->state = new unsigned char[stateSize];
+        this->synchronize = synchronize_;
+        this->emulatedFrames = 0;
+        this->displayedFrames = 0;
+        this->rollbacks = 0;
+        speculative->setSpeculative(true);
+    }
+
+    ~Z80RunAhead()
+    {
+        delete[] state;
+    }
+
+    /**
+     * Run one displayed frame.
+     * runFrame: execute one frame of the specified CPU (the input should be applied before calling it)
+     * inputChanged: true if the input has been changed from the previous frame
+     * After returning, the speculative CPU is the specified number of the frames ahead of the primary CPU,
+     * so present the output (e.g., video) of the speculative CPU.
+     */
+    void run(const std::function<void(Z80* cpu)>& runFrame, bool inputChanged)
+    {
+        runFrame(primary);
+        emulatedFrames++;
+        if (inputChanged || !valid) {
+            // the speculative frames are based on the old input: roll back and run ahead again
+            rollback();
+            for (int i = 0; i < frames; i++) runFrame(speculative);
+            emulatedFrames += (unsigned long long)frames;
+            valid = true;
+        } else {
+            // the input is not changed: the speculative CPU is still valid
+            runFrame(speculative);
+            emulatedFrames++;
+        }
+        displayedFrames++;
+    }
+
+    // discard the speculative frames (e.g., after loading the state of the primary CPU)
+    void invalidate() { valid = false; }
+
+    unsigned long long getEmulatedFrames() { return emulatedFrames; }
+    unsigned long long getDisplayedFrames() { return displayedFrames; }
+    unsigned long long getRollbacks() { return rollbacks; }
+};
+
+#endif // INCLUDE_Z80RUNAHEAD_HPP
@@ -0,0 +1,156 @@
+/**
+ * SUZUKI PLAN - Z80 Emulator (Timeline trace writer)
+ * -----------------------------------------------------------------------------
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Yoji Suzuki.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef INCLUDE_Z80TIMELINE_HPP
+#define INCLUDE_Z80TIMELINE_HPP
+#include "z80.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#ifdef Z80_DISABLE_TIMELINE
+#error "z80timeline.hpp requires the timeline (do not define Z80_DISABLE_TIMELINE)"
+#endif
+
+class Z80TimelineWriter
+{
+  private:
+    // the tracks (tid) of the timeline
+    static const int trackCPU = 1;       // execute slices
+    static const int trackHalt = 2;      // HALT spans
+    static const int trackInterrupt = 3; // interrupts and break points
+    static const int trackDevice = 4;    // user-defined events
+
+    Z80* cpu;
+    FILE* fp;
+    double clockHz;
+    bool first;
+    std::mutex mutex; // serializes drain and write (the writer thread and flush)
+    std::atomic<bool> running;
+    std::thread thread;
+    Z80::TimelineEvent events[1024];
+
+    void writeName(const char* name)
+    {
+        fputc('"', fp);
+        for (const char* ptr = name; *ptr; ptr++) {
+            if ('"' == *ptr || '\\' == *ptr) fputc('\\', fp);
+            if (0x20 <= (unsigned char)*ptr) fputc(*ptr, fp);
+        }
+        fputc('"', fp);
+    }
+
+    void writeEvent(const char* name, const char* phase, int track, const Z80::TimelineEvent& e)
+    {
+        fputs(first ? "\n" : ",\n", fp);
+        first = false;
+        fputs("{\"name\":", fp);
+        writeName(name);
+        fprintf(fp, ",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", phase, (double)e.clock * 1000000.0 / clockHz, track);
+        if ('i' == phase[0]) fputs(",\"s\":\"t\"", fp);
+        fprintf(fp, ",\"args\":{\"pc\":\"$%04X\"}}", e.addr);
+    }
+
+    void writeTrackName(int track, const char* name)
+    {
+        fputs(first ? "\n" : ",\n", fp);
+        first = false;
+        fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", track, name);
+    }
+
+    void write(const Z80::TimelineEvent& e)
+    {
+        static const char* modes[4] = {"IM0", "IM1", "IM2", "IM2"};
+        switch (e.type) {
+            case Z80::TimelineType::ExecuteBegin: writeEvent("execute", "B", trackCPU, e); break;
+            case Z80::TimelineType::ExecuteEnd: writeEvent("execute", "E", trackCPU, e); break;
+            case Z80::TimelineType::HaltBegin: writeEvent("HALT", "B", trackHalt, e); break;
+            case Z80::TimelineType::HaltEnd: writeEvent("HALT", "E", trackHalt, e); break;
+            case Z80::TimelineType::NMI: writeEvent("NMI", "i", trackInterrupt, e); break;
+            case Z80::TimelineType::IRQ: writeEvent(modes[e.value & 3], "i", trackInterrupt, e); break;
+            case Z80::TimelineType::BreakPoint: writeEvent("break point", "i", trackInterrupt, e); break;
+            case Z80::TimelineType::SpanBegin: writeEvent(e.name ? e.name : "", "B", trackDevice, e); break;
+            case Z80::TimelineType::SpanEnd: writeEvent(e.name ? e.name : "", "E", trackDevice, e); break;
+            case Z80::TimelineType::Instant: writeEvent(e.name ? e.name : "", "i", trackDevice, e); break;
+        }
+    }
+
+    void run()
+    {
+        while (running.load()) {
+            flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+  public:
+    /**
+     * cpu: the CPU that the timeline is enabled (enableTimeline)
+     * fp: the stream to write the Chrome trace JSON (closed by the caller after the destructor)
+     * clockHz: the CPU clock to convert the clocks (T-states) to the microseconds
+     * async: drain and write the events on the writer thread (false: call flush on the CPU thread)
+     */
+    Z80TimelineWriter(Z80* cpu_, FILE* fp_, double clockHz_ = 3579545.0, bool async = true)
+    {
+        this->cpu = cpu_;
+        this->fp = fp_;
+        this->clockHz = 0 < clockHz_ ? clockHz_ : 3579545.0;
+        this->first = true;
+        fputs("{\"traceEvents\":[", fp);
+        writeTrackName(trackCPU, "CPU");
+        writeTrackName(trackHalt, "HALT");
+        writeTrackName(trackInterrupt, "interrupt");
+        writeTrackName(trackDevice, "device");
+        running.store(async);
+        if (async) thread = std::thread(&Z80TimelineWriter::run, this);
+    }
+
+    // stop the writer thread, write the remaining events and close the JSON
+    ~Z80TimelineWriter()
+    {
+        if (running.exchange(false)) thread.join();
+        flush();
+        fputs("\n],\"displayTimeUnit\":\"ns\"}\n", fp);
+        fflush(fp);
+    }
+
+    // drain the events from the CPU and write them (returns the number of the written events)
+    int flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int total = 0;
+        while (true) {
+            int n = cpu->drainTimeline(events, (int)(sizeof(events) / sizeof(events[0])));
+            for (int i = 0; i < n; i++) write(events[i]);
+            total += n;
+            if (n < (int)(sizeof(events) / sizeof(events[0]))) break;
+        }
+        return total;
+    }
+};
+
+#endif // INCLUDE_Z80TIMELINE_HPP